@@ -83,6 +83,8 @@ HEADERS += \
     ../../../src/libtsduck/tsDescriptor.h \
     ../../../src/libtsduck/tsDescriptorList.h \
     ../../../src/libtsduck/tsDescriptorListTemplate.h \
+    ../../../src/libtsduck/tsDescriptorListView.h \
+    ../../../src/libtsduck/tsDescriptorView.h \
     ../../../src/libtsduck/tsDoubleCheckLock.h \
     ../../../src/libtsduck/tsDTSDescriptor.h \
     ../../../src/libtsduck/tsduck.h \
@@ -136,9 +138,11 @@ HEADERS += \
     ../../../src/libtsduck/tsLocalTimeOffsetDescriptor.h \
     ../../../src/libtsduck/tsLogicalChannelNumberDescriptor.h \
     ../../../src/libtsduck/tsMACAddress.h \
+    ../../../src/libtsduck/tsMappedSectionFile.h \
     ../../../src/libtsduck/tsMaximumBitrateDescriptor.h \
     ../../../src/libtsduck/tsMD5.h \
     ../../../src/libtsduck/tsMediaGuardDate.h \
+    ../../../src/libtsduck/tsMemoryMappedFile.h \
     ../../../src/libtsduck/tsMemoryUtils.h \
     ../../../src/libtsduck/tsMessageDescriptor.h \
     ../../../src/libtsduck/tsMessageQueue.h \
@@ -162,7 +166,9 @@ HEADERS += \
     ../../../src/libtsduck/tsOneShotPacketizer.h \
     ../../../src/libtsduck/tsOutputPager.h \
     ../../../src/libtsduck/tsOutputRedirector.h \
+    ../../../src/libtsduck/tsPacketClock.h \
     ../../../src/libtsduck/tsPacketizer.h \
+    ../../../src/libtsduck/tsPacketPacer.h \
     ../../../src/libtsduck/tsParentalRatingDescriptor.h \
     ../../../src/libtsduck/tsPAT.h \
     ../../../src/libtsduck/tsPCR.h \
@@ -174,6 +180,7 @@ HEADERS += \
     ../../../src/libtsduck/tsPIDOperator.h \
     ../../../src/libtsduck/tsPlatform.h \
     ../../../src/libtsduck/tsPlugin.h \
+    ../../../src/libtsduck/tsPluginManifest.h \
     ../../../src/libtsduck/tsPluginRepository.h \
     ../../../src/libtsduck/tsPluginSharedLibrary.h \
     ../../../src/libtsduck/tsPMT.h \
@@ -195,6 +202,8 @@ HEADERS += \
     ../../../src/libtsduck/tsReportWithPrefix.h \
     ../../../src/libtsduck/tsResidentBuffer.h \
     ../../../src/libtsduck/tsResidentBufferTemplate.h \
+    ../../../src/libtsduck/tsRingMessageQueue.h \
+    ../../../src/libtsduck/tsRingMessageQueueTemplate.h \
     ../../../src/libtsduck/tsRingNode.h \
     ../../../src/libtsduck/tsRST.h \
     ../../../src/libtsduck/tsS2SatelliteDeliverySystemDescriptor.h \
@@ -286,6 +295,8 @@ HEADERS += \
     ../../../src/libtsduck/tstlvMessageFactoryTemplate.h \
     ../../../src/libtsduck/tstlvProtocol.h \
     ../../../src/libtsduck/tstlvSerializer.h \
+    ../../../src/libtsduck/tstlvServer.h \
+    ../../../src/libtsduck/tstlvServerHandlerInterface.h \
     ../../../src/libtsduck/tstlvStreamMessage.h \
     ../../../src/libtsduck/tsTLVSyntax.h \
     ../../../src/libtsduck/tsTOT.h \
@@ -294,12 +305,14 @@ HEADERS += \
     ../../../src/libtsduck/tsTSAnalyzerOptions.h \
     ../../../src/libtsduck/tsTSAnalyzerReport.h \
     ../../../src/libtsduck/tsTSDT.h \
+    ../../../src/libtsduck/tsTSFileIndex.h \
     ../../../src/libtsduck/tsTSFileInput.h \
     ../../../src/libtsduck/tsTSFileInputBuffered.h \
     ../../../src/libtsduck/tsTSFileOutput.h \
     ../../../src/libtsduck/tsTSFileOutputResync.h \
     ../../../src/libtsduck/tsTSPacket.h \
     ../../../src/libtsduck/tsTSScanner.h \
+    ../../../src/libtsduck/tsTSSparseFormat.h \
     ../../../src/libtsduck/tsTuner.h \
     ../../../src/libtsduck/tsTunerArgs.h \
     ../../../src/libtsduck/tsTunerParameters.h \
@@ -400,6 +413,8 @@ SOURCES += \
     ../../../src/libtsduck/tsDES.cpp \
     ../../../src/libtsduck/tsDescriptor.cpp \
     ../../../src/libtsduck/tsDescriptorList.cpp \
+    ../../../src/libtsduck/tsDescriptorListView.cpp \
+    ../../../src/libtsduck/tsDescriptorView.cpp \
     ../../../src/libtsduck/tsDTSDescriptor.cpp \
     ../../../src/libtsduck/tsDVBCharset.cpp \
     ../../../src/libtsduck/tsDVBCharsetSingleByte.cpp \
@@ -441,8 +456,10 @@ SOURCES += \
     ../../../src/libtsduck/tsLocalTimeOffsetDescriptor.cpp \
     ../../../src/libtsduck/tsLogicalChannelNumberDescriptor.cpp \
     ../../../src/libtsduck/tsMACAddress.cpp \
+    ../../../src/libtsduck/tsMappedSectionFile.cpp \
     ../../../src/libtsduck/tsMaximumBitrateDescriptor.cpp \
     ../../../src/libtsduck/tsMD5.cpp \
+    ../../../src/libtsduck/tsMemoryMappedFile.cpp \
     ../../../src/libtsduck/tsMemoryUtils.cpp \
     ../../../src/libtsduck/tsMessageDescriptor.cpp \
     ../../../src/libtsduck/tsMJD.cpp \
@@ -461,7 +478,9 @@ SOURCES += \
     ../../../src/libtsduck/tsOneShotPacketizer.cpp \
     ../../../src/libtsduck/tsOutputPager.cpp \
     ../../../src/libtsduck/tsOutputRedirector.cpp \
+    ../../../src/libtsduck/tsPacketClock.cpp \
     ../../../src/libtsduck/tsPacketizer.cpp \
+    ../../../src/libtsduck/tsPacketPacer.cpp \
     ../../../src/libtsduck/tsParentalRatingDescriptor.cpp \
     ../../../src/libtsduck/tsPAT.cpp \
     ../../../src/libtsduck/tsPCR.cpp \
@@ -471,6 +490,7 @@ SOURCES += \
     ../../../src/libtsduck/tsPESPacket.cpp \
     ../../../src/libtsduck/tsPIDOperator.cpp \
     ../../../src/libtsduck/tsPlugin.cpp \
+    ../../../src/libtsduck/tsPluginManifest.cpp \
     ../../../src/libtsduck/tsPluginRepository.cpp \
     ../../../src/libtsduck/tsPluginSharedLibrary.cpp \
     ../../../src/libtsduck/tsPMT.cpp \
@@ -555,12 +575,14 @@ SOURCES += \
     ../../../src/libtsduck/tstlvMessage.cpp \
     ../../../src/libtsduck/tstlvMessageFactory.cpp \
     ../../../src/libtsduck/tstlvSerializer.cpp \
+    ../../../src/libtsduck/tstlvServer.cpp \
     ../../../src/libtsduck/tsTLVSyntax.cpp \
     ../../../src/libtsduck/tsTOT.cpp \
     ../../../src/libtsduck/tsTSAnalyzer.cpp \
     ../../../src/libtsduck/tsTSAnalyzerOptions.cpp \
     ../../../src/libtsduck/tsTSAnalyzerReport.cpp \
     ../../../src/libtsduck/tsTSDT.cpp \
+    ../../../src/libtsduck/tsTSFileIndex.cpp \
     ../../../src/libtsduck/tsTSFileInput.cpp \
     ../../../src/libtsduck/tsTSFileInputBuffered.cpp \
     ../../../src/libtsduck/tsTSFileOutput.cpp \
@@ -100,8 +100,10 @@ SUBDIRS += \
     tsdate \
     tsdektec \
     tsdump \
+    tsecmg \
     tsfixcc \
     tsftrunc \
+    tsindex \
     tslsdvb \
     tsp \
     tspacketize \
@@ -0,0 +1,3 @@
+CONFIG += tstool
+TARGET = tsecmg
+include(../tsduck.pri)
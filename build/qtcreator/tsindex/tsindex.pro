@@ -0,0 +1,3 @@
+CONFIG += tstool
+TARGET = tsindex
+include(../tsduck.pri)
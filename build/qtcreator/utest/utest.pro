@@ -16,6 +16,7 @@ SOURCES += \
     ../../../src/utest/utest.cpp \
     ../../../src/utest/utestAlgorithm.cpp \
     ../../../src/utest/utestArgs.cpp \
+    ../../../src/utest/utestAVCParser.cpp \
     ../../../src/utest/utestBitStream.cpp \
     ../../../src/utest/utestByteBlock.cpp \
     ../../../src/utest/utestCppUnitMain.cpp \
@@ -39,8 +40,11 @@ SOURCES += \
     ../../../src/utest/utestNames.cpp \
     ../../../src/utest/utestNetworking.cpp \
     ../../../src/utest/utestPacketizer.cpp \
+    ../../../src/utest/utestPacketPacer.cpp \
+    ../../../src/utest/utestPCRAnalyzer.cpp \
     ../../../src/utest/utestPlatform.cpp \
     ../../../src/utest/utestPlugin.cpp \
+    ../../../src/utest/utestPluginManifest.cpp \
     ../../../src/utest/utestReport.cpp \
     ../../../src/utest/utestResidentBuffer.cpp \
     ../../../src/utest/utestRing.cpp \
@@ -55,8 +59,12 @@ SOURCES += \
     ../../../src/utest/utestTable.cpp \
     ../../../src/utest/utestTablesFactory.cpp \
     ../../../src/utest/utestThread.cpp \
+    ../../../src/utest/utestTLV.cpp \
     ../../../src/utest/utestThreadAttributes.cpp \
     ../../../src/utest/utestTime.cpp \
+    ../../../src/utest/utestTSAnalyzer.cpp \
+    ../../../src/utest/utestTSFile.cpp \
+    ../../../src/utest/utestTSFileIndex.cpp \
     ../../../src/utest/utestTSPacket.cpp \
     ../../../src/utest/utestUString.cpp \
     ../../../src/utest/utestVariable.cpp \
@@ -42,8 +42,10 @@ TSDUCK_SOURCE;
 
 bool ts::AVCParser::rbspTrailingBits()
 {
-    const uint8_t* saved_byte = _byte;
-    size_t saved_bit = _bit;
+    const uint8_t* const saved_byte = _byte;
+    const uint64_t saved_cache = _cache;
+    const size_t saved_cache_bits = _cache_bits;
+    const uint64_t saved_cache_epb = _cache_epb;
     uint8_t bit;
     bool valid = readBits (bit, 1) && bit == 1;
     while (valid && !byteAligned()) {
@@ -51,7 +53,9 @@ bool ts::AVCParser::rbspTrailingBits()
     }
     if (!valid) {
         _byte = saved_byte;
-        _bit = saved_bit;
+        _cache = saved_cache;
+        _cache_bits = saved_cache_bits;
+        _cache_epb = saved_cache_epb;
     }
     return valid;
 }
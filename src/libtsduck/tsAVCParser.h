@@ -44,6 +44,10 @@ namespace ts {
     //! The naming of methods such as readBits(), i(), u(), etc. is
     //! directly transposed from ISO/IEC 14496-10.
     //!
+    //! The bits are extracted from a 64-bit cache word which is reloaded
+    //! from memory only when empty. The emulation prevention bytes are
+    //! removed when the cache is reloaded.
+    //!
     class TSDUCKDLL AVCParser
     {
     public:
@@ -58,7 +62,9 @@ namespace ts {
             _end(_base + size_in_bytes),
             _total_size(size_in_bytes),
             _byte(_base),
-            _bit(0)
+            _cache(0),
+            _cache_bits(0),
+            _cache_epb(0)
         {
         }
 
@@ -74,7 +80,9 @@ namespace ts {
             _end = _base + size_in_bytes;
             _total_size = size_in_bytes;
             _byte = _base;
-            _bit = 0;
+            _cache = 0;
+            _cache_bits = 0;
+            _cache_epb = 0;
         }
 
         //!
@@ -86,7 +94,13 @@ namespace ts {
         void reset(size_t byte_offset = 0, size_t bit_offset = 0)
         {
             _byte = _base + std::min(byte_offset + bit_offset / 8, _total_size);
-            _bit = bit_offset % 8;
+            _cache = 0;
+            _cache_bits = 0;
+            _cache_epb = 0;
+            if (bit_offset % 8 != 0) {
+                refill();
+                dropBits(std::min(bit_offset % 8, _cache_bits));
+            }
         }
 
         //!
@@ -95,23 +109,24 @@ namespace ts {
         //!
         size_t remainingBytes() const
         {
-            assert(_byte >= _base);
-            assert(_byte <= _end);
-            assert(_byte < _end || _bit == 0);
-            return _end - _byte - (_bit != 0);
+            return remainingBits() / 8;
         }
 
         //!
         //! Get number of remaining bits.
+        //! As in the raw byte stream, the emulation prevention bytes after the current byte are included.
         //! @return The number of remaining bits.
         //!
         size_t remainingBits() const
         {
             assert(_byte >= _base);
             assert(_byte <= _end);
-            assert(_byte < _end || _bit == 0);
-            assert(_bit < 8);
-            return 8 * (_end - _byte) - _bit;
+            assert(_cache_bits <= 64);
+            size_t epb = 0;
+            for (uint64_t mask = _cache_epb; mask != 0; mask &= mask - 1) {
+                epb++;
+            }
+            return 8 * (_end - _byte + epb) + _cache_bits;
         }
 
         //!
@@ -120,7 +135,7 @@ namespace ts {
         //!
         bool endOfStream() const
         {
-            return _byte >= _end;
+            return _cache_bits == 0 && _byte >= _end;
         }
 
         //!
@@ -129,7 +144,8 @@ namespace ts {
         //!
         bool byteAligned() const
         {
-            return _bit == 0;
+            // The cache is always loaded with complete bytes.
+            return (_cache_bits & 0x07) == 0;
         }
 
         //!
@@ -221,36 +237,38 @@ namespace ts {
         const uint8_t* _base;
         const uint8_t* _end;
         size_t         _total_size;
-        const uint8_t* _byte;         // Byte pointer
-        size_t         _bit;          // Bit offset into *_byte
+        const uint8_t* _byte;         // Next byte to load in cache
+        uint64_t       _cache;        // Cached bits, next bit is the MSB, unused bits are zero
+        size_t         _cache_bits;   // Number of valid bits in _cache
+        uint64_t       _cache_epb;    // Same layout as _cache, a bit is set at the end of each cached byte which is followed by an emulation prevention byte
 
-        // Advance pointer to next byte boundary.
-        void nextByte()
+        // Load as many complete bytes as possible in the cache.
+        void refill()
         {
-            // Next byte boundary
-            assert(_byte < _end);
-            ++_byte;
-            _bit = 0;
+            while (_cache_bits <= 56 && _byte < _end) {
+                const size_t shift = 56 - _cache_bits;
+                _cache |= uint64_t(*_byte++) << shift;
+                _cache_bits += 8;
 
-            // Process start code emulation prevention: sequences 00 00 03
-            // are used when 00 00 00 or 00 00 01 would be present. In that
-            // case, the 00 00 is part of the raw byte sequence payload (rbsp)
-            // but the 03 shall be discarded.
-            if (_byte < _end && *_byte == 0x03 && _byte > _base+1 && _byte[-1] == 0x00 && _byte[-2] == 0x00) {
-                // Skip 03 after 00 00
-                ++_byte;
+                // Process start code emulation prevention: sequences 00 00 03
+                // are used when 00 00 00 or 00 00 01 would be present. In that
+                // case, the 00 00 is part of the raw byte sequence payload (rbsp)
+                // but the 03 shall be discarded.
+                if (_byte < _end && *_byte == 0x03 && _byte > _base + 1 && _byte[-1] == 0x00 && _byte[-2] == 0x00) {
+                    // Skip 03 after 00 00
+                    ++_byte;
+                    _cache_epb |= uint64_t(1) << shift;
+                }
             }
         }
 
-        // Advance pointer by one bit and return the bit value
-        uint8_t nextBit()
+        // Drop n bits from the cache, n <= _cache_bits.
+        void dropBits(size_t n)
         {
-            assert(_byte < _end);
-            uint8_t b = (*_byte >> (7 - _bit)) & 0x01;
-            if (++_bit > 7) {
-                nextByte();
-            }
-            return b;
+            assert(n <= _cache_bits);
+            _cache = n >= 64 ? 0 : _cache << n;
+            _cache_epb = n >= 64 ? 0 : _cache_epb << n;
+            _cache_bits -= n;
         }
 
         // Extract Exp-Golomb-coded value using n bits.
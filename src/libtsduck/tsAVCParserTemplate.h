@@ -35,13 +35,17 @@
 //----------------------------------------------------------------------------
 
 template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type*>
-bool ts::AVCParser::nextBits (INT& val, size_t n)
+bool ts::AVCParser::nextBits(INT& val, size_t n)
 {
-    const uint8_t* saved_byte = _byte;
-    size_t saved_bit = _bit;
-    bool result = readBits (val, n);
+    const uint8_t* const saved_byte = _byte;
+    const uint64_t saved_cache = _cache;
+    const size_t saved_cache_bits = _cache_bits;
+    const uint64_t saved_cache_epb = _cache_epb;
+    const bool result = readBits(val, n);
     _byte = saved_byte;
-    _bit = saved_bit;
+    _cache = saved_cache;
+    _cache_bits = saved_cache_bits;
+    _cache_epb = saved_cache_epb;
     return result;
 }
 
@@ -51,7 +55,7 @@ bool ts::AVCParser::nextBits (INT& val, size_t n)
 //----------------------------------------------------------------------------
 
 template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type*>
-bool ts::AVCParser::readBits (INT& val, size_t n)
+bool ts::AVCParser::readBits(INT& val, size_t n)
 {
     val = 0;
 
@@ -60,25 +64,23 @@ bool ts::AVCParser::readBits (INT& val, size_t n)
         return false;
     }
 
-    // Read leading bits up to byte boundary
-    while (n > 0 && _bit != 0) {
-        val = (val << 1) | nextBit();
-        --n;
-    }
-
-    // Read complete bytes
-    while (n > 7) {
-        val = (val << 8) | *_byte;
-        nextByte();
-        n -= 8;
-    }
-
-    // Read trailing bits
+    // Extract bits from the cache by chunks of up to 32 bits.
+    uint64_t result = 0;
     while (n > 0) {
-        val = (val << 1) | nextBit();
-        --n;
+        if (_cache_bits < n) {
+            refill();
+        }
+        const size_t count = std::min<size_t>(32, std::min(n, _cache_bits));
+        if (count == 0) {
+            // Less bits than expected because of emulation prevention bytes.
+            return false;
+        }
+        result = (result << count) | (_cache >> (64 - count));
+        dropBits(count);
+        n -= count;
     }
 
+    val = static_cast<INT>(result);
     return true;
 }
 
@@ -88,21 +90,33 @@ bool ts::AVCParser::readBits (INT& val, size_t n)
 //----------------------------------------------------------------------------
 
 template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type*>
-bool ts::AVCParser::expColomb (INT& val)
+bool ts::AVCParser::expColomb(INT& val)
 {
     // See ISO/IEC 14496-10 section 9.1
+    // Count the leading zero bits in the cache, using a CLZ instruction when available.
+    // Since the unused bits of the cache are zero, a 1 bit is always a valid one.
     val = 0;
-    int leading_zero_bits = -1;
-    for (uint8_t b = 0; b == 0; leading_zero_bits++) {
-        if (_byte >= _end) {
-            return false;
+    size_t leading_zero_bits = 0;
+    for (;;) {
+        if (_cache_bits == 0) {
+            refill();
+            if (_cache_bits == 0) {
+                return false;
+            }
+        }
+        const size_t zeroes = size_t(CountLeadingZeros64(_cache));
+        if (zeroes < _cache_bits) {
+            leading_zero_bits += zeroes;
+            dropBits(zeroes + 1);
+            break;
         }
-        b = nextBit();
+        leading_zero_bits += _cache_bits;
+        dropBits(_cache_bits);
     }
-    if (!readBits (val, leading_zero_bits)) {
+    if (!readBits(val, leading_zero_bits)) {
         return false;
     }
-    val += (INT (1) << leading_zero_bits) - 1;
+    val += (INT(1) << leading_zero_bits) - 1;
     return true;
 }
 
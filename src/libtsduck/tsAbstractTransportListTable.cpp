@@ -162,6 +162,50 @@ void ts::AbstractTransportListTable::deserialize(const BinaryTable& table, const
 }
 
 
+//----------------------------------------------------------------------------
+// Get non-owning views on the content of a NIT or BAT section.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractTransportListTable::GetTransportView(const Section& section, uint16_t& tid_ext, DescriptorListView& descs, TransportViewVector& transports)
+{
+    transports.clear();
+    if (!section.isValid() || section.payloadSize() < 4) {
+        return false;
+    }
+
+    tid_ext = section.tableIdExtension();
+
+    // Analyze the section payload:
+    const uint8_t* data(section.payload());
+    size_t remain(section.payloadSize());
+
+    // Get top-level descriptor list
+    size_t info_length = std::min<size_t>(GetUInt16(data) & 0x0FFF, remain - 2);
+    descs = DescriptorListView(data + 2, info_length);
+    data += 2 + info_length;
+    remain -= 2 + info_length;
+
+    // Get transports description length
+    if (remain < 2) {
+        return false;
+    }
+    remain = std::min<size_t>(GetUInt16(data) & 0x0FFF, remain - 2);
+    data += 2;
+
+    // Get transports description
+    while (remain >= 6) {
+        transports.resize(transports.size() + 1);
+        TransportView& tp(transports.back());
+        tp.ts_id = TransportStreamId(GetUInt16(data), GetUInt16(data + 2)); // tsid, onid
+        info_length = std::min<size_t>(GetUInt16(data + 4) & 0x0FFF, remain - 6);
+        tp.descs = DescriptorListView(data + 6, info_length);
+        data += 6 + info_length;
+        remain -= 6 + info_length;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Private method: Add a new section to a table being serialized.
 // Section number is incremented. Data and remain are reinitialized.
@@ -37,6 +37,7 @@
 #include "tsAbstractLongTable.h"
 #include "tsTransportStreamId.h"
 #include "tsDescriptorList.h"
+#include "tsDescriptorListView.h"
 
 namespace ts {
     //!
@@ -60,6 +61,25 @@ namespace ts {
         //!
         typedef std::map<TransportStreamId, int> SectionHintsMap;
 
+        //!
+        //! Non-owning view of a transport stream description in a NIT or BAT section.
+        //!
+        struct TSDUCKDLL TransportView
+        {
+            TransportStreamId  ts_id;  //!< Transport stream id and original network id.
+            DescriptorListView descs;  //!< View of the descriptor list.
+
+            //!
+            //! Default constructor.
+            //!
+            TransportView() : ts_id(), descs() {}
+        };
+
+        //!
+        //! Vector of non-owning views of transport streams.
+        //!
+        typedef std::vector<TransportView> TransportViewVector;
+
         // NIT/BAT common public members:
         DescriptorList  descs;          //!< Top-level descriptor list.
         TransportMap    transports;     //!< Map of TS descriptions, key=onid/tsid, value=descriptor_list.
@@ -101,6 +121,17 @@ namespace ts {
         //!
         AbstractTransportListTable(TID tid, const UChar* xml_name, const BinaryTable& table, const DVBCharset* charset);
 
+        //!
+        //! Get non-owning views on the content of a NIT or BAT section, without deserializing it.
+        //! The table id of the section is not checked, this is the responsibility of the subclass.
+        //! @param [in] section A NIT or BAT section.
+        //! @param [out] tid_ext Table id extension.
+        //! @param [out] descs View of the top-level descriptor list.
+        //! @param [out] transports Views of the transport streams, in section order. The vector is cleared first.
+        //! @return True on success, false if @a section is not valid.
+        //!
+        static bool GetTransportView(const Section& section, uint16_t& tid_ext, DescriptorListView& descs, TransportViewVector& transports);
+
     private:
         typedef std::set <TransportStreamId> TransportStreamIdSet;
 
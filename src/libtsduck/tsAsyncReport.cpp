@@ -28,10 +28,13 @@
 //----------------------------------------------------------------------------
 
 #include "tsAsyncReport.h"
+#include "tsGuardCondition.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 const size_t ts::AsyncReport::MAX_LOG_MESSAGES;
+const ts::MilliSecond ts::AsyncReport::REPEAT_INTERVAL;
 #endif
 
 
@@ -39,18 +42,46 @@ const size_t ts::AsyncReport::MAX_LOG_MESSAGES;
 // Default constructor
 //----------------------------------------------------------------------------
 
+namespace {
+    // Size of the ring: power of 2, at least 2.
+    size_t RingSize(size_t max_messages)
+    {
+        size_t size = 2;
+        while (size < max_messages) {
+            size *= 2;
+        }
+        return size;
+    }
+}
+
 ts::AsyncReport::AsyncReport(int max_severity, bool time_stamp, size_t max_messages, bool synchronous) :
     Report(max_severity),
     Thread(ThreadAttributes().setPriority(ThreadAttributes::GetMinimumPriority())),
-    _log_queue(max_messages),
+    _ring_mask(RingSize(max_messages) - 1),
+    _ring(new LogSlot[_ring_mask + 1]),
+    _enqueue_pos(0),
+    _dequeue_pos(0),
+    _dropped(0),
+    _sleeping(false),
+    _mutex(),
+    _wakeup(),
+    _last_severity(std::numeric_limits<int>::max()),
+    _last_message(),
+    _repeat_count(0),
+    _repeat_limit(),
     _default_handler(*this),
     _handler(&_default_handler),
     _time_stamp(time_stamp),
     _synchronous(synchronous),
     _terminated(false)
 {
+    // Slot N is initially free for position N.
+    for (size_t i = 0; i <= _ring_mask; ++i) {
+        _ring[i].sequence = i;
+    }
+
     // Start the logging thread
-    start ();
+    start();
 }
 
 
@@ -61,6 +92,7 @@ ts::AsyncReport::AsyncReport(int max_severity, bool time_stamp, size_t max_messa
 ts::AsyncReport::~AsyncReport()
 {
     terminate();
+    delete[] _ring;
 }
 
 
@@ -73,7 +105,7 @@ void ts::AsyncReport::terminate()
     if (!_terminated) {
         // Insert an "end of report" message in the queue.
         // This message will tell the logging thread to terminate.
-        _log_queue.forceEnqueue(new LogMessage(true, 0, UString()));
+        forceEnqueue(true, 0, UString());
 
         // Wait for termination of the logging thread
         waitForTermination();
@@ -89,9 +121,114 @@ void ts::AsyncReport::terminate()
 void ts::AsyncReport::writeLog(int severity, const UString &msg)
 {
     if (!_terminated) {
-        // Enqueue the message immediately (timeout = 0), drop message on overflow.
-        // On the contrary, in synchronous mode, wait infinitely until the message is queued.
-        _log_queue.enqueue(new LogMessage(false, severity, msg), _synchronous ? Infinite : 0);
+        // Enqueue the message immediately, drop message on overflow.
+        // On the contrary, in synchronous mode, wait until the message is queued.
+        if (_synchronous) {
+            forceEnqueue(false, severity, msg);
+        }
+        else if (!enqueue(false, severity, msg)) {
+            _dropped++;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Try to enqueue a message, return false if the ring is full.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncReport::enqueue(bool terminate, int severity, const UString& message)
+{
+    // Reserve a position in the ring.
+    size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+    LogSlot* slot = 0;
+    for (;;) {
+        slot = &_ring[pos & _ring_mask];
+        const size_t seq = slot->sequence.load(std::memory_order_acquire);
+        const ptrdiff_t diff = ptrdiff_t(seq) - ptrdiff_t(pos);
+        if (diff == 0) {
+            // The slot is free, try to get it.
+            if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The slot still contains a message from the previous round, the ring is full.
+            return false;
+        }
+        else {
+            // Another thread got the slot, retry with the new position.
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Fill the slot. The previously allocated memory of the string is reused.
+    slot->terminate = terminate;
+    slot->severity = severity;
+    slot->message = message;
+
+    // Publish the message. Sequentially consistent with the check of _sleeping.
+    slot->sequence.store(pos + 1);
+
+    // Wake up the logging thread if it is waiting.
+    if (_sleeping.load()) {
+        GuardCondition lock(_mutex, _wakeup);
+        lock.signal();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Enqueue a message, wait as long as necessary.
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::forceEnqueue(bool terminate, int severity, const UString& message)
+{
+    while (!enqueue(terminate, severity, message)) {
+        Yield();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until some message is available or the timeout expires (logging thread only).
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::waitMessage(MilliSecond timeout)
+{
+    GuardCondition lock(_mutex, _wakeup);
+
+    // Producers check _sleeping after publishing a message. Set _sleeping before
+    // checking the ring again so that one side always sees the other.
+    _sleeping.store(true);
+    if (_ring[_dequeue_pos & _ring_mask].sequence.load() != _dequeue_pos + 1) {
+        lock.waitCondition(timeout);
+    }
+    _sleeping.store(false);
+}
+
+
+//----------------------------------------------------------------------------
+// Report pending repeated or dropped messages (logging thread only).
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::flushRepeated()
+{
+    if (_repeat_count == 1) {
+        _handler->handleMessage(_last_severity, _last_message);
+    }
+    else if (_repeat_count > 1) {
+        _handler->handleMessage(_last_severity, UString::Format(u"last message repeated %d times", {_repeat_count}));
+    }
+    _repeat_count = 0;
+}
+
+void ts::AsyncReport::flushDropped()
+{
+    const size_t dropped = _dropped.exchange(0);
+    if (dropped > 0) {
+        _handler->handleMessage(Severity::Warning, UString::Format(u"%'d messages dropped, logging queue overflow", {dropped}));
     }
 }
 
@@ -102,19 +239,75 @@ void ts::AsyncReport::writeLog(int severity, const UString &msg)
 
 void ts::AsyncReport::main()
 {
-    LogMessagePtr msg;
+    for (;;) {
+        LogSlot& slot = _ring[_dequeue_pos & _ring_mask];
+
+        // When the ring is empty, report dropped messages and wait. The repetitions
+        // of the last message are reported when their time limit is reached.
+        if (slot.sequence.load(std::memory_order_acquire) != _dequeue_pos + 1) {
+            flushDropped();
+            if (_repeat_count == 0) {
+                waitMessage(Infinite);
+            }
+            else {
+                Monotonic now;
+                now.getSystemTime();
+                if (now >= _repeat_limit) {
+                    flushRepeated();
+                }
+                else {
+                    // Round up to avoid a busy loop on the last millisecond.
+                    waitMessage((_repeat_limit - now + NanoSecPerMilliSec - 1) / NanoSecPerMilliSec);
+                }
+            }
+            continue;
+        }
 
-    while (_log_queue.dequeue(msg) && !msg->terminate) {
+        const bool terminate = slot.terminate;
+        const int severity = slot.severity;
+        const bool repeated = !terminate && severity == _last_severity && severity != Severity::Fatal && slot.message == _last_message;
+        if (!terminate && !repeated) {
+            // Report the repetitions of the previous message first.
+            flushRepeated();
+            flushDropped();
+            // Keep the new message, give the memory of the previous one to the slot.
+            _last_message.swap(slot.message);
+            _last_severity = severity;
+        }
 
-        // Invoke the report handler
-        _handler->handleMessage(msg->severity, msg->message);
+        // Release the slot for the producers.
+        slot.sequence.store(_dequeue_pos + _ring_mask + 1, std::memory_order_release);
+        _dequeue_pos++;
+
+        if (terminate) {
+            break;
+        }
+        else if (repeated) {
+            // Start the time window of the repetitions on the first one.
+            // During a continuous flow of repetitions, report them when the window is over.
+            Monotonic now;
+            now.getSystemTime();
+            if (_repeat_count++ == 0) {
+                _repeat_limit = now;
+                _repeat_limit += REPEAT_INTERVAL * NanoSecPerMilliSec;
+            }
+            else if (now >= _repeat_limit) {
+                flushRepeated();
+            }
+        }
+        else {
+            // Invoke the report handler
+            _handler->handleMessage(severity, _last_message);
 
-        // Abort application on fatal error
-        if (msg->severity == Severity::Fatal) {
-            ::exit(EXIT_FAILURE);
+            // Abort application on fatal error
+            if (severity == Severity::Fatal) {
+                ::exit(EXIT_FAILURE);
+            }
         }
     }
 
+    flushRepeated();
+    flushDropped();
     if (_max_severity >= Severity::Debug) {
         _handler->handleMessage(Severity::Debug, u"Report logging thread terminated");
     }
@@ -35,9 +35,11 @@
 #pragma once
 #include "tsReport.h"
 #include "tsReportHandler.h"
-#include "tsMessageQueue.h"
-#include "tsNullMutex.h"
 #include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsMonotonic.h"
+#include <atomic>
 
 namespace ts {
     //!
@@ -52,7 +54,17 @@ namespace ts {
     //! cannot immediately enqueue a message or if the internal queue of messages is
     //! full, the message is dropped. In other words, reporting messages is guaranteed
     //! to never block, slow down or crash the application. Messages are dropped when
-    //! necessary to avoid that kind of problem.
+    //! necessary to avoid that kind of problem. The number of dropped messages is
+    //! reported later, as a warning.
+    //!
+    //! The internal queue is a lock-free ring of preallocated message slots. Any number
+    //! of threads can log messages concurrently without locking each other. The message
+    //! strings are copied into the slots, reusing their previous memory.
+    //!
+    //! Identical consecutive messages are coalesced by the logging thread: only the first
+    //! one is displayed, followed by a "last message repeated N times" message. The
+    //! repetitions are reported when a different message is logged, at termination or
+    //! at most REPEAT_INTERVAL milliseconds after the first repetition.
     //!
     //! Messages are displayed on the standard error device by default.
     //!
@@ -66,12 +78,19 @@ namespace ts {
         //!
         static const size_t MAX_LOG_MESSAGES = 512;
 
+        //!
+        //! Maximum interval in milliseconds between the first repetition of a message
+        //! and the report of the number of repetitions.
+        //!
+        static const MilliSecond REPEAT_INTERVAL = 1000;
+
         //!
         //! Constructor.
         //! The default initial report level is Info.
         //! @param [in] max_severity Set initial level report to that level.
         //! @param [in] time_stamp If true, time stamps are added to all messages.
         //! @param [in] max_messages Maximum number of buffered messages.
+        //! The size of the internal ring is rounded up to the next power of 2.
         //! @param [in] synchronous If true, the delivery of messages is synchronous.
         //! No message is dropped, all messages are delivered. The downside is that
         //! the emitted thread may be temporarily blocked when the message queue is
@@ -130,19 +149,32 @@ namespace ts {
         // This hook is invoked in the context of the logging thread.
         virtual void main() override;
 
-        // The application threads send that type of message to the logging thread
-        struct LogMessage
+        // The application threads send that type of message to the logging thread.
+        // The ring of slots is a bounded lock-free multi-producer queue (D. Vyukov's algorithm).
+        // The sequence number of a slot tells if it is free for the producer of a given position
+        // (sequence == position) or filled for the consumer (sequence == position + 1).
+        struct LogSlot
         {
-            // Members
-            bool    terminate;  // ask the logging thread to terminate
-            int     severity;
-            UString message;
+            std::atomic<size_t> sequence;
+            bool                terminate;  // ask the logging thread to terminate
+            int                 severity;
+            UString             message;
 
-            // Constructor:
-            LogMessage(bool t, int s, const UString& m) : terminate(t), severity(s), message(m) {}
+            LogSlot() : sequence(0), terminate(false), severity(0), message() {}
         };
-        typedef SafePtr <LogMessage, NullMutex> LogMessagePtr;
-        typedef MessageQueue <LogMessage, NullMutex> LogMessageQueue;
+
+        // Try to enqueue a message, return false if the ring is full.
+        bool enqueue(bool terminate, int severity, const UString& message);
+
+        // Enqueue a message, wait as long as necessary.
+        void forceEnqueue(bool terminate, int severity, const UString& message);
+
+        // Wait until some message is available or the timeout expires (logging thread only).
+        void waitMessage(MilliSecond timeout);
+
+        // Report pending repeated or dropped messages (logging thread only).
+        void flushRepeated();
+        void flushDropped();
 
         // Default report handler:
         class DefaultHandler : public ReportHandler
@@ -155,7 +187,18 @@ namespace ts {
         };
 
         // Private members:
-        LogMessageQueue         _log_queue;
+        const size_t            _ring_mask;     // Size of ring (power of 2) minus 1
+        LogSlot*                _ring;          // Ring of message slots
+        std::atomic<size_t>     _enqueue_pos;   // Next position to write (shared by producers)
+        size_t                  _dequeue_pos;   // Next position to read (logging thread only)
+        std::atomic<size_t>     _dropped;       // Number of dropped messages since last report
+        std::atomic<bool>       _sleeping;      // The logging thread is waiting for messages
+        Mutex                   _mutex;         // Only used to wake up the logging thread
+        Condition               _wakeup;        // Signaled when a message is enqueued while sleeping
+        int                     _last_severity; // Last displayed message (logging thread only)
+        UString                 _last_message;
+        size_t                  _repeat_count;  // Number of repetitions of last message
+        Monotonic               _repeat_limit;  // Time limit to report the repetitions
         DefaultHandler          _default_handler;
         ReportHandler* volatile _handler;
         volatile bool           _time_stamp;
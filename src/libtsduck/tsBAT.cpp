@@ -78,6 +78,20 @@ ts::BAT& ts::BAT::operator=(const BAT& other)
 }
 
 
+//----------------------------------------------------------------------------
+// Get non-owning views on the content of a BAT section.
+//----------------------------------------------------------------------------
+
+bool ts::BAT::GetView(const Section& section, uint16_t& bouquet_id, DescriptorListView& descs, TransportViewVector& transports)
+{
+    if (section.tableId() != MY_TID) {
+        transports.clear();
+        return false;
+    }
+    return GetTransportView(section, bouquet_id, descs, transports);
+}
+
+
 //----------------------------------------------------------------------------
 // A static method to display a BAT section.
 //----------------------------------------------------------------------------
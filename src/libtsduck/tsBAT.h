@@ -73,6 +73,17 @@ namespace ts {
         //!
         BAT& operator=(const BAT& other);
 
+        //!
+        //! Get non-owning views on the content of a BAT section, without deserializing it.
+        //! The views point inside @a section, which must outlive them.
+        //! @param [in] section A BAT section.
+        //! @param [out] bouquet_id Bouquet identifier.
+        //! @param [out] descs View of the top-level descriptor list.
+        //! @param [out] transports Views of the transport streams, in section order. The vector is cleared first.
+        //! @return True on success, false if @a section is not a valid BAT section.
+        //!
+        static bool GetView(const Section& section, uint16_t& bouquet_id, DescriptorListView& descs, TransportViewVector& transports);
+
         // Inherited methods
         virtual void buildXML(xml::Element*) const override;
         virtual void fromXML(const xml::Element*) override;
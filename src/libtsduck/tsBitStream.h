@@ -249,25 +249,32 @@ namespace ts {
             if (_next_bit + n > _end_bit) {
                 return def;
             }
-            INT val = 0;
-            // Read leading bits up to byte boundary
-            while (n > 0 && (_next_bit & 0x07) != 0) {
-                val = (val << 1) | INT (readBit());
-                --n;
+            // Extract the bits by chunks of up to 32 bits from a 64-bit word.
+            uint64_t val = 0;
+            while (n > 0) {
+                const size_t bit = _next_bit & 0x07;
+                const size_t count = std::min<size_t>(n, 32);
+                val = (val << count) | ((loadWord(_next_bit >> 3) << bit) >> (64 - count));
+                _next_bit += count;
+                n -= count;
             }
-            // Read complete bytes
-            const uint8_t* byte = _base + (_next_bit >> 3);
-            while (n > 7) {
-                val = (val << 8) | INT(*byte++);
-                _next_bit += 8;
-                n -= 8;
+            return static_cast<INT>(val);
+        }
+
+    private:
+        // Load the 64-bit big-endian word at the specified byte offset from _base.
+        // Bytes after the end of the stream are not read and are replaced with zeroes.
+        uint64_t loadWord(size_t index) const
+        {
+            const size_t size = (_end_bit + 7) >> 3;
+            if (index + 8 <= size) {
+                return GetUInt64(_base + index);
             }
-            // Read trailing bits
-            while (n > 0) {
-                val = (val << 1) | INT(readBit());
-                --n;
+            uint64_t word = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                word = (word << 8) | (index + i < size ? _base[index + i] : 0);
             }
-            return val;
+            return word;
         }
     };
 }
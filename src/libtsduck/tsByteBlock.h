@@ -529,7 +529,7 @@ namespace ts {
     //!
     //! Safe pointer for ByteBlock, thread-safe (MT = multi-thread).
     //!
-    typedef SafePtr<ByteBlock, Mutex> ByteBlockPtrMT;
+    typedef SafePtr<ByteBlock, AtomicRefCount> ByteBlockPtrMT;
 }
 
 //!
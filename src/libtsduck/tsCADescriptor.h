@@ -112,5 +112,5 @@ namespace ts {
     //!
     //! Safe pointer to a CADescriptor (thread-safe).
     //!
-    typedef SafePtr<CADescriptor,Mutex> CADescriptorPtr;
+    typedef SafePtr<CADescriptor, AtomicRefCount> CADescriptorPtr;
 }
@@ -47,6 +47,7 @@ ts::CyclingPacketizer::CyclingPacketizer(PID pid, StuffingPolicy stuffing, BitRa
     _section_count(0),
     _sched_sections(),
     _other_sections(),
+    _index(),
     _sched_packets(0),
     _current_cycle(1),
     _remain_in_cycle(0),
@@ -101,16 +102,26 @@ void ts::CyclingPacketizer::addTable(const AbstractTable& table, MilliSecond rep
 
 
 //----------------------------------------------------------------------------
-// Insert a scheduled section in the list, sorted by due_packet, after other
-// sections with the same due_packet.
+// Insert a scheduled section in the schedule, sorted by due_packet, after
+// other sections with the same due_packet.
 //----------------------------------------------------------------------------
 
 void ts::CyclingPacketizer::addScheduledSection(const SectionDescPtr& sect)
 {
-    const PacketCounter due_packet = sect->due_packet;
-    SectionDescList::iterator it;
-    for (it = _sched_sections.begin(); it != _sched_sections.end() && (*it)->due_packet <= due_packet; ++it) {}
-    _sched_sections.insert(it, sect);
+    // A multimap inserts at the upper bound of equivalent keys.
+    sect->scheduled = true;
+    sect->sched_iter = _sched_sections.insert(std::make_pair(sect->due_packet, sect));
+}
+
+
+//----------------------------------------------------------------------------
+// Append an unscheduled section at end of the round-robin list.
+//----------------------------------------------------------------------------
+
+void ts::CyclingPacketizer::addOtherSection(const SectionDescPtr& sect)
+{
+    sect->scheduled = false;
+    sect->other_iter = _other_sections.insert(_other_sections.end(), sect);
 }
 
 
@@ -124,7 +135,7 @@ void ts::CyclingPacketizer::addSection(const SectionPtr& sect, MilliSecond rep_r
 
     if (rep_rate == 0 || _bitrate == 0) {
         // Unschedule section, simply add it at end of queue
-        _other_sections.push_back(desc);
+        addOtherSection(desc);
     }
     else {
         // Scheduled section, its due time is "now"
@@ -133,6 +144,7 @@ void ts::CyclingPacketizer::addSection(const SectionPtr& sect, MilliSecond rep_r
         _sched_packets += sect->packetCount();
     }
 
+    _index.insert(std::make_pair(sect->etid(), desc));
     _section_count++;
     _remain_in_cycle++;
 }
@@ -144,8 +156,10 @@ void ts::CyclingPacketizer::addSection(const SectionPtr& sect, MilliSecond rep_r
 
 void ts::CyclingPacketizer::removeSections(TID tid)
 {
-    removeSections(_sched_sections, tid, 0, false, true);
-    removeSections(_other_sections, tid, 0, false, false);
+    // Short sections and long sections with the same table id are stored
+    // in two distinct ranges of the index.
+    removeSections(_index.lower_bound(ETID(tid)), _index.upper_bound(ETID(tid)));
+    removeSections(_index.lower_bound(ETID(tid, 0x0000)), _index.upper_bound(ETID(tid, 0xFFFF)));
 }
 
 
@@ -155,39 +169,41 @@ void ts::CyclingPacketizer::removeSections(TID tid)
 
 void ts::CyclingPacketizer::removeSections(TID tid, uint16_t tid_ext)
 {
-    removeSections(_sched_sections, tid, tid_ext, true, true);
-    removeSections(_other_sections, tid, tid_ext, true, false);
+    const std::pair<SectionDescIndex::iterator, SectionDescIndex::iterator> range(_index.equal_range(ETID(tid, tid_ext)));
+    removeSections(range.first, range.second);
+
+    // Short sections have no table id extension, they are considered as having a zero one.
+    if (tid_ext == 0) {
+        const std::pair<SectionDescIndex::iterator, SectionDescIndex::iterator> short_range(_index.equal_range(ETID(tid)));
+        removeSections(short_range.first, short_range.second);
+    }
 }
 
 
 //----------------------------------------------------------------------------
-// Remove all sections with the specified tid/tid_ext in the specified list.
+// Remove all sections in a range of the index.
 //----------------------------------------------------------------------------
 
-void ts::CyclingPacketizer::removeSections(SectionDescList& list, TID tid, uint16_t tid_ext, bool use_tid_ext, bool scheduled)
+void ts::CyclingPacketizer::removeSections(SectionDescIndex::iterator first, SectionDescIndex::iterator last)
 {
-    SectionDescList::iterator it(list.begin());
-    while (it != list.end()) {
-        const SectionDescPtr& sp(*it);
-        const Section& sect(*sp->section);
-        if (sect.tableId() == tid && (!use_tid_ext || sect.tableIdExtension() == tid_ext)) {
-            // Section match, remove it
-            assert(_section_count > 0);
-            _section_count--;
-            if (sp->last_cycle != _current_cycle) {
-                assert(_remain_in_cycle > 0);
-                _remain_in_cycle--;
-            }
-            if (scheduled) {
-                assert(_sched_packets >= sect.packetCount());
-                _sched_packets -= sect.packetCount();
-            }
-            it = list.erase(it);
+    for (SectionDescIndex::iterator it = first; it != last; ++it) {
+        const SectionDescPtr& sp(it->second);
+        assert(_section_count > 0);
+        _section_count--;
+        if (sp->last_cycle != _current_cycle) {
+            assert(_remain_in_cycle > 0);
+            _remain_in_cycle--;
+        }
+        if (sp->scheduled) {
+            assert(_sched_packets >= sp->section->packetCount());
+            _sched_packets -= sp->section->packetCount();
+            _sched_sections.erase(sp->sched_iter);
         }
         else {
-            ++it;
+            _other_sections.erase(sp->other_iter);
         }
     }
+    _index.erase(first, last);
 }
 
 
@@ -202,6 +218,7 @@ void ts::CyclingPacketizer::removeAll()
     _sched_packets = 0;
     _sched_sections.clear();
     _other_sections.clear();
+    _index.clear();
 }
 
 
@@ -232,10 +249,10 @@ void ts::CyclingPacketizer::setBitRate(BitRate new_bitrate)
     else if (new_bitrate == 0) {
         // Bitrate now unknown, unable to schedule sections, move them all
         // into the list of unscheduled sections.
-        while (!_sched_sections.empty()) {
-            _other_sections.push_back(_sched_sections.front());
-            _sched_sections.pop_front();
+        for (SectionDescSchedule::iterator it = _sched_sections.begin(); it != _sched_sections.end(); ++it) {
+            addOtherSection(it->second);
         }
+        _sched_sections.clear();
         _sched_packets = 0;
     }
     else if (_bitrate == 0) {
@@ -262,14 +279,13 @@ void ts::CyclingPacketizer::setBitRate(BitRate new_bitrate)
     }
     else {
         // Old and new bitrate not null. Compute new due packet for all
-        // scheduled sections and re-sort list according to new due packet.
-        SectionDescList tmp_list;
-        tmp_list.swap(_sched_sections);
-        while (!tmp_list.empty()) {
-            SectionDesc* sp(tmp_list.back().pointer());
+        // scheduled sections and rebuild the schedule according to new due packet.
+        SectionDescSchedule tmp_sched;
+        tmp_sched.swap(_sched_sections);
+        for (SectionDescSchedule::iterator it = tmp_sched.begin(); it != tmp_sched.end(); ++it) {
+            const SectionDescPtr& sp(it->second);
             sp->due_packet = sp->last_packet + PacketDistance(new_bitrate, sp->repetition);
-            addScheduledSection(tmp_list.back());
-            tmp_list.pop_back();
+            addScheduledSection(sp);
         }
     }
 
@@ -307,10 +323,10 @@ void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& s
          // .. or previous unscheduled section passed in this cycle a long time ago
          spp->last_packet + spp->section->packetCount() + _sched_packets < current_packet);
 
-    if (!force_unscheduled && !_sched_sections.empty() && _sched_sections.front()->due_packet <= current_packet) {
+    if (!force_unscheduled && !_sched_sections.empty() && _sched_sections.begin()->first <= current_packet) {
         // One scheduled section is ready
-        sp = _sched_sections.front();
-        _sched_sections.pop_front();
+        sp = _sched_sections.begin()->second;
+        _sched_sections.erase(_sched_sections.begin());
         // Reschedule the section. Make sure we add at least one packet to
         // ensure that all scheduled sections may pass.
         sp->due_packet = current_packet + std::max(PacketCounter(1), PacketDistance(_bitrate, sp->repetition));
@@ -321,7 +337,7 @@ void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& s
         sp = _other_sections.front();
         _other_sections.pop_front();
         // Move section back at end of queue
-        _other_sections.push_back(sp);
+        addOtherSection(sp);
     }
 
     if (sp.isNull()) {
@@ -404,8 +420,8 @@ std::ostream& ts::CyclingPacketizer::display(std::ostream& strm) const
         << "  Stored sections: " << _section_count << std::endl
         << "  Scheduled sections: " << _sched_sections.size() << std::endl
         << "  Scheduled packets max: " << _sched_packets << std::endl;
-    for (SectionDescList::const_iterator it = _sched_sections.begin(); it != _sched_sections.end(); ++it) {
-        (*it)->display(strm);
+    for (SectionDescSchedule::const_iterator it = _sched_sections.begin(); it != _sched_sections.end(); ++it) {
+        it->second->display(strm);
     }
     strm << "  Unscheduled sections: " << _other_sections.size() << std::endl;
     for (SectionDescList::const_iterator it = _other_sections.begin(); it != _other_sections.end(); ++it) {
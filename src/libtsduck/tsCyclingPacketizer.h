@@ -37,6 +37,7 @@
 #include "tsSectionProviderInterface.h"
 #include "tsBinaryTable.h"
 #include "tsAbstractTable.h"
+#include "tsETID.h"
 
 namespace ts {
     //!
@@ -169,13 +170,16 @@ namespace ts {
         //!
         //! Remove all sections with the specified table id.
         //! If one such section is currently being packetized, the rest of the section will be packetized.
+        //! The cost is logarithmic in the number of stored sections and linear in the number of removed sections.
         //! @param [in] tid The table id of the sections to remove.
         //!
         void removeSections(TID tid);
 
         //!
         //! Remove all sections with the specified table id and table id extension.
+        //! Short sections have no table id extension and are removed when @a tid_ext is zero.
         //! If one such section is currently being packetized, the rest of the section will be packetized.
+        //! The cost is logarithmic in the number of stored sections and linear in the number of removed sections.
         //! @param [in] tid The table id of the sections to remove.
         //! @param [in] tid_ext The table id extension of the sections to remove.
         //!
@@ -210,6 +214,21 @@ namespace ts {
 
     private:
         // Each section is identified by a SectionDesc instance
+        class SectionDesc;
+
+        // Safe pointer for SectionDesc (not thread-safe)
+        typedef SafePtr <SectionDesc, NullMutex> SectionDescPtr;
+
+        // List of unscheduled sections, in round-robin order.
+        typedef std::list <SectionDescPtr> SectionDescList;
+
+        // Scheduled sections, indexed by due packet. Sections with the same
+        // due packet are kept in insertion order.
+        typedef std::multimap <PacketCounter, SectionDescPtr> SectionDescSchedule;
+
+        // Index of all sections by table id / table id extension.
+        typedef std::multimap <ETID, SectionDescPtr> SectionDescIndex;
+
         class SectionDesc
         {
         public:
@@ -219,10 +238,13 @@ namespace ts {
             PacketCounter  last_packet; // Packet index of last time the section was sent
             PacketCounter  due_packet;  // Packet index of next time
             SectionCounter last_cycle;  // Cycle index of last time the section was sent
+            bool           scheduled;   // The section is in _sched_sections (in _other_sections otherwise)
+            SectionDescSchedule::iterator sched_iter; // Position in _sched_sections when scheduled
+            SectionDescList::iterator     other_iter; // Position in _other_sections when unscheduled
 
             // Constructor
             SectionDesc(const SectionPtr& sec, MilliSecond rep) :
-                section(sec), repetition(rep), last_packet(0), due_packet(0), last_cycle(0)
+                section(sec), repetition(rep), last_packet(0), due_packet(0), last_cycle(0), scheduled(false), sched_iter(), other_iter()
             {
             }
 
@@ -230,31 +252,29 @@ namespace ts {
             std::ostream& display(std::ostream&) const;
         };
 
-        // Safe pointer for SectionDesc (not thread-safe)
-        typedef SafePtr <SectionDesc, NullMutex> SectionDescPtr;
-
-        // List of sections
-        typedef std::list <SectionDescPtr> SectionDescList;
-
         // Private members:
-        StuffingPolicy  _stuffing;
-        BitRate         _bitrate;
-        size_t          _section_count;   // Number of sections in the 2 lists
-        SectionDescList _sched_sections;  // Scheduled sections, with repetition rates
-        SectionDescList _other_sections;  // Unscheduled sections
-        PacketCounter   _sched_packets;   // Size in TS packets of all sections in _sched_sections
-        SectionCounter  _current_cycle;   // Cycle number (start at 1, always increasing)
-        size_t          _remain_in_cycle; // Number of unsent sections in this cycle
-        SectionCounter  _cycle_end;       // At end of cycle, contains the index of last section
+        StuffingPolicy      _stuffing;
+        BitRate             _bitrate;
+        size_t              _section_count;   // Number of sections in the 2 lists
+        SectionDescSchedule _sched_sections;  // Scheduled sections, with repetition rates
+        SectionDescList     _other_sections;  // Unscheduled sections
+        SectionDescIndex    _index;           // All sections, by table id / table id extension
+        PacketCounter       _sched_packets;   // Size in TS packets of all sections in _sched_sections
+        SectionCounter      _current_cycle;   // Cycle number (start at 1, always increasing)
+        size_t              _remain_in_cycle; // Number of unsent sections in this cycle
+        SectionCounter      _cycle_end;       // At end of cycle, contains the index of last section
 
         static const SectionCounter UNDEFINED = ~SectionCounter(0);
 
-        // Insert a scheduled section in the list, sorted by due_packet,
+        // Insert a scheduled section in the schedule, sorted by due_packet,
         // after other sections with the same due_packet.
         void addScheduledSection(const SectionDescPtr&);
 
-        // Remove all sections with the specified tid/tid_ext in the specified list.
-        void removeSections(SectionDescList&, TID, uint16_t tid_ext, bool use_tid_ext, bool scheduled);
+        // Append an unscheduled section at end of the round-robin list.
+        void addOtherSection(const SectionDescPtr&);
+
+        // Remove all sections in a range of the index.
+        void removeSections(SectionDescIndex::iterator first, SectionDescIndex::iterator last);
 
         // Inherited from SectionProviderInterface
         virtual void provideSection(SectionCounter, SectionPtr&) override;
@@ -179,6 +179,51 @@ void ts::DVBCharset::Unregister(const DVBCharset* charset)
 }
 
 
+//----------------------------------------------------------------------------
+// Decode a DVB string, starting with an optional character coding table.
+//----------------------------------------------------------------------------
+
+bool ts::DVBCharset::Decode(UString& str, const uint8_t* dvb, size_t dvbSize, const DVBCharset* charset)
+{
+    str.clear();
+
+    // Null or empty buffer is a valid empty string.
+    if (dvb == 0 || dvbSize == 0) {
+        return true;
+    }
+
+    // Get the DVB character set code from the beginning of the string.
+    uint32_t code = 0;
+    size_t codeSize = 0;
+    if (!GetCharCodeTable(code, codeSize, dvb, dvbSize)) {
+        return false;
+    }
+
+    // Skip the character code.
+    assert(codeSize <= dvbSize);
+    dvb += codeSize;
+    dvbSize -= codeSize;
+
+    // Get the character set for this DVB string.
+    if (code != 0 || charset == 0) {
+        charset = GetCharset(code);
+    }
+    if (charset == 0) {
+        // Unsupported charset. Collect all ANSI characters, replace others by '.'.
+        str.assign(dvbSize, FULL_STOP);
+        for (size_t i = 0; i < dvbSize; i++) {
+            if (dvb[i] >= 0x20 && dvb[i] <= 0x7E) {
+                str[i] = UChar(dvb[i]);
+            }
+        }
+        return false;
+    }
+
+    // Convert the DVB string using the character set.
+    return charset->decode(str, dvb, dvbSize);
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor / destructor.
 //----------------------------------------------------------------------------
@@ -84,6 +84,20 @@ namespace ts {
         //!
         static bool GetCharCodeTable(uint32_t& code, size_t& codeSize, const uint8_t* dvb, size_t dvbSize);
 
+        //!
+        //! Decode a DVB string, starting with an optional character coding table.
+        //!
+        //! @param [out] str Returned decoded string.
+        //! @param [in] dvb Address of a DVB string.
+        //! @param [in] dvbSize Size in bytes of the DVB string.
+        //! @param [in] charset If not zero, use this character set if no explicit table
+        //! code is present, instead of the standard default ISO-6937.
+        //! @return True on success, false on error (truncated, unsupported format, etc.)
+        //! On error, @a str contains the characters which could be decoded.
+        //! @see ETSI EN 300 468, Annex A.
+        //!
+        static bool Decode(UString& str, const uint8_t* dvb, size_t dvbSize, const DVBCharset* charset = 0);
+
         //!
         //! Get the character set name.
         //! @return The name.
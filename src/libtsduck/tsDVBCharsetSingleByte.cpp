@@ -32,6 +32,12 @@
 #include "tsUString.h"
 TSDUCK_SOURCE;
 
+// SSE2 is used to expand blocks of ASCII characters when available.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TS_DVB_SSE2 1
+    #include <emmintrin.h>
+#endif
+
 
 //----------------------------------------------------------------------------
 // Protected constructor.
@@ -40,6 +46,7 @@ TSDUCK_SOURCE;
 ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tableCode, std::initializer_list<uint16_t> init) :
     DVBCharset(name, tableCode),
     _upperCodePoints(init),
+    _codePoints(),
     _bytesMap()
 {
     // Check the size of the upper code point table.
@@ -51,16 +58,19 @@ ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tab
     // Code point to byte mapping for ASCII range
     for (size_t i = 0x20; i <= 0x7E; i++) {
         _bytesMap.insert(std::make_pair(UChar(i), uint8_t(i)));
+        _codePoints[i] = uint16_t(i);
     }
 
     // Control codes
     _bytesMap.insert(std::make_pair(LINE_FEED, DVB_SINGLE_BYTE_CRLF));
+    _codePoints[DVB_SINGLE_BYTE_CRLF] = LINE_FEED;
 
     // Code point to byte mapping for 0xA0-0xFF range
     for (size_t i = 0; i < _upperCodePoints.size(); i++) {
         if (_upperCodePoints[i] != 0) {
             _bytesMap.insert(std::make_pair(UChar(_upperCodePoints[i]), uint8_t(0xA0 + i)));
         }
+        _codePoints[0xA0 + i] = _upperCodePoints[i];
     }
 }
 
@@ -71,34 +81,57 @@ ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tab
 
 bool ts::DVBCharsetSingleByte::decode(UString& str, const uint8_t* dvb, size_t dvbSize) const
 {
-    str.clear();
-    str.reserve(dvbSize);
-    bool status = true;
-
-    for (; dvb != 0 && dvbSize > 0; --dvbSize) {
-        // Get next byte
-        const uint8_t b = *dvb++;
-        // Convert it to a code point
-        uint16_t cp = 0;
-        if (b >= 0x20 && b <= 0x7E) {
-            cp = b; // ASCII range = identity
-        }
-        else if (b >= 0xA0) {
-            cp = _upperCodePoints[b - 0xA0];
-        }
-        else if (b == DVB_SINGLE_BYTE_CRLF) {
-            cp = LINE_FEED;
-        }
-        // Add in result if no error.
-        if (cp != 0) {
-            str.push_back(UChar(cp));
+    if (dvb == 0) {
+        dvbSize = 0;
+    }
+
+    // One character per byte at most, decode directly into the string.
+    str.resize(dvbSize);
+    UChar* const first = const_cast<UChar*>(str.data());
+    UChar* out = first;
+    uint16_t valid = 1;
+
+    const uint8_t* const end = dvb + dvbSize;
+
+#if defined(TS_DVB_SSE2)
+    // Blocks of 16 printable ASCII characters (identical in all single-byte
+    // character sets) are directly expanded to UTF-16.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = _mm_set1_epi8(0x1F);
+    const __m128i high = _mm_set1_epi8(0x7F);
+    while (end - dvb >= 16) {
+        // Signed comparisons, bytes 0x80-0xFF are negative and rejected.
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dvb));
+        const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(bytes, low), _mm_cmplt_epi8(bytes, high));
+        if (_mm_movemask_epi8(printable) == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(bytes, zero));
+            out += 16;
+            dvb += 16;
         }
         else {
-            // Untranslatable character.
-            status = false;
+            // At least one non-ASCII byte, use the table for the whole block.
+            for (const uint8_t* const blockEnd = dvb + 16; dvb < blockEnd; ++dvb) {
+                const uint16_t cp = _codePoints[*dvb];
+                *out = UChar(cp);
+                out += cp != 0;
+                valid &= uint16_t(cp != 0);
+            }
         }
     }
-    return status;
+#endif
+
+    // Table-driven conversion, without test on byte values. Untranslatable
+    // bytes (zero code point) are written and immediately overwritten.
+    for (; dvb < end; ++dvb) {
+        const uint16_t cp = _codePoints[*dvb];
+        *out = UChar(cp);
+        out += cp != 0;
+        valid &= uint16_t(cp != 0);
+    }
+
+    str.resize(out - first);
+    return valid != 0;
 }
 
 
@@ -84,6 +84,8 @@ namespace ts {
     private:
         //! List of code points for byte values 0xA0-0xFF. Always contain 96 values.
         const std::vector<uint16_t> _upperCodePoints;
+        //! Code points for all byte values, zero means unused. Used by decode().
+        uint16_t _codePoints[256];
         //! Reverse mapping for complete character set (key = code point, value = byte rep).
         std::map<UChar, uint8_t> _bytesMap;
 
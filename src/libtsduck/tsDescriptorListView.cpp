@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Non-owning view of a list of MPEG PSI/SI descriptors
+//
+//----------------------------------------------------------------------------
+
+#include "tsDescriptorListView.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Iterator constructor at start of list.
+//----------------------------------------------------------------------------
+
+ts::DescriptorListView::const_iterator::const_iterator(const uint8_t* data, const uint8_t* end) :
+    _end(end),
+    _view()
+{
+    next(data);
+}
+
+
+//----------------------------------------------------------------------------
+// Point to the descriptor at the specified address.
+//----------------------------------------------------------------------------
+
+void ts::DescriptorListView::const_iterator::next(const uint8_t* data)
+{
+    if (data == 0 || _end == 0 || data + 2 > _end || data + 2 + data[1] > _end) {
+        // End of list or truncated descriptor.
+        _view = DescriptorView();
+    }
+    else if (data[0] == DID_PRIV_DATA_SPECIF) {
+        // This descriptor defines a new "private data specifier".
+        _view = DescriptorView(data, data[1] < 4 ? 0 : GetUInt32(data + 2));
+    }
+    else {
+        // Use same PDS as previous descriptor.
+        _view = DescriptorView(data, _view.privateDataSpecifier());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Count the number of descriptors in the list.
+//----------------------------------------------------------------------------
+
+size_t ts::DescriptorListView::count() const
+{
+    size_t n = 0;
+    for (const_iterator it = begin(); it != end(); ++it) {
+        ++n;
+    }
+    return n;
+}
+
+
+//----------------------------------------------------------------------------
+// Search a descriptor with the specified tag.
+//----------------------------------------------------------------------------
+
+ts::DescriptorListView::const_iterator ts::DescriptorListView::search(DID tag, const_iterator start, PDS pds) const
+{
+    const bool check_pds = pds != 0 && tag >= 0x80;
+    while (start != end() && (start->tag() != tag || (check_pds && start->privateDataSpecifier() != pds))) {
+        ++start;
+    }
+    return start;
+}
@@ -0,0 +1,245 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Non-owning view of a list of MPEG PSI/SI descriptors
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsDescriptorView.h"
+#include "tsDescriptorList.h"
+
+namespace ts {
+    //!
+    //! Non-owning view of a list of MPEG PSI/SI descriptors.
+    //!
+    //! A DescriptorListView points to a descriptor loop inside a larger memory area,
+    //! typically the payload of a section. Iterating over the list returns
+    //! ts::DescriptorView objects. Nothing is allocated or copied. The application
+    //! must ensure that the viewed memory area remains valid and unmodified while
+    //! the view is used.
+    //!
+    //! This is the preferred way to analyze descriptors when a table is only read,
+    //! not modified. An owning ts::DescriptorList can be built on demand using
+    //! toDescriptorList().
+    //!
+    //! Like in a ts::DescriptorList, the private data specifier of each descriptor
+    //! is the value of the last private_data_specifier_descriptor before it in the list.
+    //! A truncated descriptor terminates the list.
+    //!
+    class TSDUCKDLL DescriptorListView
+    {
+    public:
+        //!
+        //! Forward iterator over the descriptors in the list.
+        //!
+        class TSDUCKDLL const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category; //!< Iterator category.
+            typedef DescriptorView            value_type;        //!< Type of iterated elements.
+            typedef std::ptrdiff_t            difference_type;   //!< Difference between iterators.
+            typedef const DescriptorView*     pointer;           //!< Pointer to iterated elements.
+            typedef const DescriptorView&     reference;         //!< Reference to iterated elements.
+
+            //!
+            //! Default constructor, equal to the end of any list.
+            //!
+            const_iterator() : _end(0), _view() {}
+
+            //!
+            //! Access the current descriptor.
+            //! @return A reference to the view of the current descriptor.
+            //!
+            const DescriptorView& operator*() const { return _view; }
+
+            //!
+            //! Access the current descriptor.
+            //! @return A pointer to the view of the current descriptor.
+            //!
+            const DescriptorView* operator->() const { return &_view; }
+
+            //!
+            //! Move to next descriptor (prefix).
+            //! @return A reference to this object.
+            //!
+            const_iterator& operator++()
+            {
+                next(_view.content() + _view.size());
+                return *this;
+            }
+
+            //!
+            //! Move to next descriptor (postfix).
+            //! @return A copy of this object before moving.
+            //!
+            const_iterator operator++(int)
+            {
+                const_iterator it(*this);
+                ++*this;
+                return it;
+            }
+
+            //!
+            //! Equality operator.
+            //! @param [in] other Another iterator.
+            //! @return True if both iterators point to the same descriptor.
+            //!
+            bool operator==(const const_iterator& other) const { return _view.content() == other._view.content(); }
+
+            //!
+            //! Unequality operator.
+            //! @param [in] other Another iterator.
+            //! @return True if both iterators point to different descriptors.
+            //!
+            bool operator!=(const const_iterator& other) const { return _view.content() != other._view.content(); }
+
+        private:
+            friend class DescriptorListView;
+            const uint8_t* _end;   // End of descriptor list.
+            DescriptorView _view;  // View of current descriptor, invalid at end of list.
+
+            // Constructor at start of list.
+            const_iterator(const uint8_t* data, const uint8_t* end);
+
+            // Point to the descriptor at the specified address.
+            void next(const uint8_t* data);
+        };
+
+        //!
+        //! Default constructor.
+        //! The list is empty.
+        //!
+        DescriptorListView() :
+            _data(0),
+            _size(0)
+        {
+        }
+
+        //!
+        //! Constructor from a binary descriptor loop.
+        //! @param [in] data Address of the binary descriptor loop.
+        //! @param [in] size Size in bytes of the descriptor loop.
+        //!
+        DescriptorListView(const void* data, size_t size) :
+            _data(reinterpret_cast<const uint8_t*>(data)),
+            _size(data == 0 ? 0 : size)
+        {
+        }
+
+        //!
+        //! Get an iterator to the first descriptor.
+        //! @return An iterator to the first descriptor.
+        //!
+        const_iterator begin() const
+        {
+            return const_iterator(_data, _data + _size);
+        }
+
+        //!
+        //! Get an iterator after the last descriptor.
+        //! @return An iterator after the last descriptor.
+        //!
+        const_iterator end() const
+        {
+            return const_iterator();
+        }
+
+        //!
+        //! Check if the list is empty.
+        //! @return True if the list contains no valid descriptor.
+        //!
+        bool empty() const
+        {
+            return begin() == end();
+        }
+
+        //!
+        //! Count the number of descriptors in the list.
+        //! This is not a constant-time operation since the list is walked.
+        //! @return The number of valid descriptors in the list.
+        //!
+        size_t count() const;
+
+        //!
+        //! Access to the binary descriptor loop.
+        //! @return Address of the binary descriptor loop.
+        //!
+        const uint8_t* data() const
+        {
+            return _data;
+        }
+
+        //!
+        //! Size of the binary descriptor loop.
+        //! @return Size in bytes of the binary descriptor loop.
+        //!
+        size_t size() const
+        {
+            return _size;
+        }
+
+        //!
+        //! Search a descriptor with the specified tag.
+        //! @param [in] tag Tag of descriptor to search.
+        //! @param [in] start Iterator where to start the search.
+        //! @param [in] pds Private data specifier for private descriptors (tag >= 0x80).
+        //! If zero, the private data specifier is not checked.
+        //! @return An iterator to the first matching descriptor, starting at @a start,
+        //! or end() if not found.
+        //!
+        const_iterator search(DID tag, const_iterator start, PDS pds = 0) const;
+
+        //!
+        //! Search a descriptor with the specified tag.
+        //! @param [in] tag Tag of descriptor to search.
+        //! @param [in] pds Private data specifier for private descriptors (tag >= 0x80).
+        //! If zero, the private data specifier is not checked.
+        //! @return An iterator to the first matching descriptor or end() if not found.
+        //!
+        const_iterator search(DID tag, PDS pds = 0) const
+        {
+            return search(tag, begin(), pds);
+        }
+
+        //!
+        //! Build an owning list of descriptors from the view.
+        //! @param [in,out] list The descriptors are added at the end of this list.
+        //!
+        void toDescriptorList(DescriptorList& list) const
+        {
+            list.add(_data, _size);
+        }
+
+    private:
+        const uint8_t* _data;  // Address of descriptor loop.
+        size_t         _size;  // Size of descriptor loop.
+    };
+}
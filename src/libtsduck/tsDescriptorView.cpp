@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Non-owning view of an MPEG PSI/SI descriptor
+//
+//----------------------------------------------------------------------------
+
+#include "tsDescriptorView.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Get the extended descriptor id.
+//----------------------------------------------------------------------------
+
+ts::EDID ts::DescriptorView::edid() const
+{
+    if (_data == 0) {
+        return EDID();  // invalid value.
+    }
+    const DID did = tag();
+    if (did >= 0x80) {
+        // Private descriptor.
+        return EDID::Private(did, _pds);
+    }
+    else if (did == DID_EXTENSION && payloadSize() > 0) {
+        // Extension descriptor.
+        return EDID::Extension(payload()[0]);
+    }
+    else {
+        // Standard descriptor.
+        return EDID::Standard(did);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build an owning copy of the viewed descriptor.
+//----------------------------------------------------------------------------
+
+ts::DescriptorPtr ts::DescriptorView::toDescriptor() const
+{
+    return _data == 0 ? DescriptorPtr() : DescriptorPtr(new Descriptor(_data, size()));
+}
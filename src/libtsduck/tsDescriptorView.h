@@ -0,0 +1,151 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Non-owning view of an MPEG PSI/SI descriptor
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsDescriptor.h"
+
+namespace ts {
+    //!
+    //! Non-owning view of an MPEG PSI/SI descriptor.
+    //!
+    //! A DescriptorView points to the binary content of a descriptor inside a larger
+    //! memory area, typically the payload of a section. Nothing is allocated or copied.
+    //! The application must ensure that the viewed memory area remains valid and unmodified
+    //! while the view is used. Use toDescriptor() to build an owning ts::Descriptor.
+    //!
+    class TSDUCKDLL DescriptorView
+    {
+    public:
+        //!
+        //! Default constructor.
+        //! The view is invalid.
+        //!
+        DescriptorView() :
+            _data(0),
+            _pds(0)
+        {
+        }
+
+        //!
+        //! Constructor from the address of a binary descriptor.
+        //! @param [in] data Address of the binary descriptor (tag, length and payload).
+        //! The descriptor length shall have been checked by the caller.
+        //! @param [in] pds Associated private data specifier.
+        //!
+        DescriptorView(const uint8_t* data, PDS pds = 0) :
+            _data(data),
+            _pds(pds)
+        {
+        }
+
+        //!
+        //! Check if the view points to a descriptor.
+        //! @return True if the view points to a descriptor.
+        //!
+        bool isValid() const
+        {
+            return _data != 0;
+        }
+
+        //!
+        //! Get the descriptor tag.
+        //! @return The descriptor tag or zero if the view is invalid.
+        //!
+        DID tag() const
+        {
+            return _data == 0 ? 0 : _data[0];
+        }
+
+        //!
+        //! Get the private data specifier which applies to this descriptor.
+        //! @return The private data specifier in the descriptor list.
+        //!
+        PDS privateDataSpecifier() const
+        {
+            return _pds;
+        }
+
+        //!
+        //! Get the extended descriptor id.
+        //! @return The extended descriptor id, using the private data specifier of the view.
+        //!
+        EDID edid() const;
+
+        //!
+        //! Access to the full binary content of the descriptor.
+        //! @return Address of the full binary content of the descriptor.
+        //!
+        const uint8_t* content() const
+        {
+            return _data;
+        }
+
+        //!
+        //! Size of the binary content of the descriptor.
+        //! @return Size of the full binary content of the descriptor.
+        //!
+        size_t size() const
+        {
+            return _data == 0 ? 0 : size_t(_data[1]) + 2;
+        }
+
+        //!
+        //! Access to the payload of the descriptor.
+        //! @return Address of the payload of the descriptor.
+        //!
+        const uint8_t* payload() const
+        {
+            return _data == 0 ? 0 : _data + 2;
+        }
+
+        //!
+        //! Size of the payload of the descriptor.
+        //! @return Size in bytes of the payload of the descriptor.
+        //!
+        size_t payloadSize() const
+        {
+            return _data == 0 ? 0 : size_t(_data[1]);
+        }
+
+        //!
+        //! Build an owning copy of the viewed descriptor.
+        //! @return A safe pointer to a new descriptor or a null pointer if the view is invalid.
+        //!
+        DescriptorPtr toDescriptor() const;
+
+    private:
+        const uint8_t* _data;  // Address of descriptor tag.
+        PDS            _pds;   // Applicable private data specifier.
+    };
+}
@@ -38,7 +38,7 @@
 #pragma once
 #include "tsECMGClientHandlerInterface.h"
 #include "tstlvConnection.h"
-#include "tsMessageQueue.h"
+#include "tsRingMessageQueue.h"
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
@@ -182,7 +182,7 @@ namespace ts {
         Mutex                   _mutex;          // exclusive access to protected fields
         Condition               _work_to_do;     // notify receiver thread to do some work
         AsyncRequests           _async_requests;
-        MessageQueue <tlv::Message, NullMutex> _response_queue;
+        RingMessageQueue<tlv::Message, NullMutex> _response_queue;
 
         // Receiver thread main code
         virtual void main() override;
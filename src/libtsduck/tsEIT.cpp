@@ -225,6 +225,68 @@ void ts::EIT::deserialize(const BinaryTable& table, const DVBCharset* charset)
 }
 
 
+//----------------------------------------------------------------------------
+// Get non-owning views on the content of an EIT section.
+//----------------------------------------------------------------------------
+
+bool ts::EIT::GetView(const Section& section,
+                      uint16_t& service_id,
+                      uint16_t& ts_id,
+                      uint16_t& onetw_id,
+                      uint8_t& segment_last,
+                      TID& last_table_id,
+                      EventViewVector& events)
+{
+    events.clear();
+    if (!section.isValid() || section.tableId() < TID_EIT_MIN || section.tableId() > TID_EIT_MAX || section.payloadSize() < 6) {
+        return false;
+    }
+
+    service_id = section.tableIdExtension();
+
+    // Analyze the section payload:
+    const uint8_t* data(section.payload());
+    size_t remain(section.payloadSize());
+    ts_id = GetUInt16(data);
+    onetw_id = GetUInt16(data + 2);
+    segment_last = data[4];
+    last_table_id = data[5];
+    data += 6;
+    remain -= 6;
+
+    // Get events description
+    while (remain >= 12) {
+        events.resize(events.size() + 1);
+        EventView& ev(events.back());
+        ev.event_id = GetUInt16(data);
+        DecodeMJD(data + 2, 5, ev.start_time);
+        ev.duration = (DecodeBCD(data[7]) * 3600) + (DecodeBCD(data[8]) * 60) + DecodeBCD(data[9]);
+        ev.running_status = (data[10] >> 5) & 0x07;
+        ev.CA_controlled = (data[10] & 0x10) != 0;
+        const size_t info_length = std::min<size_t>(GetUInt16(data + 10) & 0x0FFF, remain - 12);
+        ev.descs = DescriptorListView(data + 12, info_length);
+        data += 12 + info_length;
+        remain -= 12 + info_length;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Non-owning view of an event description.
+//----------------------------------------------------------------------------
+
+ts::EIT::EventView::EventView() :
+    event_id(0),
+    start_time(),
+    duration(0),
+    running_status(0),
+    CA_controlled(false),
+    descs()
+{
+}
+
+
 //----------------------------------------------------------------------------
 // Serialization
 //----------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsAbstractLongTable.h"
 #include "tsDescriptorList.h"
+#include "tsDescriptorListView.h"
 #include "tsTime.h"
 
 namespace ts {
@@ -76,6 +77,29 @@ namespace ts {
         //!
         typedef EntryWithDescriptorsMap<uint16_t,Event> EventMap;
 
+        //!
+        //! Non-owning view of an event description in an EIT section.
+        //!
+        struct TSDUCKDLL EventView
+        {
+            uint16_t           event_id;        //!< Event id.
+            Time               start_time;      //!< Event start_time.
+            Second             duration;        //!< Event duration in seconds.
+            uint8_t            running_status;  //!< Running status code.
+            bool               CA_controlled;   //!< Controlled by a CA_system.
+            DescriptorListView descs;           //!< View of the descriptor list.
+
+            //!
+            //! Default constructor.
+            //!
+            EventView();
+        };
+
+        //!
+        //! Vector of non-owning views of events.
+        //!
+        typedef std::vector<EventView> EventViewVector;
+
         // EIT public members:
         uint16_t service_id;     //!< Service_id.
         uint16_t ts_id;          //!< Transport stream_id.
@@ -147,6 +171,28 @@ namespace ts {
             return _table_id == TID_EIT_PF_ACT || _table_id == TID_EIT_PF_OTH;
         }
 
+        //!
+        //! Get non-owning views on the content of an EIT section, without deserializing it.
+        //! The views point inside @a section, which must outlive them.
+        //! @param [in] section An EIT section, present/following or schedule, actual or other.
+        //! @param [out] service_id Service id.
+        //! @param [out] ts_id Transport stream id.
+        //! @param [out] onetw_id Original network id.
+        //! @param [out] segment_last Segment last section number.
+        //! @param [out] last_table_id Last table id.
+        //! @param [out] events Views of the events, in section order. The vector is cleared first.
+        //! Its capacity is reused, the application should keep it from one section to another,
+        //! EIT schedules have many sections.
+        //! @return True on success, false if @a section is not a valid EIT section.
+        //!
+        static bool GetView(const Section& section,
+                            uint16_t& service_id,
+                            uint16_t& ts_id,
+                            uint16_t& onetw_id,
+                            uint8_t& segment_last,
+                            TID& last_table_id,
+                            EventViewVector& events);
+
         // Inherited methods
         virtual void serialize(BinaryTable& table, const DVBCharset* = 0) const override;
         virtual void deserialize(const BinaryTable& table, const DVBCharset* = 0) override;
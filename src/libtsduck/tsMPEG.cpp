@@ -44,6 +44,13 @@ const ts::PIDSet ts::NoPID;
 const ts::PIDSet ts::AllPIDs (~NoPID);
 
 
+//----------------------------------------------------------------------------
+// This TID set contains all TID's.
+//----------------------------------------------------------------------------
+
+const ts::TIDSet ts::AllTIDs (~TIDSet());
+
+
 //----------------------------------------------------------------------------
 // Enumeration description of PDS values.
 //----------------------------------------------------------------------------
@@ -789,6 +789,17 @@ namespace ts {
 
     const size_t TID_MAX = 0x100; //!< Maximum number of TID values.
 
+    //!
+    //! A bit mask for TID values.
+    //! Useful to implement TID filtering.
+    //!
+    typedef std::bitset <TID_MAX> TIDSet;
+
+    //!
+    //! TIDSet constant with all TID's set.
+    //!
+    TSDUCKDLL extern const TIDSet AllTIDs;
+
     //---------------------------------------------------------------------
     //! Private data specifier (PDS) values
     //---------------------------------------------------------------------
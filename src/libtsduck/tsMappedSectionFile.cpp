@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Memory-mapped binary section file.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMappedSectionFile.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::MappedSectionFile::MappedSectionFile() :
+    _file(),
+    _offsets(),
+    _end(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Map a binary section file and locate all its sections.
+//----------------------------------------------------------------------------
+
+bool ts::MappedSectionFile::open(const UString& file_name, Report& report)
+{
+    close();
+    if (!_file.open(file_name, report)) {
+        return false;
+    }
+
+    // Locate all sections, using the length field in the section headers only.
+    const uint8_t* const data = _file.data();
+    const size_t size = _file.size();
+    while (_end + 3 <= size) {
+        const size_t next = _end + 3 + (GetUInt16(data + _end + 1) & 0x0FFF);
+        if (next > size) {
+            break;
+        }
+        _offsets.push_back(_end);
+        _end = next;
+    }
+
+    return checkComplete(report);
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the file.
+//----------------------------------------------------------------------------
+
+void ts::MappedSectionFile::close()
+{
+    _file.close();
+    _offsets.clear();
+    _end = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Check that the file ends with a complete section.
+//----------------------------------------------------------------------------
+
+bool ts::MappedSectionFile::checkComplete(Report& report) const
+{
+    const size_t remain = _file.size() - _end;
+    if (remain == 0) {
+        return true;
+    }
+    else {
+        // Same message as Section::read().
+        const size_t expected = remain < 3 ? 3 : 3 + (GetUInt16(_file.data() + _end + 1) & 0x0FFF);
+        report.error(u"truncated section%s, got %d bytes, expected %d", {UString::AfterBytes(std::streampos(_end)), remain, expected});
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build a Section object from a section of the file.
+//----------------------------------------------------------------------------
+
+ts::SectionPtr ts::MappedSectionFile::section(size_t index, CRC32::Validation crc_op) const
+{
+    const SectionPtr sp(new Section(sectionData(index), sectionSize(index), PID_NULL, crc_op));
+    CheckNonNull(sp.pointer());
+    return sp;
+}
+
+
+//----------------------------------------------------------------------------
+// Build the table which starts at a given section of the file.
+//----------------------------------------------------------------------------
+
+bool ts::MappedSectionFile::getTable(size_t& index, BinaryTable& table, CRC32::Validation crc_op) const
+{
+    table.clear();
+    if (index >= _offsets.size()) {
+        return false;
+    }
+
+    // Check the headers of the sections in the mapped file before building any Section object.
+    // A short section is a table on its own. Long sections must be contiguous and in order.
+    const uint8_t* const first = sectionData(index);
+    size_t count = 1;
+    if (sectionSize(index) >= 8 && (first[1] & 0x80) != 0) {
+        // Long section: table_id (1), section_length (2), table_id_extension (2),
+        // version (1), section_number (1), last_section_number (1).
+        count = size_t(first[7]) + 1;
+        bool ok = first[6] == 0 && index + count <= _offsets.size();
+        for (size_t i = 1; ok && i < count; ++i) {
+            const uint8_t* const sec = sectionData(index + i);
+            // Same table_id, long section, table_id_extension, version, last_section_number.
+            ok = sectionSize(index + i) >= 8 &&
+                sec[0] == first[0] &&
+                (sec[1] & 0x80) != 0 &&
+                GetUInt16(sec + 3) == GetUInt16(first + 3) &&
+                (sec[5] & 0x3E) == (first[5] & 0x3E) &&
+                sec[6] == i &&
+                sec[7] == first[7];
+        }
+        if (!ok) {
+            // The section does not start a complete table.
+            index++;
+            return false;
+        }
+    }
+
+    // Build the sections and the table.
+    for (size_t i = 0; i < count; ++i) {
+        const SectionPtr sp(section(index + i, crc_op));
+        if (!sp->isValid() || !table.addSection(sp, false, false)) {
+            table.clear();
+            index++;
+            return false;
+        }
+    }
+    index += count;
+    return table.isValid();
+}
@@ -0,0 +1,191 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Memory-mapped binary section file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMemoryMappedFile.h"
+#include "tsSection.h"
+#include "tsBinaryTable.h"
+#include "tsCerrReport.h"
+
+namespace ts {
+    //!
+    //! Read-only access to a memory-mapped binary section file.
+    //!
+    //! The file is mapped in memory and the boundaries of all sections are located
+    //! in one pass over the section headers. The content of the sections is not
+    //! copied: each section is directly accessed in the mapped file. Section objects
+    //! and tables are built only when requested by the application.
+    //!
+    //! Unlike SectionFile::loadBinary(), the memory which is used by the application
+    //! does not depend on the file size, except for a small index of section offsets.
+    //! The pages of the file are loaded on demand by the operating system and can be
+    //! reclaimed at any time. This is appropriate for large section files, EIT dumps
+    //! for instance.
+    //!
+    //! @see SectionFile for the description of the binary section file format.
+    //!
+    class TSDUCKDLL MappedSectionFile
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        MappedSectionFile();
+
+        //!
+        //! Map a binary section file and locate all its sections.
+        //! If a file was already open, it is first closed.
+        //! @param [in] file_name Name of the binary section file. Only regular files can be mapped.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error. If the file could be mapped but its
+        //! last section is truncated, an error is reported but the file remains open
+        //! and all complete sections are available.
+        //!
+        bool open(const UString& file_name, Report& report = CERR);
+
+        //!
+        //! Unmap the file.
+        //!
+        void close();
+
+        //!
+        //! Check if a file is open.
+        //! @return True if a file is open.
+        //!
+        bool isOpen() const
+        {
+            return _file.isOpen();
+        }
+
+        //!
+        //! Get the name of the file.
+        //! @return The name of the file.
+        //!
+        UString fileName() const
+        {
+            return _file.fileName();
+        }
+
+        //!
+        //! Check that the file ends with a complete section.
+        //! @param [in,out] report Where to report an error if the last section is truncated.
+        //! @return True if the file ends with a complete section.
+        //!
+        bool checkComplete(Report& report = CERR) const;
+
+        //!
+        //! Get the number of complete sections in the file.
+        //! @return The number of complete sections in the file.
+        //!
+        size_t sectionCount() const
+        {
+            return _offsets.size();
+        }
+
+        //!
+        //! Get the address of a section in the mapped file, without copy.
+        //! @param [in] index Index of the section, from 0 to sectionCount() - 1.
+        //! @return The address of the complete section (header and payload).
+        //!
+        const uint8_t* sectionData(size_t index) const
+        {
+            assert(index < _offsets.size());
+            return _file.data() + _offsets[index];
+        }
+
+        //!
+        //! Get the size of a section in the mapped file.
+        //! @param [in] index Index of the section, from 0 to sectionCount() - 1.
+        //! @return The size in bytes of the complete section (header and payload).
+        //!
+        size_t sectionSize(size_t index) const
+        {
+            return 3 + (GetUInt16(sectionData(index) + 1) & 0x0FFF);
+        }
+
+        //!
+        //! Get the offset of a section in the file.
+        //! @param [in] index Index of the section, from 0 to sectionCount() - 1.
+        //! @return The offset in bytes of the section in the file.
+        //!
+        size_t sectionOffset(size_t index) const
+        {
+            assert(index < _offsets.size());
+            return _offsets[index];
+        }
+
+        //!
+        //! Build a Section object from a section of the file.
+        //! The content of the section is copied into the Section object.
+        //! @param [in] index Index of the section, from 0 to sectionCount() - 1.
+        //! @param [in] crc_op How to process the CRC32 of the section.
+        //! @return A safe pointer to the section. The section is marked as invalid
+        //! when its content is invalid.
+        //!
+        SectionPtr section(size_t index, CRC32::Validation crc_op = CRC32::IGNORE) const;
+
+        //!
+        //! Build the table which starts at a given section of the file.
+        //!
+        //! As in SectionFile, a short section is a table on its own and the sections of
+        //! a long table must be contiguous, in the order of their section number.
+        //! Typically, all tables are iterated as follows:
+        //! @code
+        //! for (size_t index = 0; index < file.sectionCount(); ) {
+        //!     ts::BinaryTable table;
+        //!     if (file.getTable(index, table)) {
+        //!         ... use table ...
+        //!     }
+        //! }
+        //! @endcode
+        //!
+        //! @param [in,out] index Index of the first section of the table. On return,
+        //! index of the section after the table or after the orphan section.
+        //! @param [out] table Returned table.
+        //! @param [in] crc_op How to process the CRC32 of the sections.
+        //! @return True if a valid table was built. False if the section at @a index
+        //! does not start a complete table (orphan section).
+        //!
+        bool getTable(size_t& index, BinaryTable& table, CRC32::Validation crc_op = CRC32::IGNORE) const;
+
+    private:
+        MemoryMappedFile    _file;     // Memory-mapped file.
+        std::vector<size_t> _offsets;  // Offsets of all complete sections in the file.
+        size_t              _end;      // Offset after the last complete section.
+
+        // Inaccessible operations.
+        MappedSectionFile(const MappedSectionFile&) = delete;
+        MappedSectionFile& operator=(const MappedSectionFile&) = delete;
+    };
+}
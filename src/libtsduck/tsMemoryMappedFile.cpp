@@ -0,0 +1,178 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Read-only memory mapping of a complete file.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryMappedFile.h"
+#include "tsSysUtils.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryMappedFile::MemoryMappedFile() :
+    _filename(),
+    _is_open(false),
+    _data(0),
+#if defined(TS_WINDOWS)
+    _size(0),
+    _file(INVALID_HANDLE_VALUE),
+    _mapping(0)
+#else
+    _size(0)
+#endif
+{
+}
+
+ts::MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Map a file in memory.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::open(const UString& fileName, Report& report)
+{
+    close();
+
+#if defined(TS_WINDOWS)
+
+    _file = ::CreateFileW(fileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (_file == INVALID_HANDLE_VALUE) {
+        report.error(u"cannot open %s: %s", {fileName, ErrorCodeMessage()});
+        return false;
+    }
+    // Pipes and devices cannot be mapped.
+    if (::GetFileType(_file) != FILE_TYPE_DISK) {
+        report.error(u"%s is not a regular file, cannot be mapped", {fileName});
+        ::CloseHandle(_file);
+        _file = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    ::LARGE_INTEGER size;
+    if (::GetFileSizeEx(_file, &size) == 0) {
+        report.error(u"cannot get size of %s: %s", {fileName, ErrorCodeMessage()});
+        ::CloseHandle(_file);
+        _file = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    _size = size_t(size.QuadPart);
+    // An empty file cannot be mapped.
+    if (_size > 0) {
+        _mapping = ::CreateFileMappingW(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (_mapping == 0 || (_data = reinterpret_cast<const uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0))) == 0) {
+            report.error(u"cannot map %s: %s", {fileName, ErrorCodeMessage()});
+            if (_mapping != 0) {
+                ::CloseHandle(_mapping);
+                _mapping = 0;
+            }
+            ::CloseHandle(_file);
+            _file = INVALID_HANDLE_VALUE;
+            _size = 0;
+            return false;
+        }
+    }
+
+#else
+
+    const int fd = ::open(fileName.toUTF8().c_str(), O_RDONLY);
+    if (fd < 0) {
+        report.error(u"cannot open %s: %s", {fileName, ErrorCodeMessage()});
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        report.error(u"cannot get size of %s: %s", {fileName, ErrorCodeMessage()});
+        ::close(fd);
+        return false;
+    }
+    // Pipes and devices cannot be mapped.
+    if (!S_ISREG(st.st_mode)) {
+        report.error(u"%s is not a regular file, cannot be mapped", {fileName});
+        ::close(fd);
+        return false;
+    }
+    _size = size_t(st.st_size);
+    // An empty file cannot be mapped.
+    if (_size > 0) {
+        void* addr = ::mmap(0, _size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            report.error(u"cannot map %s: %s", {fileName, ErrorCodeMessage()});
+            ::close(fd);
+            _size = 0;
+            return false;
+        }
+        _data = reinterpret_cast<const uint8_t*>(addr);
+    }
+    // The mapping remains valid after closing the file descriptor.
+    ::close(fd);
+
+#endif
+
+    _filename = fileName;
+    _is_open = true;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the file.
+//----------------------------------------------------------------------------
+
+void ts::MemoryMappedFile::close()
+{
+#if defined(TS_WINDOWS)
+    if (_data != 0) {
+        ::UnmapViewOfFile(_data);
+    }
+    if (_mapping != 0) {
+        ::CloseHandle(_mapping);
+        _mapping = 0;
+    }
+    if (_file != INVALID_HANDLE_VALUE) {
+        ::CloseHandle(_file);
+        _file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (_data != 0) {
+        ::munmap(const_cast<uint8_t*>(_data), _size);
+    }
+#endif
+    _filename.clear();
+    _is_open = false;
+    _data = 0;
+    _size = 0;
+}
@@ -0,0 +1,125 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only memory mapping of a complete file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+#include "tsNullReport.h"
+
+namespace ts {
+    //!
+    //! Read-only memory mapping of a complete file.
+    //!
+    //! The content of the file is directly accessed in memory, without copy.
+    //! Pages are loaded on demand by the operating system and are shared
+    //! between all processes which map the same file.
+    //!
+    class TSDUCKDLL MemoryMappedFile
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        MemoryMappedFile();
+
+        //!
+        //! Destructor, unmap the file.
+        //!
+        ~MemoryMappedFile();
+
+        //!
+        //! Map a file in memory.
+        //! If a file was already mapped, it is first unmapped. Only regular files
+        //! can be mapped, pipes and devices are rejected.
+        //! @param [in] fileName Name of the file to map.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& fileName, Report& report = NULLREP);
+
+        //!
+        //! Unmap the file.
+        //!
+        void close();
+
+        //!
+        //! Check if a file is mapped.
+        //! @return True if a file is mapped.
+        //!
+        bool isOpen() const
+        {
+            return _is_open;
+        }
+
+        //!
+        //! Get the name of the mapped file.
+        //! @return The name of the mapped file.
+        //!
+        UString fileName() const
+        {
+            return _filename;
+        }
+
+        //!
+        //! Get the address of the file content in memory.
+        //! @return The address of the file content in memory or a null pointer if no file is mapped or the file is empty.
+        //!
+        const uint8_t* data() const
+        {
+            return _data;
+        }
+
+        //!
+        //! Get the size of the mapped file.
+        //! @return The size in bytes of the mapped file.
+        //!
+        size_t size() const
+        {
+            return _size;
+        }
+
+    private:
+        UString        _filename;  // File name.
+        bool           _is_open;   // A file is mapped.
+        const uint8_t* _data;      // Base address of the mapping.
+        size_t         _size;      // File size.
+#if defined(TS_WINDOWS)
+        ::HANDLE       _file;      // File handle.
+        ::HANDLE       _mapping;   // File mapping object.
+#endif
+
+        // Inaccessible operations.
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    };
+}
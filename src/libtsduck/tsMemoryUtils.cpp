@@ -70,6 +70,43 @@ const void* ts::LocatePattern (const void* area, size_t area_size, const void* p
     return 0; // not found
 }
 
+//----------------------------------------------------------------------------
+// Locate a 3-byte sequence 00 00 XY into a memory area.
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::LocateZeroZero(const void* area, size_t area_size, uint8_t third_min, uint8_t third_max)
+{
+    if (area_size < 3) {
+        return 0;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(area);
+    const uint8_t* const end = p + area_size;
+    const uint8_t* const last = end - 2;  // last possible address of the sequence + 1
+
+    while (p < last) {
+        // Skip 64-bit words without zero byte: a sequence cannot start there.
+        // The expression is the classical "has zero byte" test, independent of endianness.
+        while (end - p >= 8) {
+            uint64_t word;
+            ::memcpy(&word, p, 8);
+            if (((word - TS_UCONST64(0x0101010101010101)) & ~word & TS_UCONST64(0x8080808080808080)) != 0) {
+                break;
+            }
+            p += 8;
+        }
+        // Check the next word byte per byte.
+        const uint8_t* const stop = last - p > 8 ? p + 8 : last;
+        for (; p < stop; ++p) {
+            if (p[0] == 0x00 && p[1] == 0x00 && p[2] >= third_min && p[2] <= third_max) {
+                return p;
+            }
+        }
+    }
+    return 0; // not found
+}
+
+
 //----------------------------------------------------------------------------
 // Check if a memory area contains all identical byte values.
 //----------------------------------------------------------------------------
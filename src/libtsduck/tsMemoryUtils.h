@@ -77,6 +77,19 @@ namespace ts {
     //!
     TSDUCKDLL const void* LocatePattern(const void* area, size_t area_size, const void* pattern, size_t pattern_size);
 
+    //!
+    //! Locate a 3-byte sequence 00 00 XY into a memory area, where XY is in a range of values.
+    //! This is typically used to locate start codes (00 00 01) or the end of NAL units
+    //! (00 00 00 or 00 00 01) in video streams. The memory area is checked by 64-bit words
+    //! to quickly skip areas without zero byte.
+    //! @param [in] area Address of a memory area to check.
+    //! @param [in] area_size Size in bytes of the memory area.
+    //! @param [in] third_min Minimum value of the third byte of the sequence.
+    //! @param [in] third_max Maximum value of the third byte of the sequence.
+    //! @return Address of the first occurence of the sequence in @a area or zero if not found.
+    //!
+    TSDUCKDLL const uint8_t* LocateZeroZero(const void* area, size_t area_size, uint8_t third_min, uint8_t third_max);
+
     //!
     //! Check if a memory area contains all identical byte values.
     //! @param [in] area Address of a memory area to check.
@@ -191,6 +191,66 @@ void ts::Monotonic::wait()
 }
 
 
+//----------------------------------------------------------------------------
+// Wait until the time of the monotonic clock with high precision.
+//----------------------------------------------------------------------------
+
+ts::NanoSecond ts::Monotonic::preciseWait(const NanoSecond& spin)
+{
+    const NanoSecond spin_duration = spin < 0 ? SleepLatency() : spin;
+
+    // Coarse sleep until the start of the spin phase.
+    Monotonic now;
+    now.getSystemTime();
+    if (*this - now > spin_duration) {
+        Monotonic coarse(*this);
+        coarse -= spin_duration;
+        coarse.wait();
+    }
+
+    // Spin on the clock until the due time.
+    do {
+        now.getSystemTime();
+    } while (now < *this);
+
+    return now - *this;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the calibrated wake-up latency of the system timers.
+//----------------------------------------------------------------------------
+
+namespace {
+    ts::NanoSecond CalibrateSleepLatency()
+    {
+        // Sleep a few times for a short duration and keep the worst wake-up delay.
+        const ts::NanoSecond sleep_duration = 100000; // 100 microseconds
+        const ts::NanoSecond min_latency = 10000;     // 10 microseconds
+        const ts::NanoSecond max_latency = 4000000;   // 4 milliseconds
+        ts::NanoSecond latency = min_latency;
+        ts::Monotonic due;
+        ts::Monotonic now;
+        for (int i = 0; i < 10; ++i) {
+            due.getSystemTime();
+            due += sleep_duration;
+            due.wait();
+            now.getSystemTime();
+            latency = std::max(latency, now - due);
+        }
+        // Keep a safety margin of 25%.
+        return std::min(max_latency, latency + latency / 4);
+    }
+}
+
+ts::NanoSecond ts::Monotonic::SleepLatency()
+{
+    // Thread-safe initialization of local static data in C++11.
+    static const NanoSecond latency = CalibrateSleepLatency();
+    return latency;
+}
+
+
 //----------------------------------------------------------------------------
 // This static method requests a minimum resolution, in nano-seconds, for the
 // timers. Return the guaranteed value (can be equal to or greater than the
@@ -174,6 +174,34 @@ namespace ts {
         //!
         void wait();
 
+        //!
+        //! Wait until the time of the monotonic clock with high precision.
+        //!
+        //! The system timers have a limited precision and the wake-up of a sleeping
+        //! thread is usually late by some tens of microseconds or more. This method
+        //! is a hybrid wait: the calling thread sleeps until shortly before the due
+        //! time and then actively spins on the monotonic clock until the due time.
+        //! The spin phase consumes CPU but this method can be used to pace packets
+        //! with a much lower jitter than wait().
+        //!
+        //! @param [in] spin Duration of the spin phase in nano-seconds, before the
+        //! due time. When negative, use the calibrated wake-up latency of the system
+        //! (see SleepLatency()). When zero, this is equivalent to wait().
+        //! @return The lateness of the wake-up in nano-seconds, ie. the difference
+        //! between the actual wake-up time and the due time. This is zero or positive.
+        //!
+        NanoSecond preciseWait(const NanoSecond& spin = -1);
+
+        //!
+        //! Get the calibrated wake-up latency of the system timers.
+        //!
+        //! The latency is measured once, on first call, as the worst delay between
+        //! the requested and actual wake-up time of a few short sleeps. This is the
+        //! default spin duration of preciseWait().
+        //! @return The wake-up latency of the system timers in nano-seconds.
+        //!
+        static NanoSecond SleepLatency();
+
         //!
         //! This static method requests a minimum resolution, in nano-seconds, for the timers.
         //! @param [in] precision Requested minimum resolution in nano-seconds.
@@ -79,6 +79,20 @@ ts::NIT& ts::NIT::operator=(const NIT& other)
 }
 
 
+//----------------------------------------------------------------------------
+// Get non-owning views on the content of a NIT section.
+//----------------------------------------------------------------------------
+
+bool ts::NIT::GetView(const Section& section, uint16_t& network_id, DescriptorListView& descs, TransportViewVector& transports)
+{
+    if (section.tableId() != TID_NIT_ACT && section.tableId() != TID_NIT_OTH) {
+        transports.clear();
+        return false;
+    }
+    return GetTransportView(section, network_id, descs, transports);
+}
+
+
 //----------------------------------------------------------------------------
 // A static method to display a NIT section.
 //----------------------------------------------------------------------------
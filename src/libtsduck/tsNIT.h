@@ -92,6 +92,17 @@ namespace ts {
             _table_id = uint8_t(is_actual ? TID_NIT_ACT : TID_NIT_OTH);
         }
 
+        //!
+        //! Get non-owning views on the content of a NIT section, without deserializing it.
+        //! The views point inside @a section, which must outlive them.
+        //! @param [in] section A NIT Actual or Other section.
+        //! @param [out] network_id Network identifier.
+        //! @param [out] descs View of the top-level descriptor list.
+        //! @param [out] transports Views of the transport streams, in section order. The vector is cleared first.
+        //! @return True on success, false if @a section is not a valid NIT section.
+        //!
+        static bool GetView(const Section& section, uint16_t& network_id, DescriptorListView& descs, TransportViewVector& transports);
+
         // Inherited methods
         virtual void buildXML(xml::Element*) const override;
         virtual void fromXML(const xml::Element*) override;
@@ -32,8 +32,28 @@
 #include "tsSysUtils.h"
 #include "tsFatal.h"
 #include "tsCerrReport.h"
+#include "tsByteBlock.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 
+const ts::UChar* const ts::Names::IMAGE_SUFFIX = u".bin";
+
+// Binary image layout. All integers are big endian, all offsets are from the
+// beginning of the image. Sections are followed by all entries, sorted by first
+// value inside each section, and by all names, in UTF-8, without separator.
+//   - Header: magic (8 bytes), format version (uint32), number of sections (uint32).
+//   - Section: name offset, name size, bits, entries offset, entries count, reserved (6 x uint32).
+//   - Entry: first value, last value (2 x uint64), name offset, name size (2 x uint32).
+// All structures are multiple of 8 bytes, keeping 64-bit values aligned in the mapped image.
+
+namespace {
+    const char   IMAGE_MAGIC[8] = {'T', 'S', 'N', 'A', 'M', 'E', 'S', '\0'};
+    const size_t IMAGE_VERSION = 1;
+    const size_t IMAGE_HEADER_SIZE = 16;
+    const size_t IMAGE_SECTION_SIZE = 24;
+    const size_t IMAGE_ENTRY_SIZE = 24;
+}
+
 
 //----------------------------------------------------------------------------
 // Configuration instances.
@@ -317,8 +337,21 @@ ts::Names::Names(const UString& fileName) :
     _configFile(SearchConfigurationFile(fileName)),
     _configLines(0),
     _configErrors(0),
-    _sections()
-{
+    _sections(),
+    _image()
+{
+    // Use the binary image of the configuration file when it is not older than the text file.
+    const UString imageFile(SearchConfigurationFile(fileName + IMAGE_SUFFIX));
+    if (!imageFile.empty() &&
+        (_configFile.empty() || GetFileModificationTimeUTC(imageFile) >= GetFileModificationTimeUTC(_configFile)) &&
+        loadImage(imageFile))
+    {
+        if (_configFile.empty()) {
+            _configFile = imageFile;
+        }
+        return;
+    }
+
     // Locate the configuration file.
     if (_configFile.empty()) {
         // Cannot load configuration, names will not be available.
@@ -377,6 +410,140 @@ ts::Names::Names(const UString& fileName) :
 }
 
 
+//----------------------------------------------------------------------------
+// Map a binary image. Return true on success, false on error.
+//----------------------------------------------------------------------------
+
+bool ts::Names::loadImage(const UString& fileName)
+{
+    if (!_image.open(fileName, _log)) {
+        return false;
+    }
+
+    const uint8_t* const data = _image.data();
+    const size_t size = _image.size();
+    const size_t count = size < IMAGE_HEADER_SIZE ? 0 : GetUInt32(data + 12);
+    bool valid = size >= IMAGE_HEADER_SIZE &&
+        ::memcmp(data, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) == 0 &&
+        GetUInt32(data + 8) == IMAGE_VERSION &&
+        count <= (size - IMAGE_HEADER_SIZE) / IMAGE_SECTION_SIZE;
+
+    // Build the map of sections. The entries remain in the image.
+    for (size_t i = 0; valid && i < count; ++i) {
+        const uint8_t* const sec = data + IMAGE_HEADER_SIZE + i * IMAGE_SECTION_SIZE;
+        const size_t name_offset = GetUInt32(sec);
+        const size_t name_size = GetUInt32(sec + 4);
+        const size_t entries_offset = GetUInt32(sec + 12);
+        const size_t entries_count = GetUInt32(sec + 16);
+        valid = name_offset <= size && name_size <= size - name_offset &&
+            entries_offset <= size && entries_count <= (size - entries_offset) / IMAGE_ENTRY_SIZE;
+        if (valid) {
+            ConfigSection* section = new ConfigSection;
+            CheckNonNull(section);
+            section->bits = GetUInt32(sec + 8);
+            section->image = &_image;
+            section->imageEntries = data + entries_offset;
+            section->imageCount = entries_count;
+            _sections.insert(std::make_pair(UString::FromUTF8(reinterpret_cast<const char*>(data + name_offset), name_size), section));
+        }
+    }
+
+    if (!valid) {
+        _log.error(u"%s: invalid names image", {fileName});
+        for (ConfigSectionMap::iterator it = _sections.begin(); it != _sections.end(); ++it) {
+            delete it->second;
+        }
+        _sections.clear();
+        _image.close();
+    }
+    return valid;
+}
+
+
+//----------------------------------------------------------------------------
+// Save the content of the repository as a binary image.
+//----------------------------------------------------------------------------
+
+bool ts::Names::saveImage(const UString& fileName, Report& report) const
+{
+    // Collect all entries per section, regardless of the origin of the names.
+    typedef std::vector<std::pair<Value, const ConfigEntry*>> EntryVector;
+    std::vector<EntryVector> allEntries;
+    std::list<ConfigEntry> imageEntries;
+    size_t entryCount = 0;
+
+    for (ConfigSectionMap::const_iterator it = _sections.begin(); it != _sections.end(); ++it) {
+        const ConfigSection* section = it->second;
+        allEntries.push_back(EntryVector());
+        EntryVector& vec(allEntries.back());
+        if (section->image == 0) {
+            for (ConfigEntryMap::const_iterator eit = section->entries.begin(); eit != section->entries.end(); ++eit) {
+                vec.push_back(std::make_pair(eit->first, eit->second));
+            }
+        }
+        else {
+            for (size_t i = 0; i < section->imageCount; ++i) {
+                const uint8_t* const ent = section->imageEntries + i * IMAGE_ENTRY_SIZE;
+                imageEntries.push_back(ConfigEntry(GetUInt64(ent + 8), section->getName(GetUInt64(ent))));
+                vec.push_back(std::make_pair(GetUInt64(ent), &imageEntries.back()));
+            }
+        }
+        entryCount += vec.size();
+    }
+
+    // Build the image: header, sections, entries, names.
+    const size_t sectionsOffset = IMAGE_HEADER_SIZE;
+    size_t entriesOffset = sectionsOffset + _sections.size() * IMAGE_SECTION_SIZE;
+    const size_t stringsOffset = entriesOffset + entryCount * IMAGE_ENTRY_SIZE;
+
+    ByteBlock image;
+    ByteBlock strings;
+    image.append(IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    image.appendUInt32(uint32_t(IMAGE_VERSION));
+    image.appendUInt32(uint32_t(_sections.size()));
+
+    size_t index = 0;
+    for (ConfigSectionMap::const_iterator it = _sections.begin(); it != _sections.end(); ++it, ++index) {
+        const size_t nameOffset = stringsOffset + strings.size();
+        strings.appendUTF8(it->first);
+        image.appendUInt32(uint32_t(nameOffset));
+        image.appendUInt32(uint32_t(stringsOffset + strings.size() - nameOffset));
+        image.appendUInt32(uint32_t(it->second->bits));
+        image.appendUInt32(uint32_t(entriesOffset));
+        image.appendUInt32(uint32_t(allEntries[index].size()));
+        image.appendUInt32(0);
+        entriesOffset += allEntries[index].size() * IMAGE_ENTRY_SIZE;
+    }
+    for (std::vector<EntryVector>::const_iterator vit = allEntries.begin(); vit != allEntries.end(); ++vit) {
+        for (EntryVector::const_iterator eit = vit->begin(); eit != vit->end(); ++eit) {
+            const size_t nameOffset = stringsOffset + strings.size();
+            strings.appendUTF8(eit->second->name);
+            image.appendUInt64(eit->first);
+            image.appendUInt64(eit->second->last);
+            image.appendUInt32(uint32_t(nameOffset));
+            image.appendUInt32(uint32_t(stringsOffset + strings.size() - nameOffset));
+        }
+    }
+    assert(image.size() == stringsOffset);
+    image.append(strings);
+
+    // Write the image file.
+    std::ofstream strm(fileName.toUTF8().c_str(), std::ios::out | std::ios::binary);
+    if (!strm) {
+        report.error(u"error creating %s", {fileName});
+        return false;
+    }
+    strm.write(reinterpret_cast<const char*>(image.data()), std::streamsize(image.size()));
+    strm.close();
+    if (!strm) {
+        report.error(u"error writing %s", {fileName});
+        return false;
+    }
+    report.verbose(u"%s: %d sections, %d names, %'d bytes", {fileName, _sections.size(), entryCount, image.size()});
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Decode a line as "first[-last] = name". Return true on success.
 //----------------------------------------------------------------------------
@@ -460,7 +627,10 @@ ts::Names::ConfigEntry::ConfigEntry(Value l, const UString& n) :
 
 ts::Names::ConfigSection::ConfigSection() :
     bits(0),
-    entries()
+    entries(),
+    image(0),
+    imageEntries(0),
+    imageCount(0)
 {
 }
 
@@ -518,6 +688,31 @@ void ts::Names::ConfigSection::addEntry(Value first, Value last, const UString&
 
 ts::UString ts::Names::ConfigSection::getName(Value val) const
 {
+    if (image != 0) {
+        // Binary search of the last entry in the image with a first value not greater than 'val'.
+        size_t low = 0;
+        size_t high = imageCount;
+        while (low < high) {
+            const size_t mid = low + (high - low) / 2;
+            if (GetUInt64(imageEntries + mid * IMAGE_ENTRY_SIZE) <= val) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+        if (low == 0) {
+            return UString();
+        }
+        const uint8_t* const ent = imageEntries + (low - 1) * IMAGE_ENTRY_SIZE;
+        const size_t offset = GetUInt32(ent + 16);
+        const size_t size = GetUInt32(ent + 20);
+        if (val > GetUInt64(ent + 8) || offset > image->size() || size > image->size() - offset) {
+            return UString();
+        }
+        return UString::FromUTF8(reinterpret_cast<const char*>(image->data() + offset), size);
+    }
+
     // Eliminate trivial cases which would cause issues with code below.
     if (entries.empty()) {
         return UString();
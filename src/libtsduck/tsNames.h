@@ -37,6 +37,7 @@
 #include "tsCASFamily.h"
 #include "tsReport.h"
 #include "tsStaticInstance.h"
+#include "tsMemoryMappedFile.h"
 
 namespace ts {
     //!
@@ -348,6 +349,13 @@ namespace ts {
     //! A repository of names for MPEG/DVB entities.
     //! All names are loaded from configuration files @em tsduck.*.names.
     //!
+    //! Each configuration file can be compiled into a binary image (see saveImage()),
+    //! with the same name and an additional suffix ".bin". When such an image is found
+    //! and is not older than the text configuration file, it is memory-mapped instead
+    //! of parsing the text file. All lookups are then binary searches in the mapped
+    //! image, without loading anything. A text file which is more recent than the
+    //! image (typically a user-supplied configuration file) is always parsed.
+    //!
     class TSDUCKDLL Names
     {
     public:
@@ -357,6 +365,11 @@ namespace ts {
         //!
         Names(const UString& fileName);
 
+        //!
+        //! File name suffix of binary images of configuration files.
+        //!
+        static const UChar* const IMAGE_SUFFIX;
+
         //!
         //! Virtual destructor.
         //!
@@ -376,6 +389,24 @@ namespace ts {
             return _configFile;
         }
 
+        //!
+        //! Get the complete path of the binary image which is mapped in memory.
+        //! @return The complete path of the binary image. Empty if the names were loaded from the text configuration file.
+        //!
+        UString imageFile() const
+        {
+            return _image.fileName();
+        }
+
+        //!
+        //! Save the content of the repository as a binary image.
+        //! The image can be mapped in memory by subsequent instances of Names.
+        //! @param [in] fileName Name of the binary image file to create.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool saveImage(const UString& fileName, Report& report) const;
+
         //!
         //! Get the number of errors in the configuration file.
         //! @return The number of errors in the configuration file.
@@ -444,11 +475,15 @@ namespace ts {
 
         // Description of a configuration section.
         // The name of the section is the key in a map.
+        // When loaded from a binary image, the entries remain in the image.
         class ConfigSection
         {
         public:
-            size_t          bits;     // Number of significant bits in values of the type.
-            ConfigEntryMap  entries;  // All entries, indexed by names.
+            size_t                  bits;          // Number of significant bits in values of the type.
+            ConfigEntryMap          entries;       // All entries, indexed by names.
+            const MemoryMappedFile* image;         // Binary image, null when loaded from the text file.
+            const uint8_t*          imageEntries;  // Array of entries in the binary image, sorted by first value.
+            size_t                  imageCount;    // Number of entries in imageEntries.
 
             ConfigSection();
             ~ConfigSection();
@@ -466,6 +501,9 @@ namespace ts {
         // Map of configuration sections, indexed by name.
         typedef std::map<UString, ConfigSection*> ConfigSectionMap;
 
+        // Map a binary image. Return true on success, false on error.
+        bool loadImage(const UString& fileName);
+
         // Decode a line as "first[-last] = name". Return true on success, false on error.
         bool decodeDefinition(const UString& line, ConfigSection* section);
 
@@ -477,10 +515,11 @@ namespace ts {
 
         // Names private fields.
         Report&          _log;           // Error logger.
-        const UString    _configFile;    // Configuration file path.
+        UString          _configFile;    // Configuration file path.
         size_t           _configLines;   // Number of lines in configuration file.
         size_t           _configErrors;  // Number of errors in configuration file.
         ConfigSectionMap _sections;      // Configuration sections.
+        MemoryMappedFile _image;         // Binary image of the configuration file, when available.
 
         // Inaccessible operations.
         Names() = delete;
@@ -42,7 +42,7 @@ namespace ts {
     //!
     //! Safe pointer for Object (thread-safe).
     //!
-    typedef SafePtr<Object, Mutex> ObjectPtr;
+    typedef SafePtr<Object, AtomicRefCount> ObjectPtr;
 
     //!
     //! Abstract base class for objects which can be stored in a repository.
@@ -33,8 +33,16 @@
 
 #include "tsPCRAnalyzer.h"
 #include "tsMemoryUtils.h"
+#include "tsPCR.h"
 TSDUCK_SOURCE;
 
+namespace {
+    // When the PCR rate between two PCR's in a PID differs from the previous one by more
+    // than this factor, a new segment of the regression starts. This is typically a PCR
+    // jump without discontinuity indicator, at the loop of a file.
+    const double MAX_REGRESSION_RATIO = 4.0;
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -52,7 +60,9 @@ ts::PCRAnalyzer::PCRAnalyzer(size_t min_pid, size_t min_pcr) :
     _ts_bitrate_204(0),
     _ts_bitrate_cnt(0),
     _completed_pids(0),
-    _pcr_pids(0)
+    _pcr_pids(0),
+    _lsq_var(0.0),
+    _lsq_cov(0.0)
 {
     TS_ZERO(_pid);
 }
@@ -79,7 +89,13 @@ ts::PCRAnalyzer::PIDAnalysis::PIDAnalysis() :
     last_pcr_packet(0),
     ts_bitrate_188(0),
     ts_bitrate_204(0),
-    ts_bitrate_cnt(0)
+    ts_bitrate_cnt(0),
+    lsq_count(0),
+    lsq_first_packet(0),
+    lsq_first_pcr(0),
+    lsq_mean_packet(0.0),
+    lsq_mean_pcr(0.0),
+    lsq_last_rate(0.0)
 {
 }
 
@@ -135,6 +151,8 @@ void ts::PCRAnalyzer::reset()
     _ts_bitrate_cnt = 0;
     _completed_pids = 0;
     _pcr_pids = 0;
+    _lsq_var = 0.0;
+    _lsq_cov = 0.0;
 
     for (size_t i = 0; i < PID_MAX; ++i) {
         if (_pid[i] != 0) {
@@ -193,6 +211,28 @@ ts::BitRate ts::PCRAnalyzer::bitrate204() const
 }
 
 
+//----------------------------------------------------------------------------
+// Return the evaluated TS bitrate in bits/second from the least-squares
+// regression (based on 188-byte or 204-byte packets).
+//----------------------------------------------------------------------------
+
+ts::BitRate ts::PCRAnalyzer::regressionBitrate(size_t packet_size) const
+{
+    // The slope of the regression is _lsq_cov / _lsq_var PCR units per packet.
+    return _lsq_cov <= 0.0 ? 0 : BitRate(0.5 + (_lsq_var * double(SYSTEM_CLOCK_FREQ * packet_size * 8)) / _lsq_cov);
+}
+
+ts::BitRate ts::PCRAnalyzer::regressionBitrate188() const
+{
+    return regressionBitrate(PKT_SIZE);
+}
+
+ts::BitRate ts::PCRAnalyzer::regressionBitrate204() const
+{
+    return regressionBitrate(PKT_RS_SIZE);
+}
+
+
 //----------------------------------------------------------------------------
 // Return the evaluated PID bitrate in bits/second
 // (based on 188-byte or 204-byte packets).
@@ -242,20 +282,50 @@ void ts::PCRAnalyzer::getStatus(Status& stat) const
 //----------------------------------------------------------------------------
 
 bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
+{
+    processPacket(pkt);
+    return _bitrate_valid;
+}
+
+
+//----------------------------------------------------------------------------
+// Feed the PCR analyzer with a contiguous set of transport packets.
+//----------------------------------------------------------------------------
+
+bool ts::PCRAnalyzer::feedPackets(const TSPacket* pkt, size_t count)
+{
+    for (const TSPacket* const end = pkt + count; pkt < end; ++pkt) {
+        processPacket(*pkt);
+    }
+    return _bitrate_valid;
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze one TS packet.
+//----------------------------------------------------------------------------
+
+inline void ts::PCRAnalyzer::processPacket(const TSPacket& pkt)
 {
     // Count one more packet in the TS
     _ts_pkt_cnt++;
 
     // Reject invalid packets, suspected TS corruption
-    if (!pkt.hasValidSync()) {
+    const uint8_t* const b = pkt.b;
+    if (b[0] != SYNC_BYTE) {
         processDiscountinuity();
-        return _bitrate_valid;
+        return;
     }
 
-    // Find PID context
-    const PID pid = pkt.getPID();
-    assert(pid < PID_MAX);
+    // All header fields are directly read from the packet: b[3] contains the
+    // adaptation field control and the continuity counter. When present, the
+    // size of the adaptation field is in b[4] and its flags are in b[5].
+    const PID pid = GetUInt16(b + 1) & 0x1FFF;
+    const uint8_t continuity_cnt = b[3] & 0x0F;
+    const bool has_payload = (b[3] & 0x10) != 0;
+    const uint8_t af_flags = (b[3] & 0x20) != 0 && b[4] > 0 ? b[5] : 0;
 
+    // Find PID context
     PIDAnalysis* ps = _pid[pid];
     if (ps == 0) {
         ps = _pid[pid] = new PIDAnalysis;
@@ -267,24 +337,23 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
     // Process discontinuities. If a discontinuity is discovered,
     // the PCR calculation across this packet is not valid.
     bool broken_rate = false;
-    uint8_t continuity_cnt = pkt.getCC();
 
     if (ps->ts_pkt_cnt == 1) {
         // First packet on this PID, initialize continuity
         ps->cur_continuity = continuity_cnt;
     }
-    else if (pkt.getDiscontinuityIndicator()) {
+    else if ((af_flags & 0x80) != 0) {
         // Expected discontinuity
         broken_rate = true;
     }
-    else if (pkt.hasPayload()) {
+    else if (has_payload) {
         // Packet has payload. Compute next continuity counter.
         uint8_t next_cont((ps->cur_continuity + 1) & 0x0F);
         // The countinuity counter must be either identical to previous one
         // (duplicated packet) or adjacent.
         broken_rate = continuity_cnt != ps->cur_continuity && continuity_cnt != next_cont;
     }
-    else if (continuity_cnt != ps->cur_continuity) {
+    else {
         // Packet has no payload -> should have same counter
         broken_rate = continuity_cnt != ps->cur_continuity;
     }
@@ -296,10 +365,10 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
     }
 
     // Process PCR (or DTS)
-    if ((_use_dts && pkt.hasDTS()) || (!_use_dts && pkt.hasPCR())) {
+    if ((_use_dts && pkt.hasDTS()) || (!_use_dts && (af_flags & 0x10) != 0)) {
 
         // Get PCR value (or converted DTS)
-        const uint64_t pcr = _use_dts ? pkt.getDTS() * SYSTEM_CLOCK_SUBFACTOR : pkt.getPCR();
+        const uint64_t pcr = _use_dts ? pkt.getDTS() * SYSTEM_CLOCK_SUBFACTOR : (b[4] >= 7 ? GetPCR(b + 6) : 0);
 
         // If last PCR valid, compute transport rate between the two
         if (ps->last_pcr_value != 0 && ps->last_pcr_value < pcr) {
@@ -333,10 +402,37 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             }
         }
 
+        // PCR units per packet since the previous PCR, zero after a discontinuity.
+        const double rate = ps->last_pcr_value == 0 || ps->last_pcr_value >= pcr ? 0.0 :
+            double(pcr - ps->last_pcr_value) / double(_ts_pkt_cnt - ps->last_pcr_packet);
+
+        // Start a new segment of the regression on this PID after a discontinuity.
+        if (rate <= 0.0 || (ps->lsq_last_rate > 0.0 && (rate > ps->lsq_last_rate * MAX_REGRESSION_RATIO || rate * MAX_REGRESSION_RATIO < ps->lsq_last_rate))) {
+            ps->lsq_count = 0;
+            ps->lsq_first_packet = _ts_pkt_cnt;
+            ps->lsq_first_pcr = pcr;
+            ps->lsq_mean_packet = 0.0;
+            ps->lsq_mean_pcr = 0.0;
+            ps->lsq_last_rate = 0.0;
+        }
+        else {
+            ps->lsq_last_rate = rate;
+        }
+
+        // Add the PCR to the least-squares regression. The means and the sums of deviations
+        // are updated incrementally (Welford's method). The sums of all segments of all PID's
+        // are accumulated together, giving the common slope of all segments.
+        const double x = double(_ts_pkt_cnt - ps->lsq_first_packet);
+        const double y = double(pcr - ps->lsq_first_pcr);
+        const double dx = x - ps->lsq_mean_packet;
+        ps->lsq_count++;
+        ps->lsq_mean_packet += dx / double(ps->lsq_count);
+        ps->lsq_mean_pcr += (y - ps->lsq_mean_pcr) / double(ps->lsq_count);
+        _lsq_var += dx * (x - ps->lsq_mean_packet);
+        _lsq_cov += dx * (y - ps->lsq_mean_pcr);
+
         // Save PCR for next calculation
         ps->last_pcr_value = pcr;
         ps->last_pcr_packet = _ts_pkt_cnt;
     }
-
-    return _bitrate_valid;
 }
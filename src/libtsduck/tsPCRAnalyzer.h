@@ -93,6 +93,16 @@ namespace ts {
         //!
         bool feedPacket(const TSPacket& pkt);
 
+        //!
+        //! The following method feeds the analyzer with a contiguous set of TS packets.
+        //! This is faster than calling feedPacket() for each packet. All packets are
+        //! analyzed, even when the bitrate becomes valid in the middle of the set.
+        //! @param [in] pkt Address of the first TS packet.
+        //! @param [in] count Number of TS packets.
+        //! @return True if we have collected enough packet to evaluate TS bitrate.
+        //!
+        bool feedPackets(const TSPacket* pkt, size_t count);
+
         //!
         //! Check if we have collected enough packet to evaluate TS bitrate.
         //! @return True if we have collected enough packet to evaluate TS bitrate.
@@ -111,6 +121,29 @@ namespace ts {
         //!
         BitRate bitrate204() const;
 
+        //!
+        //! Get the evaluated TS bitrate in bits/second based on 188-byte packets,
+        //! using a least-squares regression of the PCR values on the packet indexes.
+        //!
+        //! The regression is updated at each PCR with a constant cost. It is more accurate
+        //! than bitrate188() which averages the bitrates between consecutive PCR's and
+        //! is consequently sensitive to the PCR jitter. All PID's with PCR's contribute to
+        //! the same regression. After a discontinuity or a PCR jump, a new segment of the
+        //! regression starts with the same slope but a distinct origin.
+        //! @return The evaluated TS bitrate in bits/second based on 188-byte packets
+        //! or zero if there are not enough PCR's.
+        //!
+        BitRate regressionBitrate188() const;
+
+        //!
+        //! Get the evaluated TS bitrate in bits/second based on 204-byte packets,
+        //! using a least-squares regression of the PCR values on the packet indexes.
+        //! @return The evaluated TS bitrate in bits/second based on 204-byte packets
+        //! or zero if there are not enough PCR's.
+        //! @see regressionBitrate188()
+        //!
+        BitRate regressionBitrate204() const;
+
         //!
         //! Get the evaluated PID bitrate in bits/second based on 188-byte packets.
         //! @param [in] pid The PID to evaluate.
@@ -171,6 +204,12 @@ namespace ts {
         // Process a discontinuity in the transport stream
         void processDiscountinuity();
 
+        // Analyze one TS packet.
+        void processPacket(const TSPacket& pkt);
+
+        // Compute a bitrate from the least-squares regression.
+        BitRate regressionBitrate(size_t packet_size) const;
+
         // Analysis of one PID
         struct PIDAnalysis
         {
@@ -184,6 +223,12 @@ namespace ts {
             uint64_t ts_bitrate_188;   // Sum of all computed TS bitrates (188-byte)
             uint64_t ts_bitrate_204;   // Sum of all computed TS bitrates (204-byte)
             uint64_t ts_bitrate_cnt;   // Count of computed TS bitrates
+            uint64_t lsq_count;        // Number of PCR's in current regression segment
+            uint64_t lsq_first_packet; // Packet index of first PCR in current regression segment
+            uint64_t lsq_first_pcr;    // First PCR value in current regression segment
+            double   lsq_mean_packet;  // Mean packet index in current segment, relative to first one
+            double   lsq_mean_pcr;     // Mean PCR value in current segment, relative to first one
+            double   lsq_last_rate;    // PCR units per packet between the last two PCR's in current segment
         };
 
         // Private members:
@@ -197,6 +242,8 @@ namespace ts {
         uint64_t _ts_bitrate_cnt;     // Count of computed bitrates
         size_t   _completed_pids;     // Number of PIDs with enough PCRs
         size_t   _pcr_pids;           // Number of PIDs with PCRs
+        double   _lsq_var;            // Sum of squared deviations of packet indexes, in all segments
+        double   _lsq_cov;            // Sum of products of deviations of packet indexes and PCR's
         PIDAnalysis* _pid[PID_MAX];   // Per-PID stats
     };
 }
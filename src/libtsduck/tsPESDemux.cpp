@@ -36,20 +36,6 @@
 TSDUCK_SOURCE;
 
 
-//----------------------------------------------------------------------------
-// Delimiters
-//----------------------------------------------------------------------------
-
-namespace {
-
-    // Start code prefix for ISO 11172-2 (MPEG-1 video) and ISO 13818-2 (MPEG-2 video)
-    const uint8_t StartCodePrefix[] = {0x00, 0x00, 0x01};
-
-    // End of AVC NALunit delimiter
-    const uint8_t Zero3[] = {0x00, 0x00, 0x00};
-}
-
-
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
@@ -330,8 +316,8 @@ void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
             // The beginning of the payload is already a start code prefix.
             for (size_t offset = 0; offset < psize; ) {
                 // Look for next start code
-                const void* pnext = LocatePattern (pdata + offset + 1, psize - offset - 1, StartCodePrefix, sizeof(StartCodePrefix));
-                size_t next = pnext == 0 ? psize : reinterpret_cast <const uint8_t*> (pnext) - pdata;
+                const uint8_t* pnext = LocateZeroZero(pdata + offset + 1, psize - offset - 1, 0x01, 0x01);
+                size_t next = pnext == 0 ? psize : pnext - pdata;
                 // Invoke handler
                 if (_pes_handler != 0) {
                     _pes_handler->handleVideoStartCode (*this, pp, pdata[offset+3], offset, next - offset);
@@ -350,28 +336,16 @@ void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
         else if (pp.isAVC()) {
             for (size_t offset = 0; offset < psize; ) {
                 // Locate next access unit: starts with 00 00 01 (this start code is not part of the NALunit)
-                const uint8_t* p1 = reinterpret_cast<const uint8_t*>(
-                            LocatePattern(pdata + offset, psize - offset, StartCodePrefix, sizeof(StartCodePrefix)));
+                const uint8_t* p1 = LocateZeroZero(pdata + offset, psize - offset, 0x01, 0x01);
                 if (p1 == 0) {
                     break;
                 }
-                offset = p1 - pdata + sizeof(StartCodePrefix);
-
-                // Locate end of access unit: ends with 00 00 00, 00 00 01 or end of
-                const uint8_t* p2 = reinterpret_cast<const uint8_t*>(
-                            LocatePattern(pdata + offset, psize - offset, StartCodePrefix, sizeof(StartCodePrefix)));
-                const uint8_t* p3 = reinterpret_cast<const uint8_t*>(
-                            LocatePattern(pdata + offset, psize - offset, Zero3, sizeof(Zero3)));
-                size_t nalunit_size;
-                if (p2 == 0 && p3 == 0) {
-                    nalunit_size = psize - offset;
-                }
-                else if (p2 == 0 || p3 < p2) {
-                    nalunit_size = p3 - pdata - offset;
-                }
-                else {
-                    nalunit_size = p2 - pdata - offset;
-                }
+                offset = p1 - pdata + 3;
+
+                // Locate end of access unit: ends with 00 00 00, 00 00 01 or end of payload.
+                // Both delimiters are searched in one single pass.
+                const uint8_t* p2 = LocateZeroZero(pdata + offset, psize - offset, 0x00, 0x01);
+                const size_t nalunit_size = p2 == 0 ? psize - offset : p2 - pdata - offset;
 
                 // Compute NALunit type.
                 const uint8_t nalunit_type = nalunit_size == 0 ? 0 : (pdata[offset] & 0x1F);
@@ -160,6 +160,45 @@ void ts::PMT::deserialize(const BinaryTable& table, const DVBCharset* charset)
 }
 
 
+//----------------------------------------------------------------------------
+// Get non-owning views on the content of a PMT section.
+//----------------------------------------------------------------------------
+
+bool ts::PMT::GetView(const Section& section, uint16_t& service_id, PID& pcr_pid, DescriptorListView& descs, StreamViewVector& streams)
+{
+    streams.clear();
+    if (!section.isValid() || section.tableId() != TID_PMT || section.payloadSize() < 4) {
+        return false;
+    }
+
+    service_id = section.tableIdExtension();
+
+    // Analyze the section payload:
+    const uint8_t* data(section.payload());
+    size_t remain(section.payloadSize());
+
+    // Get PCR PID and program information descriptor list
+    pcr_pid = GetUInt16(data) & 0x1FFF;
+    size_t info_length = std::min<size_t>(GetUInt16(data + 2) & 0x0FFF, remain - 4);
+    descs = DescriptorListView(data + 4, info_length);
+    data += 4 + info_length;
+    remain -= 4 + info_length;
+
+    // Get elementary streams description
+    while (remain >= 5) {
+        streams.resize(streams.size() + 1);
+        StreamView& str(streams.back());
+        str.stream_type = data[0];
+        str.pid = GetUInt16(data + 1) & 0x1FFF;
+        info_length = std::min<size_t>(GetUInt16(data + 3) & 0x0FFF, remain - 5);
+        str.descs = DescriptorListView(data + 5, info_length);
+        data += 5 + info_length;
+        remain -= 5 + info_length;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Serialization
 //----------------------------------------------------------------------------
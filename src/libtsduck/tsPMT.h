@@ -35,6 +35,7 @@
 #pragma once
 #include "tsAbstractLongTable.h"
 #include "tsDescriptorList.h"
+#include "tsDescriptorListView.h"
 
 namespace ts {
     //!
@@ -106,6 +107,42 @@ namespace ts {
         //!
         typedef EntryWithDescriptorsMap<PID, Stream> StreamMap;
 
+        //!
+        //! Non-owning view of an elementary stream description in a PMT section.
+        //!
+        struct TSDUCKDLL StreamView
+        {
+            uint8_t            stream_type;  //!< Stream type, one of ST_* (eg ts::ST_MPEG2_VIDEO).
+            PID                pid;          //!< Elementary stream PID.
+            DescriptorListView descs;        //!< View of the descriptor list.
+
+            //!
+            //! Default constructor.
+            //!
+            StreamView() : stream_type(0), pid(PID_NULL), descs() {}
+        };
+
+        //!
+        //! Vector of non-owning views of elementary streams.
+        //!
+        typedef std::vector<StreamView> StreamViewVector;
+
+        //!
+        //! Get non-owning views on the content of a PMT section, without deserializing it.
+        //! No descriptor is allocated. The views point inside the section, which must remain
+        //! valid and unmodified while the views are used. Use DescriptorListView::toDescriptorList()
+        //! to build owning descriptor lists on demand.
+        //! @param [in] section A PMT section.
+        //! @param [out] service_id Service id aka "program_number".
+        //! @param [out] pcr_pid PID for PCR data.
+        //! @param [out] descs View of the program-level descriptor list.
+        //! @param [out] streams Views of the elementary streams, in section order. The vector
+        //! is cleared first. Its capacity is reused, the application should keep it from one
+        //! PMT to another to avoid reallocations.
+        //! @return True on success, false if @a section is not a valid PMT section.
+        //!
+        static bool GetView(const Section& section, uint16_t& service_id, PID& pcr_pid, DescriptorListView& descs, StreamViewVector& streams);
+
         // PMT public members:
         uint16_t       service_id;  //!< Service id aka "program_number".
         PID            pcr_pid;     //!< PID for PCR data.
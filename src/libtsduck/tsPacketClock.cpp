@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Low-overhead clock for per-packet time queries.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketClock.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::PacketClock::PacketClock(bool coarse) :
+    _coarse(coarse),
+    _utc(),
+    _local_offset(0),
+    _offset_end()
+{
+    update();
+}
+
+
+//----------------------------------------------------------------------------
+// Refresh the clock from the system time.
+//----------------------------------------------------------------------------
+
+void ts::PacketClock::update()
+{
+    _utc = _coarse ? Time::CurrentCoarseUTC() : Time::CurrentUTC();
+
+    // Daylight saving time changes occur on minute boundaries, recompute
+    // the local time offset at the beginning of each minute (or when the
+    // system time was moved backward).
+    if (_utc >= _offset_end || _utc < _offset_end - MilliSecPerMin) {
+        _local_offset = _utc.UTCToLocal() - _utc;
+        const Time hour(_utc.thisHour());
+        _offset_end = hour + ((_utc - hour) / MilliSecPerMin + 1) * MilliSecPerMin;
+    }
+}
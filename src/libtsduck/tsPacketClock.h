@@ -0,0 +1,108 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Low-overhead clock for per-packet time queries.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTime.h"
+
+namespace ts {
+    //!
+    //! Low-overhead clock for per-packet time queries.
+    //!
+    //! Reading the system time and converting it into local time for each TS packet
+    //! is expensive. A PacketClock keeps a snapshot of the system time which is
+    //! explicitly refreshed by the application at chosen points, typically once per
+    //! group of packets. All time queries between two updates return the same time.
+    //!
+    //! The offset between UTC and local time is computed once per minute only.
+    //!
+    class TSDUCKDLL PacketClock
+    {
+    public:
+        //!
+        //! Constructor.
+        //! The clock is initialized with the current time.
+        //! @param [in] coarse If true, use a faster clock with a coarse precision
+        //! (a few milliseconds) when the operating system provides one.
+        //! See Time::CurrentCoarseUTC().
+        //!
+        explicit PacketClock(bool coarse = true);
+
+        //!
+        //! Refresh the clock from the system time.
+        //!
+        void update();
+
+        //!
+        //! Get the UTC time at the last update.
+        //! @return A constant reference to the UTC time at the last update.
+        //!
+        const Time& utc() const
+        {
+            return _utc;
+        }
+
+        //!
+        //! Get the local time at the last update.
+        //! @return The local time at the last update.
+        //!
+        Time localTime() const
+        {
+            return _utc + _local_offset;
+        }
+
+        //!
+        //! Check if the clock uses a coarse precision.
+        //! @return True if the clock uses a coarse precision.
+        //!
+        bool isCoarse() const
+        {
+            return _coarse;
+        }
+
+        //!
+        //! Set the precision of the clock.
+        //! @param [in] coarse If true, use a faster clock with a coarse precision.
+        //!
+        void setCoarse(bool coarse)
+        {
+            _coarse = coarse;
+        }
+
+    private:
+        bool        _coarse;        // Use coarse system clock.
+        Time        _utc;           // UTC time at last update.
+        MilliSecond _local_offset;  // Local time minus UTC.
+        Time        _offset_end;    // End of validity of _local_offset (next minute).
+    };
+}
@@ -0,0 +1,279 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Precise pacing of TS packets, based on PCR's or bitrate
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketPacer.h"
+TSDUCK_SOURCE;
+
+// Maximum interval between two PCR's. Above this, this is considered as a discontinuity.
+#define MAX_PCR_INTERVAL NanoSecPerSec
+
+// Default maximum lateness. Above this, the schedule is shifted instead of bursting to catch up.
+#define DEFAULT_MAX_LATENESS NanoSecPerSec
+
+// Maximum number of packets since origin of a bitrate-driven schedule (avoid overflows).
+#define MAX_ORIGIN_PACKETS 100000
+
+
+//----------------------------------------------------------------------------
+// Statistics.
+//----------------------------------------------------------------------------
+
+ts::PacketPacer::Statistics::Statistics() :
+    bursts(0),
+    late_bursts(0),
+    min_late(0),
+    max_late(0),
+    total_late(0),
+    resyncs(0)
+{
+}
+
+void ts::PacketPacer::Statistics::reset()
+{
+    bursts = late_bursts = resyncs = 0;
+    min_late = max_late = total_late = 0;
+}
+
+ts::UString ts::PacketPacer::Statistics::toString() const
+{
+    return UString::Format(u"%'d bursts, %'d late, lateness min: %'d ns, max: %'d ns, mean: %'d ns, %'d resyncs",
+                           {bursts, late_bursts, min_late, max_late, meanLate(), resyncs});
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::PacketPacer::PacketPacer(NanoSecond spin) :
+    _spin(spin),
+    _max_late(DEFAULT_MAX_LATENESS),
+    _bitrate(0),
+    _use_pcr(false),
+    _pcr_pid(PID_NULL),
+    _started(false),
+    _due(),
+    _origin(),
+    _origin_pkt(0),
+    _pkt_count(0),
+    _has_pcr(false),
+    _last_pcr(0),
+    _last_pcr_pkt(0),
+    _last_pcr_due(),
+    _pcr_ns(0),
+    _pcr_pkts(0),
+    _stats()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the schedule.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::reset()
+{
+    _started = false;
+    _origin_pkt = 0;
+    _pkt_count = 0;
+    _has_pcr = false;
+    _last_pcr = 0;
+    _last_pcr_pkt = 0;
+    _pcr_ns = 0;
+    _pcr_pkts = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Enable or disable PCR-driven pacing.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::usePCR(bool on, PID pid)
+{
+    _use_pcr = on;
+    _pcr_pid = pid;
+    _has_pcr = false;
+    _pcr_ns = 0;
+    _pcr_pkts = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Set / get the bitrate.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::setBitrate(BitRate bitrate)
+{
+    if (bitrate != _bitrate) {
+        // Restart the bitrate-driven schedule from the last due time.
+        if (_started) {
+            _origin = _due;
+            _origin_pkt = _pkt_count - 1;
+            _stats.resyncs++;
+        }
+        _bitrate = bitrate;
+    }
+}
+
+ts::BitRate ts::PacketPacer::bitrate() const
+{
+    if (_use_pcr && _pcr_ns > 0) {
+        return BitRate((_pcr_pkts * PKT_SIZE * 8 * NanoSecPerSec) / _pcr_ns);
+    }
+    else {
+        return _bitrate;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Time offset of a packet from the origin of the schedule.
+//----------------------------------------------------------------------------
+
+ts::NanoSecond ts::PacketPacer::offset(PacketCounter count) const
+{
+    if (_use_pcr && _pcr_ns > 0) {
+        // Bitrate measured between the last two PCR's.
+        return NanoSecond((count * _pcr_ns) / _pcr_pkts);
+    }
+    else if (_bitrate > 0) {
+        // User-specified bitrate.
+        return NanoSecond((count * PKT_SIZE * 8 * NanoSecPerSec) / _bitrate);
+    }
+    else {
+        // Unknown bitrate, no pacing.
+        return 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Account for the next packet in the stream and compute its due time.
+//----------------------------------------------------------------------------
+
+const ts::Monotonic& ts::PacketPacer::feedPacket(const TSPacket& pkt)
+{
+    // Index of this packet since reset.
+    const PacketCounter index = _pkt_count++;
+
+    if (!_started) {
+        // First packet, due immediately.
+        _started = true;
+        _due.getSystemTime();
+        _origin = _due;
+        _origin_pkt = index;
+    }
+    else if (_bitrate == 0 && (!_use_pcr || _pcr_ns == 0)) {
+        // No known bitrate, no pacing, the packet is due now.
+        _due.getSystemTime();
+        _origin = _due;
+        _origin_pkt = index;
+    }
+    else {
+        // Evenly spaced from the origin of the schedule.
+        _due = _origin;
+        _due += offset(index - _origin_pkt);
+        // Move the origin from time to time to avoid overflows.
+        if (index - _origin_pkt >= MAX_ORIGIN_PACKETS) {
+            _origin = _due;
+            _origin_pkt = index;
+        }
+    }
+
+    // Process PCR's on the reference PID.
+    if (_use_pcr && pkt.hasPCR() && (_pcr_pid == PID_NULL || pkt.getPID() == _pcr_pid)) {
+        _pcr_pid = pkt.getPID();
+        const uint64_t pcr = pkt.getPCR();
+        if (_has_pcr) {
+            // PCR values wrap up at 2**33 * 300.
+            const uint64_t pcr_wrap = PTS_DTS_SCALE * SYSTEM_CLOCK_SUBFACTOR;
+            const uint64_t delta = pcr >= _last_pcr ? pcr - _last_pcr : pcr + pcr_wrap - _last_pcr;
+            const NanoSecond delta_ns = NanoSecond((delta * 1000) / (SYSTEM_CLOCK_FREQ / 1000000));
+            const PacketCounter delta_pkts = index - _last_pcr_pkt;
+            if (!pkt.getDiscontinuityIndicator() && delta_ns > 0 && delta_ns < MAX_PCR_INTERVAL && delta_pkts > 0) {
+                // Due time of a PCR packet is directly derived from the PCR value, relatively to the previous one.
+                _due = _last_pcr_due;
+                _due += delta_ns;
+                _pcr_ns = delta_ns;
+                _pcr_pkts = delta_pkts;
+            }
+            else {
+                // PCR discontinuity, keep the bitrate-driven due time.
+                _stats.resyncs++;
+            }
+        }
+        // A packet with PCR becomes the origin of the schedule.
+        _origin = _due;
+        _origin_pkt = index;
+        _has_pcr = true;
+        _last_pcr = pcr;
+        _last_pcr_pkt = index;
+        _last_pcr_due = _due;
+    }
+
+    return _due;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until the due time of the last packet.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::wait()
+{
+    Monotonic now;
+    now.getSystemTime();
+
+    NanoSecond late = 0;
+    if (now >= _due) {
+        // Already late, do not wait.
+        late = now - _due;
+        _stats.late_bursts++;
+        if (late > _max_late) {
+            // Far too late (input starvation for instance), shift the schedule instead of bursting.
+            _origin += late;
+            _last_pcr_due += late;
+            _due = now;
+            _stats.resyncs++;
+        }
+    }
+    else {
+        late = _due.preciseWait(_spin);
+    }
+
+    // Collect statistics.
+    _stats.min_late = _stats.bursts == 0 ? late : std::min(_stats.min_late, late);
+    _stats.max_late = std::max(_stats.max_late, late);
+    _stats.total_late += late;
+    _stats.bursts++;
+}
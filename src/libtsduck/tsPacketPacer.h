@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Precise pacing of TS packets, based on PCR's or bitrate
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMonotonic.h"
+#include "tsTSPacket.h"
+#include "tsMPEG.h"
+#include "tsUString.h"
+
+namespace ts {
+    //!
+    //! Precise pacing of TS packets, based on PCR's or bitrate.
+    //!
+    //! A PacketPacer computes the due time of each packet of a transport stream.
+    //! When PCR-driven pacing is enabled, the due time of the packets which carry
+    //! a PCR on the reference PID is directly derived from the PCR value and the
+    //! packets between two PCR's are evenly spaced at the bitrate which is measured
+    //! between the two last PCR's. Otherwise, or before the first PCR, the packets
+    //! are evenly spaced at the bitrate which is set by the application.
+    //!
+    //! The application waits for the due time of a packet using wait(), typically
+    //! once per burst of packets, using a hybrid sleep/spin wait (see Monotonic::preciseWait()).
+    //! Statistics on the wake-up lateness are collected per burst.
+    //!
+    class TSDUCKDLL PacketPacer
+    {
+    public:
+        //!
+        //! Pacing statistics, one sample per burst (ie. per call to wait()).
+        //!
+        struct TSDUCKDLL Statistics
+        {
+            PacketCounter bursts;      //!< Number of bursts (calls to wait()).
+            PacketCounter late_bursts; //!< Number of bursts which were due before wait() was called.
+            NanoSecond    min_late;    //!< Minimum wake-up lateness in nano-seconds.
+            NanoSecond    max_late;    //!< Maximum wake-up lateness in nano-seconds.
+            NanoSecond    total_late;  //!< Accumulated wake-up lateness in nano-seconds.
+            PacketCounter resyncs;     //!< Number of schedule resynchronizations (PCR discontinuities, bitrate changes).
+
+            //!
+            //! Default constructor.
+            //!
+            Statistics();
+
+            //!
+            //! Reset the statistics.
+            //!
+            void reset();
+
+            //!
+            //! Get the average wake-up lateness.
+            //! @return The average wake-up lateness in nano-seconds.
+            //!
+            NanoSecond meanLate() const {return bursts == 0 ? 0 : total_late / NanoSecond(bursts);}
+
+            //!
+            //! Format the statistics as a one-line string.
+            //! @return A human-readable string.
+            //!
+            UString toString() const;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] spin Duration of the spin phase in nano-seconds, before the due time
+        //! of a packet. When negative, use the calibrated wake-up latency of the system.
+        //!
+        explicit PacketPacer(NanoSecond spin = -1);
+
+        //!
+        //! Reset the schedule. The next packet is due immediately.
+        //! The statistics are not reset.
+        //!
+        void reset();
+
+        //!
+        //! Set the bitrate which is used to space the packets.
+        //! In PCR-driven pacing, this bitrate is only used until two PCR's are found.
+        //! @param [in] bitrate Bitrate in bits/second. Zero means unknown.
+        //!
+        void setBitrate(BitRate bitrate);
+
+        //!
+        //! Get the current bitrate which is used to space the packets.
+        //! @return The current bitrate in bits/second or zero if unknown.
+        //!
+        BitRate bitrate() const;
+
+        //!
+        //! Enable or disable PCR-driven pacing.
+        //! @param [in] on True to enable PCR-driven pacing.
+        //! @param [in] pid Reference PID for PCR's. When PID_NULL, the first PID carrying PCR's is used.
+        //!
+        void usePCR(bool on, PID pid = PID_NULL);
+
+        //!
+        //! Set the duration of the spin phase of wait().
+        //! @param [in] spin Duration of the spin phase in nano-seconds. When negative, use the
+        //! calibrated wake-up latency of the system.
+        //!
+        void setSpin(NanoSecond spin) {_spin = spin;}
+
+        //!
+        //! Set the maximum lateness of wait().
+        //! When wait() is called later than this after the due time of the packet, the schedule
+        //! is shifted to the current time instead of sending the late packets in a burst.
+        //! Below this lateness, the next packets are sent without waiting, to catch up.
+        //! @param [in] max_late Maximum lateness in nano-seconds. The default is one second.
+        //!
+        void setMaxLateness(NanoSecond max_late) {_max_late = max_late;}
+
+        //!
+        //! Account for the next packet in the stream and compute its due time.
+        //! @param [in] pkt The next TS packet.
+        //! @return The due time of the packet.
+        //!
+        const Monotonic& feedPacket(const TSPacket& pkt);
+
+        //!
+        //! Get the due time of the last packet which was passed to feedPacket().
+        //! @return The due time of the last packet.
+        //!
+        const Monotonic& due() const {return _due;}
+
+        //!
+        //! Wait until the due time of the last packet which was passed to feedPacket().
+        //! Collect the wake-up lateness in the statistics.
+        //!
+        void wait();
+
+        //!
+        //! Get the pacing statistics.
+        //! @return A constant reference to the statistics.
+        //!
+        const Statistics& statistics() const {return _stats;}
+
+        //!
+        //! Reset the pacing statistics.
+        //!
+        void resetStatistics() {_stats.reset();}
+
+    private:
+        NanoSecond    _spin;          // Spin duration before due time.
+        NanoSecond    _max_late;      // Maximum lateness before shifting the schedule.
+        BitRate       _bitrate;       // User-specified bitrate.
+        bool          _use_pcr;       // Use PCR-driven pacing.
+        PID           _pcr_pid;       // Reference PID for PCR.
+        bool          _started;       // At least one packet was fed since reset.
+        Monotonic     _due;           // Due time of last fed packet.
+        Monotonic     _origin;        // Time origin of bitrate-driven schedule.
+        PacketCounter _origin_pkt;    // Packet count at _origin.
+        PacketCounter _pkt_count;     // Packet count since reset.
+        bool          _has_pcr;       // A PCR was found on reference PID.
+        uint64_t      _last_pcr;      // Last PCR value on reference PID.
+        PacketCounter _last_pcr_pkt;  // Packet count at last PCR.
+        Monotonic     _last_pcr_due;  // Due time of last PCR.
+        NanoSecond    _pcr_ns;        // Duration in nano-seconds between the last two PCR's, zero if unknown.
+        PacketCounter _pcr_pkts;      // Number of packets between the last two PCR's.
+        Statistics    _stats;         // Pacing statistics.
+
+        // Time offset in nano-seconds of a packet from the origin of the schedule.
+        NanoSecond offset(PacketCounter count) const;
+    };
+}
@@ -580,6 +580,7 @@
 #include <sys/time.h>
 #include <sys/wait.h>
 #include <sys/socket.h>
+#include <poll.h>
 #include <netdb.h>
 #include <net/if.h>
 #include <netinet/in.h>
@@ -599,6 +600,7 @@
 #if defined(TS_LINUX)
 #include <limits.h>
 #include <sys/mman.h>
+#include <sys/epoll.h>
 #include <byteswap.h>
 #include <linux/dvb/version.h>
 #include <linux/dvb/frontend.h>
@@ -2561,6 +2563,43 @@ namespace ts {
 }
 
 
+//----------------------------------------------------------------------------
+// Cross-plaftorms portable definitions for bit counting.
+//----------------------------------------------------------------------------
+
+#if defined(TS_MSC) && defined(TS_X86_64)
+    #pragma intrinsic(_BitScanReverse64)
+#endif
+
+namespace ts {
+    //!
+    //! Inlined function counting the number of leading zero bits in a 64-bit integer.
+    //!
+    //! The compiler builtin or intrinsic is used when available. It is typically
+    //! translated into one single instruction.
+    //!
+    //! @param [in] word A 64-bit unsigned integer.
+    //! @return The number of consecutive zero bits in @a word, starting from the most
+    //! significant one. Return 64 when @a word is zero.
+    //!
+    TSDUCKDLL inline int CountLeadingZeros64(uint64_t word)
+    {
+    #if defined(TS_GCC) || defined(TS_LLVM)
+        return word == 0 ? 64 : __builtin_clzll(word);
+    #elif defined(TS_MSC) && defined(TS_X86_64)
+        unsigned long index = 0;
+        return _BitScanReverse64(&index, word) ? 63 - int(index) : 64;
+    #else
+        int count = 0;
+        for (uint64_t mask = TS_UCONST64(0x8000000000000000); mask != 0 && (word & mask) == 0; mask >>= 1) {
+            count++;
+        }
+        return count;
+    #endif
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Cross-plaftorms portable definitions for memory barrier.
 //----------------------------------------------------------------------------
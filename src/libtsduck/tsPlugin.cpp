@@ -38,7 +38,8 @@ TSDUCK_SOURCE;
 ts::TSP::TSP(int max_severity) :
     Report(max_severity),
     _tsp_bitrate(0),
-    _tsp_aborting(false)
+    _tsp_aborting(false),
+    _tsp_clock(true)
 {
 }
 
@@ -37,6 +37,7 @@
 #include "tsAbortInterface.h"
 #include "tsReport.h"
 #include "tsTSPacket.h"
+#include "tsPacketClock.h"
 
 namespace ts {
 
@@ -84,7 +85,7 @@ namespace ts {
         //! @c int data named @c tspInterfaceVersion which contains the current
         //! interface version at the time the library is built.
         //!
-        static const int API_VERSION = 5;
+        static const int API_VERSION = 6;
 
         //!
         //! Get the current input bitrate in bits/seconds.
@@ -92,6 +93,25 @@ namespace ts {
         //!
         BitRate bitrate() const {return _tsp_bitrate;}
 
+        //!
+        //! Get the current UTC time, as seen by tsp for the current group of packets.
+        //!
+        //! The system time is read by tsp once each time a group of packets is passed
+        //! to the plugin, with a coarse precision (a few milliseconds). This is much
+        //! faster than Time::CurrentUTC() and should be used by plugins which need
+        //! the current time for each packet.
+        //!
+        //! @return The current UTC time, with the precision of a group of packets.
+        //!
+        const Time& currentUTC() const {return _tsp_clock.utc();}
+
+        //!
+        //! Get the current local time, as seen by tsp for the current group of packets.
+        //! @return The current local time, with the precision of a group of packets.
+        //! @see currentUTC()
+        //!
+        Time currentLocalTime() const {return _tsp_clock.localTime();}
+
         //!
         //! Check for aborting application.
         //!
@@ -135,6 +155,7 @@ namespace ts {
     protected:
         BitRate       _tsp_bitrate;   //!< TSP input bitrate.
         volatile bool _tsp_aborting;  //!< TSP is currently aborting.
+        PacketClock   _tsp_clock;     //!< System time for the current group of packets, updated by subclasses.
 
         //!
         //! Constructor for subclasses.
@@ -0,0 +1,239 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Manifest of the tsp plugins which are installed in a directory.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPluginManifest.h"
+#include "tsPluginSharedLibrary.h"
+#include "tsSysUtils.h"
+TSDUCK_SOURCE;
+
+const ts::UChar* const ts::PluginManifest::FILE_NAME = u"tsplugins.manifest";
+
+// Keywords for the capabilities in the manifest file, in the order of the Capability enum.
+namespace {
+    const ts::UChar* const CAP_NAMES[ts::PluginManifest::CAP_COUNT] = {u"input", u"output", u"processor"};
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PluginManifest::Entry::Entry() :
+    file(),
+    syntax(),
+    description(),
+    manifestTime()
+{
+}
+
+ts::PluginManifest::PluginManifest() :
+    _loaded(false),
+    _entries(),
+    _files()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Check if an entry is up to date.
+//----------------------------------------------------------------------------
+
+bool ts::PluginManifest::Entry::isUpToDate() const
+{
+    const Time modified(GetFileModificationTimeUTC(file));
+    return modified != Time::Epoch && modified <= manifestTime;
+}
+
+
+//----------------------------------------------------------------------------
+// Load all manifests in the search path of the plugins.
+//----------------------------------------------------------------------------
+
+void ts::PluginManifest::load(const UString& library_path, Report& report)
+{
+    // Same search rules as ApplicationSharedLibrary: search path, then same directory as executable.
+    UStringList dirs;
+    if (!library_path.empty()) {
+        GetEnvironmentPath(dirs, library_path);
+    }
+    dirs.push_back(DirectoryName(ExecutableFile()));
+
+    for (UStringList::const_iterator it = dirs.begin(); it != dirs.end(); ++it) {
+        loadFile(*it, report);
+    }
+    _loaded = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Load one manifest file.
+//----------------------------------------------------------------------------
+
+void ts::PluginManifest::loadFile(const UString& directory, Report& report)
+{
+    const UString fileName(directory + PathSeparator + FILE_NAME);
+    const Time manifestTime(GetFileModificationTimeUTC(fileName));
+    UStringList lines;
+
+    if (manifestTime == Time::Epoch || !UString::Load(lines, fileName)) {
+        // No manifest in this directory.
+        return;
+    }
+
+    // Each line is "name, capability, file, syntax, description", separated by tabs.
+    for (UStringList::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+        if (it->empty() || it->front() == u'#') {
+            continue;
+        }
+        UStringVector fields;
+        it->split(fields, u'\t', false);
+        int cap = 0;
+        while (fields.size() == 5 && cap < CAP_COUNT && fields[1] != CAP_NAMES[cap]) {
+            ++cap;
+        }
+        if (fields.size() != 5 || cap >= CAP_COUNT) {
+            report.debug(u"%s: invalid line: %s", {fileName, *it});
+            continue;
+        }
+        EntryMap& entries(_entries[cap]);
+        if (entries.find(fields[0]) == entries.end()) {
+            Entry& entry(entries[fields[0]]);
+            entry.file = directory + PathSeparator + fields[2];
+            entry.syntax = fields[3];
+            entry.description = fields[4];
+            entry.manifestTime = manifestTime;
+            _files.insert(std::make_pair(entry.file, manifestTime));
+        }
+    }
+    report.debug(u"loaded plugin manifest %s", {fileName});
+}
+
+
+//----------------------------------------------------------------------------
+// Access entries.
+//----------------------------------------------------------------------------
+
+const ts::PluginManifest::Entry* ts::PluginManifest::find(Capability cap, const UString& name) const
+{
+    assert(cap >= 0 && cap < CAP_COUNT);
+    const EntryMap::const_iterator it(_entries[cap].find(name));
+    return it != _entries[cap].end() && it->second.isUpToDate() ? &it->second : 0;
+}
+
+bool ts::PluginManifest::isKnown(const UString& name) const
+{
+    for (int cap = 0; cap < CAP_COUNT; ++cap) {
+        if (find(Capability(cap), name) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ts::PluginManifest::containsFile(const UString& file) const
+{
+    const FileMap::const_iterator it(_files.find(file));
+    if (it == _files.end()) {
+        return false;
+    }
+    const Time modified(GetFileModificationTimeUTC(file));
+    return modified != Time::Epoch && modified <= it->second;
+}
+
+const ts::PluginManifest::EntryMap& ts::PluginManifest::entries(Capability cap) const
+{
+    assert(cap >= 0 && cap < CAP_COUNT);
+    return _entries[cap];
+}
+
+
+//----------------------------------------------------------------------------
+// Create the manifest of all plugins in a directory.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Format one line of manifest for a plugin capability.
+    void ManifestLine(ts::UStringList& out, const ts::UString& name, ts::PluginManifest::Capability cap, const ts::UString& file, ts::Plugin* plugin)
+    {
+        // Fields must not contain separators.
+        ts::UString syntax(plugin->getSyntax());
+        ts::UString description(plugin->getDescription());
+        syntax.substitute(u"\t", u" ");
+        syntax.substitute(u"\n", u" ");
+        description.substitute(u"\t", u" ");
+        description.substitute(u"\n", u" ");
+        out.push_back(name + u"\t" + CAP_NAMES[cap] + u"\t" + file + u"\t" + syntax + u"\t" + description);
+        delete plugin;
+    }
+}
+
+bool ts::PluginManifest::Create(const UString& directory, Report& report)
+{
+    // Get list of shared library files in the directory.
+    UStringVector files;
+    ExpandWildcard(files, directory + PathSeparator + u"tsplugin_*" TS_SHARED_LIB_SUFFIX);
+
+    UStringList out;
+    out.push_back(u"# TSDuck plugin manifest, generated by tsp --create-plugin-manifest");
+    out.push_back(u"# name, capability, file, syntax, description (tab-separated)");
+    bool success = true;
+    size_t count = 0;
+
+    for (UStringVector::const_iterator it = files.begin(); it != files.end(); ++it) {
+        PluginSharedLibrary shlib(*it, report);
+        if (!shlib.isLoaded()) {
+            success = false;
+            continue;
+        }
+        const UString name(shlib.moduleName());
+        const UString file(BaseName(*it));
+        if (shlib.new_input != 0) {
+            ManifestLine(out, name, INPUT, file, shlib.new_input(0));
+        }
+        if (shlib.new_output != 0) {
+            ManifestLine(out, name, OUTPUT, file, shlib.new_output(0));
+        }
+        if (shlib.new_processor != 0) {
+            ManifestLine(out, name, PROCESSOR, file, shlib.new_processor(0));
+        }
+        count++;
+    }
+
+    const UString fileName(directory + PathSeparator + FILE_NAME);
+    if (!UString::Save(out, fileName)) {
+        report.error(u"error creating %s", {fileName});
+        return false;
+    }
+    report.verbose(u"created %s with %d plugins", {fileName, count});
+    return success;
+}
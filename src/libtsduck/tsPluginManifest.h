@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Manifest of the tsp plugins which are installed in a directory.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUString.h"
+#include "tsReport.h"
+#include "tsTime.h"
+
+namespace ts {
+    //!
+    //! Manifest of the tsp plugins which are installed in a directory.
+    //!
+    //! A manifest is a text file named @e tsplugins.manifest, in the same directory as
+    //! the plugins. It records the name, capabilities, shared library file, syntax and
+    //! description of each plugin. Using the manifests, tsp locates a plugin without
+    //! searching all directories and lists all plugins without loading them.
+    //!
+    //! A plugin which is not in any manifest, or which shared library is more recent
+    //! than its manifest, is ignored here and must be searched and loaded as usual.
+    //!
+    class TSDUCKDLL PluginManifest
+    {
+    public:
+        //!
+        //! Name of the manifest file in a directory of plugins.
+        //!
+        static const UChar* const FILE_NAME;
+
+        //!
+        //! Capabilities of a plugin.
+        //!
+        enum Capability {
+            INPUT,      //!< Input plugin.
+            OUTPUT,     //!< Output plugin.
+            PROCESSOR,  //!< Packet processor plugin.
+            CAP_COUNT   //!< Number of capabilities, not a valid capability.
+        };
+
+        //!
+        //! Description of one capability of a plugin in a manifest.
+        //!
+        class TSDUCKDLL Entry
+        {
+        public:
+            UString file;         //!< Full path of the shared library.
+            UString syntax;       //!< Syntax of the plugin command line.
+            UString description;  //!< One-line description of the plugin.
+            Time    manifestTime; //!< Modification time of the manifest file.
+
+            //!
+            //! Default constructor.
+            //!
+            Entry();
+
+            //!
+            //! Check if the entry is up to date.
+            //! @return True if the shared library exists and is not more recent than the manifest.
+            //!
+            bool isUpToDate() const;
+        };
+
+        //!
+        //! Map of entries, indexed by plugin name.
+        //!
+        typedef std::map<UString, Entry> EntryMap;
+
+        //!
+        //! Constructor.
+        //!
+        PluginManifest();
+
+        //!
+        //! Load all manifests in the search path of the plugins.
+        //! The directories are searched in the same order as when loading a plugin.
+        //! When a plugin is found in several manifests, the first one is used.
+        //! @param [in] library_path Name of an environment variable containing a search path for plugins.
+        //! @param [in,out] report Where to report errors.
+        //!
+        void load(const UString& library_path, Report& report);
+
+        //!
+        //! Check if the manifests were loaded.
+        //! @return True if load() was called.
+        //!
+        bool isLoaded() const
+        {
+            return _loaded;
+        }
+
+        //!
+        //! Find an up to date entry for a plugin.
+        //! @param [in] cap Requested capability.
+        //! @param [in] name Plugin name.
+        //! @return Address of the entry or zero if not found or not up to date.
+        //!
+        const Entry* find(Capability cap, const UString& name) const;
+
+        //!
+        //! Check if a plugin name is described in an up to date manifest, regardless of capabilities.
+        //! @param [in] name Plugin name.
+        //! @return True if the plugin is described in an up to date entry.
+        //!
+        bool isKnown(const UString& name) const;
+
+        //!
+        //! Check if a shared library file is described in an up to date manifest.
+        //! @param [in] file Full path of a shared library.
+        //! @return True if all capabilities of the shared library are described in a manifest.
+        //!
+        bool containsFile(const UString& file) const;
+
+        //!
+        //! Get all entries for a capability, including entries which are not up to date.
+        //! @param [in] cap Requested capability.
+        //! @return A constant reference to the map of entries.
+        //!
+        const EntryMap& entries(Capability cap) const;
+
+        //!
+        //! Create the manifest of all plugins in a directory.
+        //! All plugins in the directory are loaded.
+        //! @param [in] directory Directory of the plugins.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        static bool Create(const UString& directory, Report& report);
+
+    private:
+        typedef std::map<UString, Time> FileMap;
+
+        bool     _loaded;             // Manifests were loaded.
+        EntryMap _entries[CAP_COUNT]; // Entries, per capability.
+        FileMap  _files;              // Manifest time of all shared library files.
+
+        // Load one manifest file.
+        void loadFile(const UString& directory, Report& report);
+    };
+}
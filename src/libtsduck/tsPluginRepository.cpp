@@ -44,11 +44,48 @@ ts::PluginRepository::PluginRepository() :
     _sharedLibraryAllowed(true),
     _inputPlugins(),
     _processorPlugins(),
-    _outputPlugins()
+    _outputPlugins(),
+    _manifest()
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Get the manifests of all plugins, load them the first time.
+//----------------------------------------------------------------------------
+
+const ts::PluginManifest& ts::PluginRepository::manifest(Report& report)
+{
+    if (!_manifest.isLoaded()) {
+        _manifest.load(TS_PLUGINS_PATH, report);
+    }
+    return _manifest;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the shared library file to load for a plugin.
+//----------------------------------------------------------------------------
+
+ts::UString ts::PluginRepository::pluginFile(const UString& name, PluginManifest::Capability cap, Report& report)
+{
+    const PluginManifest& mf(manifest(report));
+    const PluginManifest::Entry* entry = mf.find(cap, name);
+    if (entry != 0) {
+        // Directly load the shared library from the manifest, no search.
+        return entry->file;
+    }
+    else if (mf.isKnown(name)) {
+        // The plugin exists but does not have the requested capability, don't even load it.
+        return UString();
+    }
+    else {
+        // Not in a manifest, search the shared library.
+        return name;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Plugin registration.
 //----------------------------------------------------------------------------
@@ -110,7 +147,12 @@ ts::NewInputProfile ts::PluginRepository::getInput(const UString& name, Report&
     }
 
     // Try to load a shareable library.
-    PluginSharedLibrary shlib(name, report);
+    const UString file(pluginFile(name, PluginManifest::INPUT, report));
+    if (file.empty()) {
+        report.error(u"plugin %s has no input capability", {name});
+        return 0;
+    }
+    PluginSharedLibrary shlib(file, report);
     if (!shlib.isLoaded()) {
         // Error message already displayed.
         return 0;
@@ -141,7 +183,12 @@ ts::NewProcessorProfile ts::PluginRepository::getProcessor(const UString& name,
     }
 
     // Try to load a shareable library.
-    PluginSharedLibrary shlib(name, report);
+    const UString file(pluginFile(name, PluginManifest::PROCESSOR, report));
+    if (file.empty()) {
+        report.error(u"plugin %s has no processor capability", {name});
+        return 0;
+    }
+    PluginSharedLibrary shlib(file, report);
     if (!shlib.isLoaded()) {
         // Error message already displayed.
         return 0;
@@ -172,7 +219,12 @@ ts::NewOutputProfile ts::PluginRepository::getOutput(const UString& name, Report
     }
 
     // Try to load a shareable library.
-    PluginSharedLibrary shlib(name, report);
+    const UString file(pluginFile(name, PluginManifest::OUTPUT, report));
+    if (file.empty()) {
+        report.error(u"plugin %s has no output capability", {name});
+        return 0;
+    }
+    PluginSharedLibrary shlib(file, report);
     if (!shlib.isLoaded()) {
         // Error message already displayed.
         return 0;
@@ -222,62 +274,99 @@ void ts::PluginRepository::loadAllPlugins(Report& report)
 
 ts::UString ts::PluginRepository::listPlugins(bool loadAll, Report& report)
 {
-    // Output text, use some preservation.
-    UString out;
-    out.reserve(5000);
+    // Descriptions of all plugins, by type.
+    DescriptionMap inputs;
+    DescriptionMap outputs;
+    DescriptionMap processors;
 
-    // Load all shareable plugins first.
-    if (loadAll) {
-        loadAllPlugins(report);
+    // First, plugins which are already registered.
+    for (InputMap::const_iterator it = _inputPlugins.begin(); it != _inputPlugins.end(); ++it) {
+        AddDescription(inputs, it->first, it->second(0));
+    }
+    for (OutputMap::const_iterator it = _outputPlugins.begin(); it != _outputPlugins.end(); ++it) {
+        AddDescription(outputs, it->first, it->second(0));
+    }
+    for (ProcessorMap::const_iterator it = _processorPlugins.begin(); it != _processorPlugins.end(); ++it) {
+        AddDescription(processors, it->first, it->second(0));
+    }
+
+    // Then all shareable plugins, from the manifests when possible, loading them otherwise.
+    if (loadAll && _sharedLibraryAllowed) {
+        const PluginManifest& mf(manifest(report));
+        UStringVector files;
+        ApplicationSharedLibrary::GetPluginList(files, u"tsplugin_", TS_PLUGINS_PATH);
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!mf.containsFile(files[i])) {
+                PluginSharedLibrary shlib(files[i], report);
+                if (shlib.isLoaded()) {
+                    const UString name(shlib.moduleName());
+                    registerInput(name, shlib.new_input);
+                    registerOutput(name, shlib.new_output);
+                    registerProcessor(name, shlib.new_processor);
+                    AddDescription(inputs, name, shlib.new_input == 0 ? 0 : shlib.new_input(0));
+                    AddDescription(outputs, name, shlib.new_output == 0 ? 0 : shlib.new_output(0));
+                    AddDescription(processors, name, shlib.new_processor == 0 ? 0 : shlib.new_processor(0));
+                }
+            }
+        }
+        DescriptionMap* const descs[PluginManifest::CAP_COUNT] = {&inputs, &outputs, &processors};
+        for (int cap = 0; cap < PluginManifest::CAP_COUNT; ++cap) {
+            const PluginManifest::EntryMap& entries(mf.entries(PluginManifest::Capability(cap)));
+            for (PluginManifest::EntryMap::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.isUpToDate()) {
+                    descs[cap]->insert(std::make_pair(it->first, it->second.description));
+                }
+            }
+        }
     }
 
     // Compute max name width of all plugins.
     size_t name_width = 0;
-    for (InputMap::const_iterator it = _inputPlugins.begin(); it != _inputPlugins.end(); ++it) {
+    for (DescriptionMap::const_iterator it = inputs.begin(); it != inputs.end(); ++it) {
         name_width = std::max(name_width, it->first.width());
     }
-    for (ProcessorMap::const_iterator it = _processorPlugins.begin(); it != _processorPlugins.end(); ++it) {
+    for (DescriptionMap::const_iterator it = outputs.begin(); it != outputs.end(); ++it) {
         name_width = std::max(name_width, it->first.width());
     }
-    for (OutputMap::const_iterator it = _outputPlugins.begin(); it != _outputPlugins.end(); ++it) {
+    for (DescriptionMap::const_iterator it = processors.begin(); it != processors.end(); ++it) {
         name_width = std::max(name_width, it->first.width());
     }
 
-    // List capabilities.
-    out += u"\nList of tsp input plugins:\n\n";
-    for (InputMap::const_iterator it = _inputPlugins.begin(); it != _inputPlugins.end(); ++it) {
-        Plugin* p = it->second(0);
-        ListOnePlugin(out, it->first, p, name_width);
-        delete p;
-    }
+    // Output text, use some preservation.
+    UString out;
+    out.reserve(5000);
+    ListPlugins(out, u"\nList of tsp input plugins:\n\n", inputs, name_width);
+    ListPlugins(out, u"\nList of tsp output plugins:\n\n", outputs, name_width);
+    ListPlugins(out, u"\nList of tsp packet processor plugins:\n\n", processors, name_width);
+    return out;
+}
 
-    out += u"\nList of tsp output plugins:\n\n";
-    for (OutputMap::const_iterator it = _outputPlugins.begin(); it != _outputPlugins.end(); ++it) {
-        Plugin* p = it->second(0);
-        ListOnePlugin(out, it->first, p, name_width);
-        delete p;
-    }
 
-    out += u"\nList of tsp packet processor plugins:\n\n";
-    for (ProcessorMap::const_iterator it = _processorPlugins.begin(); it != _processorPlugins.end(); ++it) {
-        Plugin* p = it->second(0);
-        ListOnePlugin(out, it->first, p, name_width);
-        delete p;
-    }
+//----------------------------------------------------------------------------
+// Add the description of a plugin in a list, when not already present.
+//----------------------------------------------------------------------------
 
-    return out;
+void ts::PluginRepository::AddDescription(DescriptionMap& descs, const UString& name, Plugin* plugin)
+{
+    if (plugin != 0) {
+        descs.insert(std::make_pair(name, plugin->getDescription()));
+        delete plugin;
+    }
 }
 
 
 //----------------------------------------------------------------------------
-// List one plugin.
+// List all plugins of one type.
 //----------------------------------------------------------------------------
 
-void ts::PluginRepository::ListOnePlugin(UString& out, const UString& name, Plugin* plugin, size_t name_width)
+void ts::PluginRepository::ListPlugins(UString& out, const UString& title, const DescriptionMap& descs, size_t name_width)
 {
-    out += u"  ";
-    out += name.toJustifiedLeft(name_width + 1, u'.', false, 1);
-    out += u" ";
-    out += plugin->getDescription();
-    out += u"\n";
+    out += title;
+    for (DescriptionMap::const_iterator it = descs.begin(); it != descs.end(); ++it) {
+        out += u"  ";
+        out += it->first.toJustifiedLeft(name_width + 1, u'.', false, 1);
+        out += u" ";
+        out += it->second;
+        out += u"\n";
+    }
 }
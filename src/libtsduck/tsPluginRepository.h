@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsPlugin.h"
+#include "tsPluginManifest.h"
 #include "tsReport.h"
 #include "tsSingletonManager.h"
 
@@ -132,7 +133,9 @@ namespace ts {
         //!
         //! List all tsp processors.
         //! This function is typically used to implement the <code>tsp -\-list-processors</code> option.
-        //! @param [in] loadAll When true, all available plugins are loaded first.
+        //! @param [in] loadAll When true, all available plugins are listed. The plugins which are
+        //! described in an up to date manifest are listed from the manifest, without loading them.
+        //! All other plugins are loaded first.
         //! Ignored when dynamic loading of plugins is disabled.
         //! @param [in,out] report Where to report errors.
         //! @return The text to display.
@@ -181,12 +184,25 @@ namespace ts {
         typedef std::map<UString, NewProcessorProfile> ProcessorMap;
         typedef std::map<UString, NewOutputProfile>    OutputMap;
 
-        bool         _sharedLibraryAllowed;
-        InputMap     _inputPlugins;
-        ProcessorMap _processorPlugins;
-        OutputMap    _outputPlugins;
+        typedef std::map<UString, UString> DescriptionMap;
 
-        // List one plugin.
-        static void ListOnePlugin(UString& out, const UString& name, Plugin* plugin, size_t name_width);
+        bool           _sharedLibraryAllowed;
+        InputMap       _inputPlugins;
+        ProcessorMap   _processorPlugins;
+        OutputMap      _outputPlugins;
+        PluginManifest _manifest;
+
+        // Get the manifests of all plugins, load them the first time.
+        const PluginManifest& manifest(Report& report);
+
+        // Get the shared library file to load for a plugin, using the manifest when possible.
+        // Return an empty string when the manifest says that the plugin does not have the capability.
+        UString pluginFile(const UString& name, PluginManifest::Capability cap, Report& report);
+
+        // Add the description of a plugin in a list, when not already present.
+        static void AddDescription(DescriptionMap& descs, const UString& name, Plugin* plugin);
+
+        // List all plugins of one type.
+        static void ListPlugins(UString& out, const UString& title, const DescriptionMap& descs, size_t name_width);
     };
 }
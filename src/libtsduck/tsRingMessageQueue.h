@@ -0,0 +1,244 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Template bounded message queue for inter-thread communication, based on a ring buffer
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+#include "tsSafePtr.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+
+namespace ts {
+
+    //!
+    //! Template bounded message queue for inter-thread communication, based on a ring buffer.
+    //!
+    //! The ts::RingMessageQueue template class implements the same kind of synchronized
+    //! shared queue of messages as ts::MessageQueue. The differences are:
+    //!
+    //! - The maximum number of messages is fixed and cannot be unlimited. The message
+    //!   slots are allocated once for all in a circular buffer. There is no allocation
+    //!   per enqueued message, unlike the linked list of ts::MessageQueue.
+    //! - Several messages can be enqueued or dequeued at once using enqueueBatch()
+    //!   and dequeueBatch(), under one single lock of the mutex.
+    //! - A message can be inserted at the head of the queue (priority message).
+    //! - The conditions are signaled only when some thread is actually waiting on them.
+    //!   When the consumer finds messages in the queue or the producer finds free slots,
+    //!   the operation is a simple mutex lock / unlock.
+    //!
+    //! @tparam MSG The type of the messages to exchange.
+    //! @tparam MUTEX The type of mutex for synchronization (ts::Mutex by default).
+    //!
+    template <typename MSG, class MUTEX = Mutex>
+    class RingMessageQueue
+    {
+    public:
+        //!
+        //! Safe pointer to messages.
+        //!
+        typedef SafePtr<MSG, MUTEX> MessagePtr;
+
+        //!
+        //! Vector of safe pointers to messages, used in batch operations.
+        //!
+        typedef std::vector<MessagePtr> MessagePtrVector;
+
+        //!
+        //! Constructor.
+        //!
+        //! @param [in] maxMessages Maximum number of messages in the queue.
+        //! When a thread attempts to enqueue a message and the queue is full,
+        //! the thread waits until at least one message is dequeued.
+        //! Zero is not allowed and is interpreted as 1.
+        //!
+        RingMessageQueue(size_t maxMessages);
+
+        //!
+        //! Destructor
+        //!
+        ~RingMessageQueue();
+
+        //!
+        //! Get the maximum allowed messages in the queue.
+        //! @return The maximum allowed messages in the queue.
+        //!
+        size_t getMaxMessages() const
+        {
+            return _maxMessages;
+        }
+
+        //!
+        //! Get the current number of messages in the queue.
+        //! @return The current number of messages in the queue.
+        //!
+        size_t size() const;
+
+        //!
+        //! Insert a message at the end of the queue.
+        //!
+        //! If the queue is full, the calling thread waits until some space becomes
+        //! available in the queue or the timeout expires.
+        //!
+        //! @param [in] msg The message to enqueue.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return True on success, false on error (queue still full after timeout).
+        //!
+        bool enqueue(const MessagePtr& msg, MilliSecond timeout = Infinite)
+        {
+            return enqueueMessage(msg, timeout, false);
+        }
+
+        //!
+        //! Insert a priority message at the head of the queue.
+        //!
+        //! The message will be the next one to be dequeued, before all messages which
+        //! are already in the queue. If the queue is full, the calling thread waits until
+        //! some space becomes available in the queue or the timeout expires.
+        //!
+        //! @param [in] msg The message to enqueue.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return True on success, false on error (queue still full after timeout).
+        //!
+        bool enqueueFront(const MessagePtr& msg, MilliSecond timeout = Infinite)
+        {
+            return enqueueMessage(msg, timeout, true);
+        }
+
+        //!
+        //! Insert a message at the end of the queue, even if the queue is full.
+        //!
+        //! This method immediately inserts the message, even if the queue is full.
+        //! This can be used to allow exceptional overflow of the queue with unique messages,
+        //! to enqueue a message to instruct the consumer thread to terminate for instance.
+        //! When the queue is full, the ring buffer is enlarged.
+        //!
+        //! @param [in] msg The message to enqueue.
+        //!
+        void forceEnqueue(const MessagePtr& msg)
+        {
+            forceEnqueueMessage(msg, false);
+        }
+
+        //!
+        //! Insert a priority message at the head of the queue, even if the queue is full.
+        //! @param [in] msg The message to enqueue.
+        //! @see forceEnqueue()
+        //!
+        void forceEnqueueFront(const MessagePtr& msg)
+        {
+            forceEnqueueMessage(msg, true);
+        }
+
+        //!
+        //! Insert several messages at the end of the queue.
+        //!
+        //! The messages are inserted in order. When the queue is full, the calling
+        //! thread waits until some space becomes available in the queue or the timeout
+        //! expires. The timeout applies to the complete operation.
+        //!
+        //! @param [in] msgs The messages to enqueue.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return The number of enqueued messages, from the beginning of @a msgs.
+        //! This is less than the size of @a msgs if the timeout expired.
+        //!
+        size_t enqueueBatch(const MessagePtrVector& msgs, MilliSecond timeout = Infinite);
+
+        //!
+        //! Remove a message from the queue.
+        //!
+        //! Wait until a message is received or the timeout expires.
+        //!
+        //! @param [out] msg Received message.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! If @a timeout is zero and the queue is empty, return immediately.
+        //! @return True on success, false on error (queue still empty after timeout).
+        //!
+        bool dequeue(MessagePtr& msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Remove several messages from the queue.
+        //!
+        //! Wait until at least one message is received or the timeout expires.
+        //! Then, all available messages, up to @a maxCount, are removed.
+        //!
+        //! @param [out] msgs Received messages, in queue order. The vector is cleared first.
+        //! Its capacity is reused, the application should keep it from one call to another.
+        //! @param [in] maxCount Maximum number of messages to dequeue.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! If @a timeout is zero and the queue is empty, return immediately.
+        //! @return True on success, false on error (queue still empty after timeout).
+        //!
+        bool dequeueBatch(MessagePtrVector& msgs, size_t maxCount = std::numeric_limits<size_t>::max(), MilliSecond timeout = Infinite);
+
+        //!
+        //! Clear the content of the queue.
+        //!
+        void clear();
+
+    private:
+        RingMessageQueue(const RingMessageQueue&) = delete;
+        RingMessageQueue& operator=(const RingMessageQueue&) = delete;
+
+        // Private members.
+        mutable Mutex     _mutex;        //!< Protect access to all private members
+        mutable Condition _enqueued;     //!< Signaled when some message is inserted
+        mutable Condition _dequeued;     //!< Signaled when some message is removed
+        size_t            _maxMessages;  //!< Max number of messages in the queue
+        MessagePtrVector  _ring;         //!< Circular buffer of messages (can be larger than _maxMessages after forceEnqueue).
+        size_t            _first;        //!< Index of first message in _ring.
+        size_t            _count;        //!< Number of messages in _ring.
+        size_t            _waitEnqueue;  //!< Number of threads waiting on _enqueued.
+        size_t            _waitDequeue;  //!< Number of threads waiting on _dequeued.
+
+        // Common code for enqueue operations.
+        bool enqueueMessage(const MessagePtr& msg, MilliSecond timeout, bool front);
+        void forceEnqueueMessage(const MessagePtr& msg, bool front);
+
+        // Wait for free space or for some message. Must be called with the mutex held.
+        // The timeout is updated. Return false on timeout.
+        bool waitFreeSpace(MilliSecond& timeout);
+        bool waitMessage(MilliSecond& timeout);
+
+        // Insert / remove one message. Must be called with the mutex held.
+        void push(const MessagePtr& msg, bool front);
+        void pop(MessagePtr& msg);
+
+        // Signal the conditions when some threads are waiting. Must be called with the mutex held.
+        void signalWaiters();
+
+        // Enlarge the ring buffer. Must be called with the mutex held.
+        void enlarge(size_t size);
+    };
+}
+
+#include "tsRingMessageQueueTemplate.h"
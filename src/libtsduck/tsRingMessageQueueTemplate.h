@@ -0,0 +1,327 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Template bounded message queue for inter-thread communication
+//
+//----------------------------------------------------------------------------
+
+#include "tsGuard.h"
+#include "tsTime.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+ts::RingMessageQueue<MSG, MUTEX>::RingMessageQueue(size_t maxMessages) :
+    _mutex(),
+    _enqueued(),
+    _dequeued(),
+    _maxMessages(std::max<size_t>(1, maxMessages)),
+    _ring(_maxMessages),
+    _first(0),
+    _count(0),
+    _waitEnqueue(0),
+    _waitDequeue(0)
+{
+}
+
+template <typename MSG, class MUTEX>
+ts::RingMessageQueue<MSG, MUTEX>::~RingMessageQueue()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get the current number of messages in the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+size_t ts::RingMessageQueue<MSG, MUTEX>::size() const
+{
+    Guard lock(_mutex);
+    return _count;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for free space or for some message, mutex held.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::waitFreeSpace(MilliSecond& timeout)
+{
+    Time start(Time::CurrentUTC());
+    while (_count >= _maxMessages && timeout > 0) {
+        // Wait for a message to be dequeued, temporarily release the mutex.
+        _waitDequeue++;
+        const bool signaled = _dequeued.wait(_mutex, timeout);
+        _waitDequeue--;
+
+        // Reduce timeout
+        if (timeout != Infinite) {
+            const Time now(Time::CurrentUTC());
+            timeout -= now - start;
+            start = now;
+        }
+        if (!signaled) {
+            break; // timeout
+        }
+    }
+    return _count < _maxMessages;
+}
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::waitMessage(MilliSecond& timeout)
+{
+    Time start(Time::CurrentUTC());
+    while (_count == 0 && timeout > 0) {
+        // Wait for a message to be enqueued, temporarily release the mutex.
+        _waitEnqueue++;
+        const bool signaled = _enqueued.wait(_mutex, timeout);
+        _waitEnqueue--;
+
+        // Reduce timeout
+        if (timeout != Infinite) {
+            const Time now(Time::CurrentUTC());
+            timeout -= now - start;
+            start = now;
+        }
+        if (!signaled) {
+            break; // timeout
+        }
+    }
+    return _count > 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert / remove one message, mutex held.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::push(const MessagePtr& msg, bool front)
+{
+    assert(_count < _ring.size());
+    if (front) {
+        _first = _first == 0 ? _ring.size() - 1 : _first - 1;
+        _ring[_first] = msg;
+    }
+    else {
+        const size_t index = _first + _count;
+        _ring[index < _ring.size() ? index : index - _ring.size()] = msg;
+    }
+    _count++;
+}
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::pop(MessagePtr& msg)
+{
+    assert(_count > 0);
+    // Moving the message leaves a null pointer in the free slot.
+    msg = std::move(_ring[_first]);
+    if (++_first >= _ring.size()) {
+        _first = 0;
+    }
+    _count--;
+}
+
+
+//----------------------------------------------------------------------------
+// Signal waiting threads, mutex held.
+// A condition wakes up one thread only. When the woken thread leaves messages
+// or free space behind it, it signals the condition again for the next waiter.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::signalWaiters()
+{
+    if (_waitEnqueue > 0 && _count > 0) {
+        _enqueued.signal();
+    }
+    if (_waitDequeue > 0 && _count < _maxMessages) {
+        _dequeued.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Enlarge the ring buffer, mutex held.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::enlarge(size_t size)
+{
+    if (size > _ring.size()) {
+        // Move the messages at the beginning of a new buffer.
+        MessagePtrVector ring(size);
+        for (size_t i = 0; i < _count; ++i) {
+            ring[i] = std::move(_ring[(_first + i) % _ring.size()]);
+        }
+        _ring.swap(ring);
+        _first = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in the queue with a timeout.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::enqueueMessage(const MessagePtr& msg, MilliSecond timeout, bool front)
+{
+    Guard lock(_mutex);
+
+    // If the queue is full, wait for the queue not being full.
+    if (!waitFreeSpace(timeout)) {
+        return false;
+    }
+
+    // Enqueue the message and signal waiting threads, if any.
+    push(msg, front);
+    signalWaiters();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in the queue, even if the queue is full.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::forceEnqueueMessage(const MessagePtr& msg, bool front)
+{
+    Guard lock(_mutex);
+
+    // Exceptional overflow, enlarge the ring buffer.
+    if (_count >= _ring.size()) {
+        enlarge(2 * _ring.size());
+    }
+
+    push(msg, front);
+    signalWaiters();
+}
+
+
+//----------------------------------------------------------------------------
+// Insert several messages in the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+size_t ts::RingMessageQueue<MSG, MUTEX>::enqueueBatch(const MessagePtrVector& msgs, MilliSecond timeout)
+{
+    Guard lock(_mutex);
+
+    size_t index = 0;
+    while (index < msgs.size()) {
+
+        // Fill all available free space at once.
+        const size_t before = index;
+        while (index < msgs.size() && _count < _maxMessages) {
+            push(msgs[index++], false);
+        }
+
+        // Signal the consumers before waiting for more free space.
+        if (index > before) {
+            signalWaiters();
+        }
+        if (index < msgs.size() && !waitFreeSpace(timeout)) {
+            break;
+        }
+    }
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove a message from the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::dequeue(MessagePtr& msg, MilliSecond timeout)
+{
+    Guard lock(_mutex);
+
+    // If the queue is empty, wait for a message.
+    if (!waitMessage(timeout)) {
+        return false;
+    }
+
+    // Remove a message and signal waiting threads, if any.
+    pop(msg);
+    signalWaiters();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove several messages from the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::dequeueBatch(MessagePtrVector& msgs, size_t maxCount, MilliSecond timeout)
+{
+    msgs.clear();
+    Guard lock(_mutex);
+
+    // If the queue is empty, wait for a message.
+    if (maxCount == 0 || !waitMessage(timeout)) {
+        return false;
+    }
+
+    // Remove all available messages.
+    const size_t count = std::min(_count, maxCount);
+    msgs.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        pop(msgs[i]);
+    }
+    signalWaiters();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::clear()
+{
+    Guard lock(_mutex);
+    if (_count > 0) {
+        MessagePtr msg;
+        while (_count > 0) {
+            pop(msg);
+        }
+        // Signal that messages have been dequeued (dropped in fact).
+        signalWaiters();
+    }
+}
@@ -188,6 +188,93 @@ void ts::SDT::deserialize(const BinaryTable& table, const DVBCharset* charset)
 }
 
 
+//----------------------------------------------------------------------------
+// Get non-owning views on the content of an SDT section.
+//----------------------------------------------------------------------------
+
+bool ts::SDT::GetView(const Section& section, uint16_t& ts_id, uint16_t& onetw_id, ServiceViewVector& services)
+{
+    services.clear();
+    if (!section.isValid() || (section.tableId() != TID_SDT_ACT && section.tableId() != TID_SDT_OTH) || section.payloadSize() < 3) {
+        return false;
+    }
+
+    ts_id = section.tableIdExtension();
+
+    // Analyze the section payload. There is one trailing reserved byte after original_network_id.
+    const uint8_t* data(section.payload());
+    size_t remain(section.payloadSize());
+    onetw_id = GetUInt16(data);
+    data += 3;
+    remain -= 3;
+
+    // Get services description
+    while (remain >= 5) {
+        services.resize(services.size() + 1);
+        ServiceView& serv(services.back());
+        serv.service_id = GetUInt16(data);
+        serv.EITs_present = (data[2] & 0x02) != 0;
+        serv.EITpf_present = (data[2] & 0x01) != 0;
+        serv.running_status = data[3] >> 5;
+        serv.CA_controlled = (data[3] & 0x10) != 0;
+        const size_t info_length = std::min<size_t>(GetUInt16(data + 3) & 0x0FFF, remain - 5);
+        serv.descs = DescriptorListView(data + 5, info_length);
+        data += 5 + info_length;
+        remain -= 5 + info_length;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Non-owning view of a service description.
+//----------------------------------------------------------------------------
+
+ts::SDT::ServiceView::ServiceView() :
+    service_id(0),
+    EITs_present(false),
+    EITpf_present(false),
+    running_status(0),
+    CA_controlled(false),
+    descs()
+{
+}
+
+uint8_t ts::SDT::ServiceView::serviceType() const
+{
+    const DescriptorListView::const_iterator it(descs.search(DID_SERVICE));
+    return it == descs.end() || it->payloadSize() < 1 ? 0 : it->payload()[0]; // 0 is a "reserved" service_type value
+}
+
+ts::UString ts::SDT::ServiceView::providerName(const DVBCharset* charset) const
+{
+    const DescriptorListView::const_iterator it(descs.search(DID_SERVICE));
+    if (it == descs.end() || it->payloadSize() < 1) {
+        return UString();
+    }
+    const uint8_t* data = it->payload() + 1;
+    size_t size = it->payloadSize() - 1;
+    return UString::FromDVBWithByteLength(data, size, charset);
+}
+
+ts::UString ts::SDT::ServiceView::serviceName(const DVBCharset* charset) const
+{
+    const DescriptorListView::const_iterator it(descs.search(DID_SERVICE));
+    if (it == descs.end() || it->payloadSize() < 1) {
+        return UString();
+    }
+    const uint8_t* data = it->payload() + 1;
+    size_t size = it->payloadSize() - 1;
+    if (size > 0) {
+        // Skip provider name.
+        const size_t len = std::min<size_t>(data[0], size - 1);
+        data += len + 1;
+        size -= len + 1;
+    }
+    return UString::FromDVBWithByteLength(data, size, charset);
+}
+
+
 //----------------------------------------------------------------------------
 // Private method: Add a new section to a table being serialized.
 // Section number is incremented. Data and remain are reinitialized.
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsAbstractLongTable.h"
 #include "tsDescriptorList.h"
+#include "tsDescriptorListView.h"
 #include "tsServiceDescriptor.h"
 #include "tsService.h"
 
@@ -168,6 +169,64 @@ namespace ts {
         //!
         typedef EntryWithDescriptorsMap<uint16_t, Service> ServiceMap;
 
+        //!
+        //! Non-owning view of a service description in an SDT section.
+        //!
+        struct TSDUCKDLL ServiceView
+        {
+            uint16_t           service_id;      //!< Service id.
+            bool               EITs_present;    //!< There are EIT schedule for this service.
+            bool               EITpf_present;   //!< There are EIT present/following for this service.
+            uint8_t            running_status;  //!< Running status of the service.
+            bool               CA_controlled;   //!< The service is controlled by a CA_system.
+            DescriptorListView descs;           //!< View of the descriptor list.
+
+            //!
+            //! Default constructor.
+            //!
+            ServiceView();
+
+            //!
+            //! Get the service type, from the first service_descriptor, without allocation.
+            //! @return The service type or zero if no service_descriptor is found.
+            //!
+            uint8_t serviceType() const;
+
+            //!
+            //! Get the service name, from the first service_descriptor.
+            //! @param [in] charset If not zero, default character set to use.
+            //! @return The service name or an empty string if no service_descriptor is found.
+            //!
+            UString serviceName(const DVBCharset* charset = 0) const;
+
+            //!
+            //! Get the provider name, from the first service_descriptor.
+            //! @param [in] charset If not zero, default character set to use.
+            //! @return The provider name or an empty string if no service_descriptor is found.
+            //!
+            UString providerName(const DVBCharset* charset = 0) const;
+        };
+
+        //!
+        //! Vector of non-owning views of services.
+        //!
+        typedef std::vector<ServiceView> ServiceViewVector;
+
+        //!
+        //! Get non-owning views on the content of an SDT section, without deserializing it.
+        //! No descriptor is allocated. The views point inside the section, which must remain
+        //! valid and unmodified while the views are used. Use DescriptorListView::toDescriptorList()
+        //! to build owning descriptor lists on demand.
+        //! @param [in] section An SDT Actual or Other section.
+        //! @param [out] ts_id Transport stream id.
+        //! @param [out] onetw_id Original network id.
+        //! @param [out] services Views of the services, in section order. The vector is cleared
+        //! first. Its capacity is reused, the application should keep it from one section to
+        //! another to avoid reallocations.
+        //! @return True on success, false if @a section is not a valid SDT section.
+        //!
+        static bool GetView(const Section& section, uint16_t& ts_id, uint16_t& onetw_id, ServiceViewVector& services);
+
         // SDT public members:
         uint16_t   ts_id;     //!< Transport stream_id.
         uint16_t   onetw_id;  //!< Original network id.
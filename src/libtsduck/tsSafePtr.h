@@ -38,8 +38,106 @@
 #include "tsGuard.h"
 #include "tsMutex.h"
 #include "tsNullMutex.h"
+#include <atomic>
 
 namespace ts {
+    //!
+    //! Lock-free synchronization policy for ts::SafePtr.
+    //!
+    //! This class can be used as @a MUTEX template parameter of ts::SafePtr,
+    //! instead of an actual mutex class. The safe pointer is thread-safe but
+    //! its reference counter and pointer are atomic variables and no mutex is
+    //! locked when safe pointers are copied or destroyed.
+    //!
+    //! Example:
+    //! @code
+    //! typedef ts::SafePtr<Foo, ts::AtomicRefCount> FooPtr;
+    //! @endcode
+    //!
+    class AtomicRefCount
+    {
+    };
+
+    //! @cond nodoxygen
+    // Synchronized state of the object which is shared by safe pointers.
+    // Generic version: the pointer and the reference counter are protected by a mutex.
+    template <typename T, class MUTEX>
+    class SafePtrState
+    {
+    public:
+        SafePtrState(T* p) : _ptr(p), _ref_count(1), _mutex() {}
+        T* pointer() { Guard lock(_mutex); return _ptr; }
+        T* exchange(T* p) { Guard lock(_mutex); T* previous = _ptr; _ptr = p; return previous; }
+        template <typename ST> ST* extract()
+        {
+            Guard lock(_mutex);
+            ST* sp = dynamic_cast<ST*>(_ptr);
+            if (sp != 0) {
+                _ptr = 0;
+            }
+            return sp;
+        }
+        int count() { Guard lock(_mutex); return _ref_count; }
+        void attach() { Guard lock(_mutex); _ref_count++; }
+        int detach() { Guard lock(_mutex); return --_ref_count; }
+    private:
+        T*    _ptr;        // pointer to actual object
+        int   _ref_count;  // reference counter
+        MUTEX _mutex;      // protect the state
+    };
+
+    // Specialization without synchronization: no need to go through the empty mutex.
+    template <typename T>
+    class SafePtrState<T, NullMutex>
+    {
+    public:
+        SafePtrState(T* p) : _ptr(p), _ref_count(1) {}
+        T* pointer() { return _ptr; }
+        T* exchange(T* p) { T* previous = _ptr; _ptr = p; return previous; }
+        template <typename ST> ST* extract()
+        {
+            ST* sp = dynamic_cast<ST*>(_ptr);
+            if (sp != 0) {
+                _ptr = 0;
+            }
+            return sp;
+        }
+        int count() { return _ref_count; }
+        void attach() { _ref_count++; }
+        int detach() { return --_ref_count; }
+    private:
+        T*  _ptr;
+        int _ref_count;
+    };
+
+    // Specialization with atomic variables.
+    template <typename T>
+    class SafePtrState<T, AtomicRefCount>
+    {
+    public:
+        SafePtrState(T* p) : _ptr(p), _ref_count(1) {}
+        T* pointer() { return _ptr.load(std::memory_order_acquire); }
+        T* exchange(T* p) { return _ptr.exchange(p, std::memory_order_acq_rel); }
+        template <typename ST> ST* extract()
+        {
+            T* p = _ptr.load(std::memory_order_acquire);
+            ST* sp = 0;
+            // Retry if the pointer was concurrently modified between the cast and the reset.
+            while ((sp = dynamic_cast<ST*>(p)) != 0 && !_ptr.compare_exchange_weak(p, 0, std::memory_order_acq_rel)) {
+            }
+            return sp;
+        }
+        int count() { return _ref_count.load(std::memory_order_relaxed); }
+        // A new reference is always created from an existing one, no ordering is required.
+        void attach() { _ref_count.fetch_add(1, std::memory_order_relaxed); }
+        // The last release must see all previous accesses to the object before deleting it.
+        int detach() { return _ref_count.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+    private:
+        std::atomic<T*>  _ptr;
+        std::atomic<int> _ref_count;
+    };
+    //! @endcond
+
     //!
     //!  Template safe pointer (reference-counted, auto-delete, thread-safe).
     //!
@@ -79,11 +177,16 @@ namespace ts {
     //!  ts::NullMutex is used. The default implementation is consequently
     //!  not thread-safe but there is no synchronization overhead. To use
     //!  safe pointers in a multi-thread environment, specify an actual
-    //!  mutex implementation for the target environment.
+    //!  mutex implementation for the target environment or, preferably,
+    //!  ts::AtomicRefCount which uses lock-free atomic operations.
+    //!
+    //!  A safe pointer can be moved (move constructor and move assignment).
+    //!  The reference counter is not modified by a move. The moved-from safe
+    //!  pointer becomes a null pointer.
     //!
     //!  @tparam T The type of the pointed object. Cannot be an array type.
     //!  @tparam MUTEX A subclass of ts::MutexInterface which is used to
-    //!  synchronize access to the safe pointer internal state.
+    //!  synchronize access to the safe pointer internal state or ts::AtomicRefCount.
     //!
     template <typename T, class MUTEX = NullMutex>
     class SafePtr
@@ -127,8 +230,22 @@ namespace ts {
         //! @param [in] sp Another safe pointer instance.
         //!
         SafePtr(const SafePtr<T,MUTEX> &sp) :
-            _shared(sp._shared->attach())
+            _shared(sp._shared == 0 ? 0 : sp._shared->attach())
+        {
+        }
+
+        //!
+        //! Move constructor.
+        //!
+        //! This object references the same @a T object as @a sp, without modifying
+        //! the reference counter. The safe pointer @a sp becomes a null pointer.
+        //!
+        //! @param [in,out] sp Another safe pointer instance.
+        //!
+        SafePtr(SafePtr<T,MUTEX>&& sp) noexcept :
+            _shared(sp._shared)
         {
+            sp._shared = 0;
         }
 
         //!
@@ -154,6 +271,21 @@ namespace ts {
         //!
         SafePtr<T,MUTEX>& operator=(const SafePtr<T,MUTEX>& sp);
 
+        //!
+        //! Move assignment between safe pointers.
+        //!
+        //! After the assignment, this object references the same @a T object
+        //! as @a sp and @a sp becomes a null pointer. The reference counter of
+        //! the @a T object is not modified. If this object was previously not the
+        //! null pointer, the reference counter of the previously referenced @a T
+        //! object is decremented. If the reference counter reaches zero, the previously
+        //! pointed object is automatically deleted.
+        //!
+        //! @param [in,out] sp The value to assign.
+        //! @return A reference to this object.
+        //!
+        SafePtr<T,MUTEX>& operator=(SafePtr<T,MUTEX>&& sp) noexcept;
+
         //!
         //! Assignment from a standard pointer @c T*.
         //!
@@ -244,7 +376,7 @@ namespace ts {
         //!
         T* operator->() const
         {
-            return _shared->pointer();
+            return pointer();
         }
 
         //!
@@ -267,7 +399,7 @@ namespace ts {
         //!
         T& operator*() const
         {
-            return *_shared->pointer();
+            return *pointer();
         }
 
         //!
@@ -286,7 +418,7 @@ namespace ts {
         //!
         T* release()
         {
-            return _shared->release();
+            return _shared == 0 ? 0 : _shared->release();
         }
 
         //!
@@ -305,7 +437,12 @@ namespace ts {
         //!
         void reset(T *p = 0)
         {
-            _shared->reset(p);
+            if (_shared == 0) {
+                _shared = new SafePtrShared(p);
+            }
+            else {
+                _shared->reset(p);
+            }
         }
 
         //!
@@ -320,7 +457,9 @@ namespace ts {
         //!
         void clear()
         {
-            _shared->detach();
+            if (_shared != 0) {
+                _shared->detach();
+            }
             _shared = new SafePtrShared(0);
         }
 
@@ -332,7 +471,7 @@ namespace ts {
         //!
         bool isNull() const
         {
-            return _shared->isNull();
+            return _shared == 0 || _shared->isNull();
         }
 
         //!
@@ -354,7 +493,7 @@ namespace ts {
         template <typename ST>
         SafePtr<ST,MUTEX> upcast()
         {
-            return _shared->template upcast<ST>();
+            return _shared == 0 ? SafePtr<ST,MUTEX>() : _shared->template upcast<ST>();
         }
 
         //!
@@ -383,7 +522,7 @@ namespace ts {
         template <typename ST>
         SafePtr<ST,MUTEX> downcast()
         {
-            return _shared->template downcast<ST>();
+            return _shared == 0 ? SafePtr<ST,MUTEX>() : _shared->template downcast<ST>();
         }
 
         //!
@@ -404,7 +543,7 @@ namespace ts {
         template <typename NEWMUTEX>
         SafePtr<T,NEWMUTEX> changeMutex()
         {
-            return _shared->template changeMutex<NEWMUTEX>();
+            return _shared == 0 ? SafePtr<T,NEWMUTEX>() : _shared->template changeMutex<NEWMUTEX>();
         }
 
         //!
@@ -420,7 +559,7 @@ namespace ts {
         //!
         T* pointer() const
         {
-            return _shared->pointer();
+            return _shared == 0 ? 0 : _shared->pointer();
         }
 
         //!
@@ -435,14 +574,15 @@ namespace ts {
         //!
         int count() const
         {
-            return _shared->count();
+            return _shared == 0 ? 0 : _shared->count();
         }
 
     private:
         //! @cond nodoxygen
 
         // All safe pointer objects which reference the same @c T object share
-        // one single @c SafePtrShared object.
+        // one single @c SafePtrShared object. A moved-from safe pointer has no
+        // @c SafePtrShared object, it is a null pointer.
         class SafePtrShared;
         // cppcheck-suppress unsafeClassCanLeak // pointer is managed through its detach() method
         SafePtrShared* _shared;
@@ -450,10 +590,8 @@ namespace ts {
         class SafePtrShared
         {
         private:
-            // Private members:
-            T*    _ptr;        // pointer to actual object
-            int   _ref_count;  // reference counter
-            MUTEX _mutex;      // protect the SafePtrShared
+            // Pointer to actual object and reference counter, synchronized according to MUTEX.
+            SafePtrState<T,MUTEX> _state;
 
             // Inaccessible operators
             SafePtrShared(const SafePtrShared&) = delete;
@@ -461,7 +599,7 @@ namespace ts {
 
         public:
             // Constructor. Initial reference count is 1.
-            SafePtrShared(T* p = 0) : _ptr(p), _ref_count(1), _mutex()
+            SafePtrShared(T* p = 0) : _state(p)
             {
             }
 
@@ -491,31 +629,20 @@ namespace ts {
             // Perform a class downcast (cast to a subclass).
             template <typename ST> SafePtr<ST,MUTEX> downcast()
             {
-                Guard lock(_mutex);
-                ST* sp = dynamic_cast<ST*>(_ptr);
-                if (sp != 0) {
-                    // Successful downcast, the original safe pointer must be released.
-                    _ptr = 0;
-                }
-                return SafePtr<ST,MUTEX>(sp);
+                // On successful downcast, the original safe pointer is released.
+                return SafePtr<ST,MUTEX>(_state.template extract<ST>());
             }
 
             // Perform a class upcast.
             template <typename ST> SafePtr<ST,MUTEX> upcast()
             {
-                Guard lock(_mutex);
-                ST* sp = _ptr;
-                _ptr = 0;
-                return SafePtr<ST,MUTEX>(sp);
+                return SafePtr<ST,MUTEX>(_state.exchange(0));
             }
 
             // Change mutex type.
             template <typename NEWMUTEX> SafePtr<T,NEWMUTEX> changeMutex()
             {
-                Guard lock (_mutex);
-                T* sp = _ptr;
-                _ptr = 0;
-                return SafePtr<T,NEWMUTEX> (sp);
+                return SafePtr<T,NEWMUTEX>(_state.exchange(0));
             }
         };
 
@@ -51,8 +51,28 @@ template <typename T, class MUTEX>
 ts::SafePtr<T,MUTEX>& ts::SafePtr<T,MUTEX>::operator= (const SafePtr<T,MUTEX>& sp)
 {
     if (_shared != sp._shared) {
-        _shared->detach ();
-        _shared = sp._shared->attach ();
+        if (_shared != 0) {
+            _shared->detach();
+        }
+        _shared = sp._shared == 0 ? 0 : sp._shared->attach();
+    }
+    return *this;
+}
+
+
+//----------------------------------------------------------------------------
+// Move assignment between safe pointers.
+//----------------------------------------------------------------------------
+
+template <typename T, class MUTEX>
+ts::SafePtr<T,MUTEX>& ts::SafePtr<T,MUTEX>::operator=(SafePtr<T,MUTEX>&& sp) noexcept
+{
+    if (&sp != this) {
+        if (_shared != 0) {
+            _shared->detach();
+        }
+        _shared = sp._shared;
+        sp._shared = 0;
     }
     return *this;
 }
@@ -65,8 +85,10 @@ ts::SafePtr<T,MUTEX>& ts::SafePtr<T,MUTEX>::operator= (const SafePtr<T,MUTEX>& s
 template <typename T, class MUTEX>
 ts::SafePtr<T,MUTEX>& ts::SafePtr<T,MUTEX>::operator=(T* p)
 {
-    _shared->detach ();
-    _shared = new SafePtrShared (p);
+    if (_shared != 0) {
+        _shared->detach();
+    }
+    _shared = new SafePtrShared(p);
     return *this;
 }
 
@@ -78,9 +100,9 @@ ts::SafePtr<T,MUTEX>& ts::SafePtr<T,MUTEX>::operator=(T* p)
 template <typename T, class MUTEX>
 ts::SafePtr<T,MUTEX>::SafePtrShared::~SafePtrShared()
 {
-    if (_ptr != 0) {
-        delete _ptr;
-        _ptr = 0;
+    T* previous = _state.exchange(0);
+    if (previous != 0) {
+        delete previous;
     }
 }
 
@@ -93,10 +115,7 @@ ts::SafePtr<T,MUTEX>::SafePtrShared::~SafePtrShared()
 template <typename T, class MUTEX>
 T* ts::SafePtr<T,MUTEX>::SafePtrShared::release()
 {
-    Guard lock (_mutex);
-    T* previous (_ptr);
-    _ptr = 0;
-    return previous;
+    return _state.exchange(0);
 }
 
 
@@ -107,11 +126,10 @@ T* ts::SafePtr<T,MUTEX>::SafePtrShared::release()
 template <typename T, class MUTEX>
 void ts::SafePtr<T,MUTEX>::SafePtrShared::reset (T* p)
 {
-    Guard lock (_mutex);
-    if (_ptr != 0) {
-        delete _ptr;
+    T* previous = _state.exchange(p);
+    if (previous != 0) {
+        delete previous;
     }
-    _ptr = p;
 }
 
 
@@ -122,8 +140,7 @@ void ts::SafePtr<T,MUTEX>::SafePtrShared::reset (T* p)
 template <typename T, class MUTEX>
 T* ts::SafePtr<T,MUTEX>::SafePtrShared::pointer()
 {
-    Guard lock (_mutex);
-    return _ptr;
+    return _state.pointer();
 }
 
 
@@ -134,8 +151,7 @@ T* ts::SafePtr<T,MUTEX>::SafePtrShared::pointer()
 template <typename T, class MUTEX>
 int ts::SafePtr<T,MUTEX>::SafePtrShared::count()
 {
-    Guard lock (_mutex);
-    return _ref_count;
+    return _state.count();
 }
 
 
@@ -146,8 +162,7 @@ int ts::SafePtr<T,MUTEX>::SafePtrShared::count()
 template <typename T, class MUTEX>
 bool ts::SafePtr<T,MUTEX>::SafePtrShared::isNull()
 {
-    Guard lock (_mutex);
-    return _ptr == 0;
+    return _state.pointer() == 0;
 }
 
 
@@ -158,8 +173,7 @@ bool ts::SafePtr<T,MUTEX>::SafePtrShared::isNull()
 template <typename T, class MUTEX>
 typename ts::SafePtr<T,MUTEX>::SafePtrShared* ts::SafePtr<T,MUTEX>::SafePtrShared::attach()
 {
-    Guard lock (_mutex);
-    _ref_count++;
+    _state.attach();
     return this;
 }
 
@@ -172,12 +186,7 @@ typename ts::SafePtr<T,MUTEX>::SafePtrShared* ts::SafePtr<T,MUTEX>::SafePtrShare
 template <typename T, class MUTEX>
 bool ts::SafePtr<T,MUTEX>::SafePtrShared::detach()
 {
-    int refcount;
-    {
-        Guard lock (_mutex);
-        refcount = --_ref_count;
-    }
-    if (refcount == 0) {
+    if (_state.detach() == 0) {
         delete this;
         return true;
     }
@@ -171,7 +171,8 @@ ts::SectionDemux::PIDContext::PIDContext() :
     sync(false),
     ts(),
     tids(),
-    pusi_pkt_index(0)
+    pusi_pkt_index(0),
+    skip(0)
 {
 }
 
@@ -180,6 +181,7 @@ void ts::SectionDemux::PIDContext::syncLost()
 {
     sync = false;
     ts.clear();
+    skip = 0;
 }
 
 
@@ -194,7 +196,9 @@ ts::SectionDemux::SectionDemux(TableHandlerInterface* table_handler,
     _table_handler(table_handler),
     _section_handler(section_handler),
     _pids(),
-    _status()
+    _status(),
+    _tid_filter(AllTIDs),
+    _tidext_filter()
 {
 }
 
@@ -341,6 +345,37 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
         pc.sync = true;
     }
 
+    // Skip the rest of an unwanted section, without copying it.
+
+    if (pc.skip > 0) {
+        size_t size = std::min(pc.skip, payload_size);
+        if (pkt.getPUSI() && pointer_field < size) {
+            // The unwanted section is truncated, a new section starts in this packet.
+            size = pointer_field;
+            pc.skip = 0;
+        }
+        else {
+            pc.skip -= size;
+        }
+        payload += size;
+        payload_size -= size;
+        if (pkt.getPUSI()) {
+            pointer_field -= uint8_t(size);
+        }
+        // If the unwanted section ends in this packet, the rest of the packet may be stuffing.
+        if (pc.skip == 0 && payload_size > 0 && payload[0] == 0xFF) {
+            if (pkt.getPUSI()) {
+                // Stuffing up to the next section.
+                payload += pointer_field;
+                payload_size -= pointer_field;
+                pointer_field = 0;
+            }
+            else {
+                payload_size = 0;
+            }
+        }
+    }
+
     // Copy TS packet payload in PID context
 
     pc.ts.append (payload, payload_size);
@@ -387,9 +422,20 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             return;
         }
 
+        // Check the TID and TID-ext filters as soon as the section header is available.
+        // The TID-ext is in the first 5 bytes, before the minimum size of a long section.
+
+        const bool unwanted =
+            !_tid_filter.test(etid.tid()) ||
+            (long_header && !_tidext_filter.empty() && ts_size >= 5 && _tidext_filter.count(GetUInt16(ts_start + 3)) == 0);
+
+        if (unwanted) {
+            section_ok = false;
+        }
+
         // Exit when end of section is missing. Wait for next TS packets.
 
-        if (ts_size < section_length) {
+        if (!unwanted && ts_size < section_length) {
             break;
         }
 
@@ -401,6 +447,14 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             section_length = uint16_t(pusi_section - ts_start);
         }
 
+        // An incomplete unwanted section is not buffered, its end is skipped in the next TS packets.
+
+        if (ts_size < section_length) {
+            pc.skip = section_length - ts_size;
+            ts_size = 0;
+            break;
+        }
+
         // We have a complete section in the pc.ts buffer. Analyze it.
 
         uint8_t version = 0;
@@ -46,6 +46,10 @@ namespace ts {
     //!
     //! Sections with the @e next indicator are ignored. Only sections with the @e current indicator are reported.
     //!
+    //! In addition to the PID filter, the demux can filter sections by table id and table id extension.
+    //! These filters are checked on the first bytes of each section, as soon as its header is received.
+    //! Unwanted sections are skipped at TS packet level, without buffering, CRC check or allocation.
+    //!
     class TSDUCKDLL SectionDemux: public AbstractDemux
     {
     public:
@@ -64,6 +68,83 @@ namespace ts {
                      SectionHandlerInterface* section_handler = 0,
                      const PIDSet& pid_filter = NoPID);
 
+        //!
+        //! Replace the list of table ids to filter.
+        //! By default, all table ids are filtered.
+        //! @param [in] tid_filter The list of table ids to filter.
+        //!
+        void setTIDFilter(const TIDSet& tid_filter)
+        {
+            _tid_filter = tid_filter;
+        }
+
+        //!
+        //! Add one table id to filter.
+        //! @param [in] tid The new table id to filter.
+        //!
+        void addTID(TID tid)
+        {
+            _tid_filter.set(tid);
+        }
+
+        //!
+        //! Remove one table id to filter.
+        //! @param [in] tid The table id to no longer filter.
+        //!
+        void removeTID(TID tid)
+        {
+            _tid_filter.reset(tid);
+        }
+
+        //!
+        //! Get the list of table ids to filter.
+        //! @return A constant reference to the list of table ids to filter.
+        //!
+        const TIDSet& tidFilter() const
+        {
+            return _tid_filter;
+        }
+
+        //!
+        //! Replace the list of table id extensions to filter.
+        //! This filter applies to long sections only. Short sections have no table id extension.
+        //! @param [in] tidext_filter The list of table id extensions to filter.
+        //! When empty (the default), all table id extensions are filtered.
+        //!
+        void setTIDExtFilter(const std::set<uint16_t>& tidext_filter)
+        {
+            _tidext_filter = tidext_filter;
+        }
+
+        //!
+        //! Add one table id extension to filter.
+        //! @param [in] tidext The new table id extension to filter.
+        //!
+        void addTIDExt(uint16_t tidext)
+        {
+            _tidext_filter.insert(tidext);
+        }
+
+        //!
+        //! Remove one table id extension to filter.
+        //! Note that when the last table id extension is removed, all table id extensions are filtered.
+        //! @param [in] tidext The table id extension to no longer filter.
+        //!
+        void removeTIDExt(uint16_t tidext)
+        {
+            _tidext_filter.erase(tidext);
+        }
+
+        //!
+        //! Get the list of table id extensions to filter.
+        //! @return A constant reference to the list of table id extensions to filter.
+        //! When empty, all table id extensions are filtered.
+        //!
+        const std::set<uint16_t>& tidExtFilter() const
+        {
+            return _tidext_filter;
+        }
+
         //!
         //! Destructor.
         //!
@@ -208,6 +289,7 @@ namespace ts {
             ByteBlock ts;                     // TS payload buffer
             std::map<ETID, ETIDContext> tids; // TID analysis contexts
             PacketCounter pusi_pkt_index;     // Index of last PUSI packet in this PID
+            size_t skip;                      // Remaining bytes to skip in an unwanted section
 
             // Default constructor.
             PIDContext();
@@ -221,6 +303,8 @@ namespace ts {
         SectionHandlerInterface* _section_handler;
         std::map<PID,PIDContext> _pids;
         Status                   _status;
+        TIDSet                   _tid_filter;
+        std::set<uint16_t>       _tidext_filter;
 
         // Inacessible operations
         SectionDemux(const SectionDemux&) = delete;
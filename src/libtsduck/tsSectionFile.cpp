@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsSectionFile.h"
+#include "tsMappedSectionFile.h"
 #include "tsAbstractTable.h"
 #include "tsAbstractDescriptor.h"
 #include "tsBinaryTable.h"
@@ -48,7 +49,8 @@ TSDUCK_SOURCE;
 ts::SectionFile::SectionFile() :
     _tables(),
     _sections(),
-    _orphanSections()
+    _orphanSections(),
+    _collected(0)
 {
 }
 
@@ -66,6 +68,7 @@ void ts::SectionFile::clear()
     _tables.clear();
     _sections.clear();
     _orphanSections.clear();
+    _collected = 0;
 }
 
 
@@ -94,12 +97,15 @@ void ts::SectionFile::add(const BinaryTablePtrVector& tables)
 void ts::SectionFile::add(const BinaryTablePtr& table)
 {
     if (!table.isNull() && table->isValid()) {
+        // Collect tables from previous sections first, to keep the order of tables.
+        collectTables();
         // Add the table as a whole.
         _tables.push_back(table);
         // Add all its sections (none of them is orphan).
         for (size_t i = 0; i < table->sectionCount(); ++i) {
             _sections.push_back(table->sectionAt(i));
         }
+        _collected = _sections.size();
     }
 }
 
@@ -119,9 +125,21 @@ void ts::SectionFile::add(const SectionPtr& section)
 {
     if (!section.isNull() && section->isValid()) {
         // Make the section part of the global list of sections.
+        // The tables are built later, only when they are accessed.
         _sections.push_back(section);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the tables from the sections which were added since the last call.
+//----------------------------------------------------------------------------
+
+void ts::SectionFile::collectTables() const
+{
+    while (_collected < _sections.size()) {
         // Temporary push this section in the orphan list.
-        _orphanSections.push_back(section);
+        _orphanSections.push_back(_sections[_collected++]);
         // Try to build a table from the list of orphans.
         collectLastTable();
     }
@@ -132,7 +150,7 @@ void ts::SectionFile::add(const SectionPtr& section)
 // Check it a table can be formed using the last sections in _orphanSections.
 //----------------------------------------------------------------------------
 
-void ts::SectionFile::collectLastTable()
+void ts::SectionFile::collectLastTable() const
 {
     // If there is no orphan section, nothing to do.
     if (_orphanSections.empty()) {
@@ -202,6 +220,27 @@ void ts::SectionFile::collectLastTable()
 
 bool ts::SectionFile::loadBinary(const UString& file_name, Report& report, CRC32::Validation crc_op)
 {
+    // Regular files are memory-mapped, all sections are located in one pass.
+    // Pipes and devices cannot be mapped and are read as a stream.
+    MappedSectionFile mapped;
+    if (mapped.open(file_name, NULLREP) || mapped.isOpen()) {
+        clear();
+        _sections.reserve(mapped.sectionCount());
+        ReportWithPrefix report_internal(report, file_name + u": ");
+        for (size_t i = 0; i < mapped.sectionCount(); ++i) {
+            const SectionPtr sp(mapped.section(i, crc_op));
+            if (!sp->isValid()) {
+                // Same as loadBinary(std::istream&), stop at first invalid section.
+                report_internal.error(u"invalid section%s", {UString::AfterBytes(std::streampos(mapped.sectionOffset(i)))});
+                return false;
+            }
+            add(sp);
+        }
+        // Same as loadBinary(std::istream&), a truncated last section is reported but ignored.
+        mapped.checkComplete(report_internal);
+        return true;
+    }
+
     // Open the input file.
     std::ifstream strm(file_name.toUTF8().c_str(), std::ios::in | std::ios::binary);
     if (!strm.is_open()) {
@@ -358,6 +397,9 @@ bool ts::SectionFile::generateDocument(xml::Document& doc, const DVBCharset* cha
         return false;
     }
 
+    // Build the tables from the sections, if not yet done.
+    collectTables();
+
     // Format all tables.
     for (BinaryTablePtrVector::const_iterator it = _tables.begin(); it != _tables.end(); ++it) {
         const BinaryTablePtr& table(*it);
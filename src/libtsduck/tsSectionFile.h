@@ -225,6 +225,7 @@ namespace ts {
 
         //!
         //! Load a binary section file.
+        //! Regular files are memory-mapped and all sections are located in one pass.
         //! @param [in] file_name Binary file name.
         //! @param [in] crc_op How to process the CRC32 of the input packet.
         //! @param [in,out] report Where to report errors.
@@ -250,10 +251,12 @@ namespace ts {
 
         //!
         //! Fast access to the list of loaded tables.
+        //! The tables are built from the loaded sections on the first access.
         //! @return A constant reference to the internal list of loaded tables.
         //!
         const BinaryTablePtrVector& tables() const
         {
+            collectTables();
             return _tables;
         }
 
@@ -272,6 +275,7 @@ namespace ts {
         //!
         const SectionPtrVector& orphanSections() const
         {
+            collectTables();
             return _orphanSections;
         }
 
@@ -281,6 +285,7 @@ namespace ts {
         //!
         void getTables(BinaryTablePtrVector& tables) const
         {
+            collectTables();
             tables.assign(_tables.begin(), _tables.end());
         }
 
@@ -299,6 +304,7 @@ namespace ts {
         //!
         void getOrphanSections(SectionPtrVector& sections) const
         {
+            collectTables();
             sections.assign(_orphanSections.begin(), _orphanSections.end());
         }
 
@@ -335,9 +341,10 @@ namespace ts {
         void add(const SectionPtrVector& sections);
 
     private:
-        BinaryTablePtrVector _tables;          //!< Loaded tables.
-        SectionPtrVector     _sections;        //!< All sections from the file.
-        SectionPtrVector     _orphanSections;  //!< Sections which do not belong to any table.
+        mutable BinaryTablePtrVector _tables;          //!< Loaded tables, built on demand from _sections.
+        SectionPtrVector             _sections;        //!< All sections from the file.
+        mutable SectionPtrVector     _orphanSections;  //!< Sections which do not belong to any table.
+        mutable size_t               _collected;       //!< Number of sections in _sections which were already collected in tables.
 
         //!
         //! Parse an XML document.
@@ -355,9 +362,14 @@ namespace ts {
         //!
         bool generateDocument(xml::Document& doc, const DVBCharset* charset) const;
 
+        //!
+        //! Build the tables from the sections which were added since the last call.
+        //!
+        void collectTables() const;
+
         //!
         //! Check it a table can be formed using the last sections in _orphanSections.
         //!
-        void collectLastTable();
+        void collectLastTable() const;
     };
 }
@@ -248,5 +248,5 @@ namespace ts {
     //!
     //! Safe pointer to a TCPConnection (thread-safe).
     //!
-    typedef SafePtr<TCPConnection,Mutex> TCPConnectionPtrMT;
+    typedef SafePtr<TCPConnection, AtomicRefCount> TCPConnectionPtrMT;
 }
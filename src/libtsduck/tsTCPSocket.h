@@ -177,5 +177,5 @@ namespace ts {
     //!
     //! Safe pointer to TCPSocket, multi-threaded.
     //!
-    typedef SafePtr <TCPSocket, Mutex> TCPSocketPtrMT;
+    typedef SafePtr<TCPSocket, AtomicRefCount> TCPSocketPtrMT;
 }
@@ -37,6 +37,15 @@
 #include "tsAlgorithm.h"
 TSDUCK_SOURCE;
 
+namespace {
+    // Add or subtract a value in a statistics counter.
+    template <typename INT>
+    inline void Accumulate(INT& counter, uint64_t value, bool add)
+    {
+        counter = add ? INT(counter + value) : INT(counter - value);
+    }
+}
+
 // Constant string "Unreferenced"
 const ts::UString ts::TSAnalyzer::UNREFERENCED(u"Unreferenced");
 
@@ -82,6 +91,11 @@ ts::TSAnalyzer::TSAnalyzer(BitRate bitrate_hint) :
     _pids(),
     _services(),
     _modified(false),
+    _is_snapshot(false),
+    _generation(0),
+    _pending_pids(),
+    _idle_eviction(0),
+    _next_eviction(0),
     _ts_bitrate_sum(0),
     _ts_bitrate_cnt(0),
     _preceding_errors(0),
@@ -91,7 +105,9 @@ ts::TSAnalyzer::TSAnalyzer(BitRate bitrate_hint) :
     _default_charset(0),
     _demux(this, this),
     _pes_demux(this),
-    _t2mi_demux(this)
+    _t2mi_demux(this),
+    _pmt_streams(),
+    _sdt_services()
 {
     // Specify the PID filters to collect PSI tables.
     _demux.addPID(PID_PAT);
@@ -121,6 +137,9 @@ ts::TSAnalyzer::~TSAnalyzer()
 void ts::TSAnalyzer::reset()
 {
     _modified = false;
+    _is_snapshot = false;
+    _pending_pids.clear();
+    _next_eviction = _idle_eviction;
     _ts_id = 0;
     _ts_id_valid = false;
     _ts_pkt_cnt = 0;
@@ -225,7 +244,13 @@ ts::TSAnalyzer::PIDContext::PIDContext(PID pid_, const UString& description_) :
     last_pcr(0),
     last_pcr_pkt(0),
     ts_bitrate_sum(0),
-    ts_bitrate_cnt(0)
+    ts_bitrate_cnt(0),
+    last_seen_pkt(0),
+    stat_pending(false),
+    stat_referenced(false),
+    stat_scrambled(false),
+    stat_services(),
+    generation(0)
 {
     // Guess the initial description, based on the PID
     // Global PID's (PAT, CAT, etc) are marked as "referenced" since they
@@ -318,6 +343,10 @@ ts::TSAnalyzer::PIDContext::PIDContext(PID pid_, const UString& description_) :
         default:
             break;
     }
+
+    // Without packet and service, the contribution to the statistics is empty.
+    // Just record the initial state of the PID.
+    stat_referenced = referenced;
 }
 
 
@@ -345,7 +374,8 @@ ts::TSAnalyzer::ETIDContext::ETIDContext(const ETID& etid_) :
     last_version(0),
     versions(),
     first_pkt(0),
-    last_pkt(0)
+    last_pkt(0),
+    last_seen_pkt(0)
 {
 }
 
@@ -376,7 +406,9 @@ ts::TSAnalyzer::ServiceContext::ServiceContext(uint16_t serv_id) :
     ts_pkt_cnt(0),
     bitrate(0),
     carry_ssu(false),
-    carry_t2mi(false)
+    carry_t2mi(false),
+    last_seen_pkt(0),
+    generation(0)
 {
 }
 
@@ -442,14 +474,42 @@ ts::TSAnalyzer::ETIDContextPtr ts::TSAnalyzer::getETID(const Section& section)
 
 ts::TSAnalyzer::PIDContextPtr ts::TSAnalyzer::getPID(PID pid, const UString& description)
 {
-    const PIDContextPtr p(_pids[pid]);
+    PIDContextPtr& p(_pids[pid]);
+    PIDContext& pc(writablePID(p, pid, description));
+    pc.last_seen_pkt = _ts_pkt_cnt;
+
+    // The caller may modify the references of the PID. Its contribution to
+    // the statistics will be updated before counting the next packet.
+    if (!pc.stat_pending) {
+        pc.stat_pending = true;
+        _pending_pids.push_back(pid);
+    }
+    return p;
+}
+
+
+//----------------------------------------------------------------------------
+//  Return a modifiable PID context from a map entry.
+//----------------------------------------------------------------------------
+
+ts::TSAnalyzer::PIDContext& ts::TSAnalyzer::writablePID(PIDContextPtr& p, PID pid, const UString& description)
+{
     if (p.isNull()) {
         // The PID was not yet used, map entry just created.
-        return _pids[pid] = new PIDContext(pid, description);
+        p = new PIDContext(pid, description);
+        p->generation = _generation;
     }
-    else {
-        return p;
+    else if (p->generation != _generation) {
+        // The context is shared with a snapshot, duplicate it before modification.
+        // The ETID contexts are modified through their PID context, duplicate them as well.
+        PIDContext* pc = new PIDContext(*p);
+        for (ETIDContextMap::iterator it = pc->sections.begin(); it != pc->sections.end(); ++it) {
+            it->second = new ETIDContext(*it->second);
+        }
+        pc->generation = _generation;
+        p = pc;
     }
+    return *p;
 }
 
 
@@ -459,13 +519,135 @@ ts::TSAnalyzer::PIDContextPtr ts::TSAnalyzer::getPID(PID pid, const UString& des
 
 ts::TSAnalyzer::ServiceContextPtr ts::TSAnalyzer::getService(uint16_t service_id)
 {
-    ServiceContextPtr p(_services[service_id]);
+    ServiceContextPtr& p(_services[service_id]);
+    writableService(p, service_id).last_seen_pkt = _ts_pkt_cnt;
+    return p;
+}
+
+
+//----------------------------------------------------------------------------
+//  Return a modifiable service context from a map entry.
+//----------------------------------------------------------------------------
+
+ts::TSAnalyzer::ServiceContext& ts::TSAnalyzer::writableService(ServiceContextPtr& p, uint16_t service_id)
+{
     if (p.isNull()) {
         // The service was not yet used, map entry just created.
-        return _services[service_id] = new ServiceContext(service_id);
+        p = new ServiceContext(service_id);
+        p->generation = _generation;
+        p->last_seen_pkt = _ts_pkt_cnt;
     }
-    else {
-        return p;
+    else if (p->generation != _generation) {
+        // The context is shared with a snapshot, duplicate it before modification.
+        ServiceContext* sc = new ServiceContext(*p);
+        sc->generation = _generation;
+        p = sc;
+    }
+    return *p;
+}
+
+
+//----------------------------------------------------------------------------
+// Add or remove the contribution of a PID to the global and service
+// statistics, using the state of the PID when it was last accounted.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::accountPID(const PIDContext& pc, bool add)
+{
+    const uint64_t pkt_cnt = pc.ts_pkt_cnt;
+    const uint64_t used = pkt_cnt == 0 ? 0 : 1;
+    const uint64_t scrambled = pc.stat_scrambled ? used : 0;
+
+    // Count non-empty PID's
+    Accumulate(_pid_cnt, used, add);
+
+    if (!pc.stat_referenced) {
+        // Count unreferenced PID's
+        Accumulate(_unref_pid_cnt, used, add);
+        Accumulate(_unref_pkt_cnt, pkt_cnt, add);
+        Accumulate(_unref_scr_pids, scrambled, add);
+    }
+    else if (pc.stat_services.empty()) {
+        // Count global PID's
+        Accumulate(_global_pid_cnt, used, add);
+        Accumulate(_global_pkt_cnt, pkt_cnt, add);
+        Accumulate(_global_scr_pids, scrambled, add);
+    }
+
+    // If the PID belongs to some services, update services info.
+    for (ServiceIdSet::const_iterator it = pc.stat_services.begin(); it != pc.stat_services.end(); ++it) {
+        ServiceContext& sc(writableService(_services[*it], *it));
+        const bool was_scrambled = sc.scrambled_pid_cnt > 0;
+        Accumulate(sc.pid_cnt, 1, add);
+        Accumulate(sc.ts_pkt_cnt, pkt_cnt, add);
+        Accumulate(sc.scrambled_pid_cnt, pc.stat_scrambled ? 1 : 0, add);
+        // Count scrambled services
+        if (was_scrambled != (sc.scrambled_pid_cnt > 0)) {
+            Accumulate(_scrambled_services_cnt, 1, !was_scrambled);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Update the contribution of a PID to the statistics.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::updatePIDStatistics(PIDContext& pc)
+{
+    if (pc.stat_referenced != pc.referenced || pc.stat_scrambled != pc.scrambled || pc.stat_services != pc.services) {
+        accountPID(pc, false);
+        pc.stat_referenced = pc.referenced;
+        pc.stat_scrambled = pc.scrambled;
+        pc.stat_services = pc.services;
+        accountPID(pc, true);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Update the contribution of all PID's which were modified by the signalization.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::updatePendingStatistics()
+{
+    for (std::vector<PID>::const_iterator it = _pending_pids.begin(); it != _pending_pids.end(); ++it) {
+        // The PID context was made modifiable by getPID() and no snapshot was taken since.
+        PIDContext& pc(*_pids[*it]);
+        updatePIDStatistics(pc);
+        pc.stat_pending = false;
+    }
+    _pending_pids.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Count one more TS packet in a PID and in the statistics.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::countPIDPacket(PIDContext& pc)
+{
+    const bool first = pc.ts_pkt_cnt++ == 0;
+
+    if (first) {
+        _pid_cnt++;
+    }
+    if (!pc.stat_referenced) {
+        _unref_pkt_cnt++;
+        if (first) {
+            _unref_pid_cnt++;
+            _unref_scr_pids += pc.stat_scrambled ? 1 : 0;
+        }
+    }
+    else if (pc.stat_services.empty()) {
+        _global_pkt_cnt++;
+        if (first) {
+            _global_pid_cnt++;
+            _global_scr_pids += pc.stat_scrambled ? 1 : 0;
+        }
+    }
+    for (ServiceIdSet::const_iterator it = pc.stat_services.begin(); it != pc.stat_services.end(); ++it) {
+        writableService(_services[*it], *it).ts_pkt_cnt++;
     }
 }
 
@@ -488,6 +670,107 @@ void ts::TSAnalyzer::PIDContext::addService(uint16_t service_id)
 }
 
 
+//----------------------------------------------------------------------------
+// Add an audio or video attribute to a PID.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::addAttribute(PIDContext& pc, const UString& attribute)
+{
+    // In bounded-memory mode, keep only the most recent attributes.
+    if (AppendUnique(pc.attributes, attribute) && _idle_eviction > 0 && pc.attributes.size() > MAX_PID_ATTRIBUTES) {
+        pc.attributes.erase(pc.attributes.begin(), pc.attributes.end() - MAX_PID_ATTRIBUTES);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// In bounded-memory mode, remove the PID's, tables and services which are idle.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::evictIdleContexts()
+{
+    // Contexts which were not seen since this packet index are idle.
+    if (_ts_pkt_cnt <= _idle_eviction) {
+        return;
+    }
+    const uint64_t limit = _ts_pkt_cnt - _idle_eviction;
+
+    // Services with at least one non-idle PID.
+    ServiceIdSet active_services;
+    for (PIDContextMap::const_iterator it = _pids.begin(); it != _pids.end(); ++it) {
+        if (it->second->last_seen_pkt >= limit) {
+            active_services.insert(it->second->services.begin(), it->second->services.end());
+        }
+    }
+
+    // Remove idle PID's and idle tables.
+    bool evicted_components = false;
+    for (PIDContextMap::iterator it = _pids.begin(); it != _pids.end(); ) {
+        const PID pid = it->first;
+        const PIDContext& pc(*it->second);
+        bool evict = pid > PID_SIT && pc.last_seen_pkt < limit && (!pc.referenced || !pc.services.empty());
+        for (ServiceIdSet::const_iterator srv = pc.services.begin(); evict && srv != pc.services.end(); ++srv) {
+            evict = active_services.count(*srv) == 0;
+        }
+        if (evict) {
+            // Remove the contribution of the PID to the statistics.
+            accountPID(pc, false);
+            if (pc.scrambled) {
+                _scrambled_pid_cnt--;
+            }
+            if (pc.pcr_cnt > 0) {
+                _pcr_pid_cnt--;
+            }
+            evicted_components = evicted_components || pc.referenced;
+            // Keep the PID filters but forget the demux contexts.
+            _demux.resetPID(pid);
+            _pes_demux.resetPID(pid);
+            _t2mi_demux.resetPID(pid);
+            it = _pids.erase(it);
+            continue;
+        }
+        // Check idle tables first to avoid duplicating a context which is shared with a snapshot.
+        bool idle_tables = false;
+        for (ETIDContextMap::const_iterator etc = pc.sections.begin(); !idle_tables && etc != pc.sections.end(); ++etc) {
+            idle_tables = etc->second->last_seen_pkt < limit;
+        }
+        if (idle_tables) {
+            ETIDContextMap& sections(writablePID(it->second, pid).sections);
+            for (ETIDContextMap::iterator etc = sections.begin(); etc != sections.end(); ) {
+                if (etc->second->last_seen_pkt < limit) {
+                    etc = sections.erase(etc);
+                }
+                else {
+                    ++etc;
+                }
+            }
+        }
+        ++it;
+    }
+
+    // If PID's of services were removed and reappear later, they must be referenced again.
+    // Force the demux to analyze the next PAT and PMT's, even if their versions are unchanged.
+    if (evicted_components) {
+        _demux.resetPID(PID_PAT);
+        for (PIDContextMap::const_iterator it = _pids.begin(); it != _pids.end(); ++it) {
+            if (it->second->is_pmt_pid) {
+                _demux.resetPID(it->first);
+            }
+        }
+    }
+
+    // Remove idle services without PID.
+    for (ServiceContextMap::iterator it = _services.begin(); it != _services.end(); ) {
+        if (it->second->pid_cnt == 0 && it->second->last_seen_pkt < limit) {
+            it = _services.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // This hook is invoked when a complete section is available.
 // Implementation of SectionHandlerInterface
@@ -500,6 +783,7 @@ void ts::TSAnalyzer::handleSection(SectionDemux&, const Section& section)
 
     // Count one section
     etc->section_count++;
+    etc->last_seen_pkt = _ts_pkt_cnt;
 
     // Section# 0 is used to track tables
     if (section.sectionNumber() == 0) {
@@ -559,24 +843,17 @@ void ts::TSAnalyzer::handleTable(SectionDemux&, const BinaryTable& table)
             break;
         }
         case TID_CAT: {
-            CAT cat(table);
-            if (pid == PID_CAT && cat.isValid()) {
-                analyzeCAT(cat);
+            if (pid == PID_CAT) {
+                analyzeCAT(table);
             }
             break;
         }
         case TID_PMT: {
-            PMT pmt(table);
-            if (pmt.isValid()) {
-                analyzePMT(pid, pmt);
-            }
+            analyzePMT(pid, table);
             break;
         }
         case TID_SDT_ACT: {
-            SDT sdt(table);
-            if (sdt.isValid()) {
-                analyzeSDT(sdt);
-            }
+            analyzeSDT(table);
             break;
         }
         case TID_TDT: {
@@ -633,10 +910,13 @@ void ts::TSAnalyzer::analyzePAT(const PAT& pat)
 // Analyze a CAT
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::analyzeCAT(const CAT& cat)
+void ts::TSAnalyzer::analyzeCAT(const BinaryTable& table)
 {
     // Analyze the CA descritors to find EMM PIDs
-    analyzeDescriptors(cat.descs);
+    for (size_t si = 0; si < table.sectionCount(); ++si) {
+        const Section& sect(*table.sectionAt(si));
+        analyzeDescriptors(DescriptorListView(sect.payload(), sect.payloadSize()));
+    }
 }
 
 
@@ -644,52 +924,66 @@ void ts::TSAnalyzer::analyzeCAT(const CAT& cat)
 // Analyze a PMT
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::analyzePMT(PID pid, const PMT& pmt)
+void ts::TSAnalyzer::analyzePMT(PID pid, const BinaryTable& table)
 {
+    // Get a view on the first section. A PMT is not allowed to use more than one
+    // section (see ISO/IEC 13818-1:2000 2.4.4.8 & 2.4.4.9) but we process all of them.
+    uint16_t service_id = 0;
+    PID pcr_pid = PID_NULL;
+    DescriptorListView descs;
+    if (table.sectionCount() == 0 || !PMT::GetView(*table.sectionAt(0), service_id, pcr_pid, descs, _pmt_streams)) {
+        return;
+    }
+
     // Count the number of PMT's on this PID
     PIDContextPtr ps(getPID(pid));
     ps->pmt_cnt++;
 
     // Get service description
-    ServiceContextPtr svp(getService(pmt.service_id));
+    ServiceContextPtr svp(getService(service_id));
 
     // Check that this PMT was expected on this PID
     if (svp->pmt_pid != pid) {
         // PAT/PMT inconsistency: Found a PMT on a PID which was not
         // referenced as a PMT PID in the PAT.
-        ps->addService(pmt.service_id);
+        ps->addService(service_id);
         ps->description = u"PMT";
     }
 
-    // Locate PCR PID
-    if (pmt.pcr_pid != 0 && pmt.pcr_pid != PID_NULL) {
-        svp->pcr_pid = pmt.pcr_pid;
-        // This PID is the PCR PID for this service. Initial description
-        // will normally be replaced later by "Audio", "Video", etc.
-        // Some encoders, however, generate a dedicated PID for PCR's.
-        ps = getPID(pmt.pcr_pid, u"PCR (not otherwise referenced)");
-        ps->is_pcr_pid = true;
-        ps->addService(pmt.service_id);
-    }
-
-    // Process "program info" list of descriptors.
-    analyzeDescriptors(pmt.descs, svp.pointer());
-
-    // Process all "elementary stream info"
-    for (PMT::StreamMap::const_iterator it = pmt.streams.begin(); it != pmt.streams.end(); ++it) {
-        const PID es_pid = it->first;
-        const PMT::Stream& stream(it->second);
-        ps = getPID(es_pid);
-        ps->addService(pmt.service_id);
-        ps->carry_audio = ps->carry_audio || IsAudioST(stream.stream_type);
-        ps->carry_video = ps->carry_video || IsVideoST(stream.stream_type);
-        ps->carry_pes = ps->carry_pes || IsPES(stream.stream_type);
-        if (!ps->carry_section && !ps->carry_t2mi && IsSectionST(stream.stream_type)) {
-            ps->carry_section = true;
-            _demux.addPID(es_pid);
+    for (size_t si = 0; si < table.sectionCount(); ++si) {
+
+        if (si > 0 && !PMT::GetView(*table.sectionAt(si), service_id, pcr_pid, descs, _pmt_streams)) {
+            continue;
+        }
+
+        // Locate PCR PID
+        if (pcr_pid != 0 && pcr_pid != PID_NULL) {
+            svp->pcr_pid = pcr_pid;
+            // This PID is the PCR PID for this service. Initial description
+            // will normally be replaced later by "Audio", "Video", etc.
+            // Some encoders, however, generate a dedicated PID for PCR's.
+            ps = getPID(pcr_pid, u"PCR (not otherwise referenced)");
+            ps->is_pcr_pid = true;
+            ps->addService(service_id);
+        }
+
+        // Process "program info" list of descriptors.
+        analyzeDescriptors(descs, svp.pointer());
+
+        // Process all "elementary stream info"
+        for (PMT::StreamViewVector::const_iterator it = _pmt_streams.begin(); it != _pmt_streams.end(); ++it) {
+            ps = getPID(it->pid);
+            ps->addService(service_id);
+            ps->carry_audio = ps->carry_audio || IsAudioST(it->stream_type);
+            ps->carry_video = ps->carry_video || IsVideoST(it->stream_type);
+            ps->carry_pes = ps->carry_pes || IsPES(it->stream_type);
+            if (!ps->carry_section && !ps->carry_t2mi && IsSectionST(it->stream_type)) {
+                ps->carry_section = true;
+                _demux.addPID(it->pid);
+            }
+            ps->description = names::StreamType(it->stream_type);
+            analyzeDescriptors(it->descs, svp.pointer(), ps.pointer());
         }
-        ps->description = names::StreamType(stream.stream_type);
-        analyzeDescriptors(stream.descs, svp.pointer(), ps.pointer());
     }
 }
 
@@ -698,23 +992,32 @@ void ts::TSAnalyzer::analyzePMT(PID pid, const PMT& pmt)
 // Analyze an SDT
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::analyzeSDT(const SDT& sdt)
+void ts::TSAnalyzer::analyzeSDT(const BinaryTable& table)
 {
-    // Register characteristics of all services
-    for (SDT::ServiceMap::const_iterator it = sdt.services.begin(); it != sdt.services.end(); ++it) {
-
-        ServiceContextPtr svp(getService(it->first)); // it->first = map key = service id
-        svp->orig_netw_id = sdt.onetw_id;
-        svp->service_type = it->second.serviceType();
-
-        // Replace names only if they are not empty.
-        const UString provider(it->second.providerName(_default_charset));
-        const UString name(it->second.serviceName(_default_charset));
-        if (!provider.empty()) {
-            svp->provider = provider;
+    uint16_t ts_id = 0;
+    uint16_t onetw_id = 0;
+
+    for (size_t si = 0; si < table.sectionCount(); ++si) {
+        if (!SDT::GetView(*table.sectionAt(si), ts_id, onetw_id, _sdt_services)) {
+            continue;
         }
-        if (!name.empty()) {
-            svp->name = name;
+
+        // Register characteristics of all services
+        for (SDT::ServiceViewVector::const_iterator it = _sdt_services.begin(); it != _sdt_services.end(); ++it) {
+
+            ServiceContextPtr svp(getService(it->service_id));
+            svp->orig_netw_id = onetw_id;
+            svp->service_type = it->serviceType();
+
+            // Replace names only if they are not empty.
+            const UString provider(it->providerName(_default_charset));
+            const UString name(it->serviceName(_default_charset));
+            if (!provider.empty()) {
+                svp->provider = provider;
+            }
+            if (!name.empty()) {
+                svp->name = name;
+            }
         }
     }
 }
@@ -789,16 +1092,16 @@ ts::UString ts::TSAnalyzer::PIDContext::fullDescription(bool include_attributes)
 //  If ps is not 0, we are in the description of this PID in a PMT.
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::analyzeDescriptors(const DescriptorList& descs, ServiceContext* svp, PIDContext* ps)
+void ts::TSAnalyzer::analyzeDescriptors(const DescriptorListView& descs, ServiceContext* svp, PIDContext* ps)
 {
-    for (size_t di = 0; di < descs.count(); ++di) {
+    for (DescriptorListView::const_iterator it = descs.begin(); it != descs.end(); ++it) {
 
-        const uint8_t* data(descs[di]->payload());
-        size_t size(descs[di]->payloadSize());
+        const uint8_t* data(it->payload());
+        size_t size(it->payloadSize());
 
-        switch (descs[di]->tag()) {
+        switch (it->tag()) {
             case DID_CA: {
-                analyzeCADescriptor(*descs[di], svp, ps);
+                analyzeCADescriptor(*it, svp, ps);
                 break;
             }
             case DID_LANGUAGE: {
@@ -856,7 +1159,7 @@ void ts::TSAnalyzer::analyzeDescriptors(const DescriptorList& descs, ServiceCont
                     uint8_t type = data[3];
                     ps->description = u"Subtitles";
                     ps->comment = ps->language;
-                    AppendUnique(ps->attributes, names::SubtitlingType(type));
+                    addAttribute(*ps, names::SubtitlingType(type));
                 }
                 break;
             }
@@ -868,7 +1171,7 @@ void ts::TSAnalyzer::analyzeDescriptors(const DescriptorList& descs, ServiceCont
                     uint8_t type(data[3] >> 3);
                     ps->description = u"Teletext";
                     ps->comment = ps->language;
-                    AppendUnique(ps->attributes, names::TeletextType(type));
+                    addAttribute(*ps, names::TeletextType(type));
                 }
                 break;
             }
@@ -963,7 +1266,7 @@ void ts::TSAnalyzer::analyzeDescriptors(const DescriptorList& descs, ServiceCont
 //  If svp is 0, we are in the CAT.
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::analyzeCADescriptor(const Descriptor& desc, ServiceContext* svp, PIDContext* ps)
+void ts::TSAnalyzer::analyzeCADescriptor(const DescriptorView& desc, ServiceContext* svp, PIDContext* ps)
 {
     const uint8_t* data(desc.payload());
     size_t size(desc.payloadSize());
@@ -1139,7 +1442,7 @@ void ts::TSAnalyzer::analyzeCADescriptor(const Descriptor& desc, ServiceContext*
 
 void ts::TSAnalyzer::handleNewAudioAttributes(PESDemux&, const PESPacket& pkt, const AudioAttributes& attr)
 {
-    AppendUnique(getPID(pkt.getSourcePID())->attributes, attr.toString());
+    addAttribute(*getPID(pkt.getSourcePID()), attr.toString());
 }
 
 
@@ -1150,7 +1453,7 @@ void ts::TSAnalyzer::handleNewAudioAttributes(PESDemux&, const PESPacket& pkt, c
 
 void ts::TSAnalyzer::handleNewAC3Attributes(PESDemux&, const PESPacket& pkt, const AC3Attributes& attr)
 {
-    AppendUnique(getPID(pkt.getSourcePID())->attributes, attr.toString());
+    addAttribute(*getPID(pkt.getSourcePID()), attr.toString());
 }
 
 
@@ -1161,7 +1464,7 @@ void ts::TSAnalyzer::handleNewAC3Attributes(PESDemux&, const PESPacket& pkt, con
 
 void ts::TSAnalyzer::handleNewVideoAttributes(PESDemux&, const PESPacket& pkt, const VideoAttributes& attr)
 {
-    AppendUnique(getPID(pkt.getSourcePID())->attributes, attr.toString());
+    addAttribute(*getPID(pkt.getSourcePID()), attr.toString());
 }
 
 
@@ -1172,7 +1475,7 @@ void ts::TSAnalyzer::handleNewVideoAttributes(PESDemux&, const PESPacket& pkt, c
 
 void ts::TSAnalyzer::handleNewAVCAttributes(PESDemux&, const PESPacket& pkt, const AVCAttributes& attr)
 {
-    AppendUnique(getPID(pkt.getSourcePID())->attributes, attr.toString());
+    addAttribute(*getPID(pkt.getSourcePID()), attr.toString());
 }
 
 
@@ -1219,7 +1522,7 @@ void ts::TSAnalyzer::handleT2MIPacket(T2MIDemux& demux, const T2MIPacket& pkt)
         pc->t2mi_plp_ts[pkt.plp()];
 
         // Add the PLP as attributes of this PID.
-        AppendUnique(pc->attributes, UString::Format(u"PLP: 0x%X (%d)", {pkt.plp(), pkt.plp()}));
+        addAttribute(*pc, UString::Format(u"PLP: 0x%X (%d)", {pkt.plp(), pkt.plp()}));
     }
 }
 
@@ -1295,9 +1598,21 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     _pes_demux.feedPacket(pkt);
     _t2mi_demux.feedPacket(pkt);
 
-    // Get PID context
-    PIDContextPtr ps(getPID(pkt.getPID()));
-    ps->ts_pkt_cnt++;
+    // Take into account the signalization which was analyzed by the demux.
+    if (!_pending_pids.empty()) {
+        updatePendingStatistics();
+    }
+
+    // In bounded-memory mode, periodically remove the idle contexts.
+    if (_idle_eviction > 0 && _ts_pkt_cnt >= _next_eviction) {
+        evictIdleContexts();
+        _next_eviction = _ts_pkt_cnt + std::max<PacketCounter>(_idle_eviction / 4, 1);
+    }
+
+    // Get PID context, count TS packets in the PID and in the statistics.
+    PIDContext* const ps = &writablePID(_pids[pkt.getPID()], pkt.getPID());
+    countPIDPacket(*ps);
+    ps->last_seen_pkt = packet_index;
 
     // Accumulate stat from packet
     if (pkt.hasAF()) {
@@ -1314,6 +1629,7 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     if (pkt.getScrambling() != SC_CLEAR && !ps->scrambled) {
         ps->scrambled = true;
         _scrambled_pid_cnt++;
+        updatePIDStatistics(*ps);
     }
     if (pkt.getScrambling() == SC_DVB_RESERVED) {
         ps->inv_ts_sc_cnt++;
@@ -1468,9 +1784,14 @@ void ts::TSAnalyzer::recomputeStatistics()
         return;
     }
 
-    // Store "last" system times
-    _last_utc = Time::CurrentUTC();
-    _last_local = Time::CurrentLocalTime();
+    // Take into account the last modifications of the signalization.
+    updatePendingStatistics();
+
+    // Store "last" system times. In a snapshot, these are the times of the snapshot.
+    if (!_is_snapshot) {
+        _last_utc = Time::CurrentUTC();
+        _last_local = Time::CurrentLocalTime();
+    }
 
     // Compute bitrate and broadcast duration
     _ts_pcr_bitrate_188 = _ts_bitrate_cnt == 0 ? 0 : BitRate(_ts_bitrate_sum / _ts_bitrate_cnt);
@@ -1478,25 +1799,10 @@ void ts::TSAnalyzer::recomputeStatistics()
     _ts_bitrate = _ts_user_bitrate != 0 ? _ts_user_bitrate : _ts_pcr_bitrate_188;
     _duration = _ts_bitrate == 0 ? 0 : (8000 * PKT_SIZE * uint64_t(_ts_pkt_cnt)) / _ts_bitrate;
 
-    // Reinitialize all service information that will be updated PID by PID
-    for (ServiceContextMap::iterator it = _services.begin(); it != _services.end(); ++it) {
-        it->second->pid_cnt = 0;
-        it->second->ts_pkt_cnt = 0;
-        it->second->scrambled_pid_cnt = 0;
-    }
-
-    // Complete all PID information
-
-    _pid_cnt = 0;
-    _global_pid_cnt = 0;
-    _global_pkt_cnt = 0;
-    _global_scr_pids = 0;
-    _unref_pid_cnt = 0;
-    _unref_pkt_cnt = 0;
-    _unref_scr_pids = 0;
-
+    // Complete all PID information.
+    // The packet counts were maintained while analyzing the packets.
     for (PIDContextMap::iterator pci = _pids.begin(); pci != _pids.end(); ++pci) {
-        PIDContext& pc(*pci->second);
+        PIDContext& pc(writablePID(pci->second, pci->first));
 
         // Compute TS bitrate from the PCR's of this PID
         if (pc.ts_bitrate_cnt != 0) {
@@ -1514,41 +1820,8 @@ void ts::TSAnalyzer::recomputeStatistics()
             pc.crypto_period = pc.cryptop_ts_cnt / (pc.cryptop_cnt - 1);
         }
 
-        // If the PID belongs to some services, update services info.
-        for (ServiceIdSet::iterator it = pc.services.begin(); it != pc.services.end(); ++it) {
-            ServiceContextPtr scp(getService(*it));
-            scp->pid_cnt++;
-            scp->ts_pkt_cnt += pc.ts_pkt_cnt;
-            if (pc.scrambled) {
-                scp->scrambled_pid_cnt++;
-            }
-        }
-
         // Enforce PES when carrying audio or video
         pc.carry_pes = pc.carry_pes || pc.carry_audio || pc.carry_video;
-
-        // Count non-empty PID's
-        if (pc.ts_pkt_cnt != 0) {
-            _pid_cnt++;
-        }
-
-        // Count unreferenced PID's
-        if (!pc.referenced && pc.ts_pkt_cnt != 0) {
-            _unref_pid_cnt++;
-            _unref_pkt_cnt += pc.ts_pkt_cnt;
-            if (pc.scrambled) {
-                _unref_scr_pids++;
-            }
-        }
-
-        // Count global PID's
-        if (pc.referenced && pc.services.size() == 0 && pc.ts_pkt_cnt != 0) {
-            _global_pid_cnt++;
-            _global_pkt_cnt += pc.ts_pkt_cnt;
-            if (pc.scrambled) {
-                _global_scr_pids++;
-            }
-        }
     }
 
     // Complete unreferenced and global PID's bitrates
@@ -1558,21 +1831,15 @@ void ts::TSAnalyzer::recomputeStatistics()
     }
 
     // Complete all service information
-    _scrambled_services_cnt = 0;
-
     for (ServiceContextMap::iterator sci = _services.begin(); sci != _services.end(); ++sci) {
-
-        // Count scrambled services
-        if (sci->second->scrambled_pid_cnt > 0) {
-            _scrambled_services_cnt++;
-        }
+        ServiceContext& sc(writableService(sci->second, sci->first));
 
         // Compute average service bitrate
         if (_ts_pkt_cnt == 0) {
-            sci->second->bitrate = 0;
+            sc.bitrate = 0;
         }
         else {
-            sci->second->bitrate = uint32_t((uint64_t(_ts_bitrate) * uint64_t(sci->second->ts_pkt_cnt)) / uint64_t(_ts_pkt_cnt));
+            sc.bitrate = uint32_t((uint64_t(_ts_bitrate) * uint64_t(sc.ts_pkt_cnt)) / uint64_t(_ts_pkt_cnt));
         }
     }
 
@@ -1581,6 +1848,65 @@ void ts::TSAnalyzer::recomputeStatistics()
 }
 
 
+//----------------------------------------------------------------------------
+// Get a snapshot of the analysis results into another analyzer.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::getSnapshot(TSAnalyzer& snapshot)
+{
+    if (&snapshot == this) {
+        return;
+    }
+
+    // All contributions to the statistics must be up to date in the shared contexts.
+    updatePendingStatistics();
+
+    // From now on, all existing contexts are shared. Both analyzers switch to a new
+    // generation: a context from a previous generation is duplicated before modification.
+    _generation = snapshot._generation = std::max(_generation, snapshot._generation) + 1;
+
+    // Share the analysis contexts.
+    snapshot._pids = _pids;
+    snapshot._services = _services;
+    snapshot._pending_pids.clear();
+
+    // Copy the global analysis data.
+    snapshot._ts_id = _ts_id;
+    snapshot._ts_id_valid = _ts_id_valid;
+    snapshot._ts_pkt_cnt = _ts_pkt_cnt;
+    snapshot._invalid_sync = _invalid_sync;
+    snapshot._transport_errors = _transport_errors;
+    snapshot._suspect_ignored = _suspect_ignored;
+    snapshot._pid_cnt = _pid_cnt;
+    snapshot._scrambled_pid_cnt = _scrambled_pid_cnt;
+    snapshot._pcr_pid_cnt = _pcr_pid_cnt;
+    snapshot._global_pid_cnt = _global_pid_cnt;
+    snapshot._global_scr_pids = _global_scr_pids;
+    snapshot._global_pkt_cnt = _global_pkt_cnt;
+    snapshot._unref_pid_cnt = _unref_pid_cnt;
+    snapshot._unref_scr_pids = _unref_scr_pids;
+    snapshot._unref_pkt_cnt = _unref_pkt_cnt;
+    snapshot._ts_user_bitrate = _ts_user_bitrate;
+    snapshot._first_utc = _first_utc;
+    snapshot._first_local = _first_local;
+    snapshot._first_tdt = _first_tdt;
+    snapshot._last_tdt = _last_tdt;
+    snapshot._first_tot = _first_tot;
+    snapshot._last_tot = _last_tot;
+    snapshot._country_code = _country_code;
+    snapshot._scrambled_services_cnt = _scrambled_services_cnt;
+    snapshot._tid_present = _tid_present;
+    snapshot._ts_bitrate_sum = _ts_bitrate_sum;
+    snapshot._ts_bitrate_cnt = _ts_bitrate_cnt;
+
+    // The bitrates and durations are computed later in the snapshot, using the time of the snapshot.
+    snapshot._is_snapshot = true;
+    snapshot._last_utc = Time::CurrentUTC();
+    snapshot._last_local = Time::CurrentLocalTime();
+    snapshot._modified = true;
+}
+
+
 //----------------------------------------------------------------------------
 // Return the list of service ids
 //----------------------------------------------------------------------------
@@ -85,6 +85,24 @@ namespace ts {
         //!
         void reset();
 
+        //!
+        //! Get a snapshot of the analysis results into another analyzer.
+        //!
+        //! The analysis contexts of PID's, tables and services are shared between this
+        //! analyzer and the snapshot. They are duplicated only when one of the two analyzers
+        //! subsequently modifies them (copy-on-write). Therefore, taking a snapshot is fast,
+        //! regardless of the number of PID's and services in the transport stream.
+        //!
+        //! The snapshot is typically used to produce a report in another thread while this
+        //! analyzer continues to process packets. Each analyzer shall be used by only one
+        //! thread at a time. The snapshot shall not be fed with packets. Its "last system
+        //! time" is the time of the snapshot.
+        //!
+        //! @param [out] snapshot The analyzer which receives the analysis results.
+        //! Its previous analysis results are discarded.
+        //!
+        void getSnapshot(TSAnalyzer& snapshot);
+
         //!
         //! Specify a "bitrate hint" for the analysis.
         //! @param [in] bitrate_hint Optional bitrate "hint" for the analysis.
@@ -117,6 +135,42 @@ namespace ts {
             _max_consecutive_suspects = count;
         }
 
+        //!
+        //! Maximum number of audio or video attributes which are kept per PID in bounded-memory mode.
+        //!
+        static const size_t MAX_PID_ATTRIBUTES = 8;
+
+        //!
+        //! Set the bounded-memory mode, for long-running analysis such as 24/7 monitoring.
+        //!
+        //! By default, the analyzer keeps all PID's, tables and services which were ever found,
+        //! even after they disappeared from the transport stream, after a transponder change
+        //! for instance. In bounded-memory mode, the contexts of PID's, tables and services
+        //! which are idle during the specified number of packets are removed from the analysis.
+        //! Also, only the MAX_PID_ATTRIBUTES most recent audio or video attributes are kept per PID.
+        //!
+        //! - A PID is idle when it has no packet and no reference from the signalization.
+        //!   The PID's which belong to a service with at least one non-idle PID are kept.
+        //!   The PID's in the DVB reserved range (below 0x0020) and the PID's which are referenced
+        //!   outside services (EMM PID's from the CAT for instance) are never removed.
+        //! - A table (ETID) is idle when no section is received.
+        //! - A service is idle when it has no PID and no reference from the signalization.
+        //!
+        //! On a 64-bit system, with the GNU libstdc++, each PID uses approximately 750 bytes,
+        //! plus 150 bytes per table (ETID) on this PID, plus the attributes and descriptions
+        //! (typically less than 1 kB). Each service uses approximately 200 bytes plus its names.
+        //! The memory is consequently bounded by the number of PID's, tables and services
+        //! which are active during the idle period.
+        //!
+        //! @param [in] idle_packets Number of TS packets after which idle contexts are removed.
+        //! Zero means unbounded mode, the default.
+        //!
+        void setIdleEviction(PacketCounter idle_packets)
+        {
+            _idle_eviction = idle_packets;
+            _next_eviction = _ts_pkt_cnt + idle_packets;
+        }
+
         //!
         //! Set the default DVB character set to use (for incorrect signalization only).
         //! @param [in] charset The DVB character set to use when no charset code is
@@ -192,6 +246,10 @@ namespace ts {
             bool           carry_ssu;          //!< Carry System Software Update.
             bool           carry_t2mi;         //!< Carry T2-MI encasulated data.
 
+            // Public members - Analysis data:
+            uint64_t       last_seen_pkt;      //!< Packet index of the last reference in the signalization.
+            uint64_t       generation;         //!< Generation of the analyzer which can modify this context (copy-on-write).
+
             //!
             //! Default constructor.
             //! @param [in] serv_id Service id.
@@ -217,9 +275,9 @@ namespace ts {
         };
 
         //!
-        //! Safe pointer to a ServiceContext (not thread-safe).
+        //! Safe pointer to a ServiceContext (thread-safe, shared with snapshots).
         //!
-        typedef SafePtr<ServiceContext, NullMutex> ServiceContextPtr;
+        typedef SafePtr<ServiceContext, AtomicRefCount> ServiceContextPtr;
 
         //!
         //! Map of ServiceContext, indexed by service id.
@@ -257,6 +315,7 @@ namespace ts {
             // Public members - Analysis data: Repetition interval evaluation:
             uint64_t   first_pkt;                 //!< Last packet index of first section# 0.
             uint64_t   last_pkt;                  //!< Last packet index of last section# 0.
+            uint64_t   last_seen_pkt;             //!< Last packet index of any section.
 
             //!
             //! Default constructor.
@@ -271,9 +330,9 @@ namespace ts {
         };
 
         //!
-        //! Safe pointer to an ETIDContext (not thread-safe).
+        //! Safe pointer to an ETIDContext (thread-safe, shared with snapshots).
         //!
-        typedef SafePtr<ETIDContext, NullMutex> ETIDContextPtr;
+        typedef SafePtr<ETIDContext, AtomicRefCount> ETIDContextPtr;
 
         //!
         //! Map of ETIDContext, indexed by ETID.
@@ -347,6 +406,14 @@ namespace ts {
             uint64_t       last_pcr_pkt;    //!< Index of packet with last PCR.
             uint64_t       ts_bitrate_sum;  //!< Sum of all computed TS bitrates.
             uint64_t       ts_bitrate_cnt;  //!< Number of computed TS bitrates.
+            uint64_t       last_seen_pkt;   //!< Index of last packet or last reference in the signalization.
+            // Public members - Analysis data: Contribution to the global and service statistics:
+            bool           stat_pending;    //!< Modified by the signalization, the contribution shall be updated.
+            bool           stat_referenced; //!< Value of @a referenced in the statistics.
+            bool           stat_scrambled;  //!< Value of @a scrambled in the statistics.
+            ServiceIdSet   stat_services;   //!< Value of @a services in the statistics.
+            // Public members - Analysis data: Copy-on-write management:
+            uint64_t       generation;      //!< Generation of the analyzer which can modify this context.
 
             //!
             //! Default constructor.
@@ -379,9 +446,9 @@ namespace ts {
         };
 
         //!
-        //! Safe pointer to a PIDContext (not thread-safe).
+        //! Safe pointer to a PIDContext (thread-safe, shared with snapshots).
         //!
-        typedef SafePtr<PIDContext, NullMutex> PIDContextPtr;
+        typedef SafePtr<PIDContext, AtomicRefCount> PIDContextPtr;
 
         //!
         //! Map of PIDContext, indexed by PID.
@@ -396,6 +463,8 @@ namespace ts {
 
         //!
         //! Update the global statistics value if internal data were modified.
+        //! The packet counts are maintained while the packets are analyzed.
+        //! Only the bitrates and the durations are recomputed here.
         //!
         void recomputeStatistics();
 
@@ -446,32 +515,60 @@ namespace ts {
         bool pidExists(PID pid) const {return _pids.find(pid) != _pids.end();}
 
         // Return a PID context. Allocate a new entry if PID not found.
+        // The context is modifiable, it is not shared with a snapshot. Since the caller may
+        // change the references of the PID, its contribution to the statistics is updated later.
         PIDContextPtr getPID(PID pid, const UString& description = UNREFERENCED);
 
+        // Return a modifiable PID context from a map entry, duplicate it if shared with a snapshot.
+        PIDContext& writablePID(PIDContextPtr& ptr, PID pid, const UString& description = UNREFERENCED);
+
         // Return an ETID context. Allocate a new entry if ETID not found.
         ETIDContextPtr getETID(const Section&);
 
-        // Return a service context. Allocate a new entry if service not found.
+        // Return a modifiable service context. Allocate a new entry if service not found.
+        // The service is referenced by the signalization, it is not idle.
         ServiceContextPtr getService(uint16_t service_id);
 
+        // Return a modifiable service context from a map entry, duplicate it if shared with a snapshot.
+        ServiceContext& writableService(ServiceContextPtr& ptr, uint16_t service_id);
+
+        // Add or remove the contribution of a PID to the global and service statistics.
+        void accountPID(const PIDContext& pc, bool add);
+
+        // Update the contribution of a PID to the statistics after a change of its references.
+        void updatePIDStatistics(PIDContext& pc);
+
+        // Update the contribution of all PID's which were modified by the signalization.
+        void updatePendingStatistics();
+
+        // Count one more TS packet in a PID and in the statistics.
+        void countPIDPacket(PIDContext& pc);
+
+        // Add an audio or video attribute to a PID.
+        void addAttribute(PIDContext& pc, const UString& attribute);
+
+        // In bounded-memory mode, remove the PID's, tables and services which are idle.
+        void evictIdleContexts();
+
         // Analyze the various PSI tables
         void analyzePAT(const PAT&);
-        void analyzeCAT(const CAT&);
-        void analyzePMT(PID pid, const PMT&);
-        void analyzeSDT(const SDT&);
+        // The CAT, PMT and SDT are analyzed using non-owning views, without deserialization.
+        void analyzeCAT(const BinaryTable&);
+        void analyzePMT(PID pid, const BinaryTable&);
+        void analyzeSDT(const BinaryTable&);
         void analyzeTDT(const TDT&);
         void analyzeTOT(const TOT&);
 
         // Analyse a list of descriptors.
         // If svp is not 0, we are in the PMT of the specified service.
         // If ps is not 0, we are in the description of this PID in a PMT.
-        void analyzeDescriptors(const DescriptorList& descs, ServiceContext* svp = 0, PIDContext* ps = 0);
+        void analyzeDescriptors(const DescriptorListView& descs, ServiceContext* svp = 0, PIDContext* ps = 0);
 
         // Analyse one CA descriptor, either from the CAT or a PMT.
         // If svp is not 0, we are in the PMT of the specified service.
         // If ps is not 0, we are in the description of this PID in a PMT.
         // If svp is 0, we are in the CAT.
-        void analyzeCADescriptor(const Descriptor& desc, ServiceContext* svp = 0, PIDContext* ps = 0);
+        void analyzeCADescriptor(const DescriptorView& desc, ServiceContext* svp = 0, PIDContext* ps = 0);
 
         // Implementation of TableHandlerInterface
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
@@ -492,6 +589,11 @@ namespace ts {
 
         // TSAnalyzer private members (state data, used during analysis):
         bool              _modified;                  // Internal data modified, need recomputeStatistics
+        bool              _is_snapshot;               // Snapshot of another analyzer, system times are frozen
+        uint64_t          _generation;                // Contexts from another generation are shared with a snapshot
+        std::vector<PID>  _pending_pids;              // PID's with stat_pending set
+        PacketCounter     _idle_eviction;             // Number of packets before removing idle contexts, zero if unbounded
+        PacketCounter     _next_eviction;             // Packet index of next removal of idle contexts
         uint64_t          _ts_bitrate_sum;            // Sum of all computed TS bitrates
         uint64_t          _ts_bitrate_cnt;            // Number of computed TS bitrates
         uint64_t          _preceding_errors;          // Number of contiguous invalid packets before current packet
@@ -502,6 +604,8 @@ namespace ts {
         SectionDemux      _demux;                     // PSI tables analysis
         PESDemux          _pes_demux;                 // Audio/video analysis
         T2MIDemux         _t2mi_demux;                // T2-MI analysis
+        PMT::StreamViewVector  _pmt_streams;          // Reused views of PMT streams
+        SDT::ServiceViewVector _sdt_services;         // Reused views of SDT services
 
         // Inaccessible operations.
         TSAnalyzer(const TSAnalyzer&) = delete;
@@ -55,6 +55,15 @@ void ts::TSAnalyzerOptions::setHelp(const UString& help)
         u"      forces a non-standard character table. The available table names are:\n"
         u"      " + UString::Join(DVBCharset::GetAllNames()).toSplitLines(74, UString(), UString(6, SPACE)) + u".\n"
         u"\n"
+        u"  --evict-idle count\n"
+        u"      Bounded-memory mode for long-running analysis, such as 24/7 monitoring.\n"
+        u"      The PID's, tables and services which are idle during the specified number\n"
+        u"      of TS packets are removed from the analysis. A PID is idle when it has no\n"
+        u"      packet and is not referenced by the signalization. The PID's of a service\n"
+        u"      are kept as long as the service has at least one non-idle PID. The global\n"
+        u"      PID's are never removed. By default, all PID's, tables and services which\n"
+        u"      were ever found are kept until the end of the analysis.\n"
+        u"\n"
         u"  --suspect-max-consecutive value\n"
         u"      Specifies the maximum number of consecutive \"suspect\" packets.\n"
         u"      The default value is 1. If set to zero, the suspect packet detection\n"
@@ -169,6 +178,7 @@ ts::TSAnalyzerOptions::TSAnalyzerOptions(const UString& description, const UStri
     title(),
     suspect_min_error_count(1),
     suspect_max_consecutive(1),
+    idle_eviction(0),
     default_charset(0)
 {
     setHelp(help);
@@ -189,6 +199,7 @@ ts::TSAnalyzerOptions::TSAnalyzerOptions(const UString& description, const UStri
     option(u"title", 0, STRING);
     option(u"suspect-min-error-count", 0, UNSIGNED);
     option(u"suspect-max-consecutive", 0, UNSIGNED);
+    option(u"evict-idle", 0, POSITIVE);
     option(u"default-charset", 0, STRING);
 }
 
@@ -217,6 +228,7 @@ void ts::TSAnalyzerOptions::getOptions(Args& args)
     title = args.value(u"title");
     suspect_min_error_count = args.intValue<uint64_t>(u"suspect-min-error-count", 1);
     suspect_max_consecutive = args.intValue<uint64_t>(u"suspect-max-consecutive", 1);
+    idle_eviction = args.intValue<uint64_t>(u"evict-idle", 0);
 
     // Get default DVB character set.
     const UString csName(args.value(u"default-charset"));
@@ -102,6 +102,9 @@ namespace ts {
         uint64_t suspect_min_error_count;  //!< Option -\-suspect-min-error-count
         uint64_t suspect_max_consecutive;  //!< Option -\-suspect-max-consecutive
 
+        // Bounded-memory mode
+        uint64_t idle_eviction;            //!< Option -\-evict-idle
+
         // Table analysis options
         const DVBCharset* default_charset;  //!< Option -\-default-charset
 
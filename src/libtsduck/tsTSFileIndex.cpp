@@ -0,0 +1,393 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Sidecar index of a transport stream file, for time-based seeking.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSFileIndex.h"
+#include "tsByteBlock.h"
+#include "tsMJD.h"
+TSDUCK_SOURCE;
+
+const ts::UChar* const ts::TSFileIndex::DEFAULT_SUFFIX = u".tsidx";
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const ts::MilliSecond ts::TSFileIndex::DEFAULT_INTERVAL;
+#endif
+
+namespace {
+    // Binary format of index files. All integers are big endian.
+    // Header (32 bytes): "TSIX", version (1 byte), reserved (1 byte), PCR PID (2 bytes),
+    // interval (4 bytes), duration (4 bytes), packet count (8 bytes), entry count (8 bytes).
+    // Entry (23 bytes): type (1 byte), PID (2 bytes), packet (8 bytes), elapsed (4 bytes), value (8 bytes).
+    const char   INDEX_MAGIC[4] = {'T', 'S', 'I', 'X'};
+    const uint8_t INDEX_VERSION = 1;
+    const size_t INDEX_HEADER_SIZE = 32;
+    const size_t INDEX_ENTRY_SIZE = 23;
+
+    // PCR values wrap up after 2**33 system clock units at 90 kHz.
+    const uint64_t PCR_WRAP = ts::PTS_DTS_SCALE * ts::SYSTEM_CLOCK_SUBFACTOR;
+
+    // Max gap between two consecutive PCR's, above it is a discontinuity.
+    const uint64_t MAX_PCR_GAP = 10 * uint64_t(ts::SYSTEM_CLOCK_FREQ);
+
+    // System clock units per millisecond.
+    const uint64_t PCR_PER_MS = ts::SYSTEM_CLOCK_FREQ / 1000;
+
+    // When seeking to a start position, max distance to look back for a random access point.
+    const ts::MilliSecond MAX_RAP_DISTANCE = 10000;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TSFileIndex::TSFileIndex(MilliSecond interval) :
+    _interval(interval),
+    _entries(),
+    _packet_count(0),
+    _pcr_pid(PID_NULL),
+    _last_pcr(INVALID_PCR),
+    _ext_pcr(0),
+    _elapsed(0),
+    _last_sample(0),
+    _last_rap(),
+    _rai_pids(),
+    _versions(),
+    _demux(0, this)
+{
+    clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the index content.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::clear()
+{
+    _entries.clear();
+    _packet_count = 0;
+    _pcr_pid = PID_NULL;
+    _last_pcr = INVALID_PCR;
+    _ext_pcr = 0;
+    _elapsed = 0;
+    _last_sample = 0;
+    _last_rap.clear();
+    _rai_pids.reset();
+    _versions.clear();
+    _demux.reset();
+    _demux.setPIDFilter(NoPID);
+    _demux.addPID(PID_PAT);
+    _demux.addPID(PID_CAT);
+    _demux.addPID(PID_NIT);
+    _demux.addPID(PID_SDT);
+    _demux.addPID(PID_TDT);
+}
+
+
+//----------------------------------------------------------------------------
+// Add an entry for the current packet.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::addEntry(EntryType type, PID pid, uint64_t value)
+{
+    const Entry e = {type, pid, _packet_count, _elapsed, value};
+    _entries.push_back(e);
+}
+
+
+//----------------------------------------------------------------------------
+// Feed the next packet of the file.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::feedPacket(const TSPacket& pkt)
+{
+    const PID pid = pkt.getPID();
+
+    // The reference PCR PID is the first one with PCR's.
+    if (pkt.hasPCR()) {
+        if (_pcr_pid == PID_NULL) {
+            _pcr_pid = pid;
+        }
+        if (pid == _pcr_pid) {
+            processPCR(pkt.getPCR());
+        }
+    }
+
+    // Random access points. A PES start is used only in PID's which never signal random access.
+    const bool rai = pkt.getRandomAccessIndicator();
+    if (rai) {
+        _rai_pids.set(pid);
+    }
+    if (pid != PID_NULL && (rai || (pkt.startPES() && !_rai_pids.test(pid)))) {
+        const std::map<PID, MilliSecond>::iterator it(_last_rap.find(pid));
+        if (it == _last_rap.end() || _elapsed >= it->second + _interval) {
+            addEntry(RAP_ENTRY, pid, rai ? 1 : 0);
+            _last_rap[pid] = _elapsed;
+        }
+    }
+
+    // PSI/SI analysis, may add entries for the current packet.
+    _demux.feedPacket(pkt);
+    _packet_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Process the PCR of the reference PID.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::processPCR(uint64_t pcr)
+{
+    // Add an entry for the first PCR and then at regular intervals.
+    bool sample = _last_pcr == INVALID_PCR;
+
+    if (!sample) {
+        // Compute the distance from the previous PCR, handle wrap up.
+        uint64_t diff = pcr >= _last_pcr ? pcr - _last_pcr : pcr + PCR_WRAP - _last_pcr;
+        // A PCR discontinuity does not change the elapsed time.
+        if (diff > MAX_PCR_GAP) {
+            diff = 0;
+        }
+        _ext_pcr += diff;
+        _elapsed = MilliSecond(_ext_pcr / PCR_PER_MS);
+        sample = _elapsed >= _last_sample + _interval;
+    }
+    _last_pcr = pcr;
+
+    if (sample) {
+        addEntry(PCR_ENTRY, _pcr_pid, pcr);
+        _last_sample = _elapsed;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked by the demux for each PSI/SI section.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::handleSection(SectionDemux& demux, const Section& section)
+{
+    const TID tid = section.tableId();
+    const PID pid = section.sourcePID();
+    const uint8_t* const payload = section.payload();
+    const size_t size = section.payloadSize();
+
+    if ((tid == TID_TDT || tid == TID_TOT) && size >= MJD_SIZE) {
+        // Time stamp from the TDT or TOT.
+        Time utc;
+        if (DecodeMJD(payload, MJD_SIZE, utc)) {
+            addEntry(UTC_ENTRY, pid, uint64_t(utc - Time::Epoch));
+        }
+    }
+    else if (section.isLongSection() && section.isCurrent()) {
+        // Record new versions of all long sections.
+        const uint64_t key = (uint64_t(pid) << 24) | (uint64_t(tid) << 16) | section.tableIdExtension();
+        const std::map<uint64_t, uint8_t>::iterator it(_versions.find(key));
+        if (it == _versions.end() || it->second != section.version()) {
+            _versions[key] = section.version();
+            addEntry(PSI_ENTRY, pid, (uint64_t(tid) << 24) | (uint64_t(section.tableIdExtension()) << 8) | section.version());
+        }
+        // Collect all PMT PID's from the PAT.
+        if (tid == TID_PAT) {
+            for (size_t i = 0; i + 4 <= size; i += 4) {
+                if (GetUInt16(payload + i) != 0) {
+                    _demux.addPID(GetUInt16(payload + i + 2) & 0x1FFF);
+                }
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Save the index in a binary file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::save(const UString& filename, Report& report) const
+{
+    ByteBlock data(INDEX_HEADER_SIZE + _entries.size() * INDEX_ENTRY_SIZE);
+    uint8_t* p = data.data();
+
+    ::memcpy(p, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    p[4] = INDEX_VERSION;
+    p[5] = 0;
+    PutUInt16(p + 6, _pcr_pid);
+    PutUInt32(p + 8, uint32_t(_interval));
+    PutUInt32(p + 12, uint32_t(_elapsed));
+    PutUInt64(p + 16, _packet_count);
+    PutUInt64(p + 24, _entries.size());
+    p += INDEX_HEADER_SIZE;
+
+    for (EntryVector::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+        p[0] = uint8_t(it->type);
+        PutUInt16(p + 1, it->pid);
+        PutUInt64(p + 3, it->packet);
+        PutUInt32(p + 11, uint32_t(it->elapsed));
+        PutUInt64(p + 15, it->value);
+        p += INDEX_ENTRY_SIZE;
+    }
+
+    return data.saveToFile(filename, &report);
+}
+
+
+//----------------------------------------------------------------------------
+// Load an index from a binary file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::load(const UString& filename, Report& report)
+{
+    clear();
+
+    ByteBlock data;
+    if (!data.loadFromFile(filename, std::numeric_limits<size_t>::max(), &report)) {
+        return false;
+    }
+
+    const uint8_t* p = data.data();
+    if (data.size() < INDEX_HEADER_SIZE || ::memcmp(p, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || p[4] != INDEX_VERSION) {
+        report.error(u"%s is not a valid TS index file", {filename});
+        return false;
+    }
+
+    const uint64_t count = GetUInt64(p + 24);
+    if (count != (data.size() - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE) {
+        report.error(u"invalid or truncated TS index file %s", {filename});
+        return false;
+    }
+
+    _pcr_pid = GetUInt16(p + 6);
+    _interval = GetUInt32(p + 8);
+    _elapsed = GetUInt32(p + 12);
+    _packet_count = GetUInt64(p + 16);
+    _entries.resize(size_t(count));
+    p += INDEX_HEADER_SIZE;
+
+    for (EntryVector::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+        it->type = EntryType(p[0]);
+        it->pid = GetUInt16(p + 1);
+        it->packet = GetUInt64(p + 3);
+        it->elapsed = GetUInt32(p + 11);
+        it->value = GetUInt64(p + 15);
+        p += INDEX_ENTRY_SIZE;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Find a position in the file from an elapsed time.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::findElapsed(MilliSecond elapsed, PacketCounter& packet, bool start) const
+{
+    if (elapsed < 0 || elapsed > _elapsed) {
+        return false;
+    }
+
+    if (!start) {
+        // Stop position: first PCR at or after the requested time.
+        for (EntryVector::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+            if (it->type == PCR_ENTRY && it->elapsed >= elapsed) {
+                packet = it->packet;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Start position: last PCR at or before the requested time.
+    EntryVector::const_iterator pcr(_entries.end());
+    for (EntryVector::const_iterator it = _entries.begin(); it != _entries.end() && it->elapsed <= elapsed; ++it) {
+        if (it->type == PCR_ENTRY) {
+            pcr = it;
+        }
+    }
+    if (pcr == _entries.end()) {
+        return false;
+    }
+
+    // Then move back to the last random access point before this PCR, preferably
+    // a signalled one (random_access_indicator), otherwise a PES start.
+    EntryVector::const_iterator rai(_entries.end());
+    EntryVector::const_iterator pes(_entries.end());
+    for (EntryVector::const_iterator it = _entries.begin(); it != _entries.end() && it->packet <= pcr->packet; ++it) {
+        if (it->type == RAP_ENTRY && it->elapsed + MAX_RAP_DISTANCE >= pcr->elapsed) {
+            (it->value != 0 ? rai : pes) = it;
+        }
+    }
+    packet = rai != _entries.end() ? rai->packet : (pes != _entries.end() ? pes->packet : pcr->packet);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Find a position in the file from a PCR value of the reference PCR PID.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::findPCR(uint64_t pcr, PacketCounter& packet, bool start) const
+{
+    // Look for a PCR entry which is followed by the requested PCR value
+    // before the next PCR entry (or before the end of file).
+    for (EntryVector::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->type == PCR_ENTRY && pcr >= it->value) {
+            EntryVector::const_iterator next(it + 1);
+            while (next != _entries.end() && next->type != PCR_ENTRY) {
+                ++next;
+            }
+            const MilliSecond end = next == _entries.end() ? _elapsed : next->elapsed;
+            const MilliSecond elapsed = it->elapsed + MilliSecond((pcr - it->value) / PCR_PER_MS);
+            if (elapsed <= end) {
+                return findElapsed(elapsed, packet, start);
+            }
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Find a position in the file from a UTC time.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::findUTC(const Time& utc, PacketCounter& packet, bool start) const
+{
+    // Locate the last TDT/TOT before the requested time.
+    EntryVector::const_iterator last(_entries.end());
+    for (EntryVector::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->type == UTC_ENTRY && Time::Epoch + MilliSecond(it->value) <= utc) {
+            last = it;
+        }
+    }
+    return last != _entries.end() && findElapsed(last->elapsed + (utc - (Time::Epoch + MilliSecond(last->value))), packet, start);
+}
@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Sidecar index of a transport stream file, for time-based seeking.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSectionDemux.h"
+#include "tsTime.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Sidecar index of a transport stream file, for time-based seeking.
+    //!
+    //! The index is built by feeding all packets of the file, in order. It records
+    //! the position (packet index in the file) of regularly spaced PCR values from the
+    //! reference PCR PID, of all TDT/TOT time stamps, of the random access points in
+    //! each PID and of all PSI/SI version changes. It is typically saved in a small
+    //! binary file next to the TS file (same name plus ".tsidx").
+    //!
+    //! The "elapsed time" is the playout time since the first PCR of the reference PID.
+    //! It is computed from the PCR values, taking into account PCR wrap-up and
+    //! discontinuities (in concatenated files for instance).
+    //!
+    class TSDUCKDLL TSFileIndex: private SectionHandlerInterface
+    {
+    public:
+        //!
+        //! Default suffix of the index files, to append to the TS file name.
+        //!
+        static const UChar* const DEFAULT_SUFFIX;
+
+        //!
+        //! Default interval in milliseconds between two index entries of the same kind.
+        //!
+        static const MilliSecond DEFAULT_INTERVAL = 500;
+
+        //!
+        //! Type of an index entry.
+        //!
+        enum EntryType {
+            PCR_ENTRY = 1,  //!< Value is the PCR of the reference PCR PID.
+            UTC_ENTRY = 2,  //!< Value is the UTC time from a TDT or TOT, in milliseconds since Time::Epoch.
+            RAP_ENTRY = 3,  //!< Random access point, value is 1 if the random_access_indicator is set, 0 on a PES start.
+            PSI_ENTRY = 4,  //!< New version of a PSI/SI section, value is table_id << 24 | table_id_ext << 8 | version.
+        };
+
+        //!
+        //! One entry of the index.
+        //!
+        struct TSDUCKDLL Entry
+        {
+            EntryType     type;     //!< Entry type.
+            PID           pid;      //!< PID of the packet.
+            PacketCounter packet;   //!< Index of the packet in the file.
+            MilliSecond   elapsed;  //!< Elapsed time since the first reference PCR.
+            uint64_t      value;    //!< Type-dependent value.
+        };
+
+        //!
+        //! Vector of index entries, in increasing packet order.
+        //!
+        typedef std::vector<Entry> EntryVector;
+
+        //!
+        //! Constructor.
+        //! @param [in] interval Minimum interval in milliseconds between two PCR entries
+        //! and between two random access points in the same PID.
+        //!
+        TSFileIndex(MilliSecond interval = DEFAULT_INTERVAL);
+
+        //!
+        //! Clear the index content and restart building an index.
+        //!
+        void clear();
+
+        //!
+        //! Feed the next packet of the file to build the index.
+        //! @param [in] pkt The next TS packet.
+        //!
+        void feedPacket(const TSPacket& pkt);
+
+        //!
+        //! Save the index in a binary file.
+        //! @param [in] filename Name of the index file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool save(const UString& filename, Report& report) const;
+
+        //!
+        //! Load an index from a binary file.
+        //! @param [in] filename Name of the index file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool load(const UString& filename, Report& report);
+
+        //!
+        //! Get the name of the default index file of a TS file.
+        //! @param [in] ts_file Name of the TS file.
+        //! @return Name of the default index file.
+        //!
+        static UString IndexFileName(const UString& ts_file)
+        {
+            return ts_file + DEFAULT_SUFFIX;
+        }
+
+        //!
+        //! Get all index entries.
+        //! @return A constant reference to the index entries, in increasing packet order.
+        //!
+        const EntryVector& entries() const
+        {
+            return _entries;
+        }
+
+        //!
+        //! Get the number of packets in the indexed file.
+        //! @return The number of packets which were fed into the index.
+        //!
+        PacketCounter packetCount() const
+        {
+            return _packet_count;
+        }
+
+        //!
+        //! Get the reference PCR PID.
+        //! @return The reference PCR PID (the first PID carrying PCR's) or PID_NULL if there is none.
+        //!
+        PID pcrPID() const
+        {
+            return _pcr_pid;
+        }
+
+        //!
+        //! Get the total duration of the indexed file.
+        //! @return The elapsed time of the last indexed PCR.
+        //!
+        MilliSecond duration() const
+        {
+            return _elapsed;
+        }
+
+        //!
+        //! Find a position in the file from an elapsed time.
+        //! @param [in] elapsed Elapsed time in milliseconds since the first reference PCR.
+        //! @param [out] packet Index of the packet in the file. When the position is used to
+        //! start reading, this is the last random access point before the position, in any PID.
+        //! @param [in] start If true, the position is used to start reading and the returned
+        //! position is before or at the requested time. If false, the position is used to stop
+        //! reading and the returned position is after or at the requested time.
+        //! @return True on success, false if the time is out of the file.
+        //!
+        bool findElapsed(MilliSecond elapsed, PacketCounter& packet, bool start) const;
+
+        //!
+        //! Find a position in the file from a PCR value of the reference PCR PID.
+        //! @param [in] pcr A PCR value.
+        //! @param [out] packet Index of the packet in the file.
+        //! @param [in] start Same as findElapsed().
+        //! @return True on success, false if the PCR is not found in the file.
+        //! @see findElapsed()
+        //!
+        bool findPCR(uint64_t pcr, PacketCounter& packet, bool start) const;
+
+        //!
+        //! Find a position in the file from a UTC time, as found in TDT and TOT.
+        //! The elapsed time from the last TDT/TOT before @a utc is used to locate the position.
+        //! @param [in] utc A UTC time.
+        //! @param [out] packet Index of the packet in the file.
+        //! @param [in] start Same as findElapsed().
+        //! @return True on success, false if the UTC time is not found in the file.
+        //! @see findElapsed()
+        //!
+        bool findUTC(const Time& utc, PacketCounter& packet, bool start) const;
+
+    private:
+        MilliSecond   _interval;      // Interval between PCR and RAP entries.
+        EntryVector   _entries;       // All index entries.
+        PacketCounter _packet_count;  // Number of packets in file.
+        PID           _pcr_pid;       // Reference PCR PID.
+        uint64_t      _last_pcr;      // Last PCR value in reference PCR PID.
+        uint64_t      _ext_pcr;       // Last "extended" PCR, monotonic, in PCR units since first PCR.
+        MilliSecond   _elapsed;       // Last elapsed time since first PCR.
+        MilliSecond   _last_sample;   // Elapsed time of last PCR entry.
+        std::map<PID, MilliSecond> _last_rap;   // Elapsed time of last RAP entry, per PID.
+        PIDSet        _rai_pids;      // PID's which signal random access points.
+        std::map<uint64_t, uint8_t> _versions;  // Last version, indexed by pid/tid/tidext.
+        SectionDemux  _demux;         // Demux for PSI/SI.
+
+        // Add an entry for the current packet.
+        void addEntry(EntryType type, PID pid, uint64_t value);
+
+        // Process the PCR of the reference PID.
+        void processPCR(uint64_t pcr);
+
+        // Implementation of SectionHandlerInterface.
+        virtual void handleSection(SectionDemux& demux, const Section& section) override;
+
+        // Inaccessible operations.
+        TSFileIndex(const TSFileIndex&) = delete;
+        TSFileIndex& operator=(const TSFileIndex&) = delete;
+    };
+}
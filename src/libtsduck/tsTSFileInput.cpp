@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFileInput.h"
+#include "tsTSSparseFormat.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
@@ -47,10 +48,20 @@ ts::TSFileInput::TSFileInput() :
     _repeat(0),
     _counter(0),
     _start_offset(0),
+    _stop_offset(0),
+    _remain(0),
     _is_open(false),
     _severity(Severity::Error),
     _at_eof(false),
     _rewindable(false),
+    _check_format(false),
+    _sparse(false),
+    _sparse_buf(),
+    _sparse_pos(0),
+    _null_pkt(NullPacket),
+    _null_valid(false),
+    _null_count(0),
+    _sparse_index(0),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -87,6 +98,7 @@ bool ts::TSFileInput::open(const UString& filename, uint64_t start_offset, Repor
     _repeat = 1;
     _counter = 0;
     _start_offset = start_offset;
+    _stop_offset = 0;
     _at_eof = false;
     _rewindable = true;
 
@@ -98,19 +110,25 @@ bool ts::TSFileInput::open(const UString& filename, uint64_t start_offset, Repor
 // Open file.
 // If repeat_count != 1, reading packets loops back to the start_offset
 // until all repeat are done. If repeat_count == 0, infinite repeat.
+// If stop_offset != 0, each iteration stops at this offset.
 //----------------------------------------------------------------------------
 
-bool ts::TSFileInput::open(const UString& filename, size_t repeat_count, uint64_t start_offset, Report& report)
+bool ts::TSFileInput::open(const UString& filename, size_t repeat_count, uint64_t start_offset, uint64_t stop_offset, Report& report)
 {
     if (_is_open) {
         report.log(_severity, u"already open");
         return false;
     }
+    if (stop_offset != 0 && stop_offset <= start_offset) {
+        report.log(_severity, u"invalid segment in file %s, stop offset %'d is before start offset %'d", {filename, stop_offset, start_offset});
+        return false;
+    }
 
     _filename = filename;
     _repeat = repeat_count;
     _counter = 0;
     _start_offset = start_offset;
+    _stop_offset = stop_offset;
     _at_eof = false;
     _rewindable = false;
 
@@ -142,7 +160,7 @@ bool ts::TSFileInput::openInternal (Report& report)
 
     // If a repeat count or initial offset is specified, the input file must be a regular file
 
-    if ((_repeat != 1 || _start_offset != 0) && ::GetFileType (_handle) != FILE_TYPE_DISK) {
+    if ((_repeat != 1 || _start_offset != 0 || _stop_offset != 0) && ::GetFileType (_handle) != FILE_TYPE_DISK) {
         report.log(_severity, u"input file %s is not a regular file, cannot %s", {_filename, _repeat != 1 ? u"repeat" : u"specify start offset"});
         if (!_filename.empty()) {
             ::CloseHandle(_handle);
@@ -150,9 +168,18 @@ bool ts::TSFileInput::openInternal (Report& report)
         return false;
     }
 
+    // A sparse file cannot be read by segments.
+
+    if ((_start_offset != 0 || _stop_offset != 0) && !checkNotSparse(report)) {
+        if (!_filename.empty()) {
+            ::CloseHandle(_handle);
+        }
+        return false;
+    }
+
     // If an initial offset is specified, move here
 
-    if (_start_offset != 0) {
+    if (_start_offset != 0 || _stop_offset != 0) {
         // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
         ::LARGE_INTEGER offset(*(::LARGE_INTEGER*)(&_start_offset));
         if (::SetFilePointerEx(_handle, offset, NULL, FILE_BEGIN) == 0) {
@@ -181,7 +208,7 @@ bool ts::TSFileInput::openInternal (Report& report)
     // If a repeat count or initial offset is specified, the input file
     // must be a regular file
 
-    if (_repeat != 1 || _start_offset != 0) {
+    if (_repeat != 1 || _start_offset != 0 || _stop_offset != 0) {
         struct stat st;
         if (::fstat(_fd, &st) < 0) {
             ErrorCode error_code = LastErrorCode ();
@@ -200,9 +227,18 @@ bool ts::TSFileInput::openInternal (Report& report)
         }
     }
 
+    // A sparse file cannot be read by segments.
+
+    if ((_start_offset != 0 || _stop_offset != 0) && !checkNotSparse(report)) {
+        if (!_filename.empty()) {
+            ::close(_fd);
+        }
+        return false;
+    }
+
     // If an initial offset is specified, move here
 
-    if (_start_offset != 0 && ::lseek (_fd, off_t (_start_offset), SEEK_SET) == off_t (-1)) {
+    if ((_start_offset != 0 || _stop_offset != 0) && ::lseek (_fd, off_t (_start_offset), SEEK_SET) == off_t (-1)) {
         ErrorCode error_code = LastErrorCode ();
         report.log (_severity, u"error seeking input file %s: %s", {_filename, ErrorCodeMessage(error_code)});
         if (!_filename.empty()) {
@@ -215,6 +251,17 @@ bool ts::TSFileInput::openInternal (Report& report)
 
     _is_open = true;
     _total_packets = 0;
+    _remain = _stop_offset > _start_offset ? _stop_offset - _start_offset : 0;
+
+    // The format of the file (TS or sparse) is checked on first read, when reading
+    // from the beginning of the file. Sparse files cannot be read by segments.
+    _check_format = _start_offset == 0 && _stop_offset == 0;
+    _sparse = false;
+    _sparse_buf.clear();
+    _sparse_pos = 0;
+    _null_valid = false;
+    _null_count = 0;
+    _sparse_index = 0;
     return true;
 }
 
@@ -239,6 +286,11 @@ bool ts::TSFileInput::seekInternal(uint64_t index, Report& report)
     }
     else {
         _at_eof = false;
+        _remain = _stop_offset > _start_offset + index ? _stop_offset - _start_offset - index : 0;
+        _sparse_buf.clear();
+        _sparse_pos = 0;
+        _null_count = 0;
+        _sparse_index = 0;
         return true;
     }
 }
@@ -259,9 +311,27 @@ bool ts::TSFileInput::seek(PacketCounter packet_index, Report& report)
         report.log(_severity, u"input file %s is not rewindable", {_filename});
         return false;
     }
-    else {
+    else if (_check_format && !checkFormat(report)) {
+        return false;
+    }
+    else if (!_sparse) {
         return seekInternal(packet_index * PKT_SIZE, report);
     }
+    else if (!seekInternal(0, report)) {
+        return false;
+    }
+    else {
+        // In a sparse file, the packet position is unknown, read and skip packets.
+        std::vector<TSPacket> buffer(size_t(std::min<PacketCounter>(packet_index, 1024)));
+        while (packet_index > 0) {
+            const size_t count = readSparse(&buffer[0], size_t(std::min<PacketCounter>(packet_index, buffer.size())), report);
+            if (count == 0) {
+                return false;
+            }
+            packet_index -= count;
+        }
+        return true;
+    }
 }
 
 
@@ -304,49 +374,163 @@ size_t ts::TSFileInput::read(TSPacket* buffer, size_t max_packets, Report& repor
         return 0;
     }
 
+    if (_check_format && !checkFormat(report)) {
+        return 0;
+    }
+
     if (_at_eof) {
         return 0;
     }
 
+    const size_t count = _sparse ? readSparse(buffer, max_packets, report) : readPackets(buffer, max_packets, report);
+    _total_packets += count;
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Read some data from the file. Return false on error, insize is zero at EOF.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInput::readData(void* data, size_t size, size_t& insize, ErrorCode& error_code)
+{
+    insize = 0;
+
+#if defined (TS_WINDOWS)
+    // Windows implementation
+    ::DWORD got = 0;
+    if (::ReadFile(_handle, data, ::DWORD(size), &got, NULL)) {
+        insize = size_t(got);
+        return true;
+    }
+    else {
+        error_code = LastErrorCode();
+        return error_code == ERROR_HANDLE_EOF || error_code == ERROR_BROKEN_PIPE;
+    }
+#else
+    // UNIX implementation
+    for (;;) {
+        const ssize_t got = ::read(_fd, data, size);
+        if (got >= 0) {
+            insize = size_t(got);
+            return true;
+        }
+        else if ((error_code = LastErrorCode()) != EINTR) {
+            // Actual error (not an interrupt)
+            return false;
+        }
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Check the format of the file on first read: TS or sparse file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInput::checkFormat(Report& report)
+{
+    _check_format = false;
+
+    // Read the beginning of the file, up to the size of a sparse file header.
+    // If this is not a sparse file, these data are returned first by readPackets().
+    _sparse_buf.resize(SPARSE_TS_HEADER_SIZE);
+    _sparse_pos = 0;
+    size_t got_size = 0;
+    size_t insize = 0;
+    ErrorCode error_code = SYS_SUCCESS;
+
+    while (got_size < _sparse_buf.size()) {
+        if (!readData(&_sparse_buf[got_size], _sparse_buf.size() - got_size, insize, error_code)) {
+            report.log(_severity, u"error reading file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+            _sparse_buf.clear();
+            return false;
+        }
+        else if (insize == 0) {
+            break;
+        }
+        got_size += insize;
+    }
+    _sparse_buf.resize(got_size);
+
+    if (got_size == SPARSE_TS_HEADER_SIZE && ::memcmp(_sparse_buf.data(), SPARSE_TS_MAGIC, sizeof(SPARSE_TS_MAGIC)) == 0) {
+        if (_sparse_buf[sizeof(SPARSE_TS_MAGIC)] != SPARSE_TS_VERSION) {
+            report.log(_severity, u"unsupported version %d of sparse file %s", {_sparse_buf[sizeof(SPARSE_TS_MAGIC)], _filename});
+            return false;
+        }
+        report.debug(u"reading sparse file %s", {_filename});
+        _sparse = true;
+        _sparse_buf.clear();
+        // Rewinding the file restarts after the header.
+        _start_offset = SPARSE_TS_HEADER_SIZE;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Check that a file which is read by segments is not a sparse file.
+// The file must be at the beginning, the caller moves to the start offset.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInput::checkNotSparse(Report& report)
+{
+    uint8_t header[SPARSE_TS_HEADER_SIZE];
+    size_t insize = 0;
+    ErrorCode error_code = SYS_SUCCESS;
+
+    if (readData(header, sizeof(header), insize, error_code) && insize >= sizeof(SPARSE_TS_MAGIC) && ::memcmp(header, SPARSE_TS_MAGIC, sizeof(SPARSE_TS_MAGIC)) == 0) {
+        report.log(_severity, u"%s is a sparse file, cannot specify start or stop offset", {_filename});
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read packets from a plain TS file.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFileInput::readPackets(TSPacket* buffer, size_t max_packets, Report& report)
+{
     char* data = reinterpret_cast <char*> (buffer);
     const size_t req_size = max_packets * PKT_SIZE;
     size_t got_size = 0;
     bool got_error = false;
     ErrorCode error_code = 0;
 
+    // Return the data which were read in advance when checking the file format.
+    if (_sparse_pos < _sparse_buf.size()) {
+        got_size = std::min(req_size, _sparse_buf.size() - _sparse_pos);
+        ::memcpy(data, &_sparse_buf[_sparse_pos], got_size);
+        _sparse_pos += got_size;
+    }
+
     // Loop on read until we get enough
     while (got_size < req_size && !_at_eof && !got_error) {
 
-#if defined (TS_WINDOWS)
-        // Windows implementation
-        ::DWORD insize;
-        if (::ReadFile (_handle, data + got_size, ::DWORD (req_size - got_size), &insize, NULL)) {
-            // Normal case: some data were read
-            got_size += insize;
-            assert (got_size <= req_size);
-            _at_eof = insize == 0;
+        // Do not read beyond the stop offset, if any.
+        size_t max_size = req_size - got_size;
+        if (_stop_offset != 0 && uint64_t(max_size) > _remain) {
+            max_size = size_t(_remain);
         }
-        else {
-            error_code = LastErrorCode ();
-            _at_eof = error_code == ERROR_HANDLE_EOF || error_code == ERROR_BROKEN_PIPE;
-            got_error = !_at_eof;
+
+        size_t insize = 0;
+        if (max_size == 0) {
+            _at_eof = true;
         }
-#else
-        // UNIX implementation
-        ssize_t insize = ::read (_fd, data + got_size, req_size - got_size);
-        if (insize > 0) {
-            // Normal case: some data were read
-            got_size += insize;
-            assert (got_size <= req_size);
+        else if (!readData(data + got_size, max_size, insize, error_code)) {
+            got_error = true;
         }
         else if (insize == 0) {
             _at_eof = true;
         }
-        else if ((error_code = LastErrorCode ()) != EINTR) {
-            // Actual error (not an interrupt)
-            got_error = true;
+        else {
+            // Normal case: some data were read
+            got_size += insize;
+            _remain -= std::min<uint64_t>(_remain, uint64_t(insize));
+            assert(got_size <= req_size);
         }
-#endif
 
         // At end-of-file, truncate partial packet.
         if (_at_eof) {
@@ -356,7 +540,7 @@ size_t ts::TSFileInput::read(TSPacket* buffer, size_t max_packets, Report& repor
         // At end of file, if the file must be repeated a finite number of times,
         // check if this was the last time. If the file must be repeated again,
         // rewind to original start offset.
-        if (_at_eof && (_repeat == 0 || ++_counter < _repeat) && !seekInternal (0, report)) {
+        if (_at_eof && (_repeat == 0 || ++_counter < _repeat) && !seekInternal(0, report)) {
             return 0; // rewind error
         }
     }
@@ -367,7 +551,113 @@ size_t ts::TSFileInput::read(TSPacket* buffer, size_t max_packets, Report& repor
     }
 
     // Return the number of input packets.
-    const size_t count = got_size / PKT_SIZE;
-    _total_packets += count;
+    return got_size / PKT_SIZE;
+}
+
+
+//----------------------------------------------------------------------------
+// Make sure that some bytes are available in the buffer of a sparse file.
+// Return false at end of file or on error.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInput::fillSparse(size_t needed, bool& got_error, Report& report)
+{
+    // Read the sparse file by large chunks.
+    constexpr size_t chunk_size = 64 * 1024;
+
+    while (_sparse_buf.size() - _sparse_pos < needed && !_at_eof) {
+        // Remove processed data.
+        if (_sparse_pos > 0) {
+            _sparse_buf.erase(0, _sparse_pos);
+            _sparse_pos = 0;
+        }
+        const size_t previous_size = _sparse_buf.size();
+        _sparse_buf.resize(previous_size + chunk_size);
+        size_t insize = 0;
+        ErrorCode error_code = SYS_SUCCESS;
+        if (!readData(&_sparse_buf[previous_size], chunk_size, insize, error_code)) {
+            report.log(_severity, u"error reading file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+            got_error = _at_eof = true;
+        }
+        _at_eof = _at_eof || insize == 0;
+        _sparse_buf.resize(previous_size + insize);
+    }
+    return _sparse_buf.size() - _sparse_pos >= needed;
+}
+
+
+//----------------------------------------------------------------------------
+// Read packets from a sparse file.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFileInput::readSparse(TSPacket* buffer, size_t max_packets, Report& report)
+{
+    size_t count = 0;
+    bool got_error = false;
+
+    while (count < max_packets && !got_error) {
+
+        // Expand the current run of null packets.
+        if (_null_count > 0) {
+            const size_t nulls = size_t(std::min<PacketCounter>(_null_count, max_packets - count));
+            for (size_t i = 0; i < nulls; ++i) {
+                buffer[count++] = _null_pkt;
+            }
+            _null_count -= nulls;
+            _sparse_index += nulls;
+            continue;
+        }
+
+        // Get the type of the next record. At end of file, rewind if the file must be repeated.
+        if (!fillSparse(1, got_error, report)) {
+            if (!got_error && (_repeat == 0 || ++_counter < _repeat) && seekInternal(0, report)) {
+                continue;
+            }
+            _at_eof = true;
+            break;
+        }
+
+        const uint8_t type = _sparse_buf[_sparse_pos];
+        size_t size = 0;
+        switch (type) {
+            case SYNC_BYTE: size = PKT_SIZE; break;
+            case SPARSE_NULL_RUN: size = SPARSE_NULL_RUN_SIZE; break;
+            case SPARSE_NULL_REPEAT: size = SPARSE_NULL_REPEAT_SIZE; break;
+            case SPARSE_TIMESTAMP: size = SPARSE_TIMESTAMP_SIZE; break;
+            default: break;
+        }
+        if (size == 0 || (type == SPARSE_NULL_REPEAT && !_null_valid)) {
+            report.log(_severity, u"invalid record 0x%X in sparse file %s", {type, _filename});
+            got_error = _at_eof = true;
+            break;
+        }
+
+        // Get the complete record. A truncated record at end of file is ignored, like a truncated packet.
+        if (!fillSparse(size, got_error, report)) {
+            _sparse_pos = _sparse_buf.size();
+            continue;
+        }
+        const uint8_t* const rec = &_sparse_buf[_sparse_pos];
+        _sparse_pos += size;
+
+        if (type == SYNC_BYTE) {
+            ::memcpy(buffer[count++].b, rec, PKT_SIZE);
+            _sparse_index++;
+        }
+        else if (type == SPARSE_NULL_RUN) {
+            ::memcpy(_null_pkt.b, rec + 5, PKT_SIZE);
+            _null_valid = true;
+            _null_count = GetUInt32(rec + 1);
+        }
+        else if (type == SPARSE_NULL_REPEAT) {
+            _null_count = GetUInt32(rec + 1);
+        }
+        else if (GetUInt64(rec + 1) != _sparse_index) {
+            // Time stamp at an unexpected position.
+            report.log(_severity, u"corrupted sparse file %s, time stamp of packet %'d found at packet %'d", {_filename, GetUInt64(rec + 1), _sparse_index});
+            got_error = _at_eof = true;
+        }
+    }
+
     return count;
 }
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsByteBlock.h"
 #include "tsReport.h"
 
 namespace ts {
@@ -65,7 +66,26 @@ namespace ts {
         //! @param [in,out] report Where to report errors.
         //! @return True on success, false on error.
         //!
-        bool open(const UString& filename, size_t repeat_count, uint64_t start_offset, Report& report);
+        bool open(const UString& filename, size_t repeat_count, uint64_t start_offset, Report& report)
+        {
+            return open(filename, repeat_count, start_offset, 0, report);
+        }
+
+        //!
+        //! Open the file and read only a segment of it.
+        //! @param [in] filename File name. Must be a regular file if @a repeat_count is not 1
+        //! or if @a start_offset or @a stop_offset is not zero.
+        //! @param [in] repeat_count Reading packets loops back after @a stop_offset
+        //! until all repeat are done. If zero, infinitely repeat.
+        //! @param [in] start_offset Offset in bytes from the beginning of the file
+        //! where to start reading packets at each iteration.
+        //! @param [in] stop_offset Offset in bytes from the beginning of the file
+        //! where to stop reading packets at each iteration. If zero, read up to the
+        //! end of the file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& filename, size_t repeat_count, uint64_t start_offset, uint64_t stop_offset, Report& report);
 
         //!
         //! Open the file in rewindable mode.
@@ -176,10 +196,20 @@ namespace ts {
         size_t   _repeat;        //!< Repeat count (0 means infinite)
         size_t   _counter;       //!< Current repeat count
         uint64_t _start_offset;  //!< Initial byte offset in file
+        uint64_t _stop_offset;   //!< Final byte offset in file (0 means end of file)
+        uint64_t _remain;        //!< Remaining bytes to read before _stop_offset
         bool     _is_open;       //!< Check if file is actually open
         int      _severity;      //!< Severity level for error reporting
         bool     _at_eof;        //!< End of file has been reached
         bool     _rewindable;    //!< Opened in rewindable mode
+        bool     _check_format;  //!< Check the file format on first read
+        bool     _sparse;        //!< Sparse file format
+        ByteBlock _sparse_buf;   //!< Data read in advance (sparse file or format check)
+        size_t   _sparse_pos;    //!< Next byte to process in _sparse_buf
+        TSPacket _null_pkt;      //!< Null packet of the current run in sparse file
+        bool     _null_valid;    //!< _null_pkt was read from the sparse file
+        PacketCounter _null_count;   //!< Remaining null packets in current run
+        PacketCounter _sparse_index; //!< Index of next packet in sparse file
 #if defined(TS_WINDOWS)
         ::HANDLE _handle;        //!< File handle
 #else
@@ -193,5 +223,11 @@ namespace ts {
         // Internal methods
         bool openInternal(Report& report);
         bool seekInternal(uint64_t, Report& report);
+        bool readData(void* data, size_t size, size_t& insize, ErrorCode& error_code);
+        bool checkFormat(Report& report);
+        bool checkNotSparse(Report& report);
+        bool fillSparse(size_t needed, bool& got_error, Report& report);
+        size_t readPackets(TSPacket* buffer, size_t max_packets, Report& report);
+        size_t readSparse(TSPacket* buffer, size_t max_packets, Report& report);
     };
 }
@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFileOutput.h"
+#include "tsTSSparseFormat.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
@@ -46,6 +47,14 @@ ts::TSFileOutput::TSFileOutput() :
     _is_open(false),
     _severity(Severity::Error),
     _total_packets(0),
+    _sparse(false),
+    _ts_interval(0),
+    _sparse_data(),
+    _null_pkt(NullPacket),
+    _null_written(false),
+    _null_count(0),
+    _pcr_pid(PID_NULL),
+    _last_pcr(INVALID_PCR),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -66,6 +75,11 @@ bool ts::TSFileOutput::open(const UString& filename, bool append, bool keep, Rep
         return false;
     }
 
+    if (_sparse && append) {
+        report.log(_severity, u"cannot append to a sparse file");
+        return false;
+    }
+
     _filename = filename;
     bool got_error = false;
     ErrorCode error_code = SYS_SUCCESS;
@@ -134,7 +148,24 @@ bool ts::TSFileOutput::open(const UString& filename, bool append, bool keep, Rep
     }
 
     _total_packets = 0;
-    return _is_open = !got_error;
+    _is_open = !got_error;
+
+    // A sparse file starts with a header.
+    if (_is_open && _sparse) {
+        _null_pkt = NullPacket;
+        _null_written = false;
+        _null_count = 0;
+        _pcr_pid = PID_NULL;
+        _last_pcr = INVALID_PCR;
+        _sparse_data.copy(SPARSE_TS_MAGIC, sizeof(SPARSE_TS_MAGIC));
+        _sparse_data.appendUInt8(SPARSE_TS_VERSION);
+        _sparse_data.resize(SPARSE_TS_HEADER_SIZE, 0);
+        if (!writeData(_sparse_data.data(), _sparse_data.size(), report)) {
+            close(report);
+            return false;
+        }
+    }
+    return _is_open;
 }
 
 
@@ -149,6 +180,14 @@ bool ts::TSFileOutput::close(Report& report)
         return false;
     }
 
+    // Write the last run of null packets in a sparse file.
+    bool success = true;
+    if (_sparse && _null_count > 0) {
+        _sparse_data.clear();
+        buildNullRun();
+        success = writeData(_sparse_data.data(), _sparse_data.size(), report);
+    }
+
     if (!_filename.empty()) {
 #if defined (TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -158,7 +197,7 @@ bool ts::TSFileOutput::close(Report& report)
     }
 
     _is_open = false;
-    return true;
+    return success;
 }
 
 
@@ -185,18 +224,40 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
         return false;
     }
 
+    bool success = true;
+    if (_sparse) {
+        _sparse_data.clear();
+        buildSparse(buffer, packet_count);
+        success = writeData(_sparse_data.data(), _sparse_data.size(), report);
+    }
+    else {
+        success = writeData(buffer, packet_count * PKT_SIZE, report);
+    }
+
+    if (success) {
+        _total_packets += packet_count;
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Write data to the file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileOutput::writeData(const void* buffer, size_t size, Report& report)
+{
     // Loop on write until everything is gone
 
     bool got_error = false;
     ErrorCode error_code = SYS_SUCCESS;
-    const char* const data_buffer = reinterpret_cast <const char*> (buffer);
-    const char* data = data_buffer;
+    const char* data = reinterpret_cast<const char*>(buffer);
 
 #if defined (TS_WINDOWS)
 
     // Windows implementation
 
-    ::DWORD remain = ::DWORD (packet_count) * PKT_SIZE;
+    ::DWORD remain = ::DWORD(size);
     ::DWORD outsize;
 
     while (remain > 0 && !got_error) {
@@ -204,7 +265,7 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
             // Normal case, some data were written
             outsize = std::min (outsize, remain);
             data += outsize;
-            remain -= std::max (remain, outsize);
+            remain -= outsize;
         }
         else if ((error_code = LastErrorCode()) == ERROR_BROKEN_PIPE || error_code == ERROR_NO_DATA) {
             // Broken pipe: error state but don't report error.
@@ -224,7 +285,7 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
 
     // UNIX implementation
 
-    size_t remain = packet_count * PKT_SIZE;
+    size_t remain = size;
     ssize_t outsize;
 
     while (remain > 0 && !got_error) {
@@ -233,7 +294,7 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
             // Normal case, some data were written
             assert (size_t (outsize) <= remain);
             data += outsize;
-            remain -= std::max (remain, size_t (outsize));
+            remain -= size_t(outsize);
         }
         else if ((error_code = LastErrorCode()) != EINTR) {
             // Actual error (not an interrupt)
@@ -252,6 +313,71 @@ bool ts::TSFileOutput::write(const TSPacket* buffer, size_t packet_count, Report
         report.log(_severity, u"error writing output file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
     }
 
-    _total_packets += (data - data_buffer) / PKT_SIZE;
     return !got_error;
 }
+
+
+//----------------------------------------------------------------------------
+// Build sparse records for a buffer of packets.
+//----------------------------------------------------------------------------
+
+void ts::TSFileOutput::buildSparse(const TSPacket* buffer, size_t packet_count)
+{
+    for (size_t i = 0; i < packet_count; ++i) {
+        const TSPacket& pkt(buffer[i]);
+        const PID pid = pkt.getPID();
+
+        if (pid == PID_NULL) {
+            // Extend the current run of identical null packets or start a new one.
+            if (_null_count > 0 && pkt != _null_pkt) {
+                buildNullRun();
+            }
+            if (_null_count == 0 && (!_null_written || pkt != _null_pkt)) {
+                _null_pkt = pkt;
+                _null_written = false;
+            }
+            if (++_null_count == 0xFFFFFFFF) {
+                buildNullRun();
+            }
+            continue;
+        }
+
+        // Any other packet ends the run of null packets.
+        if (_null_count > 0) {
+            buildNullRun();
+        }
+
+        // Insert a time stamp on the reference PCR PID at regular intervals.
+        if (_ts_interval > 0 && pkt.hasPCR()) {
+            if (_pcr_pid == PID_NULL) {
+                _pcr_pid = pid;
+            }
+            const uint64_t pcr = pkt.getPCR();
+            if (pid == _pcr_pid && (_last_pcr == INVALID_PCR || pcr < _last_pcr || pcr - _last_pcr >= uint64_t(_ts_interval) * (SYSTEM_CLOCK_FREQ / 1000))) {
+                _sparse_data.appendUInt8(SPARSE_TIMESTAMP);
+                _sparse_data.appendUInt64(_total_packets + i);
+                _sparse_data.appendUInt16(pid);
+                _sparse_data.appendUInt64(pcr);
+                _last_pcr = pcr;
+            }
+        }
+
+        _sparse_data.append(pkt.b, PKT_SIZE);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the record for the current run of null packets.
+//----------------------------------------------------------------------------
+
+void ts::TSFileOutput::buildNullRun()
+{
+    _sparse_data.appendUInt8(_null_written ? SPARSE_NULL_REPEAT : SPARSE_NULL_RUN);
+    _sparse_data.appendUInt32(uint32_t(_null_count));
+    if (!_null_written) {
+        _sparse_data.append(_null_pkt.b, PKT_SIZE);
+        _null_written = true;
+    }
+    _null_count = 0;
+}
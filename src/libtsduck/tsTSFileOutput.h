@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsByteBlock.h"
 #include "tsReport.h"
 
 namespace ts {
@@ -112,6 +113,31 @@ namespace ts {
             return _filename;
         }
 
+        //!
+        //! Set the sparse file format.
+        //! In a sparse file, the runs of null packets are replaced by compact records.
+        //! Sparse files are transparently read by TSFileInput. Must be called before open().
+        //! @param [in] sparse When true, write a sparse file.
+        //! @param [in] timestamp_interval When not zero, insert time stamp records in the file,
+        //! at most every @a timestamp_interval milliseconds, based on the PCR's of the first
+        //! PID with PCR's. The time stamps are used to check the consistency of the file.
+        //! @see tsTSSparseFormat.h
+        //!
+        void setSparse(bool sparse, MilliSecond timestamp_interval = 0)
+        {
+            _sparse = sparse;
+            _ts_interval = timestamp_interval;
+        }
+
+        //!
+        //! Check if the file is written in sparse format.
+        //! @return True if the file is written in sparse format.
+        //!
+        bool isSparse() const
+        {
+            return _sparse;
+        }
+
         //!
         //! Get the number of written packets.
         //! @return The number of written packets.
@@ -126,11 +152,26 @@ namespace ts {
         bool          _is_open;       // Check if file is actually open
         int           _severity;      // Severity level for error reporting
         PacketCounter _total_packets; // Total written packets
+        bool          _sparse;        // Write a sparse file
+        MilliSecond   _ts_interval;   // Interval between time stamps in sparse file
+        ByteBlock     _sparse_data;   // Sparse records to write
+        TSPacket      _null_pkt;      // Null packet of current or previous run
+        bool          _null_written;  // The null packet was written in a previous run
+        PacketCounter _null_count;    // Number of null packets in current run (not yet written)
+        PID           _pcr_pid;       // Reference PID for time stamps
+        uint64_t      _last_pcr;      // PCR of last time stamp
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle;        // File handle
 #else
         int           _fd;            // File descriptor
 #endif
+        // Write data to the file.
+        bool writeData(const void* data, size_t size, Report& report);
+
+        // Build sparse records for a buffer of packets and for the current null run.
+        void buildSparse(const TSPacket* buffer, size_t packet_count);
+        void buildNullRun();
+
         // Inaccessible operations
         TSFileOutput(const TSFileOutput&) = delete;
         TSFileOutput& operator=(const TSFileOutput&) = delete;
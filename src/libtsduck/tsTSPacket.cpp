@@ -457,3 +457,76 @@ std::ostream& ts::TSPacket::display(std::ostream& strm, uint32_t flags, int inde
 
     return strm;
 }
+
+
+//----------------------------------------------------------------------------
+// Locate the start of a sequence of TS packets in a buffer of raw data.
+//----------------------------------------------------------------------------
+
+bool ts::FindTSSync(const uint8_t* data, size_t size, size_t min_size, size_t& offset, size_t& pkt_size, size_t& header_size)
+{
+    // Searched packet formats: packet size and header size before sync byte.
+    struct Format {
+        size_t pkt_size;
+        size_t header_size;
+    };
+    static const Format std_formats[] = {
+        {PKT_SIZE, 0},
+        {PKT_RS_SIZE, 0},
+        {PKT_M2TS_SIZE, M2TS_HEADER_SIZE},
+    };
+    const Format user_format = {pkt_size, header_size};
+
+    const Format* const formats = pkt_size == 0 ? std_formats : &user_format;
+    const size_t formats_count = pkt_size == 0 ? sizeof(std_formats) / sizeof(std_formats[0]) : 1;
+
+    // Make sure that a sync byte is included in each packet format.
+    size_t max_header = 0;
+    for (size_t i = 0; i < formats_count; ++i) {
+        if (formats[i].header_size >= formats[i].pkt_size) {
+            return false;
+        }
+        max_header = std::max(max_header, formats[i].header_size);
+    }
+
+    const uint8_t* const end = data + size;
+    const uint8_t* sync = data;
+
+    // Loop on all candidate sync bytes. Each format is checked on the same candidate
+    // so that the buffer is scanned only once, whatever the number of formats.
+    while (sync < end && (sync = reinterpret_cast<const uint8_t*>(::memchr(sync, SYNC_BYTE, end - sync))) != 0) {
+
+        // With a minimum size, stop when no format can fit in the rest of the buffer.
+        if (min_size > 0 && size_t(end - sync) + max_header < min_size) {
+            break;
+        }
+
+        for (size_t i = 0; i < formats_count; ++i) {
+            const size_t psize = formats[i].pkt_size;
+            const size_t hsize = formats[i].header_size;
+            if (size_t(sync - data) < hsize) {
+                continue;
+            }
+            // Size of the area to check, starting at the beginning of the first packet.
+            const size_t remain = size_t(end - sync) + hsize;
+            const size_t area = min_size == 0 ? remain : min_size;
+            if (area > remain || area < psize) {
+                continue;
+            }
+            // Check the sync byte of all complete packets in the area.
+            const size_t count = area / psize;
+            size_t n = 1;
+            while (n < count && sync[n * psize] == SYNC_BYTE) {
+                ++n;
+            }
+            if (n >= count) {
+                offset = sync - data - hsize;
+                pkt_size = psize;
+                header_size = hsize;
+                return true;
+            }
+        }
+        ++sync;
+    }
+    return false;
+}
@@ -524,6 +524,36 @@ namespace ts {
     //! Vector of packets.
     //!
     typedef std::vector<TSPacket> TSPacketVector;
+
+    //!
+    //! Locate the start of a sequence of TS packets in a buffer of raw data.
+    //!
+    //! This is typically used to resynchronize on a stream of packets after a corruption.
+    //! Candidate sync bytes are located using memchr() which is vectorized in all decent
+    //! C libraries. For each candidate, the periodicity of the sync bytes is checked for
+    //! all searched packet formats in the same pass: 188-byte TS packets, 204-byte packets
+    //! with trailing Reed-Solomon bytes and 192-byte M2TS packets with a 4-byte header.
+    //!
+    //! @param [in] data Address of the buffer.
+    //! @param [in] size Size in bytes of the buffer.
+    //! @param [in] min_size Minimum size in bytes of the sequence of packets, starting at the first packet.
+    //! All complete packets in this area must start with a sync byte. When zero, the sequence must
+    //! extend up to the end of the buffer, where a truncated packet is allowed.
+    //! @param [out] offset Offset in @a data of the first packet, including its header, if any.
+    //! @param [in,out] pkt_size On input, the size of the packets to search, including the header
+    //! and trailer, if any, or zero to search all standard packet formats. On output, the size of
+    //! the packets which were found.
+    //! @param [in,out] header_size On input, when @a pkt_size is not zero, the size of the header
+    //! before the sync byte in each packet. Ignored when @a pkt_size is zero. On output, the
+    //! header size of the packets which were found.
+    //! @return True when a sequence of packets was found, false otherwise.
+    //!
+    TSDUCKDLL bool FindTSSync(const uint8_t* data,
+                              size_t size,
+                              size_t min_size,
+                              size_t& offset,
+                              size_t& pkt_size,
+                              size_t& header_size);
 }
 
 //!
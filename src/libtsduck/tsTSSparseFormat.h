@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Definitions of the sparse transport stream file format.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMPEG.h"
+
+namespace ts {
+    //!
+    //! Size in bytes of the header of a sparse TS file.
+    //!
+    //! A sparse TS file is a TS file where the runs of null packets are replaced by
+    //! compact run-length records. Reading it back with TSFileInput reproduces the
+    //! exact original sequence of packets. The file starts with a header of 8 bytes:
+    //! the 4 characters "TSSP", a format version (currently 1) and 3 reserved bytes.
+    //! Then, the file contains a sequence of records. The first byte of each record
+    //! is its type:
+    //! - SYNC_BYTE: complete TS packet, stored as is (188 bytes).
+    //! - SPARSE_NULL_RUN: 32-bit count, followed by one null packet (193 bytes). The
+    //!   null packet is repeated "count" times.
+    //! - SPARSE_NULL_REPEAT: 32-bit count (5 bytes). The null packet from the previous
+    //!   SPARSE_NULL_RUN record is repeated "count" times.
+    //! - SPARSE_TIMESTAMP: 64-bit packet index, 16-bit PID, 64-bit PCR (19 bytes). The
+    //!   next packet in the file is the packet at this index since the beginning of
+    //!   the file and contains this PCR value. This record is optional and is used
+    //!   to check the consistency of the file.
+    //!
+    //! All integer values are in big endian format. The first byte of a sparse file
+    //! is never a sync byte, a sparse file is always distinguishable from a TS file.
+    //!
+    const size_t SPARSE_TS_HEADER_SIZE = 8;
+
+    //!
+    //! Magic number at the beginning of a sparse TS file.
+    //!
+    const uint8_t SPARSE_TS_MAGIC[4] = {'T', 'S', 'S', 'P'};
+
+    //!
+    //! Current version of the sparse TS file format.
+    //!
+    const uint8_t SPARSE_TS_VERSION = 1;
+
+    //!
+    //! Record types in a sparse TS file.
+    //!
+    enum : uint8_t {
+        SPARSE_NULL_RUN    = 0x01,  //!< Run of null packets, with the null packet.
+        SPARSE_NULL_REPEAT = 0x02,  //!< Run of null packets, same null packet as previous run.
+        SPARSE_TIMESTAMP   = 0x03,  //!< Packet index and PCR of the next packet.
+    };
+
+    //!
+    //! Size of a SPARSE_NULL_RUN record in a sparse TS file.
+    //!
+    const size_t SPARSE_NULL_RUN_SIZE = 5 + PKT_SIZE;
+
+    //!
+    //! Size of a SPARSE_NULL_REPEAT record in a sparse TS file.
+    //!
+    const size_t SPARSE_NULL_REPEAT_SIZE = 5;
+
+    //!
+    //! Size of a SPARSE_TIMESTAMP record in a sparse TS file.
+    //!
+    const size_t SPARSE_TIMESTAMP_SIZE = 19;
+}
@@ -63,7 +63,8 @@ ts::TablesLogger::TablesLogger(const TablesLoggerArgs& opt, TablesDisplay& displ
     _binfile(),
     _sock(false, report),
     _shortSections(),
-    _sectionsOnce()
+    _sectionsOnce(),
+    _clock(true)
 {
     // Set either a table or section handler, depending on --all-sections
     if (_opt.all_sections) {
@@ -73,6 +74,22 @@ ts::TablesLogger::TablesLogger(const TablesLoggerArgs& opt, TablesDisplay& displ
         _demux.setTableHandler(this);
     }
 
+    // Push the TID and TID-ext filters down to the demux so that unwanted sections are skipped early.
+    // The PAT is always needed to add the PMT PID's. The final filtering is done in isFiltered().
+    if (!_opt.tid.empty()) {
+        TIDSet tids(_opt.negate_tid ? AllTIDs : TIDSet());
+        for (auto it = _opt.tid.begin(); it != _opt.tid.end(); ++it) {
+            tids.set(*it, !_opt.negate_tid);
+        }
+        if (_opt.add_pmt_pids) {
+            tids.set(TID_PAT);
+        }
+        _demux.setTIDFilter(tids);
+    }
+    if (!_opt.tidext.empty() && !_opt.negate_tidext && !_opt.add_pmt_pids) {
+        _demux.setTIDExtFilter(_opt.tidext);
+    }
+
     // Open/create the text output.
     if (_opt.use_text && !_display.redirect(_opt.text_destination)) {
         _abort = true;
@@ -242,7 +259,7 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
             // Add an XML comment as first child of the table.
             UString comment(UString::Format(u" PID 0x%X (%d)", {pid, pid}));
             if (_opt.time_stamp) {
-                comment += u", at " + UString(Time::CurrentLocalTime());
+                comment += u", at " + UString(currentLocalTime());
             }
             if (_opt.packet_index) {
                 comment += UString::Format(u", first TS packet: %'d, last: %'d", {table.getFirstTSPacketIndex(), table.getLastTSPacketIndex()});
@@ -444,7 +461,7 @@ void ts::TablesLogger::logSection(const Section& sect)
 
     // Display time stamp if required.
     if (_opt.time_stamp) {
-        header += UString(Time::CurrentLocalTime());
+        header += UString(currentLocalTime());
         header += u": ";
     }
 
@@ -501,7 +518,7 @@ void ts::TablesLogger::preDisplay(PacketCounter first, PacketCounter last)
     if ((_opt.time_stamp || _opt.packet_index) && !_opt.logger) {
         strm << "* ";
         if (_opt.time_stamp) {
-            strm << "At " << Time::CurrentLocalTime();
+            strm << "At " << currentLocalTime();
         }
         if (_opt.packet_index && _opt.time_stamp) {
             strm << ", ";
@@ -544,7 +561,7 @@ void ts::TablesLogger::startMessage(ByteBlock& bb, uint16_t message_type, PID pi
     bb.appendUInt16(2);
     bb.appendUInt16(pid);
     // Timestamp parameter
-    SimulCryptDate now(Time::CurrentLocalTime());
+    SimulCryptDate now(currentLocalTime());
     bb.appendUInt16(tlv::PRM_TIMESTAMP);
     bb.appendUInt16(SimulCryptDate::SIZE);
     now.putBinary(bb.enlarge(SimulCryptDate::SIZE));
@@ -568,6 +585,17 @@ void ts::TablesLogger::addSection(ByteBlock& bb, const Section& sect)
 }
 
 
+//----------------------------------------------------------------------------
+// Get the current local time for time stamps.
+//----------------------------------------------------------------------------
+
+ts::Time ts::TablesLogger::currentLocalTime()
+{
+    _clock.update();
+    return _clock.localTime();
+}
+
+
 //----------------------------------------------------------------------------
 // Report the demux errors (if any)
 //----------------------------------------------------------------------------
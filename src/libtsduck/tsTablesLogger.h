@@ -42,6 +42,7 @@
 #include "tsUDPSocket.h"
 #include "tsCASMapper.h"
 #include "tsxmlDocument.h"
+#include "tsPacketClock.h"
 
 namespace ts {
     //!
@@ -138,6 +139,10 @@ namespace ts {
         UDPSocket                _sock;            // Output socket.
         std::map<PID,SectionPtr> _shortSections;   // Tracking duplicate short sections by PID.
         std::set<uint64_t>       _sectionsOnce;    // Tracking sets of PID/TID/TDIext/secnum/version with --all-once.
+        PacketClock              _clock;           // Time stamps of tables, avoid a local time conversion per table.
+
+        // Get the current local time for time stamps.
+        Time currentLocalTime();
 
         // Save a section in a binary file
         void saveSection(const Section&);
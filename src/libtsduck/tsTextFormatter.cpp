@@ -221,24 +221,34 @@ int ts::TextFormatter::sync()
 
 bool ts::TextFormatter::flushData(const char* firstAddr, const char* lastAddr)
 {
-    for (const char* p = firstAddr; p < lastAddr; ++p) {
+    const char* p = firstAddr;
+    while (p < lastAddr) {
+        // Write sequences of regular characters at once.
+        const char* start = p;
+        while (p < lastAddr && *p != '\t' && *p != '\r' && *p != '\n') {
+            _afterSpace = _afterSpace || *p != ' ';
+            ++p;
+        }
+        if (p > start) {
+            _out->write(start, p - start);
+            _column += p - start;
+        }
+        if (p >= lastAddr) {
+            break;
+        }
         if (*p == '\t') {
             // Tabulations are expanded as spaces.
             while (++_column % _tabSize != 0) {
                 *_out << ' ';
             }
         }
-        else if (*p == '\r' || *p == '\n') {
+        else {
             // CR and LF indifferently move back to begining of current/next line.
             *_out << *p;
             _column = 0;
             _afterSpace = false;
         }
-        else {
-            *_out << *p;
-            ++_column;
-            _afterSpace = _afterSpace || *p != ' ';
-        }
+        ++p;
     }
     return !_out->fail();
 }
@@ -392,6 +392,29 @@ ts::Time ts::Time::CurrentUTC()
 }
 
 
+//----------------------------------------------------------------------------
+// This static routine returns the current UTC time with a coarse precision.
+//----------------------------------------------------------------------------
+
+ts::Time ts::Time::CurrentCoarseUTC()
+{
+#if defined(CLOCK_REALTIME_COARSE)
+
+    ::timespec result;
+    if (::clock_gettime(CLOCK_REALTIME_COARSE, &result) < 0) {
+        throw TimeError(u"clock_gettime error", errno);
+    }
+    return Time(int64_t(result.tv_nsec / 1000) + 1000000 * int64_t(result.tv_sec));
+
+#else
+
+    // On Windows, GetSystemTimeAsFileTime is already a fast low-resolution clock.
+    return CurrentUTC();
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // This static routine converts a Win32 FILETIME to MilliSecond
 //----------------------------------------------------------------------------
@@ -353,6 +353,18 @@ namespace ts {
         //!
         static Time CurrentLocalTime() {return CurrentUTC().UTCToLocal();}
 
+        //!
+        //! Static method returning the current UTC time with a coarse precision.
+        //!
+        //! When the operating system provides a faster but less precise clock (typically
+        //! a few milliseconds, @c CLOCK_REALTIME_COARSE on Linux), this clock is used.
+        //! Otherwise, this is the same as CurrentUTC().
+        //!
+        //! @return The current UTC time.
+        //! @throw ts::Time::TimeError In case of operating system time error.
+        //!
+        static Time CurrentCoarseUTC();
+
         //!
         //! Get the beginning of the current hour.
         //! @return The time for the beginning of the current hour from this object time.
@@ -1671,11 +1671,36 @@ namespace {
     }) {}
 }
 
+// Direct access table for the characteristics of the 256 first characters.
+// This is the most frequent case, avoid a map lookup.
+namespace {
+    class CharCharLatin
+    {
+        TS_DECLARE_SINGLETON(CharCharLatin);
+    public:
+        uint32_t table[256];
+    };
+    TS_DEFINE_SINGLETON(CharCharLatin);
+    CharCharLatin::CharCharLatin() : table()
+    {
+        const CharChar* cc = CharChar::Instance();
+        for (size_t c = 0; c < 256; ++c) {
+            const CharChar::const_iterator it(cc->find(ts::UChar(c)));
+            table[c] = it == cc->end() ? 0 : it->second;
+        }
+    }
+}
+
 uint32_t ts::UCharacteristics(UChar c)
 {
-    const CharChar* ll = CharChar::Instance();
-    const CharChar::const_iterator it(ll->find(c));
-    return it == ll->end() ? 0 : it->second;
+    if (c < 256) {
+        return CharCharLatin::Instance()->table[c];
+    }
+    else {
+        const CharChar* ll = CharChar::Instance();
+        const CharChar::const_iterator it(ll->find(c));
+        return it == ll->end() ? 0 : it->second;
+    }
 }
 
 
@@ -1726,6 +1751,10 @@ bool ts::IsUpper(UChar c)
 
 ts::UChar ts::ToLower(UChar c)
 {
+    if (c < 0x80) {
+        // ASCII, the most frequent case.
+        return c >= u'A' && c <= u'Z' ? UChar(c + (u'a' - u'A')) : c;
+    }
     const UChar result = UChar(std::towlower(wint_t(c)));
     if (result != c) {
         // The standard function has found a translation.
@@ -1741,6 +1770,10 @@ ts::UChar ts::ToLower(UChar c)
 
 ts::UChar ts::ToUpper(UChar c)
 {
+    if (c < 0x80) {
+        // ASCII, the most frequent case.
+        return c >= u'a' && c <= u'z' ? UChar(c - (u'a' - u'A')) : c;
+    }
     const UChar result = UChar(std::towupper(wint_t(c)));
     if (result != c) {
         // The standard function has found a translation.
@@ -33,8 +33,15 @@
 
 #include "tsUDPSocket.h"
 #include "tsNullReport.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 
+// Scheduled transmission time, Linux 4.19 and higher.
+#if defined(TS_LINUX) && defined(SO_TXTIME)
+#define TS_TXTIME 1
+#include <linux/net_tstamp.h>
+#endif
+
 // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
 volatile ::LPFN_WSARECVMSG ts::UDPSocket::_wsaRevcMsg = 0;
@@ -49,7 +56,8 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     Socket(),
     _local_address(),
     _default_destination(),
-    _mcast()
+    _mcast(),
+    _txtime(false)
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -106,6 +114,7 @@ bool ts::UDPSocket::close(Report& report)
         }
         _mcast.clear();
     }
+    _txtime = false;
 
     // Close socket
     return Socket::close(report);
@@ -307,6 +316,85 @@ bool ts::UDPSocket::send(const void* data, size_t size, const SocketAddress& des
 }
 
 
+//----------------------------------------------------------------------------
+// Scheduled transmission times.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::TxTimeSupported()
+{
+#if defined(TS_TXTIME)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ts::UDPSocket::enableTxTime(Report& report)
+{
+#if defined(TS_TXTIME)
+    // Use the same clock as ts::Monotonic.
+    ::sock_txtime config;
+    TS_ZERO(config);
+    config.clockid = CLOCK_MONOTONIC;
+    config.flags = 0;
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_TXTIME, TS_SOCKOPT_T(&config), sizeof(config)) != 0) {
+        report.error(u"error setting socket SO_TXTIME option: %s", {SocketErrorCodeMessage()});
+        return false;
+    }
+    _txtime = true;
+    return true;
+#else
+    report.error(u"scheduled transmission time is not supported on this system");
+    return false;
+#endif
+}
+
+bool ts::UDPSocket::send(const void* data, size_t size, const Monotonic& txtime, Report& report)
+{
+#if defined(TS_TXTIME)
+    if (_txtime) {
+        // Convert the transmission time into a CLOCK_MONOTONIC value in nanoseconds.
+        Monotonic now;
+        now.getSystemTime();
+        const NanoSecond delay = txtime - now;
+        const uint64_t value = uint64_t(Time::UnixClockNanoSeconds(CLOCK_MONOTONIC) + std::max<NanoSecond>(0, delay));
+
+        ::sockaddr addr;
+        _default_destination.copy(addr);
+
+        ::iovec iov;
+        iov.iov_base = const_cast<void*>(data);
+        iov.iov_len = size;
+
+        uint8_t control[CMSG_SPACE(sizeof(uint64_t))];
+        TS_ZERO(control);
+
+        ::msghdr hdr;
+        TS_ZERO(hdr);
+        hdr.msg_name = &addr;
+        hdr.msg_namelen = sizeof(addr);
+        hdr.msg_iov = &iov;
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = control;
+        hdr.msg_controllen = sizeof(control);
+
+        ::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        ::memcpy(CMSG_DATA(cmsg), &value, sizeof(value));
+
+        if (::sendmsg(getSocket(), &hdr, 0) < 0) {
+            report.error(u"error sending UDP message: " + SocketErrorCodeMessage());
+            return false;
+        }
+        return true;
+    }
+#endif
+    return send(data, size, _default_destination, report);
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 // If abort interface is non-zero, invoke it when I/O is interrupted
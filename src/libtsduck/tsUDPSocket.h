@@ -38,6 +38,7 @@
 #include "tsAbortInterface.h"
 #include "tsReport.h"
 #include "tsMemoryUtils.h"
+#include "tsMonotonic.h"
 
 namespace ts {
     //!
@@ -233,6 +234,38 @@ namespace ts {
             return send(data, size, _default_destination, report);
         }
 
+        //!
+        //! Check if the operating system supports scheduled transmission times.
+        //! This is the SO_TXTIME socket option on Linux.
+        //! @return True if scheduled transmission times are supported.
+        //!
+        static bool TxTimeSupported();
+
+        //!
+        //! Enable scheduled transmission times on the socket.
+        //!
+        //! When enabled, the messages which are sent using the send() method with a
+        //! transmission time are queued by the kernel and transmitted at the specified
+        //! time. This is the SO_TXTIME socket option on Linux. The network interface
+        //! shall use a queueing discipline which supports it, typically @e fq.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or if not supported.
+        //!
+        bool enableTxTime(Report& report = CERR);
+
+        //!
+        //! Send a message to the default destination address and port at a scheduled time.
+        //!
+        //! @param [in] data Address of the message to send.
+        //! @param [in] size Size in bytes of the message to send.
+        //! @param [in] txtime Transmission time of the message. Used only when scheduled
+        //! transmission times were enabled using enableTxTime(). Otherwise, the message
+        //! is sent immediately.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool send(const void* data, size_t size, const Monotonic& txtime, Report& report = CERR);
+
         //!
         //! Receive a message.
         //!
@@ -292,6 +325,7 @@ namespace ts {
         SocketAddress _local_address;
         SocketAddress _default_destination;
         MReqSet       _mcast; // Current list of multicast memberships
+        bool          _txtime; // Scheduled transmission times are enabled
 
         // Perform one receive operation. Hide the system mud.
         SocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, Report& report);
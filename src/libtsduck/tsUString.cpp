@@ -44,6 +44,15 @@
 #include "tsDVBCharsetUTF8.h"
 TSDUCK_SOURCE;
 
+// SSE2 is used to convert runs of ASCII characters when available.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TS_UTF_SSE2 1
+    #include <emmintrin.h>
+    #if defined(TS_MSC)
+        #include <intrin.h>
+    #endif
+#endif
+
 // The UTF-8 Byte Order Mark
 const char* const ts::UString::UTF8_BOM = "\xEF\xBB\xBF";
 
@@ -54,6 +63,116 @@ const ts::UString ts::UString::DEFAULT_THOUSANDS_SEPARATOR(1, u',');
 const ts::UString ts::UString::EMPTY;
 
 
+//----------------------------------------------------------------------------
+// Fast conversion of runs of ASCII characters between UTF-8 and UTF-16.
+// Most strings (XML documents, file names, log lines) are mostly ASCII.
+// Each function converts blocks of ASCII characters, then the remaining
+// ASCII characters one by one, and stops before the first non-ASCII character
+// or at the end of one of the buffers. The non-ASCII characters are converted
+// by the general routines.
+//----------------------------------------------------------------------------
+
+namespace {
+#if defined(TS_UTF_SSE2)
+    // Number of trailing zero bits in a non-zero value.
+    inline size_t TrailingZeroes(uint32_t x)
+    {
+#if defined(TS_MSC)
+        unsigned long index = 0;
+        _BitScanForward(&index, x);
+        return size_t(index);
+#else
+        return size_t(__builtin_ctz(x));
+#endif
+    }
+#endif
+
+    inline void ASCIIRunUTF8ToUTF16(const char*& inStart, const char* inEnd, ts::UChar*& outStart, ts::UChar* outEnd)
+    {
+        const char* const end = inStart + std::min<ptrdiff_t>(inEnd - inStart, outEnd - outStart);
+#if defined(TS_UTF_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        while (end - inStart >= 16) {
+            // The whole block is converted but we advance only over its ASCII prefix.
+            // The characters after the prefix are overwritten later.
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inStart));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outStart), _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outStart + 8), _mm_unpackhi_epi8(bytes, zero));
+            const int nonASCII = _mm_movemask_epi8(bytes);
+            if (nonASCII != 0) {
+                const size_t count = TrailingZeroes(uint32_t(nonASCII));
+                inStart += count;
+                outStart += count;
+                return;
+            }
+            inStart += 16;
+            outStart += 16;
+        }
+#else
+        uint64_t word;
+        while (end - inStart >= 8) {
+            ::memcpy(&word, inStart, 8);
+            if ((word & TS_UCONST64(0x8080808080808080)) != 0) {
+                break;
+            }
+            for (size_t i = 0; i < 8; ++i) {
+                outStart[i] = ts::UChar(uint8_t(inStart[i]));
+            }
+            inStart += 8;
+            outStart += 8;
+        }
+#endif
+        // Remaining ASCII characters, up to the first non-ASCII one.
+        while (inStart < end && (*inStart & 0x80) == 0) {
+            *outStart++ = ts::UChar(uint8_t(*inStart++));
+        }
+    }
+
+    inline void ASCIIRunUTF16ToUTF8(const ts::UChar*& inStart, const ts::UChar* inEnd, char*& outStart, char* outEnd)
+    {
+        const ts::UChar* const end = inStart + std::min<ptrdiff_t>(inEnd - inStart, outEnd - outStart);
+#if defined(TS_UTF_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mask = _mm_set1_epi16(int16_t(0xFF80));
+        while (end - inStart >= 16) {
+            // Same principle as above: convert the whole block, advance over the ASCII prefix.
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inStart));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inStart + 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outStart), _mm_packus_epi16(lo, hi));
+            // One bit per value above 0x7F.
+            const __m128i ascii = _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(lo, mask), zero), _mm_cmpeq_epi16(_mm_and_si128(hi, mask), zero));
+            const int nonASCII = _mm_movemask_epi8(ascii) ^ 0xFFFF;
+            if (nonASCII != 0) {
+                const size_t count = TrailingZeroes(uint32_t(nonASCII));
+                inStart += count;
+                outStart += count;
+                return;
+            }
+            inStart += 16;
+            outStart += 16;
+        }
+#else
+        uint64_t word;
+        while (end - inStart >= 4) {
+            ::memcpy(&word, inStart, 8);
+            if ((word & TS_UCONST64(0xFF80FF80FF80FF80)) != 0) {
+                break;
+            }
+            for (size_t i = 0; i < 4; ++i) {
+                outStart[i] = char(inStart[i]);
+            }
+            inStart += 4;
+            outStart += 4;
+        }
+#endif
+        // Remaining ASCII characters, up to the first non-ASCII one.
+        while (inStart < end && *inStart < 0x80) {
+            *outStart++ = char(*inStart++);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // General routine to convert from UTF-16 to UTF-8.
 //----------------------------------------------------------------------------
@@ -113,6 +232,8 @@ void ts::UString::ConvertUTF16ToUTF8(const UChar*& inStart, const UChar* inEnd,
             if (code < 0x0080) {
                 // ASCII compatible value, one byte encoding.
                 *outStart++ = char(code);
+                // Convert the subsequent ASCII characters, if any, by blocks.
+                ASCIIRunUTF16ToUTF8(inStart, inEnd, outStart, outEnd);
             }
             else if (code < 0x800 && outStart + 1 < outEnd) {
                 // 2 bytes encoding.
@@ -186,6 +307,8 @@ void ts::UString::ConvertUTF8ToUTF16(const char*& inStart, const char* inEnd, UC
         if (code < 0x80) {
             // 0xxx xxxx, ASCII compatible value, one byte encoding.
             *outStart++ = uint16_t(code);
+            // Convert the subsequent ASCII characters, if any, by blocks.
+            ASCIIRunUTF8ToUTF16(inStart, inEnd, outStart, outEnd);
         }
         else if ((code & 0xE0) == 0xC0) {
             // 110x xxx, 2 byte encoding.
@@ -326,12 +449,22 @@ ts::UString& ts::UString::assignFromUTF8(const char* utf8, size_type count)
 
 void ts::UString::toUTF8(std::string& utf8) const
 {
-    // The maximum number of UTF-8 bytes is 1.5 times the number of UTF-16 codes.
+    // The maximum number of UTF-8 bytes is 3 times the number of UTF-16 codes.
+    // Start with twice the size, which is enough for most strings, and enlarge
+    // the output buffer to the maximum for the rest of the string when necessary.
     utf8.resize(2 * size());
 
     const UChar* inStart = data();
+    const UChar* const inEnd = inStart + size();
     char* outStart = const_cast<char*>(utf8.data());
-    ConvertUTF16ToUTF8(inStart, inStart + size(), outStart, outStart + utf8.size());
+    ConvertUTF16ToUTF8(inStart, inEnd, outStart, outStart + utf8.size());
+
+    while (inStart < inEnd) {
+        const size_t done = outStart - utf8.data();
+        utf8.resize(done + 3 * (inEnd - inStart));
+        outStart = const_cast<char*>(utf8.data()) + done;
+        ConvertUTF16ToUTF8(inStart, inEnd, outStart, const_cast<char*>(utf8.data()) + utf8.size());
+    }
 
     utf8.resize(outStart - utf8.data());
 }
@@ -1359,43 +1492,9 @@ void ts::UString::appendDump(const void *data,
 
 ts::UString ts::UString::FromDVB(const uint8_t* dvb, size_type dvbSize, const DVBCharset* charset)
 {
-    // Null or empty buffer is a valid empty string.
-    if (dvb == 0 || dvbSize == 0) {
-        return UString();
-    }
-
-    // Get the DVB character set code from the beginning of the string.
-    uint32_t code = 0;
-    size_type codeSize = 0;
-    if (!DVBCharset::GetCharCodeTable(code, codeSize, dvb, dvbSize)) {
-        return UString();
-    }
-
-    // Skip the character code.
-    assert(codeSize <= dvbSize);
-    dvb += codeSize;
-    dvbSize -= codeSize;
-
-    // Get the character set for this DVB string.
-    if (code != 0 || charset == 0) {
-        charset = DVBCharset::GetCharset(code);
-    }
-    if (charset == 0) {
-        // Unsupported charset. Collect all ANSI characters, replace others by '.'.
-        UString str(dvbSize, FULL_STOP);
-        for (size_type i = 0; i < dvbSize; i++) {
-            if (dvb[i] >= 0x20 && dvb[i] <= 0x7E) {
-                str[i] = UChar(dvb[i]);
-            }
-        }
-        return str;
-    }
-    else {
-        // Convert the DVB string using the character set.
-        UString str;
-        charset->decode(str, dvb, dvbSize);
-        return str;
-    }
+    UString str;
+    DVBCharset::Decode(str, dvb, dvbSize, charset);
+    return str;
 }
 
 
@@ -101,6 +101,8 @@
 #include "tsDES.h"
 #include "tsDescriptor.h"
 #include "tsDescriptorList.h"
+#include "tsDescriptorListView.h"
+#include "tsDescriptorView.h"
 #include "tsDoubleCheckLock.h"
 #include "tsDTSDescriptor.h"
 #include "tsduck.h"
@@ -151,9 +153,11 @@
 #include "tsLocalTimeOffsetDescriptor.h"
 #include "tsLogicalChannelNumberDescriptor.h"
 #include "tsMACAddress.h"
+#include "tsMappedSectionFile.h"
 #include "tsMaximumBitrateDescriptor.h"
 #include "tsMD5.h"
 #include "tsMediaGuardDate.h"
+#include "tsMemoryMappedFile.h"
 #include "tsMemoryUtils.h"
 #include "tsMessageDescriptor.h"
 #include "tsMessageQueue.h"
@@ -176,7 +180,9 @@
 #include "tsOneShotPacketizer.h"
 #include "tsOutputPager.h"
 #include "tsOutputRedirector.h"
+#include "tsPacketClock.h"
 #include "tsPacketizer.h"
+#include "tsPacketPacer.h"
 #include "tsParentalRatingDescriptor.h"
 #include "tsPAT.h"
 #include "tsPCR.h"
@@ -188,6 +194,7 @@
 #include "tsPIDOperator.h"
 #include "tsPlatform.h"
 #include "tsPlugin.h"
+#include "tsPluginManifest.h"
 #include "tsPluginRepository.h"
 #include "tsPluginSharedLibrary.h"
 #include "tsPMT.h"
@@ -206,6 +213,7 @@
 #include "tsReportHandler.h"
 #include "tsReportWithPrefix.h"
 #include "tsResidentBuffer.h"
+#include "tsRingMessageQueue.h"
 #include "tsRingNode.h"
 #include "tsRST.h"
 #include "tsS2SatelliteDeliverySystemDescriptor.h"
@@ -292,6 +300,8 @@
 #include "tstlvMessageFactory.h"
 #include "tstlvProtocol.h"
 #include "tstlvSerializer.h"
+#include "tstlvServer.h"
+#include "tstlvServerHandlerInterface.h"
 #include "tstlvStreamMessage.h"
 #include "tsTLVSyntax.h"
 #include "tsTOT.h"
@@ -300,12 +310,14 @@
 #include "tsTSAnalyzerOptions.h"
 #include "tsTSAnalyzerReport.h"
 #include "tsTSDT.h"
+#include "tsTSFileIndex.h"
 #include "tsTSFileInput.h"
 #include "tsTSFileInputBuffered.h"
 #include "tsTSFileOutput.h"
 #include "tsTSFileOutputResync.h"
 #include "tsTSPacket.h"
 #include "tsTSScanner.h"
+#include "tsTSSparseFormat.h"
 #include "tsTuner.h"
 #include "tsTunerArgs.h"
 #include "tsTunerParameters.h"
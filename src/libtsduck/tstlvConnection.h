@@ -72,6 +72,7 @@ namespace ts {
 
             //!
             //! Serialize and send a TLV message.
+            //! The message is serialized in a buffer which is reused from one message to another.
             //! @param [in] msg The message to send.
             //! @param [in,out] report Where to report errors.
             //! @return True on success, false on error.
@@ -82,6 +83,9 @@ namespace ts {
             //! Receive a TLV message.
             //! Wait for the message, deserialize it and validate it.
             //! Process invalid messages and loop until a valid message is received.
+            //! The data are received by large chunks in an internal buffer and the
+            //! messages are analyzed in place. Several messages can be received at once,
+            //! the next ones are returned by the next calls, without further I/O.
             //! @param [out] msg A safe pointer to the received message.
             //! @param [in] abort If non-zero, invoked when I/O is interrupted
             //! (in case of user-interrupt, return, otherwise retry).
@@ -90,6 +94,28 @@ namespace ts {
             //!
             bool receive(MessagePtr& msg, const AbortInterface* abort, Report& report);
 
+            //!
+            //! Receive the data which are available on the connection, without analyzing them.
+            //! Wait only if no data is available. This is designed for event-driven applications
+            //! which call this method when the socket is known to be readable and then extract
+            //! all received messages using receiveBuffered().
+            //! @param [in] abort If non-zero, invoked when I/O is interrupted
+            //! (in case of user-interrupt, return, otherwise retry).
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error or end of connection.
+            //!
+            bool receiveData(const AbortInterface* abort, Report& report);
+
+            //!
+            //! Get the next valid TLV message from the data which were already received, without I/O.
+            //! Invalid messages are processed as in receive() and skipped.
+            //! @param [out] msg A safe pointer to the received message. Null when no
+            //! complete message is available in the data which were already received.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success (even if no message is available), false on error.
+            //!
+            bool receiveBuffered(MessagePtr& msg, Report& report);
+
             //!
             //! Get invalid incoming messages processing.
             //! @return True if, when an invalid message is received, the corresponding
@@ -132,6 +158,10 @@ namespace ts {
             size_t          _invalid_msg_count;
             MUTEX           _send_mutex;
             MUTEX           _receive_mutex;
+            ByteBlockPtr    _send_buffer;     // Reused serialization buffer, protected by _send_mutex.
+            ByteBlock       _receive_buffer;  // Buffer of received data, protected by _receive_mutex.
+            size_t          _receive_start;   // Start of unprocessed data in _receive_buffer.
+            size_t          _receive_end;     // End of received data in _receive_buffer.
 
             Connection(const Connection&) = delete;
             Connection& operator=(const Connection&) = delete;
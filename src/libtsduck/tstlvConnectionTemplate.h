@@ -46,8 +46,15 @@ ts::tlv::Connection<MUTEX>::Connection(const Protocol* protocol, bool auto_error
     _max_invalid_msg(max_invalid_msg),
     _invalid_msg_count(0),
     _send_mutex(),
-    _receive_mutex()
+    _receive_mutex(),
+    _send_buffer(new ByteBlock),
+    _receive_buffer(sizeof(VERSION) + sizeof(TAG) + sizeof(LENGTH) + 0xFFFF),
+    _receive_start(0),
+    _receive_end(0)
 {
+    // The receive buffer can always contain the largest message.
+    // Preallocate the send buffer for typical messages.
+    _send_buffer->reserve(1024);
 }
 
 
@@ -67,6 +74,7 @@ void ts::tlv::Connection<MUTEX>::handleConnected(Report& report)
 {
     SuperClass::handleConnected(report);
     _invalid_msg_count = 0;
+    _receive_start = _receive_end = 0;
 }
 
 #ifdef TS_MSC
@@ -79,18 +87,21 @@ void ts::tlv::Connection<MUTEX>::handleConnected(Report& report)
 //----------------------------------------------------------------------------
 
 template <class MUTEX>
-bool ts::tlv::Connection<MUTEX>::send (const Message& msg, Report& report)
+bool ts::tlv::Connection<MUTEX>::send(const Message& msg, Report& report)
 {
     if (report.debug()) {
         report.debug(u"sending message to %s\n%s", {peerName(), msg.dump(4)});
     }
 
-    ByteBlockPtr bbp (new ByteBlock);
-    Serializer serial (bbp);
-    msg.serialize (serial);
-
-    Guard lock (_send_mutex);
-    return SuperClass::send (bbp->data(), bbp->size(), report);
+    // Serialize the message in the same buffer as previous messages: no reallocation
+    // once the buffer has reached the size of the largest messages.
+    Guard lock(_send_mutex);
+    _send_buffer->clear();
+    {
+        Serializer serial(_send_buffer);
+        msg.serialize(serial);
+    }
+    return SuperClass::send(_send_buffer->data(), _send_buffer->size(), report);
 }
 
 
@@ -99,42 +110,97 @@ bool ts::tlv::Connection<MUTEX>::send (const Message& msg, Report& report)
 //----------------------------------------------------------------------------
 
 template <class MUTEX>
-bool ts::tlv::Connection<MUTEX>::receive (MessagePtr& msg, const AbortInterface* abort, Report& report)
+bool ts::tlv::Connection<MUTEX>::receive(MessagePtr& msg, const AbortInterface* abort, Report& report)
 {
-    const bool has_version (_protocol->hasVersion());
-    const size_t header_size (has_version ? 5 : 4);
-    const size_t length_offset (has_version ? 3 : 2);
+    Guard lock(_receive_mutex);
 
-    // Loop until a valid message is received
+    // Receive data until a valid message is found.
+    // Several messages can be received at once, the next ones are kept in the buffer.
     for (;;) {
-        ByteBlock bb (header_size);
+        if (!receiveBuffered(msg, report)) {
+            return false;
+        }
+        if (!msg.isNull()) {
+            return true;
+        }
+        if (!receiveData(abort, report)) {
+            return false;
+        }
+    }
+}
 
-        // Receive complete message
-        {
-            Guard lock (_receive_mutex);
 
-            // Read message header
-            if (!SuperClass::receive (bb.data(), header_size, abort, report)) {
-                return false;
-            }
+//----------------------------------------------------------------------------
+// Receive available data in the receive buffer.
+//----------------------------------------------------------------------------
 
-            // Get message length and read message payload
-            const size_t length (GetUInt16 (bb.data() + length_offset));
-            bb.resize (header_size + length);
-            if (!SuperClass::receive (bb.data() + header_size, length, abort, report)) {
-                return false;
-            }
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::receiveData(const AbortInterface* abort, Report& report)
+{
+    Guard lock(_receive_mutex);
+
+    // Move the incomplete message at the beginning of the buffer to make room.
+    // There is always room for one complete message.
+    if (_receive_start > 0) {
+        const size_t available = _receive_end - _receive_start;
+        if (available > 0) {
+            ::memmove(_receive_buffer.data(), _receive_buffer.data() + _receive_start, available);  // Flawfinder: ignore: memcpy()
+        }
+        _receive_start = 0;
+        _receive_end = available;
+    }
+
+    // Receive whatever is available, possibly several messages at once.
+    size_t got = 0;
+    if (!SuperClass::receive(_receive_buffer.data() + _receive_end, _receive_buffer.size() - _receive_end, got, abort, report)) {
+        return false;
+    }
+    _receive_end += got;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next valid message from the receive buffer.
+//----------------------------------------------------------------------------
+
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::receiveBuffered(MessagePtr& msg, Report& report)
+{
+    const size_t header_size = _protocol->hasVersion() ? 5 : 4;
+    const size_t length_offset = header_size - 2;
+
+    Guard lock(_receive_mutex);
+    msg.clear();
+
+    // Loop on complete messages in the buffer, until a valid message is found.
+    for (;;) {
+        const size_t available = _receive_end - _receive_start;
+        if (available < header_size) {
+            return true;
+        }
+        const size_t msg_size = header_size + GetUInt16(_receive_buffer.data() + _receive_start + length_offset);
+        if (available < msg_size) {
+            return true;
+        }
+
+        // Analyze the message in place, the factory points into the receive buffer.
+        MessageFactory mf(_receive_buffer.data() + _receive_start, msg_size, _protocol);
+        _receive_start += msg_size;
+        if (_receive_start == _receive_end) {
+            _receive_start = _receive_end = 0;
         }
 
-        // Analyze the message
-        MessageFactory mf (bb.data(), bb.size(), _protocol);
         if (mf.errorStatus() == tlv::OK) {
             _invalid_msg_count = 0;
-            mf.factory (msg);
+            mf.factory(msg);
             if (report.debug() && !msg.isNull()) {
                 report.debug(u"received message from %s\n%s", {peerName(), msg->dump(4)});
             }
-            return true;
+            if (!msg.isNull()) {
+                return true;
+            }
+            continue;
         }
 
         // Received an invalid message
@@ -143,8 +209,8 @@ bool ts::tlv::Connection<MUTEX>::receive (MessagePtr& msg, const AbortInterface*
         // Send back an error message if necessary
         if (_auto_error_response) {
             MessagePtr resp;
-            mf.buildErrorResponse (resp);
-            if (!send (*resp, report)) {
+            mf.buildErrorResponse(resp);
+            if (!send(*resp, report)) {
                 return false;
             }
         }
@@ -152,7 +218,7 @@ bool ts::tlv::Connection<MUTEX>::receive (MessagePtr& msg, const AbortInterface*
         // If invalid message max has been reached, break the connection
         if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
             report.error(u"too many invalid messages from %s, disconnecting", {peerName()});
-            disconnect (report);
+            disconnect(report);
             return false;
         }
     }
@@ -301,6 +301,6 @@ namespace ts {
         //!
         //! Safe pointer for TLV messages (thread-safe).
         //!
-        typedef SafePtr<Message, Mutex> MessagePtrMT;
+        typedef SafePtr<Message, AtomicRefCount> MessagePtrMT;
     }
 }
@@ -43,6 +43,9 @@ namespace ts {
         //!
         //! A DVB message is serialized in TLV into a ByteBlock.
         //! A Serializer is always associated to a ByteBlock.
+        //! The serialized data are appended to the block. To serialize many messages
+        //! without reallocation, clear the same block before each message: its capacity
+        //! is preserved.
         //!
         class TSDUCKDLL Serializer
         {
@@ -92,6 +95,16 @@ namespace ts {
             Serializer() = delete;
             Serializer& operator=(const Serializer&) = delete;
 
+            // Insert the tag and length fields of a TLV structure and reserve the value field.
+            // The block is enlarged only once. Return the address of the value field.
+            uint8_t* putTagLength(TAG tag, size_t len)
+            {
+                uint8_t* p = reinterpret_cast<uint8_t*>(_bb->enlarge(sizeof(TAG) + sizeof(LENGTH) + len));
+                PutUInt16(p, tag);
+                PutUInt16(p + sizeof(TAG), uint16_t(len));
+                return p + sizeof(TAG) + sizeof(LENGTH);
+            }
+
         public:
             //!
             //! Open a TLV structure.
@@ -161,56 +174,56 @@ namespace ts {
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putUInt8(TAG tag, uint8_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(1); _bb->appendUInt8 (i);}
+            void putUInt8(TAG tag, uint8_t i) {*putTagLength(tag, 1) = i;}
 
             //!
             //! Insert a TLV field containing an unsigned 16-bit integer value in the stream.
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putUInt16(TAG tag, uint16_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(2); _bb->appendUInt16(i);}
+            void putUInt16(TAG tag, uint16_t i) {PutUInt16(putTagLength(tag, 2), i);}
 
             //!
             //! Insert a TLV field containing an unsigned 32-bit integer value in the stream.
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putUInt32(TAG tag, uint32_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(4); _bb->appendUInt32(i);}
+            void putUInt32(TAG tag, uint32_t i) {PutUInt32(putTagLength(tag, 4), i);}
 
             //!
             //! Insert a TLV field containing an unsigned 64-bit integer value in the stream.
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putUInt64(TAG tag, uint64_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(8); _bb->appendUInt64(i);}
+            void putUInt64(TAG tag, uint64_t i) {PutUInt64(putTagLength(tag, 8), i);}
 
             //!
             //! Insert a TLV field containing a signed 8-bit integer value in the stream.
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putInt8(TAG tag, int8_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(1); _bb->appendInt8 (i);}
+            void putInt8(TAG tag, int8_t i) {*putTagLength(tag, 1) = uint8_t(i);}
 
             //!
             //! Insert a TLV field containing a signed 16-bit integer value in the stream.
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putInt16(TAG tag, int16_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(2); _bb->appendInt16(i);}
+            void putInt16(TAG tag, int16_t i) {PutInt16(putTagLength(tag, 2), i);}
 
             //!
             //! Insert a TLV field containing a signed 32-bit integer value in the stream.
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putInt32(TAG tag, int32_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(4); _bb->appendInt32(i);}
+            void putInt32(TAG tag, int32_t i) {PutInt32(putTagLength(tag, 4), i);}
 
             //!
             //! Insert a TLV field containing a signed 64-bit integer value in the stream.
             //! @param [in] tag Message or parameter tag.
             //! @param [in] i Integer value to insert.
             //!
-            void putInt64(TAG tag, int64_t i) {_bb->appendUInt16(tag); _bb->appendUInt16(8); _bb->appendInt64(i);}
+            void putInt64(TAG tag, int64_t i) {PutInt64(putTagLength(tag, 8), i);}
 
             //!
             //! Insert a TLV field containing a vector of unsigned 8-bit integer values in the stream.
@@ -303,7 +316,7 @@ namespace ts {
             //! @param [in] i Integer value to insert.
             //!
             template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type* = nullptr>
-            void put(TAG tag, INT i) {_bb->appendUInt16(tag); _bb->appendUInt16(sizeof(INT)); _bb->append<INT>(i);}
+            void put(TAG tag, INT i) {PutInt<INT>(putTagLength(tag, sizeof(INT)), i);}
 
             //!
             //! Insert a TLV field containing a vector of integer values in the stream (template variant).
@@ -335,9 +348,7 @@ namespace ts {
             //!
             void put(TAG tag, const std::string& val)
             {
-                _bb->appendUInt16(tag);
-                _bb->appendUInt16(uint16_t(val.size()));
-                _bb->append(val.data(), val.size());
+                put(tag, val.data(), val.size());
             }
 
             //!
@@ -363,9 +374,7 @@ namespace ts {
             //!
             void put(TAG tag, const ByteBlock& bl)
             {
-                _bb->appendUInt16(tag);
-                _bb->appendUInt16(uint16_t(bl.size()));
-                _bb->append(bl.data(), bl.size());
+                put(tag, bl.data(), bl.size());
             }
 
             //!
@@ -386,9 +395,12 @@ namespace ts {
             //!
             void put(TAG tag, const void *pval, size_t len)
             {
-                _bb->appendUInt16(tag);
-                _bb->appendUInt16(uint16_t(len));
-                _bb->append(pval, len);
+                if (len > 0) {
+                    ::memcpy(putTagLength(tag, len), pval, len);  // Flawfinder: ignore: memcpy()
+                }
+                else {
+                    putTagLength(tag, 0);
+                }
             }
 
             //!
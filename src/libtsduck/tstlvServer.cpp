@@ -0,0 +1,374 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Event-driven multi-client TCP server using TLV messages.
+//
+//----------------------------------------------------------------------------
+
+#include "tstlvServer.h"
+#include "tsGuard.h"
+#include "tsIPUtils.h"
+#include "tsMemoryUtils.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const ts::MilliSecond ts::tlv::Server::MAX_WAIT_TIME;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::tlv::Server::Server(const Protocol* protocol, ServerHandlerInterface* handler, bool auto_error_response, size_t max_invalid_msg) :
+    _protocol(protocol),
+    _handler(handler),
+    _auto_error_response(auto_error_response),
+    _max_invalid_msg(max_invalid_msg),
+    _terminate(false),
+    _server(),
+    _mutex(),
+    _clients()
+#if defined(TS_LINUX)
+    , _epoll_fd(-1)
+#endif
+{
+}
+
+ts::tlv::Server::~Server()
+{
+    // The handler may be already destroyed, do not notify it.
+    closeServer(false, NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Open the server.
+//----------------------------------------------------------------------------
+
+bool ts::tlv::Server::open(const SocketAddress& address, Report& report)
+{
+    if (_server.isOpen()) {
+        report.error(u"TLV server already open");
+        return false;
+    }
+
+    if (!_server.open(report)) {
+        return false;
+    }
+    if (!_server.reusePort(true, report) || !_server.bind(address, report) || !_server.listen(SOMAXCONN, report)) {
+        _server.close(NULLREP);
+        return false;
+    }
+
+#if defined(TS_LINUX)
+    _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd < 0) {
+        report.error(u"error creating epoll: %s", {ErrorCodeMessage()});
+        _server.close(NULLREP);
+        return false;
+    }
+#endif
+
+    if (!addSocket(_server.getSocket(), report)) {
+        close(NULLREP);
+        return false;
+    }
+
+    _terminate = false;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the server.
+//----------------------------------------------------------------------------
+
+bool ts::tlv::Server::close(Report& report)
+{
+    return closeServer(true, report);
+}
+
+bool ts::tlv::Server::closeServer(bool notify, Report& report)
+{
+    // Disconnect all clients.
+    for (;;) {
+        TS_SOCKET_T sock = TS_SOCKET_T_INVALID;
+        {
+            Guard lock(_mutex);
+            if (_clients.empty()) {
+                break;
+            }
+            sock = _clients.begin()->first;
+        }
+        removeClient(sock, notify, report);
+    }
+
+#if defined(TS_LINUX)
+    if (_epoll_fd >= 0) {
+        ::close(_epoll_fd);
+        _epoll_fd = -1;
+    }
+#endif
+
+    return !_server.isOpen() || _server.close(report);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of connected clients.
+//----------------------------------------------------------------------------
+
+size_t ts::tlv::Server::clientCount() const
+{
+    Guard lock(_mutex);
+    return _clients.size();
+}
+
+
+//----------------------------------------------------------------------------
+// Register or unregister a socket in the event waiting mechanism.
+//----------------------------------------------------------------------------
+
+bool ts::tlv::Server::addSocket(TS_SOCKET_T sock, Report& report)
+{
+#if defined(TS_LINUX)
+    ::epoll_event event;
+    TS_ZERO(event);
+    event.events = EPOLLIN;
+    event.data.fd = sock;
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, sock, &event) != 0) {
+        report.error(u"error adding socket to epoll: %s", {ErrorCodeMessage()});
+        return false;
+    }
+#endif
+    return true;
+}
+
+void ts::tlv::Server::removeSocket(TS_SOCKET_T sock, Report& report)
+{
+#if defined(TS_LINUX)
+    // The event parameter is ignored but must be non-null with old kernels.
+    ::epoll_event event;
+    TS_ZERO(event);
+    if (_epoll_fd >= 0 && ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, sock, &event) != 0) {
+        report.error(u"error removing socket from epoll: %s", {ErrorCodeMessage()});
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for sockets to be ready for reading (or disconnected).
+//----------------------------------------------------------------------------
+
+bool ts::tlv::Server::waitEvents(std::vector<TS_SOCKET_T>& sockets, Report& report)
+{
+    sockets.clear();
+
+#if defined(TS_LINUX)
+
+    // With epoll, the kernel maintains the set of sockets.
+    ::epoll_event events[64];
+    const int count = ::epoll_wait(_epoll_fd, events, int(sizeof(events) / sizeof(events[0])), int(MAX_WAIT_TIME));
+    if (count < 0) {
+        if (errno == EINTR) {
+            return true;
+        }
+        report.error(u"epoll error: %s", {ErrorCodeMessage()});
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        sockets.push_back(events[i].data.fd);
+    }
+
+#else
+
+    // Build the array of sockets to poll: the listening socket, then all clients.
+    std::vector<::pollfd> fds;
+    {
+        Guard lock(_mutex);
+        fds.resize(_clients.size() + 1);
+        size_t i = 0;
+        fds[i++].fd = _server.getSocket();
+        for (ClientMap::const_iterator it = _clients.begin(); it != _clients.end(); ++it) {
+            fds[i++].fd = it->first;
+        }
+    }
+    for (size_t i = 0; i < fds.size(); ++i) {
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+
+#if defined(TS_WINDOWS)
+    const int count = ::WSAPoll(fds.data(), ULONG(fds.size()), INT(MAX_WAIT_TIME));
+#else
+    const int count = ::poll(fds.data(), ::nfds_t(fds.size()), int(MAX_WAIT_TIME));
+#endif
+
+    if (count < 0) {
+        const SocketErrorCode err_code = LastSocketErrorCode();
+#if !defined(TS_WINDOWS)
+        if (err_code == EINTR) {
+            return true;
+        }
+#endif
+        report.error(u"poll error: %s", {SocketErrorCodeMessage(err_code)});
+        return false;
+    }
+    for (size_t i = 0; i < fds.size(); ++i) {
+        if (fds[i].revents != 0) {
+            sockets.push_back(fds[i].fd);
+        }
+    }
+
+#endif
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Serve all clients.
+//----------------------------------------------------------------------------
+
+bool ts::tlv::Server::run(const AbortInterface* abort, Report& report)
+{
+    if (!_server.isOpen()) {
+        report.error(u"TLV server not open");
+        return false;
+    }
+
+    std::vector<TS_SOCKET_T> sockets;
+    while (!_terminate && (abort == 0 || !abort->aborting())) {
+
+        if (!waitEvents(sockets, report)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < sockets.size(); ++i) {
+            if (sockets[i] == _server.getSocket()) {
+                acceptClient(report);
+            }
+            else {
+                ServerConnectionPtr client;
+                {
+                    Guard lock(_mutex);
+                    const ClientMap::const_iterator it(_clients.find(sockets[i]));
+                    if (it != _clients.end()) {
+                        client = it->second;
+                    }
+                }
+                if (!client.isNull() && !processClient(client, report)) {
+                    removeClient(sockets[i], true, report);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Accept a new client connection.
+//----------------------------------------------------------------------------
+
+void ts::tlv::Server::acceptClient(Report& report)
+{
+    ServerConnectionPtr client(new ServerConnection(_protocol, _auto_error_response, _max_invalid_msg));
+    SocketAddress address;
+    if (!_server.accept(*client, address, report)) {
+        return;
+    }
+
+    const TS_SOCKET_T sock = client->getSocket();
+    {
+        Guard lock(_mutex);
+        _clients[sock] = client;
+    }
+
+    if (!addSocket(sock, report) || !_handler->handleTLVConnect(*this, client, report)) {
+        removeClient(sock, true, report);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process incoming data from one client.
+//----------------------------------------------------------------------------
+
+bool ts::tlv::Server::processClient(const ServerConnectionPtr& client, Report& report)
+{
+    // The socket is readable, this does not block.
+    if (!client->receiveData(0, report)) {
+        return false;
+    }
+
+    // Dispatch all complete messages.
+    MessagePtr msg;
+    for (;;) {
+        if (!client->receiveBuffered(msg, report)) {
+            return false;
+        }
+        if (msg.isNull()) {
+            return true;
+        }
+        if (!_handler->handleTLVMessage(*this, client, msg, report)) {
+            return false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Disconnect and forget a client.
+//----------------------------------------------------------------------------
+
+void ts::tlv::Server::removeClient(TS_SOCKET_T sock, bool notify, Report& report)
+{
+    ServerConnectionPtr client;
+    {
+        Guard lock(_mutex);
+        const ClientMap::iterator it(_clients.find(sock));
+        if (it == _clients.end()) {
+            return;
+        }
+        client = it->second;
+        _clients.erase(it);
+    }
+
+    removeSocket(sock, report);
+    if (notify) {
+        _handler->handleTLVDisconnect(*this, client, report);
+    }
+
+    // Do not report errors when the client has already disconnected.
+    client->disconnect(NULLREP);
+    client->close(NULLREP);
+}
@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Event-driven multi-client TCP server using TLV messages.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tstlvServerHandlerInterface.h"
+#include "tsTCPServer.h"
+#include "tsAbortInterface.h"
+
+namespace ts {
+    namespace tlv {
+        //!
+        //! Event-driven multi-client TCP server using TLV messages.
+        //!
+        //! All client connections are multiplexed in the thread which executes run(),
+        //! using epoll() on Linux and poll() on other systems. The incoming data are
+        //! read as they arrive, the complete TLV messages are decoded and dispatched
+        //! to a ServerHandlerInterface.
+        //!
+        //! This is typically used to implement the server side of DVB SimulCrypt
+        //! protocols (ECMG, EMMG/PDG-side MUX, etc.) The same handler is used for all
+        //! clients and can serve hundreds of client channels from one thread.
+        //!
+        class TSDUCKDLL Server
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] protocol The incoming messages are interpreted according to this protocol.
+            //! @param [in] handler The handler of incoming connections and messages.
+            //! @param [in] auto_error_response When an invalid message is received, the corresponding
+            //! error message is automatically sent back to the client when @a auto_error_response is true.
+            //! @param [in] max_invalid_msg When non-zero, a client is automatically disconnected
+            //! when the number of consecutive invalid messages has reached this value.
+            //!
+            Server(const Protocol* protocol, ServerHandlerInterface* handler, bool auto_error_response = true, size_t max_invalid_msg = 0);
+
+            //!
+            //! Destructor.
+            //! All clients are disconnected.
+            //!
+            virtual ~Server();
+
+            //!
+            //! Open the server, start listening to incoming connections.
+            //! @param [in] address Local socket address to listen to.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool open(const SocketAddress& address, Report& report = CERR);
+
+            //!
+            //! Check if the server is open.
+            //! @return True if the server is open.
+            //!
+            bool isOpen() const
+            {
+                return _server.isOpen();
+            }
+
+            //!
+            //! Close the server, disconnect all clients.
+            //! The handler is notified of the disconnection of each client.
+            //! Must not be called while run() is executing in another thread, use stop() first.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool close(Report& report = CERR);
+
+            //!
+            //! Serve all clients until stop() is called or the abort interface reports an abort.
+            //! @param [in] abort If non-zero, checked regularly. The server returns when aborting.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on normal termination, false on error.
+            //!
+            bool run(const AbortInterface* abort = 0, Report& report = CERR);
+
+            //!
+            //! Request the termination of run().
+            //! Can be called from any thread, including from the handler.
+            //! The method run() returns in a short time.
+            //!
+            void stop()
+            {
+                _terminate = true;
+            }
+
+            //!
+            //! Get the number of connected clients.
+            //! @return The number of connected clients.
+            //!
+            size_t clientCount() const;
+
+            //!
+            //! Maximum time in milliseconds between two checks for termination in run().
+            //!
+            static const MilliSecond MAX_WAIT_TIME = 100;
+
+        private:
+            typedef std::map<TS_SOCKET_T, ServerConnectionPtr> ClientMap;
+
+            const Protocol*         _protocol;
+            ServerHandlerInterface* _handler;
+            bool                    _auto_error_response;
+            size_t                  _max_invalid_msg;
+            volatile bool           _terminate;
+            TCPServer               _server;
+            mutable Mutex           _mutex;    // Protect _clients, the only field which can be used from other threads.
+            ClientMap               _clients;
+#if defined(TS_LINUX)
+            int                     _epoll_fd;
+#endif
+
+            // Wait for sockets to be ready for reading (or disconnected).
+            bool waitEvents(std::vector<TS_SOCKET_T>& sockets, Report& report);
+
+            // Register or unregister a socket in the event waiting mechanism.
+            bool addSocket(TS_SOCKET_T sock, Report& report);
+            void removeSocket(TS_SOCKET_T sock, Report& report);
+
+            // Accept a new client connection.
+            void acceptClient(Report& report);
+
+            // Process incoming data from one client. Return false if the client must be disconnected.
+            bool processClient(const ServerConnectionPtr& client, Report& report);
+
+            // Close the server and disconnect all clients, optionally notifying the handler.
+            bool closeServer(bool notify, Report& report);
+
+            // Disconnect and forget a client, optionally notifying the handler.
+            void removeClient(TS_SOCKET_T sock, bool notify, Report& report);
+
+            // Inaccessible operations.
+            Server() = delete;
+            Server(const Server&) = delete;
+            Server& operator=(const Server&) = delete;
+        };
+    }
+}
@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Interface to be notified of events in a multi-client TLV server.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tstlvConnection.h"
+#include "tsSafePtr.h"
+
+namespace ts {
+    namespace tlv {
+
+        class Server;
+
+        //!
+        //! TLV connection of a client in a multi-client TLV server.
+        //! The connection is thread-safe: the handlers may keep a reference to it
+        //! and send messages from other threads.
+        //!
+        typedef Connection<Mutex> ServerConnection;
+
+        //!
+        //! Safe pointer to a client connection in a multi-client TLV server (thread-safe).
+        //!
+        typedef SafePtr<ServerConnection, AtomicRefCount> ServerConnectionPtr;
+
+        //!
+        //! Interface for classes which handle the client connections and messages of a tlv::Server.
+        //! All hooks are invoked in the context of the thread which executes tlv::Server::run().
+        //! They should not block for long, all other clients wait in the meantime.
+        //!
+        class TSDUCKDLL ServerHandlerInterface
+        {
+        public:
+            //!
+            //! This hook is invoked when a new client is connected.
+            //! @param [in,out] server The TLV server.
+            //! @param [in] client The new client connection.
+            //! @param [in,out] report Where to report errors.
+            //! @return True to accept the client, false to disconnect it.
+            //!
+            virtual bool handleTLVConnect(Server& server, const ServerConnectionPtr& client, Report& report) = 0;
+
+            //!
+            //! This hook is invoked when a valid message is received from a client.
+            //! @param [in,out] server The TLV server.
+            //! @param [in] client The client connection. Responses can be sent using @a client->send().
+            //! @param [in] msg The received message.
+            //! @param [in,out] report Where to report errors.
+            //! @return True to continue, false to disconnect the client.
+            //!
+            virtual bool handleTLVMessage(Server& server, const ServerConnectionPtr& client, const MessagePtr& msg, Report& report) = 0;
+
+            //!
+            //! This hook is invoked when a client is disconnected, by the client or the server.
+            //! The connection is still open but no longer served.
+            //! @param [in,out] server The TLV server.
+            //! @param [in] client The client connection.
+            //! @param [in,out] report Where to report errors.
+            //!
+            virtual void handleTLVDisconnect(Server& server, const ServerConnectionPtr& client, Report& report) = 0;
+
+            //!
+            //! Virtual destructor.
+            //!
+            virtual ~ServerHandlerInterface() {}
+        };
+    }
+}
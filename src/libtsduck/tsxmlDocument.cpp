@@ -169,7 +169,8 @@ bool ts::xml::Document::validate(const Document& model) const
         return false;
     }
     else if (modelRoot->haveSameName(docRoot)) {
-        return validateElement(modelRoot, docRoot);
+        ModelCache cache;
+        return validateElement(modelRoot, docRoot, cache);
     }
     else {
         _report.error(u"invalid XML document, expected <%s> as root, found <%s>", {modelRoot->name(), docRoot == 0 ? u"(null)" : docRoot->name()});
@@ -178,7 +179,7 @@ bool ts::xml::Document::validate(const Document& model) const
 }
 
 // Validate an XML tree of elements, used by validate().
-bool ts::xml::Document::validateElement(const Element* model, const Element* doc) const
+bool ts::xml::Document::validateElement(const Element* model, const Element* doc, ModelCache& cache) const
 {
     if (model == 0) {
         _report.error(u"invalid XML model document");
@@ -207,14 +208,25 @@ bool ts::xml::Document::validateElement(const Element* model, const Element* doc
     }
 
     // Check that all children elements in doc exist in model.
+    // The lookup of a model element by name is a linear search with case-insensitive comparisons,
+    // possibly through references. The same names are looked up many times in large documents.
+    std::map<UString, const Element*>& modelChildren(cache[model]);
     for (const Element* docChild = doc->firstChildElement(); docChild != 0; docChild = docChild->nextSiblingElement()) {
-        const Element* modelChild = findModelElement(model, docChild->name());
+        const Element* modelChild = 0;
+        const std::map<UString, const Element*>::const_iterator it(modelChildren.find(docChild->name()));
+        if (it != modelChildren.end()) {
+            modelChild = it->second;
+        }
+        else {
+            modelChild = findModelElement(model, docChild->name());
+            modelChildren.insert(std::make_pair(docChild->name(), modelChild));
+        }
         if (modelChild == 0) {
             // The corresponding node does not exist in the model.
             _report.error(u"unexpected node <%s> in <%s>, line %d", {docChild->name(), doc->name(), docChild->lineNumber()});
             success = false;
         }
-        else if (!validateElement(modelChild, docChild)) {
+        else if (!validateElement(modelChild, docChild, cache)) {
             success = false;
         }
     }
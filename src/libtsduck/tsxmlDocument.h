@@ -146,13 +146,20 @@ namespace ts {
             virtual bool parseNode(TextParser& parser, const Node* parent) override;
 
         private:
+            //!
+            //! Cache of model lookups during a validation.
+            //! For each model element, the model children which were found by name.
+            //!
+            typedef std::map<const Element*, std::map<UString, const Element*>> ModelCache;
+
             //!
             //! Validate an XML tree of elements, used by validate().
             //! @param [in] model The model element.
             //! @param [in] doc The element to validate.
+            //! @param [in,out] cache Cache of model lookups.
             //! @return True if @a doc matches @a model, false if it does not.
             //!
-            bool validateElement(const Element* model, const Element* doc) const;
+            bool validateElement(const Element* model, const Element* doc, ModelCache& cache) const;
 
             //!
             //! Find a child element by name in an XML model element.
@@ -297,33 +297,66 @@ ts::xml::Text* ts::xml::Element::addHexaText(const void* data, size_t size)
 
 
 //----------------------------------------------------------------------------
-// Attribute map management.
+// Attribute vector management.
 //----------------------------------------------------------------------------
 
-ts::UString ts::xml::Element::attributeKey(const UString& attributeName) const
+bool ts::xml::Element::sameAttributeName(const UString& name1, const UString& name2) const
 {
-    return _attributeCase == CASE_SENSITIVE ? attributeName : attributeName.toLower();
+    if (name1.length() != name2.length()) {
+        return false;
+    }
+    else if (_attributeCase == CASE_SENSITIVE) {
+        return name1 == name2;
+    }
+    else {
+        for (size_t i = 0; i < name1.length(); ++i) {
+            if (name1[i] != name2[i] && ToLower(name1[i]) != ToLower(name2[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+const ts::xml::Attribute* ts::xml::Element::findAttribute(const UString& attributeName) const
+{
+    for (AttributeVector::const_iterator it = _attributes.begin(); it != _attributes.end(); ++it) {
+        if (sameAttributeName(it->name(), attributeName)) {
+            return &*it;
+        }
+    }
+    return 0;
 }
 
-ts::xml::Element::AttributeMap::const_iterator ts::xml::Element::findAttribute(const UString& attributeName) const
+ts::xml::Attribute* ts::xml::Element::findAttribute(const UString& attributeName)
 {
-    return _attributes.find(attributeKey(attributeName));
+    return const_cast<Attribute*>(static_cast<const Element*>(this)->findAttribute(attributeName));
 }
 
 void ts::xml::Element::setAttribute(const UString& name, const UString& value)
 {
-    _attributes[attributeKey(name)] = Attribute(name, value);
+    Attribute* attr = findAttribute(name);
+    if (attr == 0) {
+        _attributes.push_back(Attribute(name, value));
+    }
+    else {
+        *attr = Attribute(name, value);
+    }
 }
 
 bool ts::xml::Element::hasAttribute(const UString& name) const
 {
-    return findAttribute(name) != _attributes.end();
+    return findAttribute(name) != 0;
 }
 
 ts::xml::Attribute& ts::xml::Element::refAttribute(const UString& name)
 {
-    const AttributeMap::iterator it(_attributes.find(attributeKey(name)));
-    return it == _attributes.end() ? (_attributes[attributeKey(name)] = Attribute(name, u"")) : it->second;
+    Attribute* attr = findAttribute(name);
+    if (attr == 0) {
+        _attributes.push_back(Attribute(name, u""));
+        attr = &_attributes.back();
+    }
+    return *attr;
 }
 
 
@@ -333,10 +366,10 @@ ts::xml::Attribute& ts::xml::Element::refAttribute(const UString& name)
 
 const ts::xml::Attribute& ts::xml::Element::attribute(const UString& attributeName, bool silent) const
 {
-    const AttributeMap::const_iterator it(findAttribute(attributeName));
-    if (it != _attributes.end()) {
+    const Attribute* attr = findAttribute(attributeName);
+    if (attr != 0) {
         // Found the real attribute.
-        return it->second;
+        return *attr;
     }
     if (!silent) {
         _report.error(u"attribute '%s' not found in <%s>, line %d", {attributeName, name(), lineNumber()});
@@ -520,8 +553,8 @@ bool ts::xml::Element::getMACAttribute(MACAddress& value, const UString& name, b
 void ts::xml::Element::getAttributesNames(UStringList& names) const
 {
     names.clear();
-    for (AttributeMap::const_iterator it = _attributes.begin(); it != _attributes.end(); ++it) {
-        names.push_back(it->second.name());
+    for (AttributeVector::const_iterator it = _attributes.begin(); it != _attributes.end(); ++it) {
+        names.push_back(it->name());
     }
 }
 
@@ -532,19 +565,28 @@ void ts::xml::Element::getAttributesNames(UStringList& names) const
 
 void ts::xml::Element::getAttributesNamesInModificationOrder(UStringList& names) const
 {
-    // Map of names, indexed by sequence number.
-    typedef std::multimap<size_t, UString> NameMap;
-    NameMap nameMap;
+    std::vector<const Attribute*> attributes;
+    getAttributesInModificationOrder(attributes);
 
-    // Read all names and build a map indexed by sequence number.
-    for (AttributeMap::const_iterator it = _attributes.begin(); it != _attributes.end(); ++it) {
-        nameMap.insert(std::make_pair(it->second.sequence(), it->second.name()));
+    names.clear();
+    for (std::vector<const Attribute*>::const_iterator it = attributes.begin(); it != attributes.end(); ++it) {
+        names.push_back((*it)->name());
     }
+}
 
-    // Then build the name list, ordered by sequence number.
-    names.clear();
-    for (NameMap::const_iterator it = nameMap.begin(); it != nameMap.end(); ++it) {
-        names.push_back(it->second);
+void ts::xml::Element::getAttributesInModificationOrder(std::vector<const Attribute*>& attributes) const
+{
+    attributes.clear();
+    attributes.reserve(_attributes.size());
+    bool sorted = true;
+    for (AttributeVector::const_iterator it = _attributes.begin(); it != _attributes.end(); ++it) {
+        sorted = sorted && (attributes.empty() || attributes.back()->sequence() < it->sequence());
+        attributes.push_back(&*it);
+    }
+
+    // Attributes are usually not modified after insertion and are already sorted.
+    if (!sorted) {
+        std::sort(attributes.begin(), attributes.end(), [](const Attribute* a1, const Attribute* a2) { return a1->sequence() < a2->sequence(); });
     }
 }
 
@@ -558,13 +600,13 @@ void ts::xml::Element::print(TextFormatter& output, bool keepNodeOpen) const
     // Output element name.
     output << "<" << name();
 
-    // Get all attributes names, by modification order.
-    UStringList names;
-    getAttributesNamesInModificationOrder(names);
+    // Get all attributes, by modification order.
+    std::vector<const Attribute*> attributes;
+    getAttributesInModificationOrder(attributes);
 
     // Loop on all attributes.
-    for (UStringList::const_iterator it = names.begin(); it != names.end(); ++it) {
-        const Attribute& attr(attribute(*it));
+    for (std::vector<const Attribute*>::const_iterator it = attributes.begin(); it != attributes.end(); ++it) {
+        const Attribute& attr(**it);
         output << " " << attr.name() << "=";
 
         // Check if attribute value contains simple or double quotes.
@@ -694,7 +736,7 @@ bool ts::xml::Element::parseNode(TextParser& parser, const Node* parent)
                 ok = false;
             }
             else {
-                _attributes[attributeKey(name)] = Attribute(name, value, line);
+                _attributes.push_back(Attribute(name, value, line));
             }
         }
         else {
@@ -51,8 +51,9 @@ namespace ts {
         class TSDUCKDLL Element: public Node
         {
         private:
-            // Attributes are stored indexed by case-(in)sensitive name.
-            typedef std::map<UString, Attribute> AttributeMap;
+            // Attributes are stored in a flat vector, in insertion order. An element has only
+            // a few attributes and a linear search is faster than a map lookup on a computed key.
+            typedef std::vector<Attribute> AttributeVector;
 
         public:
             //!
@@ -221,11 +222,17 @@ namespace ts {
             //! @return A constant reference to an attribute.
             //! If the argument does not exist, the referenced object is marked invalid.
             //! The reference is valid as long as the Element object is not modified.
+            //! Attributes are stored in a vector: adding a new attribute to the element
+            //! (setAttribute() or any set...Attribute() method with a new attribute name)
+            //! invalidates all references which were previously returned by this method.
+            //! Keep a copy of the attribute or of its value when the element is modified.
             //!
             const Attribute& attribute(const UString& attributeName, bool silent = false) const;
 
             //!
             //! Set an attribute.
+            //! If the attribute does not exist yet, all references which were previously
+            //! returned by attribute() are invalidated.
             //! @param [in] name Attribute name.
             //! @param [in] value Attribute value.
             //!
@@ -461,7 +468,7 @@ namespace ts {
             bool getMACAttribute(MACAddress& value, const UString& name, bool required = false, const MACAddress& defValue = MACAddress()) const;
 
             //!
-            //! Get the list of all attribute names.
+            //! Get the list of all attribute names, in creation order.
             //! @param [out] names Returned list of all attribute names.
             //!
             void getAttributesNames(UStringList& names) const;
@@ -485,13 +492,17 @@ namespace ts {
 
         private:
             CaseSensitivity _attributeCase;  //!< For attribute names.
-            AttributeMap    _attributes;     //!< Map of attributes.
+            AttributeVector _attributes;     //!< Attributes, in insertion order.
 
-            // Compute the key in the attribute map.
-            UString attributeKey(const UString& attributeName) const;
+            // Check if two attribute names are identical, according to the case sensitivity.
+            bool sameAttributeName(const UString& name1, const UString& name2) const;
 
-            // Find a key in the attribute map.
-            AttributeMap::const_iterator findAttribute(const UString& attributeName) const;
+            // Find an attribute by name, return zero if not found.
+            const Attribute* findAttribute(const UString& attributeName) const;
+            Attribute* findAttribute(const UString& attributeName);
+
+            // Get all attributes, sorted by modification order.
+            void getAttributesInModificationOrder(std::vector<const Attribute*>& attributes) const;
 
             // Get a modifiable reference to an attribute, create if does not exist.
             Attribute& refAttribute(const UString& attributeName);
@@ -35,6 +35,8 @@
 #include "tsPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsTSAnalyzerReport.h"
+#include "tsMessageQueue.h"
+#include "tsThread.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
@@ -44,7 +46,7 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class AnalyzePlugin: public ProcessorPlugin
+    class AnalyzePlugin: public ProcessorPlugin, private Thread
     {
     public:
         // Implementation of plugin API
@@ -54,6 +56,12 @@ namespace ts {
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
 
     private:
+        // Snapshots of the analysis, reported in the context of the internal thread.
+        typedef MessageQueue<TSAnalyzerReport, AtomicRefCount> ReportQueue;
+
+        // Maximum number of snapshots waiting to be reported.
+        static const size_t MAX_QUEUED_REPORTS = 4;
+
         UString           _output_name;
         std::ofstream     _output_stream;
         std::ostream*     _output;
@@ -64,12 +72,18 @@ namespace ts {
         PacketCounter     _next_report_packet;
         TSAnalyzerReport  _analyzer;
         TSAnalyzerOptions _analyzer_options;
+        ReportQueue       _report_queue;   // Snapshots to report in the internal thread.
+        volatile bool     _output_error;   // Error in the internal thread.
 
         bool openOutput();
         void closeOutput();
         bool produceReport();
+        bool produceReport(TSAnalyzerReport& analyzer);
         void computeNextReportTime (const Time& current_utc, MilliSecond interval);
 
+        // Invoked in the context of the internal thread.
+        virtual void main() override;
+
         // Inaccessible operations
         AnalyzePlugin() = delete;
         AnalyzePlugin(const AnalyzePlugin&) = delete;
@@ -96,7 +110,9 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     _next_report_time(Time::Epoch),
     _next_report_packet(0),
     _analyzer(),
-    _analyzer_options()
+    _analyzer_options(),
+    _report_queue(MAX_QUEUED_REPORTS),
+    _output_error(false)
 {
     option(u"interval",       'i', POSITIVE);
     option(u"multiple-files", 'm');
@@ -155,6 +171,14 @@ bool ts::AnalyzePlugin::start()
         return false;
     }
 
+    // With --interval, the periodic reports are formatted in an internal thread,
+    // from snapshots of the analysis, to avoid delaying the packet processing.
+    if (_output_interval > 0) {
+        _report_queue.clear();
+        _output_error = false;
+        Thread::start();
+    }
+
     return true;
 }
 
@@ -209,28 +233,55 @@ void ts::AnalyzePlugin::closeOutput()
 //----------------------------------------------------------------------------
 
 bool ts::AnalyzePlugin::produceReport()
+{
+    // Set last known input bitrate as hint
+    _analyzer.setBitrateHint(tsp->bitrate());
+    return produceReport(_analyzer);
+}
+
+bool ts::AnalyzePlugin::produceReport(TSAnalyzerReport& analyzer)
 {
     if (!openOutput()) {
         return false;
     }
     else {
-        // Set last known input bitrate as hint
-        _analyzer.setBitrateHint(tsp->bitrate());
-
-        // Produce the report
-        _analyzer.report(*_output, _analyzer_options);
+        analyzer.report(*_output, _analyzer_options);
         closeOutput();
         return true;
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Invoked in the context of the internal thread.
+//----------------------------------------------------------------------------
+
+void ts::AnalyzePlugin::main()
+{
+    // Loop on snapshots to report until a null pointer is received.
+    ReportQueue::MessagePtr snapshot;
+    while (_report_queue.dequeue(snapshot) && !snapshot.isNull()) {
+        if (!_output_error && !produceReport(*snapshot)) {
+            _output_error = true;
+        }
+        snapshot.clear();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Stop method
 //----------------------------------------------------------------------------
 
 bool ts::AnalyzePlugin::stop()
 {
+    // Wait for the completion of the periodic reports.
+    if (_output_interval > 0) {
+        _report_queue.forceEnqueue(ReportQueue::MessagePtr());
+        Thread::waitForTermination();
+    }
+
+    // Final report.
     produceReport();
     return true;
 }
@@ -263,6 +314,11 @@ void ts::AnalyzePlugin::computeNextReportTime (const Time& current_utc, MilliSec
 
 ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket (TSPacket& pkt, bool& flush, bool& bitrate_changed)
 {
+    // Stop on error in the internal thread.
+    if (_output_error) {
+        return TSP_END;
+    }
+
     // Count packets in transport stream
     _current_packet++;
 
@@ -273,19 +329,22 @@ ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket (TSPacket& pkt, boo
     if (_output_interval > 0) {
         if (_current_packet == 1) {
             // Initialize the repetition when the first packet arrives
-            computeNextReportTime(Time::CurrentUTC(), _output_interval);
+            computeNextReportTime(tsp->currentUTC(), _output_interval);
         }
         else if (_next_report_packet == 0 || (_next_report_packet > 0 && _current_packet >= _next_report_packet)) {
             // Check current time to see if this is time to produce a report
-            const Time current_utc(Time::CurrentUTC());
+            const Time current_utc(tsp->currentUTC());
             if (current_utc < _next_report_time) {
                 // False alarm, we have to wait some more
                 computeNextReportTime(current_utc, _next_report_time - current_utc);
             }
             else {
-                // Time to produce a report
-                if (!produceReport()) {
-                    return TSP_END;
+                // Time to produce a report. Report a snapshot of the analysis in the internal thread.
+                ReportQueue::MessagePtr snapshot(new TSAnalyzerReport);
+                _analyzer.setBitrateHint(tsp->bitrate());
+                _analyzer.getSnapshot(*snapshot);
+                if (!_report_queue.enqueue(snapshot, 0)) {
+                    tsp->warning(u"previous reports are still in progress, analysis report dropped");
                 }
                 // Reset analysis context
                 _analyzer.reset();
@@ -279,7 +279,7 @@ ts::ProcessorPlugin::Status ts::CountPlugin::processPacket(TSPacket& pkt, bool&
     if (_report_interval > 0) {
         if (_current_pkt == 0) {
             // Set initial interval
-            _last_report.start = Time::CurrentUTC();
+            _last_report.start = tsp->currentUTC();
             _last_report.counted_packets = 0;
             _last_report.total_packets = 0;
         }
@@ -287,7 +287,7 @@ ts::ProcessorPlugin::Status ts::CountPlugin::processPacket(TSPacket& pkt, bool&
             // It is time to produce a report.
             // Get current state.
             IntervalReport now;
-            now.start = Time::CurrentUTC();
+            now.start = tsp->currentUTC();
             now.total_packets = _current_pkt;
             now.counted_packets = 0;
             for (size_t p = 0; p < PID_MAX; p++) {
@@ -303,7 +303,7 @@ ts::ProcessorPlugin::Status ts::CountPlugin::processPacket(TSPacket& pkt, bool&
                 totalBitRate = PacketBitRate(now.total_packets - _last_report.total_packets, duration);
             }
             report(u"%s, counted: %'d packets, %'d b/s, total: %'d packets, %'d b/s",
-                   {UString(Time::CurrentLocalTime()), now.counted_packets, countedBitRate, now.total_packets, totalBitRate});
+                   {UString(tsp->currentLocalTime()), now.counted_packets, countedBitRate, now.total_packets, totalBitRate});
 
             // Save current report.
             _last_report = now;
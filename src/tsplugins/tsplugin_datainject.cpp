@@ -63,7 +63,7 @@ namespace ts {
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
 
     private:
-        typedef MessageQueue<TSPacket, Mutex> TSPacketQueue;
+        typedef MessageQueue<TSPacket, AtomicRefCount> TSPacketQueue;
         typedef TSPacketQueue::MessagePtr TSPacketPtr;
 
         // Plugin private data
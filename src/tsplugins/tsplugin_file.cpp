@@ -36,6 +36,7 @@
 #include "tsPluginRepository.h"
 #include "tsTSFileOutput.h"
 #include "tsTSFileInput.h"
+#include "tsTSFileIndex.h"
 TSDUCK_SOURCE;
 
 
@@ -57,6 +58,10 @@ namespace ts {
     private:
         TSFileInput _file;
 
+        // Find a start or stop position using the index file.
+        // Set found to false when a stop position is after the end of the indexed file.
+        bool findPosition(const TSFileIndex& index, const UString& prefix, bool start, uint64_t& offset, bool& found);
+
         // Inaccessible operations
         FileInput() = delete;
         FileInput(const FileInput&) = delete;
@@ -74,6 +79,8 @@ namespace ts {
         virtual bool send(const TSPacket*, size_t) override;
     private:
         TSFileOutput _file;
+        bool         _build_index;
+        TSFileIndex  _index;
 
         // Inaccessible operations
         FileOutput() = delete;
@@ -92,6 +99,8 @@ namespace ts {
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
     private:
         TSFileOutput _file;
+        bool         _build_index;
+        TSFileIndex  _index;
 
         // Inaccessible operations
         FileProcessor() = delete;
@@ -116,12 +125,23 @@ ts::FileInput::FileInput(TSP* tsp_) :
 {
     option(u"",               0,  STRING, 0, 1);
     option(u"byte-offset",   'b', UNSIGNED);
+    option(u"index-file",     0,  STRING);
     option(u"infinite",      'i');
     option(u"packet-offset", 'p', UNSIGNED);
     option(u"repeat",        'r', POSITIVE);
+    option(u"start-pcr",      0,  UNSIGNED);
+    option(u"start-seconds",  0,  UNSIGNED);
+    option(u"start-utc",      0,  STRING);
+    option(u"stop-pcr",       0,  UNSIGNED);
+    option(u"stop-seconds",   0,  UNSIGNED);
+    option(u"stop-utc",       0,  STRING);
 
     setHelp(u"File-name:\n"
-            u"  Name of the input file. Use standard input by default.\n"
+            u"  Name of the input file. Use standard input by default. The file is\n"
+            u"  either a TS file or a sparse file which was created by the output\n"
+            u"  plugin file with option --sparse. Sparse files are automatically\n"
+            u"  recognized, the options --byte-offset, --packet-offset, --start-*\n"
+            u"  and --stop-* cannot be used with sparse files.\n"
             u"\n"
             u"Options:\n"
             u"\n"
@@ -133,6 +153,12 @@ ts::FileInput::FileInput(TSP* tsp_) :
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
+            u"  --index-file name\n"
+            u"      Name of the index file which is used by the --start-* and --stop-*\n"
+            u"      options. The default is the input file name plus \".tsidx\". Index\n"
+            u"      files are built by the command tsindex or by the option --index of\n"
+            u"      the output plugin file.\n"
+            u"\n"
             u"  -i\n"
             u"  --infinite\n"
             u"      Repeat the playout of the file infinitely (default: only once).\n"
@@ -149,6 +175,34 @@ ts::FileInput::FileInput(TSP* tsp_) :
             u"      (default: only once). This option is allowed only if the\n"
             u"      input file is a regular file.\n"
             u"\n"
+            u"  --start-pcr value\n"
+            u"      Start reading the file at the specified PCR value of the first PID\n"
+            u"      carrying PCR's. The position is located using the index file.\n"
+            u"\n"
+            u"  --start-seconds value\n"
+            u"      Start reading the file at the specified playout time in seconds,\n"
+            u"      computed from the PCR's since the beginning of the file. The position\n"
+            u"      is located using the index file.\n"
+            u"\n"
+            u"  --start-utc value\n"
+            u"      Start reading the file at the specified UTC time, as found in the\n"
+            u"      TDT and TOT of the file. The time value must be in the format\n"
+            u"      \"year/month/day:hour:minute:second\". The position is located using\n"
+            u"      the index file.\n"
+            u"\n"
+            u"      With all --start-* options, reading starts at the last random access\n"
+            u"      point before the requested position, when possible.\n"
+            u"\n"
+            u"  --stop-pcr value\n"
+            u"  --stop-seconds value\n"
+            u"  --stop-utc value\n"
+            u"      Stop reading the file at the specified position, using the same\n"
+            u"      formats as the corresponding --start-* options. The stop position\n"
+            u"      must be after the start position. If it is after the end of the\n"
+            u"      indexed file, the file is read up to its end. With --repeat or\n"
+            u"      --infinite, the segment of file between the start and stop positions\n"
+            u"      is repeated.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -160,11 +214,16 @@ ts::FileInput::FileInput(TSP* tsp_) :
 
 ts::FileOutput::FileOutput(TSP* tsp_) :
     OutputPlugin(tsp_, u"Write packets to a file.", u"[options] [file-name]"),
-    _file()
+    _file(),
+    _build_index(false),
+    _index()
 {
-    option(u"",        0,  STRING, 0, 1);
-    option(u"append", 'a');
-    option(u"keep",   'k');
+    option(u"",                    0,  STRING, 0, 1);
+    option(u"append",             'a');
+    option(u"index",              'x');
+    option(u"keep",               'k');
+    option(u"sparse",             's');
+    option(u"sparse-timestamps",   0,  POSITIVE);
 
     setHelp(u"File-name:\n"
             u"  Name of the created output file. Use standard output by default.\n"
@@ -179,11 +238,31 @@ ts::FileOutput::FileOutput(TSP* tsp_) :
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
+            u"  -x\n"
+            u"  --index\n"
+            u"      Build an index of the file while writing it. The index is saved in a\n"
+            u"      file with the same name plus \".tsidx\". It is used by the input plugin\n"
+            u"      file to start or stop reading at given times. Incompatible with\n"
+            u"      --append and --sparse.\n"
+            u"\n"
             u"  -k\n"
             u"  --keep\n"
             u"      Keep existing file (abort if the specified file already exists).\n"
             u"      By default, existing files are overwritten.\n"
             u"\n"
+            u"  -s\n"
+            u"  --sparse\n"
+            u"      Write a sparse file where the runs of null packets are replaced by\n"
+            u"      compact records. Sparse files are automatically recognized by the\n"
+            u"      input plugin file and the exact original stream is read back. Sparse\n"
+            u"      files cannot be appended and cannot be read with byte or packet\n"
+            u"      offsets. Incompatible with --append.\n"
+            u"\n"
+            u"  --sparse-timestamps milliseconds\n"
+            u"      With --sparse, insert time stamps at the specified interval, based on\n"
+            u"      the PCR's of the stream, to check the consistency of the file when it\n"
+            u"      is read back. By default, there is no time stamp.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -195,11 +274,16 @@ ts::FileOutput::FileOutput(TSP* tsp_) :
 
 ts::FileProcessor::FileProcessor(TSP* tsp_) :
     ProcessorPlugin(tsp_, u"Write packets to a file and pass them to next plugin.", u"[options] file-name"),
-    _file()
+    _file(),
+    _build_index(false),
+    _index()
 {
-    option(u"",        0,  STRING, 1, 1);
-    option(u"append", 'a');
-    option(u"keep",   'k');
+    option(u"",                    0,  STRING, 1, 1);
+    option(u"append",             'a');
+    option(u"index",              'x');
+    option(u"keep",               'k');
+    option(u"sparse",             's');
+    option(u"sparse-timestamps",   0,  POSITIVE);
 
     setHelp(u"File-name:\n"
             u"  Name of the created output file.\n"
@@ -214,11 +298,31 @@ ts::FileProcessor::FileProcessor(TSP* tsp_) :
             u"  --help\n"
             u"      Display this help text.\n"
             u"\n"
+            u"  -x\n"
+            u"  --index\n"
+            u"      Build an index of the file while writing it. The index is saved in a\n"
+            u"      file with the same name plus \".tsidx\". It is used by the input plugin\n"
+            u"      file to start or stop reading at given times. Incompatible with\n"
+            u"      --append and --sparse.\n"
+            u"\n"
             u"  -k\n"
             u"  --keep\n"
             u"      Keep existing file (abort if the specified file already exists).\n"
             u"      By default, existing files are overwritten.\n"
             u"\n"
+            u"  -s\n"
+            u"  --sparse\n"
+            u"      Write a sparse file where the runs of null packets are replaced by\n"
+            u"      compact records. Sparse files are automatically recognized by the\n"
+            u"      input plugin file and the exact original stream is read back. Sparse\n"
+            u"      files cannot be appended and cannot be read with byte or packet\n"
+            u"      offsets. Incompatible with --append.\n"
+            u"\n"
+            u"  --sparse-timestamps milliseconds\n"
+            u"      With --sparse, insert time stamps at the specified interval, based on\n"
+            u"      the PCR's of the stream, to check the consistency of the file when it\n"
+            u"      is read back. By default, there is no time stamp.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -230,10 +334,93 @@ ts::FileProcessor::FileProcessor(TSP* tsp_) :
 
 bool ts::FileInput::start()
 {
-    return _file.open (value(u""),
-                       present(u"infinite") ? 0 : intValue<size_t>(u"repeat", 1),
-                       intValue<uint64_t>(u"byte-offset", intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE),
-                       *tsp);
+    const UString name(value(u""));
+    uint64_t start_offset = intValue<uint64_t>(u"byte-offset", intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE);
+    uint64_t stop_offset = 0;
+    bool has_stop = false;  // stop_offset is meaningful, can be zero
+
+    // Positions from the index file.
+    const int start_count = int(present(u"start-pcr")) + int(present(u"start-seconds")) + int(present(u"start-utc"));
+    const int stop_count = int(present(u"stop-pcr")) + int(present(u"stop-seconds")) + int(present(u"stop-utc"));
+
+    if (start_count + stop_count > 0) {
+        if (name.empty()) {
+            tsp->error(u"options --start-* and --stop-* require an input file name");
+            return false;
+        }
+        if (start_count > 1 || stop_count > 1) {
+            tsp->error(u"specify at most one --start-* option and one --stop-* option");
+            return false;
+        }
+        if (start_count > 0 && (present(u"byte-offset") || present(u"packet-offset"))) {
+            tsp->error(u"options --start-* are incompatible with --byte-offset and --packet-offset");
+            return false;
+        }
+        TSFileIndex index;
+        bool found = false;
+        if (!index.load(value(u"index-file", TSFileIndex::IndexFileName(name).c_str()), *tsp) ||
+            (start_count > 0 && !findPosition(index, u"start", true, start_offset, found)) ||
+            (stop_count > 0 && !findPosition(index, u"stop", false, stop_offset, has_stop)))
+        {
+            return false;
+        }
+        if (has_stop && stop_offset <= start_offset) {
+            tsp->error(u"stop position (packet %'d) is not after start position (packet %'d), nothing to read", {stop_offset / PKT_SIZE, start_offset / PKT_SIZE});
+            return false;
+        }
+        tsp->verbose(u"reading %s from packet %'d to %s", {name, start_offset / PKT_SIZE, has_stop ? UString::Format(u"packet %'d", {stop_offset / PKT_SIZE}) : UString(u"end of file")});
+    }
+
+    // A zero stop offset means end of file in TSFileInput. A valid stop offset is after the start one, never zero.
+    return _file.open(name,
+                      present(u"infinite") ? 0 : intValue<size_t>(u"repeat", 1),
+                      start_offset,
+                      has_stop ? stop_offset : 0,
+                      *tsp);
+}
+
+
+//----------------------------------------------------------------------------
+// Find a start or stop position using the index file.
+//----------------------------------------------------------------------------
+
+bool ts::FileInput::findPosition(const TSFileIndex& index, const UString& prefix, bool start, uint64_t& offset, bool& found)
+{
+    const UString pcr_name(prefix + u"-pcr");
+    const UString seconds_name(prefix + u"-seconds");
+    const UString utc_name(prefix + u"-utc");
+    const UChar* const opt_pcr = pcr_name.c_str();
+    const UChar* const opt_seconds = seconds_name.c_str();
+    const UChar* const opt_utc = utc_name.c_str();
+    PacketCounter packet = 0;
+    found = false;
+
+    if (present(opt_pcr)) {
+        found = index.findPCR(intValue<uint64_t>(opt_pcr), packet, start);
+    }
+    else if (present(opt_seconds)) {
+        found = index.findElapsed(intValue<MilliSecond>(opt_seconds) * MilliSecPerSec, packet, start);
+    }
+    else {
+        Time utc;
+        if (!utc.decode(value(opt_utc))) {
+            tsp->error(u"invalid time value \"%s\" (use \"year/month/day:hour:minute:second\")", {value(opt_utc)});
+            return false;
+        }
+        found = index.findUTC(utc, packet, start);
+    }
+
+    if (found) {
+        offset = packet * PKT_SIZE;
+    }
+    else if (start) {
+        tsp->error(u"%s position not found in the index", {prefix});
+    }
+    else {
+        // Stop position after the end of the indexed file, read up to end of file.
+        tsp->verbose(u"stop position not found in the index, reading up to end of file");
+    }
+    return found || !start;
 }
 
 bool ts::FileInput::stop()
@@ -253,17 +440,37 @@ size_t ts::FileInput::receive (TSPacket* buffer, size_t max_packets)
 
 bool ts::FileOutput::start()
 {
+    _build_index = present(u"index");
+    if (_build_index && (value(u"").empty() || present(u"append"))) {
+        tsp->error(u"option --index requires an output file name and is incompatible with --append");
+        return false;
+    }
+    if (_build_index && present(u"sparse")) {
+        tsp->error(u"options --index and --sparse are incompatible, a sparse file cannot be played from an index");
+        return false;
+    }
+    _index.clear();
+    _file.setSparse(present(u"sparse"), intValue<MilliSecond>(u"sparse-timestamps", 0));
     return _file.open (value(u""), present(u"append"), present(u"keep"), *tsp);
 }
 
 bool ts::FileOutput::stop()
 {
-    return _file.close (*tsp);
+    const UString name(_file.getFileName());
+    return _file.close (*tsp) && (!_build_index || _index.save(TSFileIndex::IndexFileName(name), *tsp));
 }
 
 bool ts::FileOutput::send (const TSPacket* buffer, size_t packet_count)
 {
-    return _file.write (buffer, packet_count, *tsp);
+    if (!_file.write (buffer, packet_count, *tsp)) {
+        return false;
+    }
+    if (_build_index) {
+        for (size_t i = 0; i < packet_count; ++i) {
+            _index.feedPacket(buffer[i]);
+        }
+    }
+    return true;
 }
 
 
@@ -273,15 +480,33 @@ bool ts::FileOutput::send (const TSPacket* buffer, size_t packet_count)
 
 bool ts::FileProcessor::start()
 {
+    _build_index = present(u"index");
+    if (_build_index && (value(u"").empty() || present(u"append"))) {
+        tsp->error(u"option --index requires an output file name and is incompatible with --append");
+        return false;
+    }
+    if (_build_index && present(u"sparse")) {
+        tsp->error(u"options --index and --sparse are incompatible, a sparse file cannot be played from an index");
+        return false;
+    }
+    _index.clear();
+    _file.setSparse(present(u"sparse"), intValue<MilliSecond>(u"sparse-timestamps", 0));
     return _file.open (value(u""), present(u"append"), present(u"keep"), *tsp);
 }
 
 bool ts::FileProcessor::stop()
 {
-    return _file.close (*tsp);
+    const UString name(_file.getFileName());
+    return _file.close (*tsp) && (!_build_index || _index.save(TSFileIndex::IndexFileName(name), *tsp));
 }
 
 ts::ProcessorPlugin::Status ts::FileProcessor::processPacket (TSPacket& pkt, bool& flush, bool& bitrate_changed)
 {
-    return _file.write (&pkt, 1, *tsp) ? TSP_OK : TSP_END;
+    if (!_file.write (&pkt, 1, *tsp)) {
+        return TSP_END;
+    }
+    if (_build_index) {
+        _index.feedPacket(pkt);
+    }
+    return TSP_OK;
 }
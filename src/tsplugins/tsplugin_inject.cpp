@@ -427,13 +427,13 @@ ts::ProcessorPlugin::Status ts::InjectPlugin::processPacket(TSPacket& pkt, bool&
 
     // Poll files when necessary.
     // Do that only at section boundary in the output PID to avoid truncated sections.
-    if (_poll_files && _pzer.atSectionBoundary() && Time::CurrentUTC() >= _poll_file_next) {
+    if (_poll_files && _pzer.atSectionBoundary() && tsp->currentUTC() >= _poll_file_next) {
         if (_infiles.scanFiles(FILE_RETRY, *tsp) > 0) {
             // Some files have changed. Reset packetizer and reload files.
             reloadFiles();
         }
         // Plan next file polling.
-        _poll_file_next = Time::CurrentUTC() + _poll_files_ms;
+        _poll_file_next = tsp->currentUTC() + _poll_files_ms;
     }
 
     // Now really process the current packet.
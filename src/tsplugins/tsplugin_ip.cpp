@@ -37,6 +37,7 @@
 #include "tsIPUtils.h"
 #include "tsUDPSocket.h"
 #include "tsUDPReceiver.h"
+#include "tsPacketPacer.h"
 #include "tsSysUtils.h"
 #include "tsTime.h"
 TSDUCK_SOURCE;
@@ -47,6 +48,9 @@ TSDUCK_SOURCE;
 #define MAX_PACKET_BURST   128  // ~ 48 kB
 #define MAX_IP_SIZE      65536
 
+// With scheduled transmission time, how much in advance are datagrams passed to the kernel.
+#define TXTIME_LOOKAHEAD 2000000  // nanoseconds
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -99,8 +103,11 @@ namespace ts {
         virtual bool send(const TSPacket*, size_t) override;
 
     private:
-        UDPSocket _sock;        // Outgoing socket
-        size_t    _pkt_burst;   // Number of TS packets per UDP message
+        UDPSocket   _sock;        // Outgoing socket
+        size_t      _pkt_burst;   // Number of TS packets per UDP message
+        bool        _pacing;      // Pace the datagrams
+        bool        _txtime;      // Use scheduled transmission time
+        PacketPacer _pacer;       // Datagram pacing
 
         // Inaccessible operations
         IPOutput() = delete;
@@ -172,12 +179,19 @@ ts::IPInput::IPInput(TSP* tsp_) :
 ts::IPOutput::IPOutput(TSP* tsp_) :
     OutputPlugin(tsp_, u"Send TS packets using UDP/IP, multicast or unicast.", u"[options] address:port"),
     _sock(false, *tsp_),
-    _pkt_burst(DEF_PACKET_BURST)
+    _pkt_burst(DEF_PACKET_BURST),
+    _pacing(false),
+    _txtime(false),
+    _pacer()
 {
     option(u"",               0,  STRING, 1, 1);
     option(u"local-address", 'l', STRING);
     option(u"packet-burst",  'p', INTEGER, 0, 1, 1, MAX_PACKET_BURST);
+    option(u"pacing",         0);
+    option(u"pcr-pacing",     0);
+    option(u"pid-pcr",        0,  PIDVAL);
     option(u"ttl",           't', INTEGER, 0, 1, 1, 255);
+    option(u"txtime",         0);
 
     setHelp(u"Parameter:\n"
             u"  The parameter address:port describes the destination for UDP packets.\n"
@@ -202,6 +216,20 @@ ts::IPOutput::IPOutput(TSP* tsp_) :
             u"      The default is " TS_STRINGIFY(DEF_PACKET_BURST) u", the maximum is "
             TS_STRINGIFY(MAX_PACKET_BURST) u".\n"
             u"\n"
+            u"  --pacing\n"
+            u"      Pace the UDP datagrams according to the bitrate of the stream. Each\n"
+            u"      datagram is sent at the due time of its first TS packet, using a hybrid\n"
+            u"      sleep/spin wait. This gives a much lower inter-datagram jitter than the\n"
+            u"      regulate plugin, at the expense of some CPU load.\n"
+            u"\n"
+            u"  --pcr-pacing\n"
+            u"      Pace the UDP datagrams according to the PCR's of the stream instead of\n"
+            u"      its average bitrate. Implies --pacing.\n"
+            u"\n"
+            u"  --pid-pcr value\n"
+            u"      With --pcr-pacing, specify the reference PID for PCR's. By default,\n"
+            u"      use the first PID containing PCR's.\n"
+            u"\n"
             u"  -t value\n"
             u"  --ttl value\n"
             u"      Specifies the TTL (Time-To-Live) socket option. The actual option\n"
@@ -209,6 +237,13 @@ ts::IPOutput::IPOutput(TSP* tsp_) :
             u"      destination address. Remember that the default Multicast TTL is 1\n"
             u"      on most systems.\n"
             u"\n"
+            u"  --txtime\n"
+            u"      Pass the datagrams to the kernel in advance with a scheduled\n"
+            u"      transmission time (SO_TXTIME socket option), instead of waiting in\n"
+            u"      tsp. This is supported on Linux 4.19 and higher and requires an\n"
+            u"      appropriate queueing discipline on the network interface, typically\n"
+            u"      fq. Implies --pacing.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -330,27 +365,16 @@ size_t ts::IPInput::receive(TSPacket* buffer, size_t max_packets)
         // 188 bytes, going forward. If we find this pattern, followed by
         // less than 188 bytes, then we have found a sequence of TS packets.
 
-        const uint8_t* max = _inbuf + insize - PKT_SIZE; // max address for a TS packet
+        size_t start = 0;
+        size_t pkt_size = PKT_SIZE;
+        size_t header_size = 0;
         _inbuf_count = 0;
 
-        for (p = _inbuf; p <= max; p++) {
-            if (*p == SYNC_BYTE) {
-                // Verify that we get a 0x47 sync byte every 188 bytes up
-                // to the end of message (not leaving more than one truncated
-                // TS packet at the end of the message).
-                const uint8_t* end;
-                for (end = p; end <= max && *end == SYNC_BYTE; end += PKT_SIZE) {}
-                if (end > max) {
-                    // Less than 188 bytes after last packet. Consider we are OK
-                    _inbuf_next = p - _inbuf;
-                    _inbuf_count = (end - p) / PKT_SIZE;
-                    new_packets = true;
-                    break; // exit packet search loop
-                }
-            }
-        }
-
-        if (new_packets) {
+        if (FindTSSync(_inbuf, insize, 0, start, pkt_size, header_size)) {
+            // Less than 188 bytes after last packet. Consider we are OK
+            _inbuf_next = start;
+            _inbuf_count = (insize - start) / PKT_SIZE;
+            new_packets = true;
             break; // exit receive loop
         }
 
@@ -388,8 +412,8 @@ size_t ts::IPInput::receive(TSPacket* buffer, size_t max_packets)
         // Check if evaluated bitrate should be displayed
         if (_display_time > 0 && now >= _next_display) {
             _next_display += _display_time;
-            const MilliSecond ms_current = Time::CurrentUTC() - _start_0;
-            const MilliSecond ms_total = Time::CurrentUTC() - _start;
+            const MilliSecond ms_current = now - _start_0;
+            const MilliSecond ms_total = now - _start;
             const BitRate br_current = ms_current == 0 ? 0 : BitRate((_packets_0 * PKT_SIZE * 8 * MilliSecPerSec) / ms_current);
             const BitRate br_average = ms_total == 0 ? 0 : BitRate((_packets * PKT_SIZE * 8 * MilliSecPerSec) / ms_total);
             tsp->info(u"IP input bitrate: %s, average: %s", {
@@ -419,6 +443,16 @@ bool ts::IPOutput::start()
     UString loc_name(value(u"local-address"));
     int ttl = intValue(u"ttl", 0);
     _pkt_burst = intValue(u"packet-burst", DEF_PACKET_BURST);
+    _txtime = present(u"txtime");
+    _pacing = _txtime || present(u"pacing") || present(u"pcr-pacing");
+    _pacer.reset();
+    _pacer.resetStatistics();
+    _pacer.usePCR(present(u"pcr-pacing"), intValue<PID>(u"pid-pcr", PID_NULL));
+
+    if (_txtime && !UDPSocket::TxTimeSupported()) {
+        tsp->error(u"--txtime is not supported on this system");
+        return false;
+    }
 
     // Create UDP socket
     bool ok = _sock.open(*tsp);
@@ -426,12 +460,17 @@ bool ts::IPOutput::start()
     if (ok) {
         ok = _sock.setDefaultDestination(dest_name, *tsp) &&
             (loc_name.empty() || _sock.setOutgoingMulticast(loc_name, *tsp)) &&
-            (ttl <= 0 || _sock.setTTL(ttl, _sock.setTTL(ttl, *tsp)));
+            (ttl <= 0 || _sock.setTTL(ttl, _sock.setTTL(ttl, *tsp))) &&
+            (!_txtime || _sock.enableTxTime(*tsp));
         if (!ok) {
             _sock.close();
         }
     }
 
+    if (ok && _pacing) {
+        tsp->verbose(u"datagram pacing, system timer latency is %'d nano-seconds", {Monotonic::SleepLatency()});
+    }
+
     return ok;
 }
 
@@ -442,6 +481,9 @@ bool ts::IPOutput::start()
 
 bool ts::IPOutput::stop()
 {
+    if (_pacing) {
+        tsp->verbose(u"pacing statistics: %s", {_pacer.statistics().toString()});
+    }
     _sock.close();
     return true;
 }
@@ -467,8 +509,34 @@ bool ts::IPOutput::send(const TSPacket* pkt, size_t packet_count)
 
     while (packet_count > 0) {
         size_t count = std::min(packet_count, _pkt_burst);
-        if (!_sock.send(pkt, count * PKT_SIZE, *tsp)) {
-            return false;
+        if (!_pacing) {
+            if (!_sock.send(pkt, count * PKT_SIZE, *tsp)) {
+                return false;
+            }
+        }
+        else {
+            // The datagram is due at the due time of its first packet.
+            _pacer.setBitrate(tsp->bitrate());
+            const Monotonic due(_pacer.feedPacket(pkt[0]));
+            if (_txtime) {
+                // Do not run too far ahead of the scheduled transmission times.
+                Monotonic ahead(due);
+                ahead -= TXTIME_LOOKAHEAD;
+                Monotonic now;
+                now.getSystemTime();
+                if (now < ahead) {
+                    ahead.wait();
+                }
+            }
+            else {
+                _pacer.wait();
+            }
+            for (size_t i = 1; i < count; ++i) {
+                _pacer.feedPacket(pkt[i]);
+            }
+            if (!_sock.send(pkt, count * PKT_SIZE, due, *tsp)) {
+                return false;
+            }
         }
         pkt += count;
         packet_count -= count;
@@ -62,7 +62,7 @@ namespace ts {
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
 
     private:
-        typedef MessageQueue<Section, Mutex> SectionQueue;
+        typedef MessageQueue<Section, AtomicRefCount> SectionQueue;
 
         // Plugin private fields.
         volatile bool  _terminate;      // Force termination flag for thread.
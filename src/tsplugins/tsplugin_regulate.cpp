@@ -35,6 +35,7 @@
 #include "tsPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsMonotonic.h"
+#include "tsPacketPacer.h"
 TSDUCK_SOURCE;
 
 #define DEF_PACKET_BURST 16
@@ -51,6 +52,7 @@ namespace ts {
         // Implementation of plugin API
         RegulatePlugin(TSP*);
         virtual bool start() override;
+        virtual bool stop() override;
         virtual Status processPacket(TSPacket&, bool&, bool&) override;
 
     private:
@@ -69,6 +71,8 @@ namespace ts {
         Monotonic     _burst_end;       // End of current burst
         Monotonic     _bitrate_start;   // Time of last bitrate change
         PacketCounter _bitrate_pkt_cnt; // Passed packets since last bitrate change
+        bool          _precise;         // Use precise pacing (hybrid sleep/spin wait)
+        PacketPacer   _pacer;           // Precise pacing of packets
 
         // Compute burst duration (_burst_duration and _burst_pkt_max), based on
         // required packets/burst (command line option) and current bitrate.
@@ -77,6 +81,9 @@ namespace ts {
         // Process one packet in a regulated burst. Wait at end of burst.
         Status regulatePacket(bool& flush, bool smoothen);
 
+        // Process one packet with precise pacing. Wait at start of burst.
+        Status pacePacket(const TSPacket& pkt, bool& flush);
+
         // Inaccessible operations
         RegulatePlugin() = delete;
         RegulatePlugin(const RegulatePlugin&) = delete;
@@ -104,10 +111,15 @@ ts::RegulatePlugin::RegulatePlugin(TSP* tsp_) :
     _burst_duration(0),
     _burst_end(),
     _bitrate_start(),
-    _bitrate_pkt_cnt(0)
+    _bitrate_pkt_cnt(0),
+    _precise(false),
+    _pacer()
 {
-    option(u"bitrate",      'b', POSITIVE);
-    option(u"packet-burst", 'p', POSITIVE);
+    option(u"bitrate",         'b', POSITIVE);
+    option(u"packet-burst",    'p', POSITIVE);
+    option(u"pcr-synchronous",  0);
+    option(u"pid-pcr",          0,  PIDVAL);
+    option(u"precise",          0);
 
     setHelp(u"Regulate (slow down only) the TS packets flow according to a specified\n"
             u"bitrate. Useful to play a non-regulated input (such as a TS file) to a\n"
@@ -129,6 +141,24 @@ ts::RegulatePlugin::RegulatePlugin(TSP* tsp_) :
             u"      output bitrate but influence smoothing and CPU load. The default\n"
             u"      is " TS_STRINGIFY(DEF_PACKET_BURST) u" packets.\n"
             u"\n"
+            u"  --pcr-synchronous\n"
+            u"      Regulate the flow according to the PCR's of the stream instead of its\n"
+            u"      average bitrate. The packets carrying PCR's are passed at the time\n"
+            u"      which is given by their PCR value and the packets in between are evenly\n"
+            u"      spaced. Before the first two PCR's are found, the bitrate is used.\n"
+            u"      Implies --precise.\n"
+            u"\n"
+            u"  --pid-pcr value\n"
+            u"      With --pcr-synchronous, specify the reference PID for PCR's. By default,\n"
+            u"      use the first PID containing PCR's.\n"
+            u"\n"
+            u"  --precise\n"
+            u"      Use a precise hybrid sleep/spin wait at the start of each burst. The\n"
+            u"      thread sleeps until slightly before the due time of the burst and then\n"
+            u"      actively waits for the exact due time. There is no minimum duration of\n"
+            u"      a burst and the jitter is much lower, at the expense of some CPU load.\n"
+            u"      Pacing statistics are reported in verbose mode.\n"
+            u"\n"
             u"  --version\n"
             u"      Display the version number.\n");
 }
@@ -143,6 +173,23 @@ bool ts::RegulatePlugin::start()
     // Get command line arguments
     _opt_bitrate = intValue<BitRate>(u"bitrate", 0);
     _opt_burst = intValue<PacketCounter>(u"packet-burst", DEF_PACKET_BURST);
+    _precise = present(u"precise") || present(u"pcr-synchronous");
+
+    // Reset state
+    _state = INITIAL;
+    _cur_bitrate = 0;
+    _burst_pkt_max = 0;
+    _burst_pkt_cnt = 0;
+    _burst_duration = 0;
+
+    if (_precise) {
+        // With a hybrid sleep/spin wait, there is no minimum burst duration.
+        _pacer.reset();
+        _pacer.resetStatistics();
+        _pacer.usePCR(present(u"pcr-synchronous"), intValue<PID>(u"pid-pcr", PID_NULL));
+        tsp->verbose(u"precise pacing, system timer latency is %'d nano-seconds", {Monotonic::SleepLatency()});
+        return true;
+    }
 
     // Compute the minimum delay between two bursts, in nano-seconds.
     // This is a limitation of the operating system. If we try to use
@@ -154,14 +201,19 @@ bool ts::RegulatePlugin::start()
     _burst_min = Monotonic::SetPrecision(2000000); // 2 milliseconds in nanoseconds
 
     tsp->verbose(u"minimum packet burst duration is %'d nano-seconds", {_burst_min});
+    return true;
+}
 
-    // Reset state
-    _state = INITIAL;
-    _cur_bitrate = 0;
-    _burst_pkt_max = 0;
-    _burst_pkt_cnt = 0;
-    _burst_duration = 0;
 
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::RegulatePlugin::stop()
+{
+    if (_precise) {
+        tsp->verbose(u"pacing statistics: %s", {_pacer.statistics().toString()});
+    }
     return true;
 }
 
@@ -233,6 +285,28 @@ ts::ProcessorPlugin::Status ts::RegulatePlugin::regulatePacket(bool& flush, bool
 }
 
 
+//----------------------------------------------------------------------------
+// Process one packet with precise pacing. Wait at start of burst.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::RegulatePlugin::pacePacket(const TSPacket& pkt, bool& flush)
+{
+    // Compute the due time of the packet. Without bitrate and PCR, it is due immediately.
+    _pacer.setBitrate(_cur_bitrate);
+    _pacer.feedPacket(pkt);
+
+    // At start of a burst, wait until the due time of its first packet and flush the previous burst.
+    if (_burst_pkt_cnt == 0) {
+        _pacer.wait();
+        _burst_pkt_cnt = _opt_burst;
+        flush = true;
+    }
+    _burst_pkt_cnt--;
+
+    return TSP_OK;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -253,6 +327,15 @@ ts::ProcessorPlugin::Status ts::RegulatePlugin::processPacket(TSPacket& pkt, boo
         }
     }
 
+    // Precise pacing does not use the burst state machine.
+    if (_precise) {
+        if (_cur_bitrate != old_bitrate || _state == INITIAL) {
+            _state = REGULATED;
+            bitrate_changed = true;
+        }
+        return pacePacket(pkt, flush);
+    }
+
     // Process with state machine
     switch (_state) {
 
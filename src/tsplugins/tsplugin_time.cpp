@@ -294,7 +294,7 @@ ts::ProcessorPlugin::Status ts::TimePlugin::processPacket(TSPacket& pkt, bool& f
 
     // Get current system time (unless TDT is used as reference)
     if (!_use_tdt) {
-        _last_time = _use_utc ? Time::CurrentUTC() : Time::CurrentLocalTime();
+        _last_time = _use_utc ? tsp->currentUTC() : tsp->currentLocalTime();
     }
 
     // Is it time to change the action?
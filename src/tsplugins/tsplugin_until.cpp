@@ -204,7 +204,7 @@ ts::ProcessorPlugin::Status ts::UntilPlugin::processPacket (TSPacket& pkt, bool&
     // Record time of first packet
     if (!_started) {
         _started = true;
-        _start_time = Time::CurrentUTC();
+        _start_time = tsp->currentUTC();
     }
 
     // Update context information
@@ -223,7 +223,7 @@ ts::ProcessorPlugin::Status ts::UntilPlugin::processPacket (TSPacket& pkt, bool&
         (_pack_max > 0 && _pack_cnt >= _pack_max) ||
         (_null_seq_max > 0 && _null_seq_cnt >= _null_seq_max) ||
         (_unit_start_max > 0 && _unit_start_cnt >= _unit_start_max) ||
-        (_msec_max && Time::CurrentUTC() - _start_time >= _msec_max);
+        (_msec_max && tsp->currentUTC() - _start_time >= _msec_max);
 
     // Update context information for next packet
     _previous_pid = pkt.getPID();
@@ -34,6 +34,8 @@
 #include "tsArgs.h"
 #include "tsMemoryUtils.h"
 #include "tsTSFileInputBuffered.h"
+#include "tsTSSparseFormat.h"
+#include "tsMemoryMappedFile.h"
 #include "tsBinaryTable.h"
 #include "tsSection.h"
 #include "tsPMT.h"
@@ -42,6 +44,8 @@
 TSDUCK_SOURCE;
 
 #define DEFAULT_BUFFERED_PACKETS 10000
+#define FAST_COMPARE_PACKETS     1024   // Max packets per block in fast comparison of memory-mapped files
+#define SUBSET_INDEX_PACKETS     65536  // Packets per read-ahead window in the hash index of --subset
 
 
 //----------------------------------------------------------------------------
@@ -162,7 +166,11 @@ Options::Options(int argc, char *argv[]) :
             u"      Specifies that the second file is a subset of the first one. This means\n"
             u"      that the second file is expected to be identical to the first one, except\n"
             u"      that some packets may be missing. When a difference is found, the first\n"
-            u"      file is read ahead until a matching packet is found.\n"
+            u"      file is read ahead until a matching packet is found. Unless --payload-only\n"
+            u"      or --threshold-diff is specified, the matching packet is located using a\n"
+            u"      hash of the packets, after applying --pcr-ignore, --pid-ignore and\n"
+            u"      --cc-ignore. When the first file is a regular file, the hashes of its\n"
+            u"      next packets are indexed and the matching packet is directly located.\n"
             u"      See also --threshold-diff.\n"
             u"\n"
             u"  -t value\n"
@@ -213,6 +221,264 @@ Options::Options(int argc, char *argv[]) :
 }
 
 
+//----------------------------------------------------------------------------
+//  Input file: memory-mapped when possible, buffered otherwise.
+//----------------------------------------------------------------------------
+
+class InputFile
+{
+public:
+    // Constructor.
+    InputFile(size_t buffered_packets);
+
+    // Open the file, starting at the specified byte offset.
+    bool open(const ts::UString& filename, uint64_t byte_offset, ts::Report& report);
+
+    // Close the file.
+    void close(ts::Report& report);
+
+    // Read one packet. Return a pointer to the packet or zero at end of file.
+    // The packet remains valid until the next read.
+    const ts::TSPacket* read(ts::Report& report);
+
+    // Check if the file is memory-mapped. When memory-mapped, the remaining
+    // packets in the file can be directly accessed and skipped.
+    bool isMapped() const {return _next != 0;}
+    const ts::TSPacket* nextPackets() const {return _next;}
+    size_t remainingPackets() const {return _end - _next;}
+    void skip(size_t count);
+
+    // Get the file name and the number of read packets.
+    ts::UString getFileName() const {return _filename;}
+    ts::PacketCounter getPacketCount() const {return _count;}
+
+private:
+    ts::UString             _filename;
+    ts::MemoryMappedFile    _mmap;   // Memory-mapped file.
+    ts::TSFileInputBuffered _file;   // Buffered file, when the file cannot be mapped.
+    const ts::TSPacket*     _next;   // Next packet in memory-mapped file.
+    const ts::TSPacket*     _end;    // End of memory-mapped packets.
+    ts::PacketCounter       _count;  // Number of read packets.
+    ts::TSPacket            _pkt;    // Last packet from buffered file.
+
+    // Inaccessible operations.
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+};
+
+InputFile::InputFile(size_t buffered_packets) :
+    _filename(),
+    _mmap(),
+    _file(buffered_packets),
+    _next(0),
+    _end(0),
+    _count(0),
+    _pkt()
+{
+}
+
+bool InputFile::open(const ts::UString& filename, uint64_t byte_offset, ts::Report& report)
+{
+    _next = _end = 0;
+    _count = 0;
+
+    // Pipes, sparse files and files which are too large for the address space are read through a buffer.
+    if (!filename.empty() && _mmap.open(filename) && (_mmap.size() < sizeof(ts::SPARSE_TS_MAGIC) || ::memcmp(_mmap.data(), ts::SPARSE_TS_MAGIC, sizeof(ts::SPARSE_TS_MAGIC)) != 0)) {
+        // A truncated packet at end of file is ignored, as in TSFileInput.
+        const size_t offset = size_t(std::min<uint64_t>(byte_offset, _mmap.size()));
+        const size_t count = (_mmap.size() - offset) / ts::PKT_SIZE;
+        _filename = filename;
+        if (count > 0) {
+            _next = reinterpret_cast<const ts::TSPacket*>(_mmap.data() + offset);
+            _end = _next + count;
+        }
+        else {
+            // Nothing to read, use a valid empty range.
+            _next = _end = &_pkt;
+        }
+        return true;
+    }
+    else {
+        _mmap.close();
+        const bool ok = _file.open(filename, 1, byte_offset, report);
+        _filename = _file.getFileName();
+        return ok;
+    }
+}
+
+void InputFile::close(ts::Report& report)
+{
+    if (_mmap.isOpen()) {
+        _mmap.close();
+        _next = _end = 0;
+    }
+    else {
+        _file.close(report);
+    }
+}
+
+const ts::TSPacket* InputFile::read(ts::Report& report)
+{
+    if (isMapped()) {
+        if (_next >= _end) {
+            return 0;
+        }
+        _count++;
+        return _next++;
+    }
+    else if (_file.read(&_pkt, 1, report) == 0) {
+        return 0;
+    }
+    else {
+        _count++;
+        return &_pkt;
+    }
+}
+
+void InputFile::skip(size_t count)
+{
+    assert(isMapped() && count <= remainingPackets());
+    _next += count;
+    _count += count;
+}
+
+
+//----------------------------------------------------------------------------
+//  Get the number of identical packets at the beginning of two memory areas.
+//  Large blocks are compared using memcmp(), which is vectorized in all
+//  decent C libraries.
+//----------------------------------------------------------------------------
+
+size_t IdenticalPackets(const ts::TSPacket* pkt1, const ts::TSPacket* pkt2, size_t count)
+{
+    if (::memcmp(pkt1, pkt2, count * ts::PKT_SIZE) == 0) {
+        return count;
+    }
+    size_t same = 0;
+    while (same < count && ::memcmp(pkt1[same].b, pkt2[same].b, ts::PKT_SIZE) == 0) {
+        same++;
+    }
+    return same;
+}
+
+
+//----------------------------------------------------------------------------
+//  Reset the fields which shall be ignored according to options.
+//----------------------------------------------------------------------------
+
+void Normalize(ts::TSPacket& pkt, const Options& opt)
+{
+    if (opt.pcr_ignore) {
+        if (pkt.hasPCR()) {
+            pkt.setPCR(0);
+        }
+        if (pkt.hasOPCR()) {
+            pkt.setOPCR(0);
+        }
+    }
+    if (opt.pid_ignore) {
+        pkt.setPID(ts::PID_NULL);
+    }
+    if (opt.cc_ignore) {
+        pkt.setCC(0);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Compute a hash of a packet, consistent with the comparison of packets
+//  (after normalization, all null packets are identical).
+//  Not used with --payload-only.
+//----------------------------------------------------------------------------
+
+uint64_t PacketHash(const ts::TSPacket& pkt, const Options& opt)
+{
+    const ts::TSPacket* p = &pkt;
+    ts::TSPacket norm;
+
+    if (pkt.getPID() == ts::PID_NULL) {
+        return 0;
+    }
+    else if (opt.pcr_ignore || opt.pid_ignore || opt.cc_ignore) {
+        norm = pkt;
+        Normalize(norm, opt);
+        p = &norm;
+    }
+
+    // FNV-1a on 64-bit words, the last 4 bytes are hashed as a 32-bit word.
+    uint64_t hash = TS_UCONST64(0xCBF29CE484222325);
+    for (size_t i = 0; i + 8 <= ts::PKT_SIZE; i += 8) {
+        hash = (hash ^ ts::GetUInt64(p->b + i)) * TS_UCONST64(0x00000100000001B3);
+    }
+    hash = (hash ^ ts::GetUInt32(p->b + ts::PKT_SIZE - 4)) * TS_UCONST64(0x00000100000001B3);
+
+    // Never return the hash of null packets.
+    return hash == 0 ? 1 : hash;
+}
+
+
+//----------------------------------------------------------------------------
+//  Index of packet hashes in a read-ahead window of a memory-mapped file.
+//  Used with --subset to locate the next packet of file2 in file1.
+//----------------------------------------------------------------------------
+
+class PacketHashIndex
+{
+public:
+    // Constructor.
+    PacketHashIndex() : _index(), _start(0), _end(0) {}
+
+    // Search the next packet with the specified hash in a memory-mapped file,
+    // starting at its current position. Return the number of packets before
+    // the found packet or the number of remaining packets when not found.
+    size_t search(const InputFile& file, uint64_t hash, const Options& opt);
+
+private:
+    typedef std::map<uint64_t, std::vector<ts::PacketCounter>> IndexMap;
+
+    IndexMap          _index;  // Packet hash => ascending packet indexes in the window.
+    ts::PacketCounter _start;  // Index of first packet in the window.
+    ts::PacketCounter _end;    // Index after last packet in the window.
+};
+
+size_t PacketHashIndex::search(const InputFile& file, uint64_t hash, const Options& opt)
+{
+    assert(file.isMapped());
+    const ts::PacketCounter first = file.getPacketCount();
+    const ts::PacketCounter last = first + file.remainingPackets();
+
+    // Restart from the current position when it is outside the window.
+    if (first < _start || first > _end) {
+        _index.clear();
+        _start = _end = first;
+    }
+
+    for (;;) {
+        // Look for the first packet with the same hash, at or after the current position.
+        const IndexMap::const_iterator it(_index.find(hash));
+        if (it != _index.end()) {
+            const std::vector<ts::PacketCounter>::const_iterator pos(std::lower_bound(it->second.begin(), it->second.end(), first));
+            if (pos != it->second.end()) {
+                return size_t(*pos - first);
+            }
+        }
+        if (_end >= last) {
+            return size_t(last - first);
+        }
+
+        // Not found, slide the window to the next packets.
+        const ts::TSPacket* const pkt = file.nextPackets() + (_end - first);
+        const size_t count = size_t(std::min<ts::PacketCounter>(SUBSET_INDEX_PACKETS, last - _end));
+        _index.clear();
+        _start = _end;
+        for (size_t i = 0; i < count; ++i) {
+            _index[PacketHash(pkt[i], opt)].push_back(_start + i);
+        }
+        _end = _start + count;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Packet comparator class
 //----------------------------------------------------------------------------
@@ -260,6 +526,9 @@ bool Comparator::compare(const uint8_t* mem1, size_t size1, const uint8_t* mem2,
 {
     diff_count = 0;
     first_diff = end_diff = compared_size = std::min (size1, size2);
+    if (::memcmp(mem1, mem2, compared_size) == 0) {
+        return equal = size1 == size2;
+    }
     for (size_t i = 0; i < compared_size; i++) {
         if (mem1[i] != mem2[i]) {
             diff_count++;
@@ -299,28 +568,8 @@ bool Comparator::compare(const ts::TSPacket& pkt1, const ts::TSPacket& pkt2, Opt
         ts::TSPacket p1, p2;
         p1 = pkt1;
         p2 = pkt2;
-        if (opt.pcr_ignore) {
-            if (p1.hasPCR()) {
-                p1.setPCR(0);
-            }
-            if (p1.hasOPCR()) {
-                p1.setOPCR(0);
-            }
-            if (p2.hasPCR()) {
-                p2.setPCR(0);
-            }
-            if (p2.hasOPCR()) {
-                p2.setOPCR(0);
-            }
-        }
-        if (opt.pid_ignore) {
-            p1.setPID(ts::PID_NULL);
-            p2.setPID(ts::PID_NULL);
-        }
-        if (opt.cc_ignore) {
-            p1.setCC(0);
-            p2.setCC(0);
-        }
+        Normalize(p1, opt);
+        Normalize(p2, opt);
         return compare(p1.b, ts::PKT_SIZE, p2.b, ts::PKT_SIZE);
     }
 }
@@ -334,12 +583,12 @@ int main (int argc, char *argv[])
 {
     TSDuckLibCheckVersion();
     Options opt (argc, argv);
-    ts::TSFileInputBuffered file1(opt.buffered_packets);
-    ts::TSFileInputBuffered file2(opt.buffered_packets);
+    InputFile file1(opt.buffered_packets);
+    InputFile file2(opt.buffered_packets);
 
     // Open files
-    file1.open(opt.filename1, 1, opt.byte_offset, opt);
-    file2.open(opt.filename2, 1, opt.byte_offset, opt);
+    file1.open(opt.filename1, opt.byte_offset, opt);
+    file2.open(opt.filename2, opt.byte_offset, opt);
     opt.exitOnError();
 
     // Display headers
@@ -363,34 +612,62 @@ int main (int argc, char *argv[])
     ts::PacketCounter total_subset_skipped = 0;
     ts::PacketCounter subset_skipped_chunks = 0;
 
+    // With --subset, the packets in file1 are searched by hash, when possible.
+    const bool subset_hash = opt.subset && opt.threshold_diff == 0 && !opt.payload_only;
+    uint64_t hash2 = 0;
+    PacketHashIndex hash_index;
+
     // Number of differences in file
     ts::PacketCounter diff_count = 0;
 
     // Read and compare all packets in the files
-    ts::TSPacket pkt1, pkt2;
-    size_t read2 = 0;
+    const ts::TSPacket* pkt1 = 0;
+    const ts::TSPacket* pkt2 = 0;
+    ts::PID pid1 = ts::PID_NULL;
     ts::PID pid2 = ts::PID_NULL;
 
     for (;;) {
 
+        // When both files are memory-mapped, skip blocks of identical packets.
+        // Identical packets are always equal, whatever the comparison options.
+        if (subset_skipped == 0 && file1.isMapped() && file2.isMapped()) {
+            size_t same = 0;
+            do {
+                const size_t count = std::min<size_t>(FAST_COMPARE_PACKETS, std::min(file1.remainingPackets(), file2.remainingPackets()));
+                const ts::TSPacket* const next = file1.nextPackets();
+                same = IdenticalPackets(next, file2.nextPackets(), count);
+                for (size_t i = 0; i < same; ++i) {
+                    const ts::PID pid = next[i].getPID();
+                    count1[pid]++;
+                    count2[pid]++;
+                }
+                file1.skip(same);
+                file2.skip(same);
+            } while (same == FAST_COMPARE_PACKETS);
+        }
+
         // Read one packet in file1
-        size_t read1 = file1.read (&pkt1, 1, opt);
-        ts::PID pid1 = pkt1.getPID();
-        count1[pid1]++;
+        pkt1 = file1.read(opt);
+        if (pkt1 != 0) {
+            pid1 = pkt1->getPID();
+            count1[pid1]++;
+        }
 
         // If currently not skipping packets, read one packet in file2
         if (subset_skipped == 0) {
-            read2 = file2.read (&pkt2, 1, opt);
-            pid2 = pkt2.getPID();
-            count2[pid2]++;
+            pkt2 = file2.read(opt);
+            if (pkt2 != 0) {
+                pid2 = pkt2->getPID();
+                count2[pid2]++;
+            }
         }
 
         // Exit if at least one file is terminated
-        if (read1 == 0 || read2 == 0) {
-            if (read1 != 0 || read2 != 0) {
+        if (pkt1 == 0 || pkt2 == 0) {
+            if (pkt1 != 0 || pkt2 != 0) {
                 diff_count++;
             }
-            if (read1 != 0) {
+            if (pkt1 != 0) {
                 // File 2 is truncated
                 if (opt.normalized) {
                     std::cout << "truncated:file=2:packet=" << file2.getPacketCount()
@@ -401,7 +678,7 @@ int main (int argc, char *argv[])
                               << ": file " << file2.getFileName() << " is truncated" << std::endl;
                 }
             }
-            if (read2 != 0) {
+            if (pkt2 != 0) {
                 // File 1 is truncated
                 if (opt.normalized) {
                     std::cout << "truncated:file=1:packet=" << file1.getPacketCount()
@@ -415,12 +692,31 @@ int main (int argc, char *argv[])
             break;
         }
 
+        // When reading ahead a buffered file1 for a packet from file2, quickly skip packets with a different hash.
+        if (subset_hash && subset_skipped > 0 && !file1.isMapped() && PacketHash(*pkt1, opt) != hash2) {
+            subset_skipped++;
+            continue;
+        }
+
         // Compare one packet
-        const Comparator comp (pkt1, pkt2, opt);
+        const Comparator comp(*pkt1, *pkt2, opt);
 
         // If file2 is a subset of file1 and an inacceptable difference has been found, read ahead file1.
         if (opt.subset && !comp.equal && comp.diff_count > opt.threshold_diff) {
+            if (subset_hash && subset_skipped == 0) {
+                hash2 = PacketHash(*pkt2, opt);
+            }
             subset_skipped++;
+            // In a memory-mapped file1, jump to the next packet with the same hash.
+            if (subset_hash && file1.isMapped()) {
+                const size_t count = hash_index.search(file1, hash2, opt);
+                const ts::TSPacket* const next = file1.nextPackets();
+                for (size_t i = 0; i < count; ++i) {
+                    count1[next[i].getPID()]++;
+                }
+                file1.skip(count);
+                subset_skipped += count;
+            }
             continue;
         }
 
@@ -479,14 +775,14 @@ int main (int argc, char *argv[])
                 std::cout << " in PID" << std::endl;
                 if (opt.dump) {
                     std::cout << "  Packet from " << file1.getFileName() << ":" << std::endl;
-                    pkt1.display (std::cout, opt.dump_flags, 6);
+                    pkt1->display(std::cout, opt.dump_flags, 6);
                     std::cout << "  Packet from " << file2.getFileName() << ":" << std::endl;
-                    pkt2.display (std::cout, opt.dump_flags, 6);
+                    pkt2->display(std::cout, opt.dump_flags, 6);
                     std::cout << "  Differing area from " << file1.getFileName() << ":" << std::endl
-                              << ts::UString::Dump(pkt1.b + (opt.payload_only ? pkt1.getHeaderSize() : 0) + comp.first_diff,
+                              << ts::UString::Dump(pkt1->b + (opt.payload_only ? pkt1->getHeaderSize() : 0) + comp.first_diff,
                                                    comp.end_diff - comp.first_diff, opt.dump_flags, 6)
                               << "  Differing area from " << file2.getFileName() << ":" << std::endl
-                              << ts::UString::Dump(pkt2.b + (opt.payload_only ? pkt2.getHeaderSize() : 0) + comp.first_diff,
+                              << ts::UString::Dump(pkt2->b + (opt.payload_only ? pkt2->getHeaderSize() : 0) + comp.first_diff,
                                                    comp.end_diff - comp.first_diff, opt.dump_flags, 6);
                 }
             }
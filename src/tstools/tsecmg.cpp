@@ -0,0 +1,355 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Minimal ECMG simulator, for load tests of scramblers without a real CAS.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tstlvServer.h"
+#include "tsECMGSCS.h"
+#include "tsOneShotPacketizer.h"
+#include "tsUserInterrupt.h"
+#include "tsIPUtils.h"
+#include "tsVersionInfo.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+namespace {
+    struct Options: public ts::Args
+    {
+        Options(int argc, char *argv[]);
+
+        ts::SocketAddress address;         // Local address and port to listen to.
+        size_t            ecm_size;        // Size in bytes of the ECM sections.
+        bool              packets;         // Return ECM's as TS packets, not sections.
+        uint16_t          rep_period;      // ECM repetition period in milliseconds.
+        uint16_t          min_cp_duration; // Minimum crypto-period duration in units of 100 ms.
+        uint16_t          comp_time;       // Max ECM computation time in milliseconds.
+        uint16_t          max_streams;     // Maximum number of streams per channel.
+    };
+}
+
+Options::Options(int argc, char *argv[]) :
+    Args(u"Minimal DVB SimulCrypt ECMG simulator.", u"[options]"),
+    address(),
+    ecm_size(0),
+    packets(false),
+    rep_period(0),
+    min_cp_duration(0),
+    comp_time(0),
+    max_streams(0)
+{
+    option(u"comp-time",        0,  UINT16);
+    option(u"ecm-size",        'e', INTEGER, 0, 1, 16, ts::MAX_PRIVATE_SECTION_SIZE);
+    option(u"local-address",   'l', STRING);
+    option(u"max-streams",      0,  UINT16);
+    option(u"min-cp-duration",  0,  UINT16);
+    option(u"packets",          0);
+    option(u"port",            'p', UINT16, 1, 1);
+    option(u"repetition",      'r', UINT16);
+
+    setHelp(u"Options:\n"
+            u"\n"
+            u"  --comp-time value\n"
+            u"      Maximum ECM computation time in milliseconds, as reported to the clients\n"
+            u"      in the channel_status messages. The default is 100 ms. ECM's are always\n"
+            u"      returned immediately.\n"
+            u"\n"
+            u"  -e value\n"
+            u"  --ecm-size value\n"
+            u"      Size in bytes of the generated ECM sections. The default is 100 bytes.\n"
+            u"\n"
+            u"  --help\n"
+            u"      Display this help text.\n"
+            u"\n"
+            u"  -l address\n"
+            u"  --local-address address\n"
+            u"      Local IP address or host name of the interface to listen to. By default,\n"
+            u"      all local interfaces are used.\n"
+            u"\n"
+            u"  --max-streams value\n"
+            u"      Maximum number of streams per channel, as reported to the clients.\n"
+            u"      The default is zero (unlimited).\n"
+            u"\n"
+            u"  --min-cp-duration value\n"
+            u"      Minimum crypto-period duration in units of 100 ms, as reported to the\n"
+            u"      clients. The default is 10 (one second).\n"
+            u"\n"
+            u"  --packets\n"
+            u"      Return the ECM's as TS packets. By default, ECM's are returned as\n"
+            u"      sections.\n"
+            u"\n"
+            u"  -p value\n"
+            u"  --port value\n"
+            u"      TCP port to listen to for ECMG <=> SCS connections. This is a required\n"
+            u"      parameter.\n"
+            u"\n"
+            u"  -r value\n"
+            u"  --repetition value\n"
+            u"      ECM repetition period in milliseconds, as reported to the clients.\n"
+            u"      The default is 100 ms.\n"
+            u"\n"
+            u"  -v\n"
+            u"  --verbose\n"
+            u"      Produce verbose messages.\n"
+            u"\n"
+            u"  --version\n"
+            u"      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    ecm_size = intValue<size_t>(u"ecm-size", 100);
+    packets = present(u"packets");
+    rep_period = intValue<uint16_t>(u"repetition", 100);
+    min_cp_duration = intValue<uint16_t>(u"min-cp-duration", 10);
+    comp_time = intValue<uint16_t>(u"comp-time", 100);
+    max_streams = intValue<uint16_t>(u"max-streams", 0);
+
+    ts::IPAddress local(ts::IPAddress::AnyAddress);
+    if (present(u"local-address")) {
+        local.resolve(value(u"local-address"), *this);
+    }
+    address = ts::SocketAddress(local, intValue<uint16_t>(u"port"));
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+//  The ECMG simulator handles all clients in the server thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ECMGSimulator: public ts::tlv::ServerHandlerInterface, public ts::InterruptHandler
+    {
+    public:
+        ECMGSimulator(Options& opt);
+
+        // Serve all clients until interrupted.
+        bool run();
+
+        // Implementation of interfaces.
+        virtual bool handleTLVConnect(ts::tlv::Server& server, const ts::tlv::ServerConnectionPtr& client, ts::Report& report) override;
+        virtual bool handleTLVMessage(ts::tlv::Server& server, const ts::tlv::ServerConnectionPtr& client, const ts::tlv::MessagePtr& msg, ts::Report& report) override;
+        virtual void handleTLVDisconnect(ts::tlv::Server& server, const ts::tlv::ServerConnectionPtr& client, ts::Report& report) override;
+        virtual void handleInterrupt() override;
+
+    private:
+        Options&           _opt;
+        ts::tlv::Server    _server;
+        uint64_t           _client_count;
+        uint64_t           _channel_count;
+        uint64_t           _stream_count;
+        uint64_t           _ecm_count;
+        ts::ByteBlock      _payload;  // Reused ECM section payload.
+        ts::TSPacketVector _packets;  // Reused ECM packets.
+
+        // Build an ECM for a CW_provision message.
+        void buildECM(const ts::ecmgscs::CWProvision& cwp, ts::ecmgscs::ECMResponse& response);
+
+        // Inaccessible operations.
+        ECMGSimulator() = delete;
+        ECMGSimulator(const ECMGSimulator&) = delete;
+        ECMGSimulator& operator=(const ECMGSimulator&) = delete;
+    };
+}
+
+ECMGSimulator::ECMGSimulator(Options& opt) :
+    _opt(opt),
+    _server(ts::ecmgscs::Protocol::Instance(), this),
+    _client_count(0),
+    _channel_count(0),
+    _stream_count(0),
+    _ecm_count(0),
+    _payload(),
+    _packets()
+{
+}
+
+bool ECMGSimulator::run()
+{
+    if (!_server.open(_opt.address, _opt)) {
+        return false;
+    }
+    _opt.verbose(u"ECMG listening on %s", {_opt.address.toString()});
+
+    // Serve all clients until interrupted.
+    const bool ok = _server.run(0, _opt);
+    _server.close(_opt);
+
+    _opt.verbose(u"%'d clients, %'d channels, %'d streams, %'d ECM's", {_client_count, _channel_count, _stream_count, _ecm_count});
+    return ok;
+}
+
+void ECMGSimulator::handleInterrupt()
+{
+    _server.stop();
+}
+
+bool ECMGSimulator::handleTLVConnect(ts::tlv::Server& server, const ts::tlv::ServerConnectionPtr& client, ts::Report& report)
+{
+    _client_count++;
+    report.verbose(u"client %s connected, %d active clients", {client->peerName(), server.clientCount()});
+    return true;
+}
+
+void ECMGSimulator::handleTLVDisconnect(ts::tlv::Server& server, const ts::tlv::ServerConnectionPtr& client, ts::Report& report)
+{
+    report.verbose(u"client %s disconnected", {client->peerName()});
+}
+
+
+//----------------------------------------------------------------------------
+//  Process a message from a client.
+//----------------------------------------------------------------------------
+
+bool ECMGSimulator::handleTLVMessage(ts::tlv::Server& server, const ts::tlv::ServerConnectionPtr& client, const ts::tlv::MessagePtr& msg, ts::Report& report)
+{
+    switch (msg->tag()) {
+        case ts::ecmgscs::Tags::channel_setup:
+        case ts::ecmgscs::Tags::channel_test: {
+            const ts::tlv::ChannelMessage* m = dynamic_cast<const ts::tlv::ChannelMessage*>(msg.pointer());
+            assert(m != 0);
+            if (msg->tag() == ts::ecmgscs::Tags::channel_setup) {
+                _channel_count++;
+            }
+            ts::ecmgscs::ChannelStatus resp;
+            resp.channel_id = m->channel_id;
+            resp.section_TSpkt_flag = _opt.packets;
+            resp.ECM_rep_period = _opt.rep_period;
+            resp.max_streams = _opt.max_streams;
+            resp.min_CP_duration = _opt.min_cp_duration;
+            resp.lead_CW = 1;
+            resp.CW_per_msg = 2;
+            resp.max_comp_time = _opt.comp_time;
+            return client->send(resp, report);
+        }
+        case ts::ecmgscs::Tags::stream_setup:
+        case ts::ecmgscs::Tags::stream_test: {
+            const ts::tlv::StreamMessage* m = dynamic_cast<const ts::tlv::StreamMessage*>(msg.pointer());
+            const ts::ecmgscs::StreamSetup* setup = dynamic_cast<const ts::ecmgscs::StreamSetup*>(msg.pointer());
+            assert(m != 0);
+            if (setup != 0) {
+                _stream_count++;
+            }
+            ts::ecmgscs::StreamStatus resp;
+            resp.channel_id = m->channel_id;
+            resp.stream_id = m->stream_id;
+            resp.ECM_id = setup != 0 ? setup->ECM_id : 0;
+            resp.access_criteria_transfer_mode = false;
+            return client->send(resp, report);
+        }
+        case ts::ecmgscs::Tags::stream_close_request: {
+            const ts::tlv::StreamMessage* m = dynamic_cast<const ts::tlv::StreamMessage*>(msg.pointer());
+            assert(m != 0);
+            ts::ecmgscs::StreamCloseResponse resp;
+            resp.channel_id = m->channel_id;
+            resp.stream_id = m->stream_id;
+            return client->send(resp, report);
+        }
+        case ts::ecmgscs::Tags::CW_provision: {
+            const ts::ecmgscs::CWProvision* m = dynamic_cast<const ts::ecmgscs::CWProvision*>(msg.pointer());
+            assert(m != 0);
+            ts::ecmgscs::ECMResponse resp;
+            buildECM(*m, resp);
+            _ecm_count++;
+            return client->send(resp, report);
+        }
+        case ts::ecmgscs::Tags::channel_close: {
+            // The client will disconnect.
+            return true;
+        }
+        default: {
+            report.debug(u"ignored message 0x%X from %s", {msg->tag(), client->peerName()});
+            return true;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Build a fake ECM. The CW's are in clear, this is only a simulator.
+//----------------------------------------------------------------------------
+
+void ECMGSimulator::buildECM(const ts::ecmgscs::CWProvision& cwp, ts::ecmgscs::ECMResponse& response)
+{
+    response.channel_id = cwp.channel_id;
+    response.stream_id = cwp.stream_id;
+    response.CP_number = cwp.CP_number;
+
+    // ECM section payload: CP number, then CP/CW combinations, then stuffing.
+    const size_t payload_size = _opt.ecm_size - ts::SHORT_SECTION_HEADER_SIZE;
+    _payload.clear();
+    _payload.appendUInt16(cwp.CP_number);
+    for (size_t i = 0; i < cwp.CP_CW_combination.size() && _payload.size() + 3 + cwp.CP_CW_combination[i].CW.size() <= payload_size; ++i) {
+        _payload.appendUInt16(cwp.CP_CW_combination[i].CP);
+        _payload.appendUInt8(uint8_t(cwp.CP_CW_combination[i].CW.size()));
+        _payload.append(cwp.CP_CW_combination[i].CW);
+    }
+    _payload.resize(payload_size, 0xFF);
+
+    // Table id 0x80 or 0x81, depending on the crypto-period parity.
+    const ts::SectionPtr section(new ts::Section(ts::TID(ts::TID_ECM_80 | (cwp.CP_number & 0x01)), true, _payload.data(), _payload.size()));
+
+    if (_opt.packets) {
+        ts::OneShotPacketizer pzer(ts::PID_NULL, true);
+        pzer.addSection(section);
+        pzer.getPackets(_packets);
+        response.ECM_datagram.copy(_packets.data(), _packets.size() * ts::PKT_SIZE);
+    }
+    else {
+        response.ECM_datagram.copy(section->content(), section->size());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    TSDuckLibCheckVersion();
+    Options opt(argc, argv);
+
+    if (!ts::IPInitialize(opt)) {
+        return EXIT_FAILURE;
+    }
+
+    ts::IgnorePipeSignal();
+
+    ECMGSimulator ecmg(opt);
+    ts::UserInterrupt interrupt_manager(&ecmg, true, true);
+    return ecmg.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
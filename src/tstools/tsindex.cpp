@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Build the sidecar index of a transport stream file.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsTSFileInput.h"
+#include "tsTSFileIndex.h"
+#include "tsVersionInfo.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    ts::UString     infile;    // Input TS file name
+    ts::UString     outfile;   // Output index file name
+    ts::MilliSecond interval;  // Interval between index entries
+    bool            display;   // Display index content
+};
+
+Options::Options(int argc, char *argv[]) :
+    Args(u"Build the index of a transport stream file for time-based seeking.", u"[options] filename"),
+    infile(),
+    outfile(),
+    interval(0),
+    display(false)
+{
+    option(u"",          0,  Args::STRING, 1, 1);
+    option(u"display",  'd');
+    option(u"interval", 'i', Args::POSITIVE);
+    option(u"output",   'o', Args::STRING);
+
+    setHelp(u"Input file:\n"
+            u"\n"
+            u"  MPEG transport stream file to index.\n"
+            u"\n"
+            u"Options:\n"
+            u"\n"
+            u"  -d\n"
+            u"  --display\n"
+            u"      Display the content of the index.\n"
+            u"\n"
+            u"  --help\n"
+            u"      Display this help text.\n"
+            u"\n"
+            u"  -i value\n"
+            u"  --interval value\n"
+            u"      Minimum interval in milliseconds between two indexed PCR's and between\n"
+            u"      two indexed random access points in the same PID. This is the precision\n"
+            u"      of the time-based positioning in the file (default: 500 ms).\n"
+            u"\n"
+            u"  -o filename\n"
+            u"  --output filename\n"
+            u"      Name of the index file to create. The default is the input file name\n"
+            u"      plus \".tsidx\", the default index file name of the input plugin file.\n"
+            u"\n"
+            u"  --verbose\n"
+            u"      Produce verbose output.\n"
+            u"\n"
+            u"  --version\n"
+            u"      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    infile = value(u"");
+    outfile = value(u"output", ts::TSFileIndex::IndexFileName(infile).c_str());
+    interval = intValue<ts::MilliSecond>(u"interval", ts::TSFileIndex::DEFAULT_INTERVAL);
+    display = present(u"display");
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+//  Format an elapsed time.
+//----------------------------------------------------------------------------
+
+namespace {
+    ts::UString Elapsed(ts::MilliSecond ms)
+    {
+        return ts::UString::Format(u"%02d:%02d:%02d.%03d", {ms / ts::MilliSecPerHour, (ms / ts::MilliSecPerMin) % 60, (ms / ts::MilliSecPerSec) % 60, ms % 1000});
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    TSDuckLibCheckVersion();
+    Options opt(argc, argv);
+    ts::TSFileIndex index(opt.interval);
+    ts::TSFileInput file;
+
+    // Read all packets in the file and pass them to the indexer.
+    if (!file.open(opt.infile, 1, 0, opt)) {
+        return EXIT_FAILURE;
+    }
+    std::vector<ts::TSPacket> buffer(1024);
+    size_t count = 0;
+    while ((count = file.read(&buffer[0], buffer.size(), opt)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            index.feedPacket(buffer[i]);
+        }
+    }
+    file.close(opt);
+
+    if (!index.save(opt.outfile, opt)) {
+        return EXIT_FAILURE;
+    }
+    opt.verbose(u"%s: %'d packets, %s, %'d index entries", {opt.outfile, index.packetCount(), Elapsed(index.duration()), index.entries().size()});
+
+    if (opt.display) {
+        static const ts::UChar* const names[] = {u"", u"PCR", u"UTC", u"RAP", u"PSI"};
+        std::cout << "Reference PCR PID: " << (index.pcrPID() == ts::PID_NULL ? ts::UString(u"none") : ts::UString::Format(u"0x%X (%d)", {index.pcrPID(), index.pcrPID()})) << std::endl
+                  << "Duration: " << Elapsed(index.duration()) << std::endl
+                  << std::endl
+                  << "      Packet       Elapsed  PID     Type  Value" << std::endl
+                  << "------------  ------------  ------  ----  -----------------------" << std::endl;
+        for (ts::TSFileIndex::EntryVector::const_iterator it = index.entries().begin(); it != index.entries().end(); ++it) {
+            ts::UString value;
+            switch (it->type) {
+                case ts::TSFileIndex::PCR_ENTRY:
+                    value = ts::UString::Decimal(it->value);
+                    break;
+                case ts::TSFileIndex::UTC_ENTRY:
+                    value = (ts::Time::Epoch + ts::MilliSecond(it->value)).format(ts::Time::DATE | ts::Time::TIME);
+                    break;
+                case ts::TSFileIndex::RAP_ENTRY:
+                    value = it->value != 0 ? u"random access" : u"PES start";
+                    break;
+                case ts::TSFileIndex::PSI_ENTRY:
+                    value = ts::UString::Format(u"tid 0x%02X, ext 0x%04X, v%d", {it->value >> 24, (it->value >> 8) & 0xFFFF, it->value & 0xFF});
+                    break;
+                default:
+                    break;
+            }
+            std::cout << ts::UString::Format(u"%12'd  %s  0x%04X  %s   %s", {it->packet, Elapsed(it->elapsed), it->pid, names[it->type < 5 ? it->type : 0], value}) << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -116,6 +116,11 @@ int main(int argc, char *argv[])
     plugins->setSharedLibraryAllowed(false);
 #endif
 
+    // Process the --create-plugin-manifest option
+    if (!opt.manifest_dir.empty()) {
+        return ts::PluginManifest::Create(opt.manifest_dir, opt) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // Process the --list-processors option
     if (opt.list_proc) {
         // Build the list of plugins.
@@ -154,7 +159,7 @@ int main(int argc, char *argv[])
     // high as the input which must remain the top-most priority?
 
     ts::tsp::InputExecutor* input = new ts::tsp::InputExecutor(&opt, &opt.input, ts::ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), global_mutex);
-    ts::tsp::OutputExecutor* output = new ts::tsp::OutputExecutor(&opt, &opt.output, ts::ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), global_mutex);
+    ts::tsp::OutputExecutor* output = new ts::tsp::OutputExecutor(&opt, &opt.outputs[0], ts::ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), global_mutex);
     output->ringInsertAfter(input);
 
     for (ts::tsp::Options::PluginOptionsVector::const_iterator it = opt.plugins.begin(); it != opt.plugins.end(); ++it) {
@@ -199,7 +204,7 @@ int main(int argc, char *argv[])
 
     // Start the output device (we now have an idea of the bitrate).
     // Exit application in case of error.
-    if (!output->plugin()->start()) {
+    if (!output->startOutputs()) {
         return EXIT_FAILURE;
     }
 
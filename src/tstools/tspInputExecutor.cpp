@@ -32,7 +32,6 @@
 //----------------------------------------------------------------------------
 
 #include "tspInputExecutor.h"
-#include "tsPCRAnalyzer.h"
 #include "tsTime.h"
 TSDUCK_SOURCE;
 
@@ -58,7 +57,8 @@ ts::tsp::InputExecutor::InputExecutor(Options* options,
     _instuff_start_remain(options->instuff_start),
     _instuff_stop_remain(options->instuff_stop),
     _instuff_nullpkt_remain(0),
-    _instuff_inpkt_remain(0)
+    _instuff_inpkt_remain(0),
+    _pcr_analyzer(1, 32)  // 1 PID, 32 PCR's per bitrate adjustment interval
 {
 }
 
@@ -90,11 +90,13 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer)
         // The input device cannot evaluate a bitrate.
         // Try to determine the original bitrate from PCR analysis.
         // Say we need at least 32 PCR's per PID, on at least 1 PID.
-        PCRAnalyzer zer(1, 32); // 1 PID, 32 PCR's
-        for (size_t p = 0; p < pkt_read && !zer.feedPacket(buffer->base()[p]); p++) {}
-        if (zer.bitrateIsValid()) {
-            init_bitrate = zer.bitrate188();
+        // Analyze all packets in buffer, the least-squares regression
+        // is more accurate with more PCR's.
+        if (_pcr_analyzer.feedPackets(buffer->base(), pkt_read)) {
+            init_bitrate = _pcr_analyzer.regressionBitrate188();
         }
+        // Periodic bitrate adjustments will use the PCR's which are received from now on.
+        _pcr_analyzer.reset();
     }
     if (init_bitrate == 0) {
         // Still no bitrate available from PCR, try DTS from video PID's.
@@ -102,11 +104,8 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer)
         // buffer, do not stop when bitrate is supposedly known.
         PCRAnalyzer zer;
         zer.resetAndUseDTS(1, 32); // 1 PID, 32 DTS
-        for (size_t p = 0; p < pkt_read; p++) {
-            zer.feedPacket(buffer->base()[p]);
-        }
-        if (zer.bitrateIsValid()) {
-            init_bitrate = zer.bitrate188();
+        if (zer.feedPackets(buffer->base(), pkt_read)) {
+            init_bitrate = zer.regressionBitrate188();
         }
     }
     if (init_bitrate == 0) {
@@ -332,14 +331,28 @@ void ts::tsp::InputExecutor::main()
         // Overall input is completed when input plugin and trailing stuffing are completed.
         input_end = plugin_completed && _instuff_stop_remain == 0;
 
+        // Collect the PCR's of the received packets, in case the plugin cannot evaluate the bitrate.
+        if (_input_bitrate == 0) {
+            _pcr_analyzer.feedPackets(_buffer->base() + pkt_first, pkt_read);
+        }
+
         // Process periodic bitrate adjustment: get current input bitrate.
         if (_input_bitrate == 0 && (current_time = Time::CurrentUTC()) > bitrate_due_time) {
             // Compute time for next bitrate adjustment. Note that we do not
             // use a monotonic time (we use current time and not due time as
             // base for next calculation).
             bitrate_due_time = current_time + _bitrate_adj;
-            // Call shared library to get input bitrate
-            if ((bitrate = getBitrate()) > 0) {
+            // Call shared library to get input bitrate. If the plugin cannot evaluate
+            // it, use the PCR's which were received since the last adjustment. If there
+            // are not enough PCR's, continue the analysis until the next adjustment.
+            bitrate = getBitrate();
+            if (bitrate == 0 && _pcr_analyzer.bitrateIsValid()) {
+                bitrate = _pcr_analyzer.regressionBitrate188();
+            }
+            if (_pcr_analyzer.bitrateIsValid()) {
+                _pcr_analyzer.reset();
+            }
+            if (bitrate > 0) {
                 // Keep this bitrate
                 _tsp_bitrate = bitrate;
                 if (debug()) {
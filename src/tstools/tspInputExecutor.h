@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tspPluginExecutor.h"
+#include "tsPCRAnalyzer.h"
 
 namespace ts {
     namespace tsp {
@@ -82,6 +83,7 @@ namespace ts {
             size_t            _instuff_stop_remain;
             size_t            _instuff_nullpkt_remain;
             size_t            _instuff_inpkt_remain;
+            PCRAnalyzer       _pcr_analyzer;      // Continuous bitrate evaluation from PCR's
 
             // Inherited from Thread
             virtual void main() override;
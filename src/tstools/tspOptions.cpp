@@ -39,6 +39,7 @@ TSDUCK_SOURCE;
 #define DEF_BUFSIZE_MB           16  // mega-bytes
 #define DEF_BITRATE_INTERVAL      5  // seconds
 #define DEF_MAX_FLUSH_PKT     10000  // packets
+#define DEF_OUTPUT_LAG_PKT    50000  // packets
 
 // Displayable names of plugin types.
 const ts::Enumeration ts::tsp::Options::PluginTypeNames({
@@ -47,6 +48,12 @@ const ts::Enumeration ts::tsp::Options::PluginTypeNames({
     {u"packet processor", ts::tsp::Options::PROCESSOR},
 });
 
+// Displayable names of lag policies.
+const ts::Enumeration ts::tsp::Options::LagPolicyNames({
+    {u"block", ts::tsp::Options::LAG_BLOCK},
+    {u"drop",  ts::tsp::Options::LAG_DROP},
+});
+
 
 //----------------------------------------------------------------------------
 // Constructor from command line options
@@ -55,6 +62,7 @@ const ts::Enumeration ts::tsp::Options::PluginTypeNames({
 ts::tsp::Options::Options(int argc, char *argv[]) :
     timed_log(false),
     list_proc(false),
+    manifest_dir(),
     monitor(false),
     ignore_jt(false),
     sync_log(false),
@@ -69,14 +77,17 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     bitrate(0),
     bitrate_adj(0),
     input(),
-    output(),
-    plugins()
+    outputs(),
+    plugins(),
+    output_max_lag(),
+    output_lag_policy()
 {
     option(u"add-input-stuffing",       'a', Args::STRING);
     option(u"add-start-stuffing",        0,  Args::UNSIGNED);
     option(u"add-stop-stuffing",         0,  Args::UNSIGNED);
     option(u"bitrate",                  'b', Args::POSITIVE);
     option(u"bitrate-adjust-interval",   0,  Args::POSITIVE);
+    option(u"create-plugin-manifest",    0,  Args::STRING);
     option(u"buffer-size-mb",            0,  Args::POSITIVE);
     option(u"ignore-joint-termination", 'i');
     option(u"list-processors",          'l');
@@ -85,6 +96,8 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     option(u"max-input-packets",         0,  Args::POSITIVE);
     option(u"no-realtime-clock",         0); // was a temporary workaround, now ignored
     option(u"monitor",                  'm');
+    option(u"output-lag-policy",         0,  LagPolicyNames, 0, UNLIMITED_COUNT);
+    option(u"output-max-lag",            0,  Args::POSITIVE, 0, UNLIMITED_COUNT);
     option(u"synchronous-log",          's');
     option(u"timed-log",                't');
 
@@ -110,7 +123,7 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     setSyntax(u" [tsp-options] \\\n"
               u"    [-I input-name [input-options]] \\\n"
               u"    [-P processor-name [processor-options]] ... \\\n"
-              u"    [-O output-name [output-options]]");
+              u"    [-O output-name [output-options]] ...");
 
     setHelp(u"All tsp-options must be placed on the command line before the input,\n"
             u"processors and output specifications. The tsp-options are:\n"
@@ -151,6 +164,13 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"      the buffer between the input and output devices. The default\n"
             u"      is " TS_USTRINGIFY(DEF_BUFSIZE_MB) u" MB.\n"
             u"\n"
+            u"  --create-plugin-manifest directory\n"
+            u"      Create a manifest of all plugins in the specified directory and exit.\n"
+            u"      The manifest records the name, capabilities and description of each\n"
+            u"      plugin. Using it, tsp locates the plugins of the command line without\n"
+            u"      searching and --list-processors does not load all plugins. This is\n"
+            u"      typically done when TSDuck is built or installed.\n"
+            u"\n"
             u"  -d[N]\n"
             u"  --debug[=N]\n"
             u"      Produce debug output. Specify an optional debug level N.\n"
@@ -199,6 +219,24 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"      This includes CPU load, virtual memory usage. Useful to verify the\n"
             u"      stability of the application.\n"
             u"\n"
+            u"  --output-lag-policy value\n"
+            u"      Specify what to do when an output plugin lags behind the processing\n"
+            u"      chain by more than its maximum lag (see --output-max-lag). Only used\n"
+            u"      when several output plugins are specified. Must be one of \"block\"\n"
+            u"      (wait for the output to catch up, the default) or \"drop\" (drop the\n"
+            u"      packets which do not fit in the output queue, never delay the other\n"
+            u"      outputs). This option may be specified several times, the Nth value\n"
+            u"      applies to the Nth output plugin. The last value applies to all\n"
+            u"      remaining output plugins.\n"
+            u"\n"
+            u"  --output-max-lag value\n"
+            u"      Specify the maximum number of packets an output plugin may lag behind\n"
+            u"      the processing chain. Only used when several output plugins are\n"
+            u"      specified. This is the size of the packet queue of each output plugin.\n"
+            u"      The default is " TS_USTRINGIFY(DEF_OUTPUT_LAG_PKT) u" packets. This option may be specified\n"
+            u"      several times, the Nth value applies to the Nth output plugin. The last\n"
+            u"      value applies to all remaining output plugins.\n"
+            u"\n"
             u"  -s\n"
             u"  --synchronous-log\n"
             u"      Each logged message is guaranteed to be displayed, synchronously, without\n"
@@ -230,7 +268,11 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             u"  -O name\n"
             u"  --output name\n"
             u"      Designate the " HELP_SHLIB u" plug-in for packet output.\n"
-            u"      By default, write packets to standard output.\n"
+            u"      By default, write packets to standard output. Several output plug-in's\n"
+            u"      are allowed. In that case, the processed stream is sent to all of them\n"
+            u"      (\"tee\" output). Each output plug-in then runs in its own thread with\n"
+            u"      its own packet queue so that a slow output does not delay the others,\n"
+            u"      within the limits of --output-max-lag and --output-lag-policy.\n"
             u"\n"
             u"  -P name\n"
             u"  --processor name\n"
@@ -276,6 +318,7 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
 
     timed_log = present(u"timed-log");
     list_proc = present(u"list-processors");
+    getValue(manifest_dir, u"create-plugin-manifest");
     monitor = present(u"monitor");
     sync_log = present(u"synchronous-log");
     bufsize = 1024 * 1024 * intValue<size_t>(u"buffer-size-mb", DEF_BUFSIZE_MB);
@@ -298,15 +341,10 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     input.name = u"file";
     input.args.clear();
 
-    // The default output is the standard output file.
-    output.type = OUTPUT;
-    output.name = u"file";
-    output.args.clear();
-
     // Locate all plugins
     plugins.reserve(args.size());
+    outputs.reserve(args.size());
     bool got_input = false;
-    bool got_output = false;
 
     while (plugin_index < args.size()) {
 
@@ -335,11 +373,8 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
                 opt = &input;
                 break;
             case OUTPUT:
-                if (got_output) {
-                    error(u"do not specify more than one output plugin");
-                }
-                got_output = true;
-                opt = &output;
+                outputs.resize(outputs.size() + 1);
+                opt = &outputs[outputs.size() - 1];
                 break;
             default:
                 // Should not get there
@@ -352,6 +387,24 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
         opt->args.insert(opt->args.begin(), args.begin() + start + 2, args.begin() + plugin_index);
     }
 
+    // The default output is the standard output file.
+    if (outputs.empty()) {
+        outputs.resize(1);
+        outputs[0].type = OUTPUT;
+        outputs[0].name = u"file";
+        outputs[0].args.clear();
+    }
+
+    // Lag budget and policy of each output. The last specified value applies to all remaining outputs.
+    const size_t lag_count = count(u"output-max-lag");
+    const size_t policy_count = count(u"output-lag-policy");
+    output_max_lag.resize(outputs.size());
+    output_lag_policy.resize(outputs.size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        output_max_lag[i] = lag_count == 0 ? DEF_OUTPUT_LAG_PKT : intValue<size_t>(u"output-max-lag", DEF_OUTPUT_LAG_PKT, std::min(i, lag_count - 1));
+        output_lag_policy[i] = policy_count == 0 ? LAG_BLOCK : enumValue<LagPolicy>(u"output-lag-policy", LAG_BLOCK, std::min(i, policy_count - 1));
+    }
+
     // Debug display
     if (maxSeverity() >= 2) {
         display(std::cerr);
@@ -402,6 +455,7 @@ std::ostream& ts::tsp::Options::display(std::ostream& strm, int indent) const
          << margin << "  --bitrate-adjust-interval: " << UString::Decimal(bitrate_adj) << " milliseconds" << std::endl
          << margin << "  --buffer-size-mb: " << UString::Decimal(bufsize) << " bytes" << std::endl
          << margin << "  --debug: " << maxSeverity() << std::endl
+         << margin << "  --create-plugin-manifest: " << manifest_dir << std::endl
          << margin << "  --list-processors: " << list_proc << std::endl
          << margin << "  --max-flushed-packets: " << UString::Decimal(max_flush_pkt) << std::endl
          << margin << "  --max-input-packets: " << UString::Decimal(max_input_pkt) << std::endl
@@ -414,8 +468,14 @@ std::ostream& ts::tsp::Options::display(std::ostream& strm, int indent) const
         strm << margin << "  Packet processor plugin " << (i+1) << ":" << std::endl;
         plugins[i].display(strm, indent + 4);
     }
-    strm << margin << "  Output plugin:" << std::endl;
-    output.display(strm, indent + 4);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        strm << margin << "  Output plugin " << (i+1) << ":" << std::endl;
+        outputs[i].display(strm, indent + 4);
+        if (outputs.size() > 1) {
+            strm << margin << "    Max lag: " << UString::Decimal(output_max_lag[i]) << " packets" << std::endl
+                 << margin << "    Lag policy: " << LagPolicyNames.name(output_lag_policy[i]) << std::endl;
+        }
+    }
     return strm;
 }
 
@@ -67,6 +67,19 @@ namespace ts {
             //!
             static const Enumeration PluginTypeNames;
 
+            //!
+            //! Behaviour of an output plugin which lags behind the others when several outputs are specified.
+            //!
+            enum LagPolicy {
+                LAG_BLOCK,  //!< Block the processing chain until the lagging output catches up.
+                LAG_DROP    //!< Drop the packets which exceed the lag budget of the lagging output.
+            };
+
+            //!
+            //! Displayable names of lag policies.
+            //!
+            static const Enumeration LagPolicyNames;
+
             //!
             //! Class containing the options for one plugin.
             //!
@@ -98,6 +111,7 @@ namespace ts {
             // Option values
             bool          timed_log;       //!< Add time stamps in log messages.
             bool          list_proc;       //!< List processors.
+            UString       manifest_dir;    //!< Create a plugin manifest in this directory.
             bool          monitor;         //!< Run a resource monitoring thread.
             bool          ignore_jt;       //!< Ignore "joint termination" options in plugins.
             bool          sync_log;        //!< Synchronous log.
@@ -112,8 +126,10 @@ namespace ts {
             BitRate       bitrate;         //!< Fixed input bitrate.
             MilliSecond   bitrate_adj;     //!< Bitrate adjust interval.
             PluginOptions input;           //!< Input plugin.
-            PluginOptions output;          //!< Output plugin.
+            PluginOptionsVector outputs;   //!< List of output plugins, at least one. Several outputs are run as a tee.
             PluginOptionsVector plugins;   //!< List of packet processor plugins.
+            std::vector<size_t> output_max_lag;       //!< Maximum lag in packets of each output (same size as @a outputs).
+            std::vector<LagPolicy> output_lag_policy; //!< What to do when an output exceeds its lag (same size as @a outputs).
 
             //!
             //! Display the content of this object to a stream.
@@ -0,0 +1,286 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor: Execution context of one output in a tee
+//
+//----------------------------------------------------------------------------
+
+#include "tspOutputBranch.h"
+#include "tspPluginExecutor.h"
+#include "tsPluginRepository.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
+TSDUCK_SOURCE;
+
+// Polling interval when waiting for free space in the queue of a blocking output.
+#define BLOCK_POLL_INTERVAL 100  // milliseconds
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructor
+//----------------------------------------------------------------------------
+
+ts::tsp::OutputBranch::OutputBranch(Options* options,
+                                    const Options::PluginOptions* pl_options,
+                                    size_t max_lag,
+                                    Options::LagPolicy policy,
+                                    const ThreadAttributes& attributes,
+                                    Mutex& global_mutex) :
+    JointTermination(options, global_mutex),
+    Thread(attributes),
+    _name(pl_options->name),
+    _output(0),
+    _owned(true),
+    _report(options),
+    _drop(policy == Options::LAG_DROP),
+    _queue(),
+    _mutex(),
+    _got_packets(),
+    _got_space(),
+    _pkt_first(0),
+    _pkt_cnt(0),
+    _input_end(false),
+    _failed(false),
+    _dropping(false),
+    _dropped(0)
+{
+    // Create the plugin instance object.
+    NewOutputProfile allocator = PluginRepository::Instance()->getOutput(_name, *options);
+    if (allocator == 0) {
+        // Error message already displayed.
+        return;
+    }
+    _output = allocator(this);
+    _output->setShell(u"tsp -O");
+
+    // Submit the plugin arguments for analysis.
+    // The process should terminate on argument error.
+    // Do not process argument redirection, already done at tsp command level.
+    _output->analyze(pl_options->name, pl_options->args, false);
+    assert(_output->valid());
+
+    init(max_lag, attributes);
+}
+
+ts::tsp::OutputBranch::OutputBranch(Options* options,
+                                    const UString& name,
+                                    OutputPlugin* output,
+                                    size_t max_lag,
+                                    Options::LagPolicy policy,
+                                    const ThreadAttributes& attributes,
+                                    Mutex& global_mutex) :
+    JointTermination(options, global_mutex),
+    Thread(attributes),
+    _name(name),
+    _output(output),
+    _owned(false),
+    _report(options),
+    _drop(policy == Options::LAG_DROP),
+    _queue(),
+    _mutex(),
+    _got_packets(),
+    _got_space(),
+    _pkt_first(0),
+    _pkt_cnt(0),
+    _input_end(false),
+    _failed(false),
+    _dropping(false),
+    _dropped(0)
+{
+    if (_output != 0) {
+        init(max_lag, attributes);
+    }
+}
+
+ts::tsp::OutputBranch::~OutputBranch()
+{
+    // Make sure the thread is terminated before deallocating the plugin.
+    waitForTermination();
+    if (_owned && _output != 0) {
+        delete _output;
+        _output = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Common part of constructors.
+//----------------------------------------------------------------------------
+
+void ts::tsp::OutputBranch::init(size_t max_lag, const ThreadAttributes& attributes)
+{
+    // Allocate the packet queue.
+    _queue.resize(std::max<size_t>(1, max_lag));
+
+    // Define thread stack size
+    ThreadAttributes attr(attributes);
+    attr.setStackSize(PluginExecutor::STACK_SIZE_OVERHEAD + _output->stackUsage());
+    Thread::setAttributes(attr);
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked by shared library to log messages
+// Inherited from Report (via TSP)
+//----------------------------------------------------------------------------
+
+void ts::tsp::OutputBranch::writeLog(int severity, const UString& msg)
+{
+    _report->log(severity, u"%s: %s", {_name, msg});
+}
+
+
+//----------------------------------------------------------------------------
+// Push packets into the queue of this output.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::OutputBranch::push(const TSPacket* buffer, size_t packet_count, BitRate bitrate, const AbortInterface* abort)
+{
+    GuardCondition lock(_mutex, _got_space);
+
+    _tsp_bitrate = bitrate;
+
+    while (packet_count > 0 && !_failed) {
+
+        // Free space in the queue.
+        size_t free_cnt = _queue.size() - _pkt_cnt;
+
+        if (free_cnt == 0) {
+            if (_drop) {
+                // Drop all remaining packets for this output only.
+                if (!_dropping) {
+                    verbose(u"output lagging by more than %'d packets, dropping packets", {_queue.size()});
+                    _dropping = true;
+                }
+                _dropped += packet_count;
+                break;
+            }
+            else if (abort != 0 && abort->aborting()) {
+                break;
+            }
+            else {
+                // Wait for the output thread to free some space.
+                lock.waitCondition(BLOCK_POLL_INTERVAL);
+                continue;
+            }
+        }
+
+        // Copy packets at end of queue, without crossing the end of the queue.
+        const size_t last = (_pkt_first + _pkt_cnt) % _queue.size();
+        const size_t cnt = std::min(packet_count, std::min(free_cnt, _queue.size() - last));
+        std::copy(buffer, buffer + cnt, _queue.begin() + last);
+        buffer += cnt;
+        packet_count -= cnt;
+        _pkt_cnt += cnt;
+        _dropping = false;
+        _got_packets.signal();
+    }
+
+    return !_failed;
+}
+
+
+//----------------------------------------------------------------------------
+// Signal that no more packets will be pushed.
+//----------------------------------------------------------------------------
+
+void ts::tsp::OutputBranch::terminate(bool aborted)
+{
+    Guard lock(_mutex);
+    _input_end = true;
+    if (aborted) {
+        _tsp_aborting = true; // volatile bool in TSP superclass
+    }
+    _got_packets.signal();
+}
+
+
+//----------------------------------------------------------------------------
+// Output plugin thread
+//----------------------------------------------------------------------------
+
+void ts::tsp::OutputBranch::main()
+{
+    debug(u"output thread started");
+
+    PacketCounter output_packets = 0;
+
+    for (;;) {
+
+        // Wait for packets to output.
+        size_t pkt_first = 0;
+        size_t pkt_cnt = 0;
+        {
+            GuardCondition lock(_mutex, _got_packets);
+            while (_pkt_cnt == 0 && !_input_end && !_tsp_aborting) {
+                lock.waitCondition();
+            }
+            if (_tsp_aborting || (_pkt_cnt == 0 && _input_end)) {
+                break;
+            }
+            // Contiguous area, up to the end of the queue.
+            pkt_first = _pkt_first;
+            pkt_cnt = std::min(_pkt_cnt, _queue.size() - _pkt_first);
+        }
+
+        // System time for this group of packets, as seen by the plugin.
+        _tsp_clock.update();
+
+        // Output the packets, outside the protection of the mutex.
+        // The writer never overwrites packets which are not yet sent.
+        const bool success = _output->send(&_queue[pkt_first], pkt_cnt);
+
+        // Release the space in the queue.
+        {
+            GuardCondition lock(_mutex, _got_space);
+            if (success) {
+                _pkt_first = (_pkt_first + pkt_cnt) % _queue.size();
+                _pkt_cnt -= pkt_cnt;
+            }
+            else {
+                _failed = true;
+            }
+            lock.signal();
+        }
+
+        if (!success) {
+            break;
+        }
+        output_packets += pkt_cnt;
+        addTotalPackets(pkt_cnt);
+    }
+
+    // Close the output processor
+    _output->stop();
+
+    if (_dropped > 0) {
+        verbose(u"dropped %'d lagging packets", {_dropped});
+    }
+    debug(u"output thread %s after %'d packets", {_failed ? u"failed" : (_tsp_aborting ? u"aborted" : u"terminated"), output_packets});
+}
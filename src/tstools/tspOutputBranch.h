@@ -0,0 +1,173 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Execution context of one output in a tee
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tspOptions.h"
+#include "tspJointTermination.h"
+#include "tsPlugin.h"
+#include "tsTSPacket.h"
+#include "tsCondition.h"
+#include "tsMutex.h"
+#include "tsThread.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Execution context of one output plugin when several outputs are specified.
+        //!
+        //! When tsp runs several output plugins ("tee" output), the output executor
+        //! does not call the output plugins directly. Instead, it copies the packets
+        //! into one private circular queue per output plugin. Each output plugin runs
+        //! in its own thread and reads the packets from its queue through its own
+        //! cursor. Consequently, a slow output (a stalled NFS recording for instance)
+        //! does not delay the other outputs (a live UDP output for instance).
+        //!
+        //! The size of the queue is the "lag budget" of the output, the maximum number
+        //! of packets by which it can lag behind the processing chain. When the queue
+        //! is full, the output executor either waits for the output to catch up
+        //! (Options::LAG_BLOCK) or drops the packets for this output only (Options::LAG_DROP).
+        //!
+        class OutputBranch: public JointTermination, public Thread
+        {
+        public:
+            //!
+            //! Constructor, allocating a new output plugin.
+            //! @param [in,out] options Command line options for tsp.
+            //! @param [in] pl_options Command line options for this plugin.
+            //! @param [in] max_lag Maximum lag in packets, ie. size of the packet queue.
+            //! @param [in] policy What to do when the output lags more than @a max_lag packets.
+            //! @param [in] attributes Creation attributes for the thread executing this plugin.
+            //! @param [in,out] global_mutex Global mutex to synchronize access to the packet buffer.
+            //!
+            OutputBranch(Options* options,
+                         const Options::PluginOptions* pl_options,
+                         size_t max_lag,
+                         Options::LagPolicy policy,
+                         const ThreadAttributes& attributes,
+                         Mutex& global_mutex);
+
+            //!
+            //! Constructor, using an existing output plugin.
+            //! @param [in,out] options Command line options for tsp.
+            //! @param [in] name Plugin name.
+            //! @param [in] output Existing output plugin, not owned by this object.
+            //! @param [in] max_lag Maximum lag in packets, ie. size of the packet queue.
+            //! @param [in] policy What to do when the output lags more than @a max_lag packets.
+            //! @param [in] attributes Creation attributes for the thread executing this plugin.
+            //! @param [in,out] global_mutex Global mutex to synchronize access to the packet buffer.
+            //!
+            OutputBranch(Options* options,
+                         const UString& name,
+                         OutputPlugin* output,
+                         size_t max_lag,
+                         Options::LagPolicy policy,
+                         const ThreadAttributes& attributes,
+                         Mutex& global_mutex);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~OutputBranch();
+
+            //!
+            //! Access the output plugin.
+            //! @return Address of the plugin interface or zero if the plugin could not be loaded.
+            //!
+            OutputPlugin* plugin() {return _output;}
+
+            //!
+            //! Change the report method.
+            //! @param [in] rep Address of new report instance.
+            //!
+            void setReport(Report* rep) {_report = rep;}
+
+            //!
+            //! Push packets into the queue of this output.
+            //! @param [in] buffer Address of the first packet.
+            //! @param [in] packet_count Number of packets to push.
+            //! @param [in] bitrate Current bitrate of the processing chain.
+            //! @param [in] abort Abort interface of the caller. When the lag policy is
+            //! Options::LAG_BLOCK, the caller waits for free space in the queue until
+            //! the output catches up or @a abort reports an abort condition.
+            //! @return False if the output has failed and will no longer accept packets.
+            //!
+            bool push(const TSPacket* buffer, size_t packet_count, BitRate bitrate, const AbortInterface* abort);
+
+            //!
+            //! Signal that no more packets will be pushed.
+            //! The output thread terminates after sending all queued packets.
+            //! @param [in] aborted If true, terminate immediately, without sending queued packets.
+            //!
+            void terminate(bool aborted);
+
+            //!
+            //! Check if the output has failed.
+            //! @return True if the output plugin reported an error.
+            //!
+            bool failed() const {return _failed;}
+
+        protected:
+            // Inherited from Report (via TSP)
+            virtual void writeLog(int severity, const UString& msg) override;
+
+        private:
+            UString        _name;          // Plugin name.
+            OutputPlugin*  _output;        // Output plugin.
+            bool           _owned;         // The output plugin is owned by this object.
+            Report*        _report;        // Common report interface for all plugins.
+            const bool     _drop;          // Drop packets when the queue is full.
+            TSPacketVector _queue;         // Circular packet queue.
+            Mutex          _mutex;         // Protect access to the queue.
+            Condition      _got_packets;   // Signal the output thread that packets are available.
+            Condition      _got_space;     // Signal the writer that some space is available.
+            size_t         _pkt_first;     // Index of first packet to output in queue.
+            size_t         _pkt_cnt;       // Number of packets to output in queue.
+            bool           _input_end;     // No more packet after those in the queue.
+            volatile bool  _failed;        // Output plugin failed.
+            bool           _dropping;      // Currently dropping packets (to report drops once).
+            PacketCounter  _dropped;       // Total number of dropped packets.
+
+            // Common part of constructors.
+            void init(size_t max_lag, const ThreadAttributes& attributes);
+
+            // Inherited from Thread
+            virtual void main() override;
+
+            // Inaccessible operations
+            OutputBranch() = delete;
+            OutputBranch(const OutputBranch&) = delete;
+            OutputBranch& operator=(const OutputBranch&) = delete;
+        };
+    }
+}
@@ -45,8 +45,89 @@ ts::tsp::OutputExecutor::OutputExecutor(Options* options,
                                         Mutex& global_mutex) :
 
     PluginExecutor(options, pl_options, attributes, global_mutex),
-    _output(dynamic_cast<OutputPlugin*>(_shlib))
+    _output(dynamic_cast<OutputPlugin*>(_shlib)),
+    _branches()
 {
+    // With several outputs, each output runs in its own branch.
+    // The first branch uses the plugin of this executor.
+    if (_output != 0 && options->outputs.size() > 1) {
+        _branches.push_back(new OutputBranch(options, _name, _output, options->output_max_lag[0], options->output_lag_policy[0], attributes, global_mutex));
+        for (size_t i = 1; i < options->outputs.size(); ++i) {
+            _branches.push_back(new OutputBranch(options, &options->outputs[i], options->output_max_lag[i], options->output_lag_policy[i], attributes, global_mutex));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------
+
+ts::tsp::OutputExecutor::~OutputExecutor()
+{
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        delete _branches[i];
+    }
+    _branches.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Propagate the report settings to all outputs.
+//----------------------------------------------------------------------------
+
+void ts::tsp::OutputExecutor::setReport(Report* rep)
+{
+    PluginExecutor::setReport(rep);
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        _branches[i]->setReport(rep);
+    }
+}
+
+void ts::tsp::OutputExecutor::setMaxSeverity(int level)
+{
+    PluginExecutor::setMaxSeverity(level);
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        _branches[i]->setMaxSeverity(level);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Start all output plugins.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::OutputExecutor::startOutputs()
+{
+    if (_branches.empty()) {
+        return _output->start();
+    }
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        if (_branches[i]->plugin() == 0 || !_branches[i]->plugin()->start()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Send packets to the output plugin or to all branches.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::OutputExecutor::send(const TSPacket* pkt, size_t count)
+{
+    if (_branches.empty()) {
+        return _output->send(pkt, count);
+    }
+
+    // Copy the packets into the queues of all outputs. Any failing output aborts tsp,
+    // as a single output would do. Waiting for space (or dropping) is done by each branch.
+    bool success = true;
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        success = _branches[i]->push(pkt, count, _tsp_bitrate, this) && success;
+    }
+    return success;
 }
 
 
@@ -61,6 +142,11 @@ void ts::tsp::OutputExecutor::main()
     PacketCounter output_packets = 0;
     bool aborted;
 
+    // Start all output threads in case of tee output.
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        _branches[i]->start();
+    }
+
     do {
         // Wait for packets to output
         size_t pkt_first, pkt_cnt;
@@ -106,7 +192,7 @@ void ts::tsp::OutputExecutor::main()
 
             // Output a contiguous range of non-dropped packets.
             if (out_cnt > 0) {
-                if (!_output->send (pkt, out_cnt)) {
+                if (!send(pkt, out_cnt)) {
                     aborted = true;
                     break;
                 }
@@ -123,8 +209,19 @@ void ts::tsp::OutputExecutor::main()
 
     } while (!aborted);
 
-    // Close the output processor
-    _output->stop();
+    // Close the output processor. In case of tee output, each output thread
+    // terminates after sending its queued packets and closes its own plugin.
+    if (_branches.empty()) {
+        _output->stop();
+    }
+    else {
+        for (size_t i = 0; i < _branches.size(); ++i) {
+            _branches[i]->terminate(aborted);
+        }
+        for (size_t i = 0; i < _branches.size(); ++i) {
+            _branches[i]->waitForTermination();
+        }
+    }
 
     debug(u"output thread %s after %'d packets (%'d output)", {aborted ? u"aborted" : u"terminated", totalPackets(), output_packets});
 }
@@ -34,19 +34,27 @@
 
 #pragma once
 #include "tspPluginExecutor.h"
+#include "tspOutputBranch.h"
 
 namespace ts {
     namespace tsp {
         //!
         //! Execution context of a tsp output plugin.
         //!
+        //! When several output plugins are specified, this executor is a "tee".
+        //! It is still the last node in the ring of plugin executors but each output
+        //! plugin is run by a ts::tsp::OutputBranch in its own thread, with its own
+        //! packet queue. The executor copies packets into all queues and immediately
+        //! returns the free buffers to the input plugin.
+        //!
         class OutputExecutor: public PluginExecutor
         {
         public:
             //!
             //! Constructor.
             //! @param [in,out] options Command line options for tsp.
-            //! @param [in] pl_options Command line options for this plugin.
+            //! @param [in] pl_options Command line options for this plugin. When several
+            //! output plugins are specified in @a options, this is the first one.
             //! @param [in] attributes Creation attributes for the thread executing this plugin.
             //! @param [in,out] global_mutex Global mutex to synchronize access to the packet buffer.
             //!
@@ -55,6 +63,21 @@ namespace ts {
                            const ThreadAttributes& attributes,
                            Mutex& global_mutex);
 
+            //!
+            //! Destructor.
+            //!
+            virtual ~OutputExecutor();
+
+            //!
+            //! Start all output plugins.
+            //! @return True on success, false if any output plugin failed to start.
+            //!
+            bool startOutputs();
+
+            // Overridden to propagate to all outputs.
+            virtual void setReport(Report* rep) override;
+            virtual void setMaxSeverity(int level) override;
+
             //!
             //! Access the shared library API.
             //! Override ts::tsp::PluginExecutor::plugin() with a specialized returned class.
@@ -64,6 +87,10 @@ namespace ts {
 
         private:
             OutputPlugin* _output;
+            std::vector<OutputBranch*> _branches;  // Empty when there is only one output.
+
+            // Send packets to the output plugin or to all branches.
+            bool send(const TSPacket* pkt, size_t count);
 
             // Inherited from Thread
             virtual void main() override;
@@ -264,5 +264,8 @@ void ts::tsp::PluginExecutor::waitWork(size_t& pkt_first,
     input_end = _input_end && pkt_cnt == _pkt_cnt;
     aborted = ringNext<PluginExecutor>()->_tsp_aborting;
 
+    // Read the system time once for this group of packets. Plugins get it using currentUTC().
+    _tsp_clock.update();
+
     log(10, u"waitWork (pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %'d, aborted = %'d)", {pkt_first, pkt_cnt, bitrate, input_end, aborted});
 }
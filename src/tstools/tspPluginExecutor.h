@@ -166,7 +166,7 @@ namespace ts {
             //! Change the report method.
             //! @param [in] rep Address of new report instance.
             //!
-            void setReport(Report* rep)
+            virtual void setReport(Report* rep)
             {
                 _report = rep;
             }
@@ -36,7 +36,7 @@
 #include "tsOutputRedirector.h"
 #include "tsByteBlock.h"
 #include "tsFatal.h"
-#include "tsMPEG.h"
+#include "tsTSPacket.h"
 #include "tsVersionInfo.h"
 TSDUCK_SOURCE;
 
@@ -179,12 +179,13 @@ public:
         _in_header_size = 0;
     }
 
-    // Look for MPEG packets in a buffer, according to an assumed packet size.
-    // If the complete buffer matches the packet size, set input and output packet
-    // sizes and return true. Return false otherwise.
-    bool checkSync(const uint8_t* buf, size_t buf_size, size_t pkt_size, size_t header_size);
+    // Look for a range of at least min_size bytes of MPEG packets in a buffer.
+    // If pkt_size is zero, try all standard packet sizes. If packets are found,
+    // set input and output packet sizes, set offset to the first packet and
+    // return true. Return false otherwise.
+    bool findSync(const uint8_t* buf, size_t buf_size, size_t min_size, size_t pkt_size, size_t header_size, size_t& offset);
 
-    // Get packet sizes, as determined by checkSync(). Size is zero if no valid packet size found.
+    // Get packet sizes, as determined by findSync(). Size is zero if no valid packet size found.
     size_t inputPacketSize() const {return _in_pkt_size;}
     size_t inputHeaderSize() const {return _in_header_size;}
     size_t outputPacketSize() const {return _out_pkt_size;}
@@ -272,23 +273,19 @@ bool Resynchronizer::writePacket(const uint8_t* input_packet)
 
 
 //----------------------------------------------------------------------------
-//  Look for MPEG packets in a buffer, according to an assumed packet size.
+//  Look for a range of MPEG packets in a buffer.
 //----------------------------------------------------------------------------
 
-bool Resynchronizer::checkSync(const uint8_t* buf, size_t buf_size, size_t pkt_size, size_t header_size)
+bool Resynchronizer::findSync(const uint8_t* buf, size_t buf_size, size_t min_size, size_t pkt_size, size_t header_size, size_t& offset)
 {
-    assert(pkt_size >= header_size + ts::PKT_SIZE);
-    const uint8_t* end = buf + buf_size - pkt_size + 1;
+    assert(pkt_size == 0 || pkt_size >= header_size + ts::PKT_SIZE);
 
-    // Check if the buffer contains packets with the appropriate size
-    while (buf < end) {
-        if (buf[header_size] != ts::SYNC_BYTE) {
-            return false; // not found
-        }
-        buf += pkt_size;
+    // Check all expected packet sizes in one pass over the buffer.
+    if (min_size == 0 || !ts::FindTSSync(buf, buf_size, min_size, offset, pkt_size, header_size)) {
+        return false; // not found
     }
 
-    // Packets found all along the buffer
+    // Packets found all along the range
     _in_pkt_size = pkt_size;
     _in_header_size = header_size;
     _out_pkt_size = _keep_packet_size ? pkt_size : ts::PKT_SIZE;
@@ -335,32 +332,14 @@ int main(int argc, char *argv[])
 
         // Look for a range of packets for at least --min-contiguous bytes
         size_t const search_size = std::min(opt.contig_size, sync_size);
-        uint8_t* const end_search = sync_end - search_size + 1;
-
-        // Search a range of valid packets. Try all expected packet sizes.
-        const uint8_t* start;
-        for (start = sync_buf; start < end_search; start++) {
-            if (opt.packet_size > 0) {
-                if (resync.checkSync(start, search_size, opt.packet_size, opt.header_size)) {
-                    // Found user-specified encapsulation of TS packets
-                    break;
-                }
-            }
-            else {
-                if (resync.checkSync(start, search_size, ts::PKT_SIZE, 0)) {
-                    // Found standard TS packets
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_RS_SIZE, 0)) {
-                    // Found TS packets with trailing Reed-Solomon outer FEC
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE)) {
-                    // Found TS packets with leading 4-byte timestamp (M2TS format, blu-ray discs)
-                    break;
-                }
-            }
-        }
+
+        // Search a range of valid packets. Unless a packet size is specified, try all
+        // expected packet sizes: standard TS packets, TS packets with trailing Reed-Solomon
+        // outer FEC, TS packets with leading 4-byte timestamp (M2TS format, blu-ray discs).
+        size_t offset = 0;
+        resync.findSync(sync_buf, sync_size, search_size, opt.packet_size, opt.header_size, offset);
+        const uint8_t* start = sync_buf + offset;
+
         if (resync.inputPacketSize() == 0) {
             std::cerr << "* Cannot find MPEG TS packets after " << ts::UString::Decimal(search_size) << " bytes" << std::endl;
             resync.setStatus (RS_ERROR);
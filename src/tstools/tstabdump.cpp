@@ -33,6 +33,8 @@
 
 #include "tsArgs.h"
 #include "tsSectionFile.h"
+#include "tsMappedSectionFile.h"
+#include "tsReportWithPrefix.h"
 #include "tsTablesDisplay.h"
 #include "tsCASFamily.h"
 #include "tsSection.h"
@@ -106,6 +108,26 @@ bool DumpFile(Options& opt, const ts::UString& file_name)
         std::cout << "* File: " << file_name << std::endl << std::endl;
     }
 
+    ts::TablesDisplay display(opt.display, opt);
+
+    // Regular files are memory-mapped. The sections are displayed one by one,
+    // without loading the complete file.
+    ts::MappedSectionFile mapped;
+    if (!file_name.empty() && (mapped.open(file_name, NULLREP) || mapped.isOpen())) {
+        ts::ReportWithPrefix report(opt, file_name + u": ");
+        for (size_t i = 0; i < mapped.sectionCount(); ++i) {
+            const ts::SectionPtr section(mapped.section(i, ts::CRC32::IGNORE));
+            if (!section->isValid()) {
+                report.error(u"invalid section%s", {ts::UString::AfterBytes(std::streampos(mapped.sectionOffset(i)))});
+                return false;
+            }
+            display.displaySection(*section) << std::endl;
+        }
+        // A truncated last section is reported but ignored, as in SectionFile.
+        mapped.checkComplete(report);
+        return true;
+    }
+
     // Load all sections
     ts::SectionFile file;
     bool ok;
@@ -121,7 +143,6 @@ bool DumpFile(Options& opt, const ts::UString& file_name)
 
     if (ok) {
         // Display all sections.
-        ts::TablesDisplay display(opt.display, opt);
         for (ts::SectionPtrVector::const_iterator it = file.sections().begin(); it != file.sections().end(); ++it) {
             display.displaySection(**it) << std::endl;
         }
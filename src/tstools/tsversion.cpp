@@ -39,6 +39,7 @@
 #include "tsSysInfo.h"
 #include "tsForkPipe.h"
 #include "tsVersionInfo.h"
+#include "tsNames.h"
 #if defined(TS_WINDOWS)
 #include "tsWinUtils.h"
 #endif
@@ -64,6 +65,7 @@ struct Options: public ts::Args
     bool        upgrade;   // Upgrade TSDuck to the latest version.
     ts::UString name;      // Use the specified version, not the latest one.
     ts::UString out_dir;   // Output directory for downloaded files.
+    ts::UStringVector names_files; // Names configuration files to compile.
 
 private:
     // Inaccessible operations.
@@ -83,11 +85,13 @@ Options::Options(int argc, char *argv[]) :
     source(false),
     upgrade(false),
     name(),
-    out_dir()
+    out_dir(),
+    names_files()
 {
     option(u"all",              'a');
     option(u"binary",           'b');
     option(u"check",            'c');
+    option(u"compile-names",     0,  Args::STRING, 0, Args::UNLIMITED_COUNT);
     option(u"download",         'd');
     option(u"force",            'f');
     option(u"latest",           'l');
@@ -117,6 +121,15 @@ Options::Options(int argc, char *argv[]) :
             u"  --check\n"
             u"      Check if a new version of TSDuck is available from GitHub.\n"
             u"\n"
+            u"  --compile-names filename\n"
+            u"      Compile the specified names configuration file (for instance\n"
+            u"      tsduck.dvb.names) into a binary image which is memory-mapped by all TSDuck\n"
+            u"      commands, avoiding the parsing of the text file at startup. The image is\n"
+            u"      created in the same directory as the configuration file (or in the\n"
+            u"      directory specified by --output-directory) with an additional suffix\n"
+            u"      '.bin'. This is typically done when TSDuck is built or installed. Several\n"
+            u"      --compile-names options may be specified.\n"
+            u"\n"
             u"  -d\n"
             u"  --download\n"
             u"      Download the latest version (or the version specified by --name) from\n"
@@ -142,7 +155,8 @@ Options::Options(int argc, char *argv[]) :
             u"\n"
             u"  -o dir-name\n"
             u"  --output-directory dir-name\n"
-            u"      Output directory for downloaded files (current directory by default).\n"
+            u"      Output directory for downloaded files (current directory by default)\n"
+            u"      or for compiled names images.\n"
             u"\n"
             u"  --proxy-host name\n"
             u"      Optional proxy host name for Internet access.\n"
@@ -189,6 +203,7 @@ Options::Options(int argc, char *argv[]) :
     upgrade = present(u"upgrade");
     getValue(name, u"name");
     getValue(out_dir, u"output-directory");
+    getValues(names_files, u"compile-names");
 
     // Proxy settings.
     ts::WebRequest::SetDefaultProxyHost(value(u"proxy-host"), intValue<uint16_t>(u"proxy-port"));
@@ -205,7 +220,7 @@ Options::Options(int argc, char *argv[]) :
     }
 
     // If nothing is specified, default to --this
-    if (!all && !latest && !check && !download && !upgrade && name.empty()) {
+    if (!all && !latest && !check && !download && !upgrade && name.empty() && names_files.empty()) {
         current = true;
     }
 
@@ -224,6 +239,33 @@ Options::Options(int argc, char *argv[]) :
 }
 
 
+//----------------------------------------------------------------------------
+//  Compile names files into binary images.
+//----------------------------------------------------------------------------
+
+bool CompileNames(Options& opt)
+{
+    bool success = true;
+    for (ts::UStringVector::const_iterator it = opt.names_files.begin(); it != opt.names_files.end(); ++it) {
+        if (!ts::FileExists(*it)) {
+            opt.error(u"file not found: %s", {*it});
+            success = false;
+            continue;
+        }
+        const ts::UString image((opt.out_dir.empty() ? *it : opt.out_dir + ts::BaseName(*it)) + ts::Names::IMAGE_SUFFIX);
+        const ts::Names names(*it);
+        if (names.errorCount() > 0) {
+            opt.error(u"%d errors in %s", {names.errorCount(), *it});
+            success = false;
+        }
+        else {
+            success = names.saveImage(image, opt) && success;
+        }
+    }
+    return success;
+}
+
+
 //----------------------------------------------------------------------------
 //  List all versions.
 //----------------------------------------------------------------------------
@@ -591,7 +633,11 @@ int main(int argc, char *argv[])
     Options opt(argc, argv);
     bool success = true;
 
-    if (opt.current) {
+    if (!opt.names_files.empty()) {
+        // Compile names files, typically during build or installation.
+        success = CompileNames(opt);
+    }
+    else if (opt.current) {
         // Display current version.
         std::cout << ts::GetVersion(opt.verbose() ? ts::VERSION_LONG : ts::VERSION_SHORT) << std::endl;
     }
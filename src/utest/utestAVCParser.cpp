@@ -0,0 +1,264 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::AVCParser and start code location
+//
+//----------------------------------------------------------------------------
+
+#include "tsAVCParser.h"
+#include "tsBitStream.h"
+#include "tsMemoryUtils.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class AVCParserTest: public CppUnit::TestFixture
+{
+public:
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testReadBits();
+    void testExpColomb();
+    void testSignedExpColomb();
+    void testEmulationPrevention();
+    void testTrailingBits();
+    void testLocateZeroZero();
+
+    CPPUNIT_TEST_SUITE(AVCParserTest);
+    CPPUNIT_TEST(testReadBits);
+    CPPUNIT_TEST(testExpColomb);
+    CPPUNIT_TEST(testSignedExpColomb);
+    CPPUNIT_TEST(testEmulationPrevention);
+    CPPUNIT_TEST(testTrailingBits);
+    CPPUNIT_TEST(testLocateZeroZero);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AVCParserTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void AVCParserTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void AVCParserTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void AVCParserTest::testReadBits()
+{
+    // Compare with BitStream on data without emulation prevention byte, for all sizes.
+    uint8_t data[40];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = uint8_t(0x5A + 37 * i);
+    }
+    for (size_t n = 1; n <= 64; ++n) {
+        ts::AVCParser parser(data, sizeof(data));
+        ts::BitStream bs(data, 8 * sizeof(data));
+        while (bs.remainingBitCount() >= n) {
+            CPPUNIT_ASSERT_EQUAL(bs.remainingBitCount(), parser.remainingBits());
+            uint64_t next = 0;
+            uint64_t value = 0;
+            CPPUNIT_ASSERT(parser.nextBits(next, n));
+            CPPUNIT_ASSERT(parser.u(value, n));
+            const uint64_t expected = bs.read<uint64_t>(n, 0);
+            CPPUNIT_ASSERT_EQUAL(expected, next);
+            CPPUNIT_ASSERT_EQUAL(expected, value);
+            CPPUNIT_ASSERT_EQUAL(bs.byteAligned(), parser.byteAligned());
+        }
+        uint64_t value = 1;
+        CPPUNIT_ASSERT_EQUAL(bs.remainingBitCount() > 0, !parser.endOfStream());
+        CPPUNIT_ASSERT(!parser.u(value, n));
+        CPPUNIT_ASSERT_EQUAL(uint64_t(0), value);
+    }
+
+    // Reset at bit offset.
+    ts::AVCParser parser(data, sizeof(data));
+    parser.reset(3, 5);
+    uint8_t b = 0;
+    CPPUNIT_ASSERT_EQUAL(size_t(8 * sizeof(data) - 29), parser.remainingBits());
+    CPPUNIT_ASSERT(parser.u(b, 3));
+    CPPUNIT_ASSERT_EQUAL(uint8_t(data[3] & 0x07), b);
+    CPPUNIT_ASSERT(parser.byteAligned());
+    CPPUNIT_ASSERT(parser.u(b, 8));
+    CPPUNIT_ASSERT_EQUAL(data[4], b);
+}
+
+void AVCParserTest::testExpColomb()
+{
+    // Values 0, 1, 2, 3, 6, 7, 2^40+4, then one stop bit.
+    static const uint8_t data[] = {0xA6, 0x43, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x02, 0xC0};
+    ts::AVCParser parser(data, sizeof(data));
+    uint32_t val = 0;
+    uint64_t val64 = 0;
+
+    CPPUNIT_ASSERT(parser.ue(val));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(0), val);
+    CPPUNIT_ASSERT(parser.ue(val));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(1), val);
+    CPPUNIT_ASSERT(parser.ue(val));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(2), val);
+    CPPUNIT_ASSERT(parser.ue(val));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(3), val);
+    CPPUNIT_ASSERT(parser.ue(val));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(6), val);
+    CPPUNIT_ASSERT(parser.ue(val));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(7), val);
+    CPPUNIT_ASSERT(parser.ue(val64));
+    CPPUNIT_ASSERT_EQUAL(TS_UCONST64(0x0000010000000004), val64);
+    CPPUNIT_ASSERT(parser.rbspTrailingBits());
+    CPPUNIT_ASSERT(parser.endOfStream());
+    CPPUNIT_ASSERT(!parser.ue(val));
+
+    // Only leading zeroes.
+    static const uint8_t zeroes[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    ts::AVCParser parser2(zeroes, sizeof(zeroes));
+    CPPUNIT_ASSERT(!parser2.ue(val));
+}
+
+void AVCParserTest::testSignedExpColomb()
+{
+    // Values 0, 1, -1, 2, -2, 100, -100, then one stop bit.
+    static const uint8_t data[] = {0xA6, 0x42, 0x80, 0xC8, 0x01, 0x93};
+    ts::AVCParser parser(data, sizeof(data));
+    int32_t val = 0;
+
+    CPPUNIT_ASSERT(parser.se(val));
+    CPPUNIT_ASSERT_EQUAL(int32_t(0), val);
+    CPPUNIT_ASSERT(parser.se(val));
+    CPPUNIT_ASSERT_EQUAL(int32_t(1), val);
+    CPPUNIT_ASSERT(parser.se(val));
+    CPPUNIT_ASSERT_EQUAL(int32_t(-1), val);
+    CPPUNIT_ASSERT(parser.se(val));
+    CPPUNIT_ASSERT_EQUAL(int32_t(2), val);
+    CPPUNIT_ASSERT(parser.se(val));
+    CPPUNIT_ASSERT_EQUAL(int32_t(-2), val);
+    CPPUNIT_ASSERT(parser.se(val));
+    CPPUNIT_ASSERT_EQUAL(int32_t(100), val);
+    CPPUNIT_ASSERT(parser.se(val));
+    CPPUNIT_ASSERT_EQUAL(int32_t(-100), val);
+    CPPUNIT_ASSERT(parser.rbspTrailingBits());
+    CPPUNIT_ASSERT(parser.endOfStream());
+}
+
+void AVCParserTest::testEmulationPrevention()
+{
+    // The 03 after 00 00 are emulation prevention bytes, except the first one.
+    static const uint8_t data[] = {0x03, 0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x03, 0xFF};
+    static const uint8_t rbsp[] = {0x03, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x03, 0xFF};
+
+    // Read by bytes.
+    ts::AVCParser parser1(data, sizeof(data));
+    for (size_t i = 0; i < sizeof(rbsp); ++i) {
+        uint8_t b = 0;
+        CPPUNIT_ASSERT(parser1.u(b, 8));
+        CPPUNIT_ASSERT_EQUAL(rbsp[i], b);
+    }
+    CPPUNIT_ASSERT(parser1.endOfStream());
+
+    // Read all at once.
+    ts::AVCParser parser2(data, sizeof(data));
+    uint64_t val = 0;
+    CPPUNIT_ASSERT(parser2.u(val, 56));
+    CPPUNIT_ASSERT_EQUAL(TS_UCONST64(0x0003000001000000), val);
+    CPPUNIT_ASSERT(parser2.u(val, 24));
+    CPPUNIT_ASSERT_EQUAL(TS_UCONST64(0x00000003FF), val);
+    CPPUNIT_ASSERT(parser2.endOfStream());
+}
+
+void AVCParserTest::testTrailingBits()
+{
+    static const uint8_t data[] = {0xA0, 0x55};
+    ts::AVCParser parser(data, sizeof(data));
+    uint8_t b = 0;
+
+    CPPUNIT_ASSERT(!parser.rbspTrailingBits());
+    CPPUNIT_ASSERT_EQUAL(size_t(16), parser.remainingBits());
+    CPPUNIT_ASSERT(parser.u(b, 2));
+    CPPUNIT_ASSERT_EQUAL(uint8_t(2), b);
+    CPPUNIT_ASSERT(parser.rbspTrailingBits());
+    CPPUNIT_ASSERT(parser.byteAligned());
+    CPPUNIT_ASSERT_EQUAL(size_t(8), parser.remainingBits());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), parser.remainingBytes());
+    CPPUNIT_ASSERT(parser.u(b, 8));
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x55), b);
+}
+
+void AVCParserTest::testLocateZeroZero()
+{
+    uint8_t data[100];
+    ::memset(data, 0xFF, sizeof(data));
+
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data), 0x01, 0x01) == 0);
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data, 2, 0x00, 0xFF) == 0);
+
+    // Isolated zeroes and 00 00 02 are not start codes.
+    data[10] = data[30] = data[31] = data[40] = data[41] = 0x00;
+    data[42] = 0x02;
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data), 0x01, 0x01) == 0);
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data), 0x00, 0x02) == data + 40);
+
+    // Start code at end of area, and 00 00 00 before.
+    data[97] = data[98] = 0x00;
+    data[99] = 0x01;
+    data[60] = data[61] = data[62] = 0x00;
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data), 0x01, 0x01) == data + 97);
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data) - 1, 0x01, 0x01) == 0);
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data), 0x00, 0x01) == data + 60);
+    CPPUNIT_ASSERT(ts::LocateZeroZero(data + 61, sizeof(data) - 61, 0x00, 0x01) == data + 97);
+
+    // Check all alignments against a simple search.
+    for (size_t start = 0; start < 16; ++start) {
+        for (size_t size = 0; start + size <= sizeof(data); ++size) {
+            const uint8_t* expected = 0;
+            for (size_t i = start; expected == 0 && i + 3 <= start + size; ++i) {
+                if (data[i] == 0x00 && data[i + 1] == 0x00 && data[i + 2] == 0x01) {
+                    expected = data + i;
+                }
+            }
+            CPPUNIT_ASSERT(ts::LocateZeroZero(data + start, size, 0x01, 0x01) == expected);
+        }
+    }
+}
@@ -56,6 +56,7 @@ public:
     void testSkipToNextByte();
     void testReadBit();
     void testRead();
+    void testReadAllSizes();
 
     CPPUNIT_TEST_SUITE (BitStreamTest);
     CPPUNIT_TEST (testConstructors);
@@ -68,6 +69,7 @@ public:
     CPPUNIT_TEST (testSkipToNextByte);
     CPPUNIT_TEST (testReadBit);
     CPPUNIT_TEST (testRead);
+    CPPUNIT_TEST (testReadAllSizes);
     CPPUNIT_TEST_SUITE_END ();
 };
 
@@ -471,3 +473,24 @@ void BitStreamTest::testRead()
     CPPUNIT_ASSERT(bs1.currentBitOffset() == 83);
     CPPUNIT_ASSERT(bs1.endOfStream());
 }
+
+void BitStreamTest::testReadAllSizes()
+{
+    // Compare multi-bit reads with bit-per-bit reads, for all offsets and sizes, up to the end of stream.
+    const size_t total_bits = 8 * sizeof(_bytes) - 3;
+    for (size_t start = 0; start < 12; ++start) {
+        for (size_t n = 1; n <= 64; ++n) {
+            ts::BitStream bs1(_bytes, total_bits, start);
+            ts::BitStream bs2(_bytes, total_bits, start);
+            while (bs1.remainingBitCount() >= n) {
+                uint64_t expected = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    expected = (expected << 1) | bs2.readBit();
+                }
+                CPPUNIT_ASSERT_EQUAL(expected, bs1.read<uint64_t>(n, 0));
+                CPPUNIT_ASSERT_EQUAL(bs2.currentBitOffset(), bs1.currentBitOffset());
+            }
+            CPPUNIT_ASSERT_EQUAL(uint64_t(0xFFFF), bs1.read<uint64_t>(n, 0xFFFF));
+        }
+    }
+}
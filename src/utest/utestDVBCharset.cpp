@@ -32,6 +32,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCharset.h"
+#include "tsDVBCharsetSingleByte.h"
+#include "tsByteBlock.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -46,9 +48,11 @@ public:
     virtual void tearDown() override;
 
     void testRepository();
+    void testDecodeSingleByte();
 
     CPPUNIT_TEST_SUITE(DVBCharsetTest);
     CPPUNIT_TEST(testRepository);
+    CPPUNIT_TEST(testDecodeSingleByte);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -79,3 +83,45 @@ void DVBCharsetTest::testRepository()
     utest::Out() << "DVBCharsetTest::testRepository: charsets: " << ts::UString::Join(ts::DVBCharset::GetAllNames()) << std::endl;
     CPPUNIT_ASSERT_EQUAL(size_t(17), ts::DVBCharset::GetAllNames().size());
 }
+
+void DVBCharsetTest::testDecodeSingleByte()
+{
+    // ISO-8859-15 strings with ASCII runs of all lengths, crossing block boundaries.
+    for (size_t len = 0; len < 40; ++len) {
+        ts::ByteBlock dvb(1, 0x0B);  // table code for ISO-8859-15
+        ts::UString ref;
+        for (size_t i = 0; i < len; ++i) {
+            dvb.push_back(uint8_t('A' + i % 26));
+            ref.push_back(ts::UChar('A' + i % 26));
+        }
+        dvb.appendUInt8(0xA4);  // euro sign
+        dvb.appendUInt8(ts::DVBCharset::DVB_SINGLE_BYTE_CRLF);
+        dvb.appendUInt8(0xBD);  // oe ligature
+        ref.push_back(ts::UChar(0x20AC));
+        ref.push_back(ts::LINE_FEED);
+        ref.push_back(ts::UChar(0x0153));
+        for (size_t i = 0; i < len; ++i) {
+            dvb.push_back(uint8_t('a' + i % 26));
+            ref.push_back(ts::UChar('a' + i % 26));
+        }
+
+        ts::UString str;
+        CPPUNIT_ASSERT(ts::DVBCharset::Decode(str, dvb.data(), dvb.size()));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(ref, str);
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(ref, ts::UString::FromDVB(dvb.data(), dvb.size()));
+
+        // An untranslatable character is skipped and reported.
+        dvb.appendUInt8(0x01);
+        dvb.appendUInt8('z');
+        ref.push_back(ts::UChar('z'));
+        CPPUNIT_ASSERT(!ts::DVBCharset::Decode(str, dvb.data(), dvb.size()));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(ref, str);
+    }
+
+    // Default charset is ISO-6937.
+    static const uint8_t dvb6937[] = {'C', 'a', 'f', 0xC2, 'e', ' ', 0xA4, ' ', '2', '0', '1', '8', ' ', 'a', 'b', 'c', 'd', 'e'};
+    ts::UString str;
+    CPPUNIT_ASSERT(ts::DVBCharsetSingleByte::ISO_6937.decode(str, dvb6937, sizeof(dvb6937)));
+    utest::Out() << "DVBCharsetTest::testDecodeSingleByte: ISO-6937: \"" << str << "\"" << std::endl;
+    CPPUNIT_ASSERT_EQUAL(sizeof(dvb6937), str.size());
+}
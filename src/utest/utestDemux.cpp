@@ -91,6 +91,7 @@ public:
     void testTDT();
     void testTOT();
     void testHEVC();
+    void testTIDFilter();
 
     CPPUNIT_TEST_SUITE(DemuxTest);
     CPPUNIT_TEST(testPAT);
@@ -104,6 +105,7 @@ public:
     CPPUNIT_TEST(testTDT);
     CPPUNIT_TEST(testTOT);
     CPPUNIT_TEST(testHEVC);
+    CPPUNIT_TEST(testTIDFilter);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -113,6 +115,9 @@ private:
     // Compare a vector of packets with the list of reference packets
     bool checkPackets(const char* test_name, const char* table_name, const ts::TSPacketVector& packets, const uint8_t* ref_packets, size_t ref_packets_size);
 
+    // Demux one table from reference packets.
+    void demuxTable(ts::BinaryTable& table, const uint8_t* ref_packets, size_t ref_packets_size);
+
     // Unitary test for one table.
     void testTable(const char* name, const uint8_t* ref_packets, size_t ref_packets_size, const uint8_t* ref_sections, size_t ref_sections_size);
 };
@@ -486,3 +491,54 @@ void DemuxTest::testHEVC()
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+void DemuxTest::demuxTable(ts::BinaryTable& table, const uint8_t* ref_packets, size_t ref_packets_size)
+{
+    CPPUNIT_ASSERT(ref_packets_size % ts::PKT_SIZE == 0);
+    const ts::TSPacket* ref_pkt = reinterpret_cast<const ts::TSPacket*>(ref_packets);
+
+    ts::StandaloneTableDemux demux(ts::AllPIDs);
+    for (size_t pi = 0; pi < ref_packets_size / ts::PKT_SIZE; ++pi) {
+        demux.feedPacket(ref_pkt[pi]);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(1), demux.tableCount());
+    table = *demux.tableAt(0);
+}
+
+void DemuxTest::testTIDFilter()
+{
+    // Build a stream with a multi-section BAT and an SDT on the same PID.
+    ts::BinaryTable bat;
+    ts::BinaryTable sdt;
+    demuxTable(bat, psi_bat_tvnum_packets, sizeof(psi_bat_tvnum_packets));
+    demuxTable(sdt, psi_sdt_r3_packets, sizeof(psi_sdt_r3_packets));
+    CPPUNIT_ASSERT(bat.tableIdExtension() != sdt.tableIdExtension());
+
+    ts::TSPacketVector packets;
+    ts::OneShotPacketizer pzer(ts::PID_SDT, false);
+    pzer.addTable(bat);
+    pzer.addTable(sdt);
+    pzer.getPackets(packets);
+
+    // Filter on TID.
+    ts::StandaloneTableDemux demux1(ts::AllPIDs);
+    ts::TIDSet tids;
+    tids.set(ts::TID_SDT_ACT);
+    demux1.setTIDFilter(tids);
+    for (ts::TSPacketVector::const_iterator it = packets.begin(); it != packets.end(); ++it) {
+        demux1.feedPacket(*it);
+    }
+    CPPUNIT_ASSERT(!demux1.hasErrors());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), demux1.tableCount());
+    CPPUNIT_ASSERT(*demux1.tableAt(0) == sdt);
+
+    // Filter on TID-ext.
+    ts::StandaloneTableDemux demux2(ts::AllPIDs);
+    demux2.addTIDExt(bat.tableIdExtension());
+    for (ts::TSPacketVector::const_iterator it = packets.begin(); it != packets.end(); ++it) {
+        demux2.feedPacket(*it);
+    }
+    CPPUNIT_ASSERT(!demux2.hasErrors());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), demux2.tableCount());
+    CPPUNIT_ASSERT(*demux2.tableAt(0) == bat);
+}
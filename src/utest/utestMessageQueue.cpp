@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsMessageQueue.h"
+#include "tsRingMessageQueue.h"
 #include "tsMonotonic.h"
 #include "tsSysUtils.h"
 #include "utestCppUnitTest.h"
@@ -53,10 +54,16 @@ public:
 
     void testConstructor();
     void testQueue();
+    void testRingQueue();
+    void testRingPriority();
+    void testRingBatch();
 
     CPPUNIT_TEST_SUITE(MessageQueueTest);
     CPPUNIT_TEST(testConstructor);
     CPPUNIT_TEST(testQueue);
+    CPPUNIT_TEST(testRingQueue);
+    CPPUNIT_TEST(testRingPriority);
+    CPPUNIT_TEST(testRingBatch);
     CPPUNIT_TEST_SUITE_END();
 private:
     ts::NanoSecond  _nsPrecision;
@@ -194,3 +201,143 @@ void MessageQueueTest::testQueue()
 
     utest::Out() << "MessageQueueTest: main thread: end of test" << std::endl;
 }
+
+typedef ts::RingMessageQueue<int> TestRingQueue;
+
+// Test case: ring queue, basic operations
+void MessageQueueTest::testRingQueue()
+{
+    TestRingQueue queue(4);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), queue.getMaxMessages());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), queue.size());
+
+    // Wrap around the ring several times.
+    TestRingQueue::MessagePtr msg;
+    int next_in = 0;
+    int next_out = 0;
+    for (int loop = 0; loop < 5; ++loop) {
+        CPPUNIT_ASSERT(queue.enqueue(new int(next_in++), 0));
+        CPPUNIT_ASSERT(queue.enqueue(new int(next_in++), 0));
+        CPPUNIT_ASSERT(queue.enqueue(new int(next_in++), 0));
+        CPPUNIT_ASSERT_EQUAL(size_t(3), queue.size());
+        for (int i = 0; i < 3; ++i) {
+            CPPUNIT_ASSERT(queue.dequeue(msg, 0));
+            CPPUNIT_ASSERT_EQUAL(next_out++, *msg);
+        }
+    }
+    CPPUNIT_ASSERT(!queue.dequeue(msg, 0));
+    CPPUNIT_ASSERT(!queue.dequeue(msg, 20));
+
+    // Full queue.
+    for (int i = 0; i < 4; ++i) {
+        CPPUNIT_ASSERT(queue.enqueue(new int(i), 0));
+    }
+    CPPUNIT_ASSERT(!queue.enqueue(new int(4), 0));
+    CPPUNIT_ASSERT(!queue.enqueue(new int(4), 20));
+
+    // Forced overflow.
+    queue.forceEnqueue(new int(4));
+    queue.forceEnqueue(new int(5));
+    CPPUNIT_ASSERT_EQUAL(size_t(6), queue.size());
+    CPPUNIT_ASSERT(!queue.enqueue(new int(6), 0));
+    for (int i = 0; i < 6; ++i) {
+        CPPUNIT_ASSERT(queue.dequeue(msg, 0));
+        CPPUNIT_ASSERT_EQUAL(i, *msg);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(0), queue.size());
+
+    queue.forceEnqueue(new int(1));
+    queue.forceEnqueue(new int(2));
+    queue.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), queue.size());
+    CPPUNIT_ASSERT(!queue.dequeue(msg, 0));
+}
+
+// Test case: ring queue, priority messages
+void MessageQueueTest::testRingPriority()
+{
+    TestRingQueue queue(5);
+    TestRingQueue::MessagePtr msg;
+
+    CPPUNIT_ASSERT(queue.enqueue(new int(2), 0));
+    CPPUNIT_ASSERT(queue.enqueue(new int(3), 0));
+    CPPUNIT_ASSERT(queue.enqueueFront(new int(1), 0));
+    CPPUNIT_ASSERT(queue.enqueueFront(new int(0), 0));
+    CPPUNIT_ASSERT(queue.enqueue(new int(4), 0));
+    CPPUNIT_ASSERT(!queue.enqueueFront(new int(-1), 0));
+    queue.forceEnqueueFront(new int(-1));
+
+    for (int i = -1; i <= 4; ++i) {
+        CPPUNIT_ASSERT(queue.dequeue(msg, 0));
+        CPPUNIT_ASSERT_EQUAL(i, *msg);
+    }
+    CPPUNIT_ASSERT(!queue.dequeue(msg, 0));
+}
+
+// Thread for testRingBatch()
+namespace {
+    class RingQueueTestThread: public utest::CppUnitThread
+    {
+    private:
+        TestRingQueue& _queue;
+        int _count;
+    public:
+        RingQueueTestThread(TestRingQueue& queue, int count) :
+            utest::CppUnitThread(),
+            _queue(queue),
+            _count(count)
+        {
+        }
+
+        virtual void test() override
+        {
+            // Enqueue messages by batches of various sizes, larger than the queue.
+            TestRingQueue::MessagePtrVector msgs;
+            int next = 0;
+            size_t batch = 1;
+            while (next < _count) {
+                msgs.clear();
+                for (size_t i = 0; i < batch && next < _count; ++i) {
+                    msgs.push_back(new int(next++));
+                }
+                CPPUNIT_ASSERT_EQUAL(msgs.size(), _queue.enqueueBatch(msgs, 10000));
+                batch = batch % 23 + 1;
+            }
+            // End of stream.
+            CPPUNIT_ASSERT(_queue.enqueue(new int(-1), 10000));
+        }
+    };
+}
+
+// Test case: ring queue, batch operations between threads
+void MessageQueueTest::testRingBatch()
+{
+    const int count = 100000;
+    TestRingQueue queue(16);
+    RingQueueTestThread thread(queue, count);
+    CPPUNIT_ASSERT(thread.start());
+
+    TestRingQueue::MessagePtrVector msgs;
+    int expected = 0;
+    size_t batches = 0;
+    bool end = false;
+    while (!end) {
+        CPPUNIT_ASSERT(queue.dequeueBatch(msgs, 10, 10000));
+        CPPUNIT_ASSERT(!msgs.empty());
+        CPPUNIT_ASSERT(msgs.size() <= 10);
+        batches++;
+        for (size_t i = 0; i < msgs.size(); ++i) {
+            CPPUNIT_ASSERT(!end);
+            if (*msgs[i] < 0) {
+                end = true;
+            }
+            else {
+                CPPUNIT_ASSERT_EQUAL(expected++, *msgs[i]);
+            }
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(count, expected);
+    CPPUNIT_ASSERT(!queue.dequeueBatch(msgs, 10, 0));
+    CPPUNIT_ASSERT(msgs.empty());
+    utest::Out() << "MessageQueueTest: " << count << " messages received in " << batches << " batches" << std::endl;
+}
@@ -53,11 +53,13 @@ public:
     void testArithmetic();
     void testSysWait();
     void testWait();
+    void testPreciseWait();
 
     CPPUNIT_TEST_SUITE(MonotonicTest);
     CPPUNIT_TEST(testArithmetic);
     CPPUNIT_TEST(testSysWait);
     CPPUNIT_TEST(testWait);
+    CPPUNIT_TEST(testPreciseWait);
     CPPUNIT_TEST_SUITE_END();
 private:
     ts::NanoSecond  _nsPrecision;
@@ -153,3 +155,24 @@ void MonotonicTest::testWait()
     CPPUNIT_ASSERT(end >= start + 100 - _msPrecision);
     CPPUNIT_ASSERT(end < start + 150);
 }
+
+void MonotonicTest::testPreciseWait()
+{
+    const ts::NanoSecond latency = ts::Monotonic::SleepLatency();
+    utest::Out() << "MonotonicTest: sleep latency = " << ts::UString::Decimal(latency) << " ns" << std::endl;
+    CPPUNIT_ASSERT(latency > 0);
+
+    ts::Monotonic start;
+    start.getSystemTime();
+    ts::Monotonic due(start);
+    due += 20 * ts::NanoSecPerMilliSec;
+
+    const ts::NanoSecond late = due.preciseWait();
+
+    ts::Monotonic end;
+    end.getSystemTime();
+
+    CPPUNIT_ASSERT(late >= 0);
+    CPPUNIT_ASSERT(end >= due);
+    CPPUNIT_ASSERT(end - start < 50 * ts::NanoSecPerMilliSec);
+}
@@ -34,7 +34,9 @@
 #include "tsNames.h"
 #include "tsMPEG.h"
 #include "tsSysUtils.h"
+#include "tsCerrReport.h"
 #include "utestCppUnitTest.h"
+#include <fstream>
 TSDUCK_SOURCE;
 
 
@@ -83,6 +85,7 @@ public:
     void testAudioType();
     void testT2MIPacketType();
     void testPlatformId();
+    void testImage();
 
     CPPUNIT_TEST_SUITE(NamesTest);
     CPPUNIT_TEST(testConfigFile);
@@ -120,6 +123,7 @@ public:
     CPPUNIT_TEST(testAudioType);
     CPPUNIT_TEST(testT2MIPacketType);
     CPPUNIT_TEST(testPlatformId);
+    CPPUNIT_TEST(testImage);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -375,3 +379,53 @@ void NamesTest::testPlatformId()
     CPPUNIT_ASSERT_USTRINGS_EQUAL(u"0x000004 (TV digitale mobile, Telecom Italia)", ts::names::PlatformId(4, ts::names::FIRST));
     CPPUNIT_ASSERT_USTRINGS_EQUAL(u"VTC Mobile TV (0x704001)", ts::names::PlatformId(0x704001, ts::names::VALUE));
 }
+
+void NamesTest::testImage()
+{
+    const ts::UString textFile(ts::TempFile(u".names"));
+    const ts::UString imageFile(textFile + ts::Names::IMAGE_SUFFIX);
+
+    std::ofstream strm(textFile.toUTF8().c_str());
+    strm << "[Alpha]" << std::endl
+         << "Bits = 16" << std::endl
+         << "0x0001 = One" << std::endl
+         << "0x0010-0x001F = Sixteen to thirty-one" << std::endl
+         << "0x1234 = T\xC3\xA9" "l\xC3\xA9" "diffusion" << std::endl
+         << "[Beta]" << std::endl
+         << "0x00 = Zero" << std::endl;
+    strm.close();
+
+    // Parse the text file and compile it.
+    {
+        ts::Names text(textFile);
+        CPPUNIT_ASSERT_EQUAL(size_t(0), text.errorCount());
+        CPPUNIT_ASSERT(text.imageFile().empty());
+        CPPUNIT_ASSERT(text.saveImage(imageFile, CERR));
+    }
+
+    // Now, the image is not older than the text file and is used.
+    ts::Names image(textFile);
+    utest::Out() << "NamesTest: image file: " << image.imageFile() << std::endl;
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(imageFile, image.imageFile());
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(textFile, image.configurationFile());
+
+    CPPUNIT_ASSERT(image.nameExists(u"ALPHA", 1));
+    CPPUNIT_ASSERT(!image.nameExists(u"alpha", 2));
+    CPPUNIT_ASSERT(!image.nameExists(u"gamma", 0));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"One", image.nameFromSection(u"Alpha", 1));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Sixteen to thirty-one (0x0018)", image.nameFromSection(u"Alpha", 0x18, ts::names::VALUE));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x0020)", image.nameFromSection(u"Alpha", 0x20));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x0000)", image.nameFromSection(u"Alpha", 0));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0xFFFF)", image.nameFromSection(u"Alpha", 0xFFFF));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(ts::UString(u"T") + ts::LATIN_SMALL_LETTER_E_WITH_ACUTE + u"l" + ts::LATIN_SMALL_LETTER_E_WITH_ACUTE + u"diffusion", image.nameFromSection(u"alpha", 0x1234));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Zero", image.nameFromSectionWithFallback(u"Beta", 7, 0));
+
+    // Recompiling from the image gives the same image.
+    const ts::UString imageFile2(ts::TempFile(u".bin"));
+    CPPUNIT_ASSERT(image.saveImage(imageFile2, CERR));
+    CPPUNIT_ASSERT_EQUAL(ts::GetFileSize(imageFile), ts::GetFileSize(imageFile2));
+
+    CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, ts::DeleteFile(textFile));
+    CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, ts::DeleteFile(imageFile));
+    CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, ts::DeleteFile(imageFile2));
+}
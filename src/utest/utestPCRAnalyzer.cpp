@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::PCRAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsPCRAnalyzer.h"
+#include "tsPCR.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PCRAnalyzerTest: public CppUnit::TestFixture
+{
+public:
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testBatch();
+    void testRegression();
+    void testDiscontinuity();
+
+    CPPUNIT_TEST_SUITE(PCRAnalyzerTest);
+    CPPUNIT_TEST(testBatch);
+    CPPUNIT_TEST(testRegression);
+    CPPUNIT_TEST(testDiscontinuity);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Build a stream at the specified bitrate, with one PCR every 50 packets.
+    // The PCR's have a jitter of up to +/- jitter PCR units.
+    static void BuildStream(ts::TSPacketVector& packets, size_t count, ts::BitRate bitrate, uint64_t jitter, uint64_t first_pcr = 1000000);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PCRAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PCRAnalyzerTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void PCRAnalyzerTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build the test stream.
+//----------------------------------------------------------------------------
+
+void PCRAnalyzerTest::BuildStream(ts::TSPacketVector& packets, size_t count, ts::BitRate bitrate, uint64_t jitter, uint64_t first_pcr)
+{
+    packets.resize(count);
+    uint8_t cc[2] = {0, 0};
+    for (size_t i = 0; i < count; ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        pkt = ts::NullPacket;
+        const size_t index = i % 50 == 0 ? 0 : 1;
+        pkt.setPID(ts::PID(0x0100 + index));
+        pkt.setCC(cc[index]);
+        cc[index] = (cc[index] + 1) % ts::CC_MAX;
+        if (index == 0) {
+            // Adaptation field with PCR, then payload.
+            const uint64_t pcr = first_pcr + (uint64_t(i) * ts::SYSTEM_CLOCK_FREQ * ts::PKT_SIZE * 8) / bitrate;
+            const uint64_t offset = jitter == 0 ? 0 : (i * 7919) % (2 * jitter + 1);
+            pkt.b[3] |= 0x20;
+            pkt.b[4] = 7;
+            pkt.b[5] = 0x10;
+            ts::PutPCR(pkt.b + 6, pcr + offset - std::min(pcr + offset, jitter));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PCRAnalyzerTest::testBatch()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets, 10000, 5000000, 800);
+
+    ts::PCRAnalyzer zer1(1, 32);
+    ts::PCRAnalyzer zer2(1, 32);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        zer1.feedPacket(packets[i]);
+    }
+    CPPUNIT_ASSERT(zer2.feedPackets(&packets[0], packets.size()));
+    CPPUNIT_ASSERT(zer1.bitrateIsValid());
+
+    CPPUNIT_ASSERT_EQUAL(zer1.bitrate188(), zer2.bitrate188());
+    CPPUNIT_ASSERT_EQUAL(zer1.bitrate204(), zer2.bitrate204());
+    CPPUNIT_ASSERT_EQUAL(zer1.regressionBitrate188(), zer2.regressionBitrate188());
+    CPPUNIT_ASSERT_EQUAL(zer1.packetCount(0x0100), zer2.packetCount(0x0100));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(200), zer2.packetCount(0x0100));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(9800), zer2.packetCount(0x0101));
+}
+
+void PCRAnalyzerTest::testRegression()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets, 20000, 10000000, 0);
+
+    // Without jitter, both methods give the exact bitrate.
+    ts::PCRAnalyzer zer;
+    CPPUNIT_ASSERT(!zer.feedPackets(&packets[0], 20));
+    CPPUNIT_ASSERT_EQUAL(ts::BitRate(0), zer.regressionBitrate188());
+    CPPUNIT_ASSERT(zer.feedPackets(&packets[20], packets.size() - 20));
+    CPPUNIT_ASSERT(zer.regressionBitrate188() >= 9999990 && zer.regressionBitrate188() <= 10000010);
+    CPPUNIT_ASSERT(zer.bitrate188() >= 9999000 && zer.bitrate188() <= 10001000);
+    CPPUNIT_ASSERT(zer.regressionBitrate204() >= 10851052 && zer.regressionBitrate204() <= 10851072);
+
+    // With jitter, the regression remains accurate.
+    BuildStream(packets, 20000, 10000000, 2000);
+    zer.reset();
+    zer.feedPackets(&packets[0], packets.size());
+    utest::Out() << "PCRAnalyzerTest::testRegression: average: " << zer.bitrate188() << " b/s, regression: " << zer.regressionBitrate188() << " b/s" << std::endl;
+    CPPUNIT_ASSERT(zer.regressionBitrate188() >= 9999000 && zer.regressionBitrate188() <= 10001000);
+}
+
+void PCRAnalyzerTest::testDiscontinuity()
+{
+    // Three parts of a stream, with distinct PCR origins. With 8000 packets per part,
+    // the continuity counters are continuous from one part to the next one.
+    ts::TSPacketVector part1;
+    ts::TSPacketVector part2;
+    ts::TSPacketVector part3;
+    BuildStream(part1, 8000, 8000000, 0, 1000000);
+    BuildStream(part2, 8000, 8000000, 0, 500000000);  // PCR jump without discontinuity indicator
+    BuildStream(part3, 8000, 8000000, 0, 1000000);
+    part3[0].b[5] |= 0x80;  // discontinuity indicator
+
+    ts::PCRAnalyzer zer(1, 32);
+    zer.feedPackets(&part1[0], part1.size());
+    zer.feedPackets(&part2[0], part2.size());
+    zer.feedPackets(&part3[0], part3.size());
+    CPPUNIT_ASSERT(zer.bitrateIsValid());
+    CPPUNIT_ASSERT(zer.regressionBitrate188() >= 7999990 && zer.regressionBitrate188() <= 8000010);
+}
@@ -0,0 +1,330 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::PacketPacer
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketPacer.h"
+#include "tsPCR.h"
+#include "tsSysUtils.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PacketPacerTest: public CppUnit::TestFixture
+{
+public:
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testBitrate();
+    void testBitrateChange();
+    void testPCR();
+    void testDiscontinuity();
+    void testWait();
+    void testCatchUp();
+    void testShift();
+
+    CPPUNIT_TEST_SUITE(PacketPacerTest);
+    CPPUNIT_TEST(testBitrate);
+    CPPUNIT_TEST(testBitrateChange);
+    CPPUNIT_TEST(testPCR);
+    CPPUNIT_TEST(testDiscontinuity);
+    CPPUNIT_TEST(testWait);
+    CPPUNIT_TEST(testCatchUp);
+    CPPUNIT_TEST(testShift);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Bitrate which gives exactly one packet per millisecond.
+    static const ts::BitRate ONE_PACKET_PER_MS = ts::PKT_SIZE * 8 * 1000;
+
+    // Build a packet with a PCR.
+    static ts::TSPacket PCRPacket(ts::PID pid, uint64_t pcr, bool discontinuity = false);
+
+    // Feed a packet and return a copy of its due time.
+    static ts::Monotonic Feed(ts::PacketPacer& pacer, const ts::TSPacket& pkt) { return pacer.feedPacket(pkt); }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PacketPacerTest);
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const ts::BitRate PacketPacerTest::ONE_PACKET_PER_MS;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PacketPacerTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void PacketPacerTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build a packet with a PCR.
+//----------------------------------------------------------------------------
+
+ts::TSPacket PacketPacerTest::PCRPacket(ts::PID pid, uint64_t pcr, bool discontinuity)
+{
+    ts::TSPacket pkt(ts::NullPacket);
+    pkt.setPID(pid);
+    pkt.b[3] |= 0x20;
+    pkt.b[4] = 7;
+    pkt.b[5] = discontinuity ? 0x90 : 0x10;
+    ts::PutPCR(pkt.b + 6, pcr);
+    return pkt;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PacketPacerTest::testBitrate()
+{
+    ts::PacketPacer pacer;
+    pacer.setBitrate(ONE_PACKET_PER_MS);
+    CPPUNIT_ASSERT_EQUAL(ONE_PACKET_PER_MS, pacer.bitrate());
+
+    // The first packet is due now, the next ones are evenly spaced from it.
+    ts::Monotonic before;
+    before.getSystemTime();
+    const ts::Monotonic first(Feed(pacer, ts::NullPacket));
+    CPPUNIT_ASSERT(first >= before);
+
+    for (ts::NanoSecond i = 1; i < 1000; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i * ts::NanoSecPerMilliSec, Feed(pacer, ts::NullPacket) - first);
+    }
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(0), pacer.statistics().resyncs);
+
+    // After a reset, the next packet is due now again.
+    pacer.reset();
+    ts::Monotonic now;
+    now.getSystemTime();
+    const ts::Monotonic restart(Feed(pacer, ts::NullPacket));
+    CPPUNIT_ASSERT(restart >= now);
+    CPPUNIT_ASSERT_EQUAL(ts::NanoSecPerMilliSec, Feed(pacer, ts::NullPacket) - restart);
+
+    // Without bitrate, each packet is due immediately.
+    ts::PacketPacer nopace;
+    const ts::Monotonic t0(Feed(nopace, ts::NullPacket));
+    ts::SleepThread(5);
+    CPPUNIT_ASSERT(Feed(nopace, ts::NullPacket) - t0 >= 5 * ts::NanoSecPerMilliSec);
+}
+
+void PacketPacerTest::testBitrateChange()
+{
+    ts::PacketPacer pacer;
+    pacer.setBitrate(ONE_PACKET_PER_MS);
+
+    const ts::Monotonic first(Feed(pacer, ts::NullPacket));
+    for (int i = 1; i < 10; ++i) {
+        Feed(pacer, ts::NullPacket);
+    }
+    const ts::Monotonic last(pacer.due());
+    CPPUNIT_ASSERT_EQUAL(9 * ts::NanoSecPerMilliSec, last - first);
+
+    // Twice the bitrate: the new schedule starts from the last due time.
+    pacer.setBitrate(2 * ONE_PACKET_PER_MS);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(1), pacer.statistics().resyncs);
+    for (ts::NanoSecond i = 1; i <= 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i * ts::NanoSecPerMilliSec / 2, Feed(pacer, ts::NullPacket) - last);
+    }
+
+    // Setting the same bitrate does not resync.
+    pacer.setBitrate(2 * ONE_PACKET_PER_MS);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(1), pacer.statistics().resyncs);
+}
+
+void PacketPacerTest::testPCR()
+{
+    ts::PacketPacer pacer;
+    pacer.setBitrate(ONE_PACKET_PER_MS);
+    pacer.usePCR(true, 100);
+
+    // Before two PCR's are known, the user-specified bitrate is used.
+    const uint64_t pcr0 = 1000000;
+    const ts::Monotonic first(Feed(pacer, PCRPacket(100, pcr0)));
+    for (ts::NanoSecond i = 1; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i * ts::NanoSecPerMilliSec, Feed(pacer, ts::NullPacket) - first);
+    }
+    CPPUNIT_ASSERT_EQUAL(ONE_PACKET_PER_MS, pacer.bitrate());
+
+    // A PCR on another PID is ignored.
+    CPPUNIT_ASSERT_EQUAL(10 * ts::NanoSecPerMilliSec, Feed(pacer, PCRPacket(200, pcr0 + 1000000)) - first);
+
+    // Next PCR, 5 ms after the first one, 11 packets later: the due time is derived from the PCR.
+    const uint64_t pcr1 = pcr0 + 5 * ts::SYSTEM_CLOCK_FREQ / 1000;
+    const ts::Monotonic second(Feed(pacer, PCRPacket(100, pcr1)));
+    CPPUNIT_ASSERT_EQUAL(5 * ts::NanoSecPerMilliSec, second - first);
+
+    // The bitrate is now measured from the PCR's: 11 packets in 5 ms.
+    CPPUNIT_ASSERT_EQUAL(ts::BitRate((11 * ts::PKT_SIZE * 8 * 1000) / 5), pacer.bitrate());
+    for (ts::NanoSecond i = 1; i <= 11; ++i) {
+        CPPUNIT_ASSERT_EQUAL((i * 5 * ts::NanoSecPerMilliSec) / 11, Feed(pacer, ts::NullPacket) - second);
+    }
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(0), pacer.statistics().resyncs);
+
+    // Disabling PCR pacing restores the user-specified bitrate.
+    pacer.usePCR(false);
+    CPPUNIT_ASSERT_EQUAL(ONE_PACKET_PER_MS, pacer.bitrate());
+}
+
+void PacketPacerTest::testDiscontinuity()
+{
+    ts::PacketPacer pacer;
+    pacer.setBitrate(ONE_PACKET_PER_MS);
+    pacer.usePCR(true, 100);
+
+    // Two PCR's, 10 packets in 5 ms.
+    const uint64_t pcr0 = 1000000;
+    const uint64_t pcr1 = pcr0 + 5 * ts::SYSTEM_CLOCK_FREQ / 1000;
+    const ts::Monotonic first(Feed(pacer, PCRPacket(100, pcr0)));
+    for (int i = 1; i < 10; ++i) {
+        Feed(pacer, ts::NullPacket);
+    }
+    const ts::Monotonic second(Feed(pacer, PCRPacket(100, pcr1)));
+    CPPUNIT_ASSERT_EQUAL(5 * ts::NanoSecPerMilliSec, second - first);
+    for (int i = 1; i < 10; ++i) {
+        Feed(pacer, ts::NullPacket);
+    }
+
+    // PCR with discontinuity indicator, back in time: the due time remains driven by the last measured bitrate.
+    const ts::Monotonic third(Feed(pacer, PCRPacket(100, 0, true)));
+    CPPUNIT_ASSERT_EQUAL(5 * ts::NanoSecPerMilliSec, third - second);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(1), pacer.statistics().resyncs);
+    for (int i = 1; i < 10; ++i) {
+        Feed(pacer, ts::NullPacket);
+    }
+
+    // PCR jump of 10 seconds without discontinuity indicator: same thing.
+    const ts::Monotonic fourth(Feed(pacer, PCRPacket(100, 10 * ts::SYSTEM_CLOCK_FREQ)));
+    CPPUNIT_ASSERT_EQUAL(5 * ts::NanoSecPerMilliSec, fourth - third);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(2), pacer.statistics().resyncs);
+    for (int i = 1; i < 10; ++i) {
+        Feed(pacer, ts::NullPacket);
+    }
+
+    // The next regular PCR is used again, 10 packets in 2 ms.
+    const ts::Monotonic fifth(Feed(pacer, PCRPacket(100, 10 * ts::SYSTEM_CLOCK_FREQ + 2 * ts::SYSTEM_CLOCK_FREQ / 1000)));
+    CPPUNIT_ASSERT_EQUAL(2 * ts::NanoSecPerMilliSec, fifth - fourth);
+    CPPUNIT_ASSERT_EQUAL(ts::BitRate(5 * ts::PKT_SIZE * 8 * 1000), pacer.bitrate());
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(2), pacer.statistics().resyncs);
+}
+
+void PacketPacerTest::testWait()
+{
+    // 10 ms between packets, long enough to always wait for the second packet.
+    ts::PacketPacer pacer;
+    pacer.setBitrate(ONE_PACKET_PER_MS / 10);
+
+    // The first packet is already due, no actual wait.
+    Feed(pacer, ts::NullPacket);
+    pacer.wait();
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(1), pacer.statistics().bursts);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(1), pacer.statistics().late_bursts);
+
+    // The second packet is in the future.
+    const ts::Monotonic due(Feed(pacer, ts::NullPacket));
+    pacer.wait();
+    ts::Monotonic now;
+    now.getSystemTime();
+    CPPUNIT_ASSERT(now >= due);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(2), pacer.statistics().bursts);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(1), pacer.statistics().late_bursts);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(0), pacer.statistics().resyncs);
+    utest::Out() << "PacketPacerTest::testWait: " << pacer.statistics().toString() << std::endl;
+}
+
+void PacketPacerTest::testCatchUp()
+{
+    // Below the maximum lateness (default: 1 second), late packets are sent in a burst to catch up.
+    ts::PacketPacer pacer;
+    pacer.setBitrate(ONE_PACKET_PER_MS);
+
+    const ts::Monotonic first(Feed(pacer, ts::NullPacket));
+    pacer.wait();
+    Feed(pacer, ts::NullPacket);
+    ts::SleepThread(20);
+    pacer.wait();
+
+    // The schedule is unchanged, the next packet is already due.
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(2), pacer.statistics().late_bursts);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(0), pacer.statistics().resyncs);
+    CPPUNIT_ASSERT(pacer.statistics().max_late >= 19 * ts::NanoSecPerMilliSec);
+
+    const ts::Monotonic third(Feed(pacer, ts::NullPacket));
+    CPPUNIT_ASSERT_EQUAL(2 * ts::NanoSecPerMilliSec, third - first);
+    ts::Monotonic now;
+    now.getSystemTime();
+    CPPUNIT_ASSERT(third < now);
+    pacer.wait();
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(3), pacer.statistics().late_bursts);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(0), pacer.statistics().resyncs);
+}
+
+void PacketPacerTest::testShift()
+{
+    // Above the maximum lateness, the schedule is shifted to the current time.
+    ts::PacketPacer pacer;
+    pacer.setBitrate(ONE_PACKET_PER_MS);
+    pacer.setMaxLateness(10 * ts::NanoSecPerMilliSec);
+
+    const ts::Monotonic first(Feed(pacer, ts::NullPacket));
+    pacer.wait();
+    Feed(pacer, ts::NullPacket);
+    ts::SleepThread(20);
+    ts::Monotonic before;
+    before.getSystemTime();
+    pacer.wait();
+
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(2), pacer.statistics().late_bursts);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(1), pacer.statistics().resyncs);
+
+    // The due time of the late packet is now, the next ones are evenly spaced from it.
+    const ts::Monotonic second(pacer.due());
+    CPPUNIT_ASSERT(second >= before);
+    CPPUNIT_ASSERT(second - first >= 20 * ts::NanoSecPerMilliSec);
+    for (ts::NanoSecond i = 1; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i * ts::NanoSecPerMilliSec, Feed(pacer, ts::NullPacket) - second);
+    }
+}
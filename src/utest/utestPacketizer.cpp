@@ -34,10 +34,12 @@
 #include "tsPacketizer.h"
 #include "tsCyclingPacketizer.h"
 #include "tsStandaloneTableDemux.h"
+#include "tsSectionDemux.h"
 #include "tsPAT.h"
 #include "tsPMT.h"
 #include "tsSDT.h"
 #include "tsNames.h"
+#include "tsMonotonic.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -57,9 +59,13 @@ public:
     virtual void tearDown() override;
 
     void testPacketizer();
+    void testManySections();
+    void testRemoveShortSections();
 
     CPPUNIT_TEST_SUITE(PacketizerTest);
     CPPUNIT_TEST(testPacketizer);
+    CPPUNIT_TEST(testManySections);
+    CPPUNIT_TEST(testRemoveShortSections);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -174,3 +180,114 @@ void PacketizerTest::testPacketizer()
     CPPUNIT_ASSERT(pmt_count == 4);
     CPPUNIT_ASSERT(sdt_count >= 15 && sdt_count <= 17);
 }
+
+// Collect the table id / table id extension of all demuxed sections.
+namespace {
+    class SectionCollector: public ts::SectionHandlerInterface
+    {
+    public:
+        std::set<std::pair<ts::TID, uint16_t>> sections;
+        SectionCollector() : sections() {}
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+        {
+            sections.insert(std::make_pair(section.tableId(), section.tableIdExtension()));
+        }
+    };
+}
+
+void PacketizerTest::testManySections()
+{
+    // EIT schedule-like load: 4,000 sections in one packetizer, 16 table ids,
+    // 250 table id extensions per table id, various repetition rates.
+
+    const size_t tid_count = 16;
+    const size_t ext_count = 250;
+    const ts::BitRate bitrate = 1000000; // 20,000 packets = 30 seconds, longer than all repetition rates
+    const ts::PacketCounter packet_count = 20000;
+    const uint8_t payload[64] = {0};
+
+    ts::CyclingPacketizer pzer(ts::PID_EIT, ts::CyclingPacketizer::NEVER, bitrate);
+
+    ts::Monotonic start;
+    start.getSystemTime();
+    for (size_t ext = 0; ext < ext_count; ++ext) {
+        for (size_t t = 0; t < tid_count; ++t) {
+            const ts::TID tid = ts::TID(ts::TID_EIT_S_ACT_MIN + t);
+            pzer.addSection(new ts::Section(tid, true, uint16_t(ext), 0, true, 0, 0, payload, sizeof(payload)), ts::MilliSecond(2000 + 500 * t));
+        }
+    }
+    ts::Monotonic end;
+    end.getSystemTime();
+    utest::Out() << "PacketizerTest: added " << ts::UString::Decimal(pzer.storedSectionCount()) << " sections in "
+                 << ts::UString::Decimal((end - start) / ts::NanoSecPerMicroSec) << " us" << std::endl;
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter(tid_count * ext_count), pzer.storedSectionCount());
+
+    // Generate packets, all sections must be scheduled.
+    SectionCollector collector;
+    ts::SectionDemux demux(0, &collector, ts::PIDSet().set(ts::PID_EIT));
+    ts::TSPacket pkt;
+    start.getSystemTime();
+    for (ts::PacketCounter pi = 0; pi < packet_count; ++pi) {
+        pzer.getNextPacket(pkt);
+        CPPUNIT_ASSERT_EQUAL(uint8_t(ts::SYNC_BYTE), pkt.b[0]);
+        demux.feedPacket(pkt);
+    }
+    end.getSystemTime();
+    utest::Out() << "PacketizerTest: generated and demuxed " << ts::UString::Decimal(packet_count) << " packets in "
+                 << ts::UString::Decimal((end - start) / ts::NanoSecPerMicroSec) << " us" << std::endl;
+    CPPUNIT_ASSERT_EQUAL(tid_count * ext_count, collector.sections.size());
+
+    // Bulk removal by table id and by table id extension.
+    start.getSystemTime();
+    pzer.removeSections(ts::TID_EIT_S_ACT_MIN);
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter((tid_count - 1) * ext_count), pzer.storedSectionCount());
+    for (size_t ext = 0; ext < 100; ++ext) {
+        pzer.removeSections(ts::TID_EIT_S_ACT_MIN + 1, uint16_t(ext));
+    }
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter((tid_count - 1) * ext_count - 100), pzer.storedSectionCount());
+    end.getSystemTime();
+    utest::Out() << "PacketizerTest: removed sections in " << ts::UString::Decimal((end - start) / ts::NanoSecPerMicroSec) << " us" << std::endl;
+
+    // Continue packetization after removal, the removed sections are no longer sent.
+    // The section which was being packetized during the removal is incomplete for a new demux.
+    SectionCollector after;
+    ts::SectionDemux demux_after(0, &after, ts::PIDSet().set(ts::PID_EIT));
+    for (ts::PacketCounter pi = 0; pi < packet_count; ++pi) {
+        pzer.getNextPacket(pkt);
+        demux_after.feedPacket(pkt);
+    }
+    CPPUNIT_ASSERT_EQUAL((tid_count - 1) * ext_count - 100, after.sections.size());
+    for (std::set<std::pair<ts::TID, uint16_t>>::const_iterator it = after.sections.begin(); it != after.sections.end(); ++it) {
+        CPPUNIT_ASSERT(it->first != ts::TID_EIT_S_ACT_MIN);
+        CPPUNIT_ASSERT(it->first != ts::TID_EIT_S_ACT_MIN + 1 || it->second >= 100);
+    }
+}
+
+void PacketizerTest::testRemoveShortSections()
+{
+    const uint8_t payload[16] = {0};
+    ts::CyclingPacketizer pzer(ts::PID(100));
+
+    // Short sections and long sections with the same table id.
+    pzer.addSection(new ts::Section(ts::TID(0x80), true, payload, sizeof(payload)));
+    pzer.addSection(new ts::Section(ts::TID(0x80), true, payload, sizeof(payload)), 1000);
+    pzer.addSection(new ts::Section(ts::TID(0x80), true, 0x0000, 0, true, 0, 0, payload, sizeof(payload)));
+    pzer.addSection(new ts::Section(ts::TID(0x80), true, 0x0001, 0, true, 0, 0, payload, sizeof(payload)), 1000);
+    pzer.addSection(new ts::Section(ts::TID(0x81), true, payload, sizeof(payload)));
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter(5), pzer.storedSectionCount());
+
+    // A short section has no table id extension, it matches a zero one.
+    pzer.removeSections(ts::TID(0x80), 0x0001);
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter(4), pzer.storedSectionCount());
+    pzer.removeSections(ts::TID(0x80), 0x0000);
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter(1), pzer.storedSectionCount());
+
+    // Packetize the remaining section.
+    ts::TSPacket pkt;
+    pzer.getNextPacket(pkt);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x81), pkt.b[5]);
+
+    // Remove by table id only.
+    pzer.removeSections(ts::TID(0x81));
+    CPPUNIT_ASSERT_EQUAL(ts::SectionCounter(0), pzer.storedSectionCount());
+}
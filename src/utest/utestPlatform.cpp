@@ -61,6 +61,7 @@ public:
     void testROL64c();
     void testROR64();
     void testROR64c();
+    void testCountLeadingZeros64();
     void testByteSwap16();
     void testByteSwap32();
     void testByteSwap64();
@@ -125,6 +126,7 @@ public:
     CPPUNIT_TEST(testROL64c);
     CPPUNIT_TEST(testROR64);
     CPPUNIT_TEST(testROR64c);
+    CPPUNIT_TEST(testCountLeadingZeros64);
     CPPUNIT_TEST(testByteSwap16);
     CPPUNIT_TEST(testByteSwap32);
     CPPUNIT_TEST(testByteSwap64);
@@ -415,6 +417,17 @@ void PlatformTest::testROR64c()
     CPPUNIT_ASSERT_EQUAL(TS_UCONST64(0xDEF0123456789ABC), ts::ROR64c(TS_UCONST64(0x0123456789ABCDEF), 12));
 }
 
+void PlatformTest::testCountLeadingZeros64()
+{
+    CPPUNIT_ASSERT_EQUAL(64, ts::CountLeadingZeros64(0));
+    CPPUNIT_ASSERT_EQUAL(63, ts::CountLeadingZeros64(1));
+    CPPUNIT_ASSERT_EQUAL(0, ts::CountLeadingZeros64(TS_UCONST64(0x8000000000000000)));
+    CPPUNIT_ASSERT_EQUAL(0, ts::CountLeadingZeros64(TS_UCONST64(0xFFFFFFFFFFFFFFFF)));
+    CPPUNIT_ASSERT_EQUAL(7, ts::CountLeadingZeros64(TS_UCONST64(0x0123456789ABCDEF)));
+    CPPUNIT_ASSERT_EQUAL(31, ts::CountLeadingZeros64(TS_UCONST64(0x00000001FFFFFFFF)));
+    CPPUNIT_ASSERT_EQUAL(32, ts::CountLeadingZeros64(TS_UCONST64(0x00000000FFFFFFFF)));
+}
+
 
 //----------------------------------------------------------------------------
 // Byte swaps
@@ -0,0 +1,273 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::PluginManifest
+//
+//----------------------------------------------------------------------------
+
+#include "tsPluginManifest.h"
+#include "tsNullReport.h"
+#include "tsSysUtils.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PluginManifestTest: public CppUnit::TestFixture
+{
+public:
+    PluginManifestTest();
+
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testLoad();
+    void testSearchOrder();
+    void testOutdated();
+
+    CPPUNIT_TEST_SUITE(PluginManifestTest);
+    CPPUNIT_TEST(testLoad);
+    CPPUNIT_TEST(testSearchOrder);
+    CPPUNIT_TEST(testOutdated);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    ts::UString _dir1;
+    ts::UString _dir2;
+
+    // Full path of a plugin shared library in a directory.
+    static ts::UString PluginFile(const ts::UString& dir, const ts::UString& name);
+
+    // Create a fake plugin shared library in a directory.
+    static void CreatePlugin(const ts::UString& dir, const ts::UString& name);
+
+    // Delete a test directory and its content.
+    static void Cleanup(const ts::UString& dir);
+
+    // Load the manifests of both test directories.
+    void load(ts::PluginManifest& manifest) const;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PluginManifestTest);
+
+// Environment variable which is used as plugin search path.
+#define PATH_VARIABLE u"UTEST_PLUGIN_MANIFEST_PATH"
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+PluginManifestTest::PluginManifestTest() :
+    _dir1(ts::TempFile(u"")),
+    _dir2(ts::TempFile(u""))
+{
+}
+
+// Test suite initialization method.
+void PluginManifestTest::setUp()
+{
+    Cleanup(_dir1);
+    Cleanup(_dir2);
+    CPPUNIT_ASSERT(ts::CreateDirectory(_dir1) == ts::SYS_SUCCESS);
+    CPPUNIT_ASSERT(ts::CreateDirectory(_dir2) == ts::SYS_SUCCESS);
+
+    // Plugin files first, then the manifests, so that the manifests are up to date.
+    CreatePlugin(_dir1, u"foo");
+    CreatePlugin(_dir1, u"bar");
+    CreatePlugin(_dir2, u"foo");
+    CreatePlugin(_dir2, u"qux");
+
+    ts::UStringList lines1;
+    lines1.push_back(u"# name, capability, file, syntax, description (tab-separated)");
+    lines1.push_back(u"foo\tinput\ttsplugin_foo" TS_SHARED_LIB_SUFFIX u"\tfoo [options]\tFoo input");
+    lines1.push_back(u"foo\tprocessor\ttsplugin_foo" TS_SHARED_LIB_SUFFIX u"\tfoo [options] file\tFoo processor");
+    lines1.push_back(u"bar\toutput\ttsplugin_bar" TS_SHARED_LIB_SUFFIX u"\tbar\tBar output");
+    lines1.push_back(u"missing\tinput\ttsplugin_missing" TS_SHARED_LIB_SUFFIX u"\tmissing\tNo shared library");
+    lines1.push_back(u"invalid\tfilter\ttsplugin_invalid" TS_SHARED_LIB_SUFFIX u"\tinvalid\tUnknown capability");
+    lines1.push_back(u"truncated\tinput");
+    CPPUNIT_ASSERT(ts::UString::Save(lines1, _dir1 + ts::PathSeparator + ts::PluginManifest::FILE_NAME));
+
+    ts::UStringList lines2;
+    lines2.push_back(u"foo\tinput\ttsplugin_foo" TS_SHARED_LIB_SUFFIX u"\tfoo2\tSecond foo input");
+    lines2.push_back(u"qux\toutput\ttsplugin_qux" TS_SHARED_LIB_SUFFIX u"\tqux\tQux output");
+    CPPUNIT_ASSERT(ts::UString::Save(lines2, _dir2 + ts::PathSeparator + ts::PluginManifest::FILE_NAME));
+}
+
+// Test suite cleanup method.
+void PluginManifestTest::tearDown()
+{
+    Cleanup(_dir1);
+    Cleanup(_dir2);
+}
+
+
+//----------------------------------------------------------------------------
+// Test directories and files.
+//----------------------------------------------------------------------------
+
+ts::UString PluginManifestTest::PluginFile(const ts::UString& dir, const ts::UString& name)
+{
+    return dir + ts::PathSeparator + u"tsplugin_" + name + TS_SHARED_LIB_SUFFIX;
+}
+
+void PluginManifestTest::CreatePlugin(const ts::UString& dir, const ts::UString& name)
+{
+    ts::UStringList content;
+    content.push_back(u"not a shared library");
+    CPPUNIT_ASSERT(ts::UString::Save(content, PluginFile(dir, name)));
+}
+
+void PluginManifestTest::Cleanup(const ts::UString& dir)
+{
+    if (ts::IsDirectory(dir)) {
+        ts::UStringVector files;
+        ts::ExpandWildcard(files, dir + ts::PathSeparator + u"*");
+        for (ts::UStringVector::const_iterator it = files.begin(); it != files.end(); ++it) {
+            ts::DeleteFile(*it);
+        }
+        ts::DeleteFile(dir);
+    }
+}
+
+void PluginManifestTest::load(ts::PluginManifest& manifest) const
+{
+    CPPUNIT_ASSERT(ts::SetEnvironment(PATH_VARIABLE, _dir1 + ts::SearchPathSeparator + _dir2));
+    CPPUNIT_ASSERT(!manifest.isLoaded());
+    manifest.load(PATH_VARIABLE, NULLREP);
+    CPPUNIT_ASSERT(manifest.isLoaded());
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PluginManifestTest::testLoad()
+{
+    ts::PluginManifest manifest;
+    load(manifest);
+
+    // Multi-capability plugin.
+    const ts::PluginManifest::Entry* e = manifest.find(ts::PluginManifest::INPUT, u"foo");
+    CPPUNIT_ASSERT(e != 0);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(PluginFile(_dir1, u"foo"), e->file);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"foo [options]", e->syntax);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Foo input", e->description);
+    CPPUNIT_ASSERT(e->isUpToDate());
+
+    e = manifest.find(ts::PluginManifest::PROCESSOR, u"foo");
+    CPPUNIT_ASSERT(e != 0);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"foo [options] file", e->syntax);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Foo processor", e->description);
+    CPPUNIT_ASSERT(manifest.find(ts::PluginManifest::OUTPUT, u"foo") == 0);
+
+    e = manifest.find(ts::PluginManifest::OUTPUT, u"bar");
+    CPPUNIT_ASSERT(e != 0);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(PluginFile(_dir1, u"bar"), e->file);
+    CPPUNIT_ASSERT(manifest.find(ts::PluginManifest::INPUT, u"bar") == 0);
+
+    CPPUNIT_ASSERT(manifest.isKnown(u"foo"));
+    CPPUNIT_ASSERT(manifest.isKnown(u"bar"));
+    CPPUNIT_ASSERT(manifest.containsFile(PluginFile(_dir1, u"foo")));
+    CPPUNIT_ASSERT(manifest.containsFile(PluginFile(_dir1, u"bar")));
+
+    // Entry without shared library: listed but never found.
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manifest.entries(ts::PluginManifest::INPUT).count(u"missing"));
+    CPPUNIT_ASSERT(manifest.find(ts::PluginManifest::INPUT, u"missing") == 0);
+    CPPUNIT_ASSERT(!manifest.isKnown(u"missing"));
+    CPPUNIT_ASSERT(!manifest.containsFile(PluginFile(_dir1, u"missing")));
+
+    // Invalid lines are ignored.
+    CPPUNIT_ASSERT(!manifest.isKnown(u"invalid"));
+    CPPUNIT_ASSERT(!manifest.isKnown(u"truncated"));
+    CPPUNIT_ASSERT(!manifest.isKnown(u"unknown"));
+    for (int cap = 0; cap < ts::PluginManifest::CAP_COUNT; ++cap) {
+        const ts::PluginManifest::EntryMap& entries(manifest.entries(ts::PluginManifest::Capability(cap)));
+        CPPUNIT_ASSERT_EQUAL(size_t(0), entries.count(u"invalid"));
+        CPPUNIT_ASSERT_EQUAL(size_t(0), entries.count(u"truncated"));
+    }
+}
+
+void PluginManifestTest::testSearchOrder()
+{
+    ts::PluginManifest manifest;
+    load(manifest);
+
+    // When a plugin is in several manifests, the first directory in the search path wins.
+    const ts::PluginManifest::Entry* e = manifest.find(ts::PluginManifest::INPUT, u"foo");
+    CPPUNIT_ASSERT(e != 0);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(PluginFile(_dir1, u"foo"), e->file);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Foo input", e->description);
+    CPPUNIT_ASSERT(!manifest.containsFile(PluginFile(_dir2, u"foo")));
+
+    // Plugins which are only in the second directory are found there.
+    e = manifest.find(ts::PluginManifest::OUTPUT, u"qux");
+    CPPUNIT_ASSERT(e != 0);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(PluginFile(_dir2, u"qux"), e->file);
+    CPPUNIT_ASSERT(manifest.containsFile(PluginFile(_dir2, u"qux")));
+}
+
+void PluginManifestTest::testOutdated()
+{
+    ts::PluginManifest manifest;
+    load(manifest);
+    CPPUNIT_ASSERT(manifest.isKnown(u"foo"));
+    CPPUNIT_ASSERT(manifest.containsFile(PluginFile(_dir1, u"foo")));
+
+    // Rewrite a plugin after its manifest. File times have a one-second resolution on some systems.
+    ts::SleepThread(1100);
+    CreatePlugin(_dir1, u"foo");
+
+    // All capabilities of the plugin are now ignored, other plugins are unchanged.
+    CPPUNIT_ASSERT(manifest.find(ts::PluginManifest::INPUT, u"foo") == 0);
+    CPPUNIT_ASSERT(manifest.find(ts::PluginManifest::PROCESSOR, u"foo") == 0);
+    CPPUNIT_ASSERT(!manifest.isKnown(u"foo"));
+    CPPUNIT_ASSERT(!manifest.containsFile(PluginFile(_dir1, u"foo")));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), manifest.entries(ts::PluginManifest::INPUT).count(u"foo"));
+    CPPUNIT_ASSERT(manifest.isKnown(u"bar"));
+    CPPUNIT_ASSERT(manifest.containsFile(PluginFile(_dir1, u"bar")));
+
+    // A deleted plugin is ignored as well.
+    CPPUNIT_ASSERT(ts::DeleteFile(PluginFile(_dir1, u"bar")) == ts::SYS_SUCCESS);
+    CPPUNIT_ASSERT(!manifest.isKnown(u"bar"));
+    CPPUNIT_ASSERT(!manifest.containsFile(PluginFile(_dir1, u"bar")));
+
+    // A new manifest makes the plugin up to date again.
+    ts::PluginManifest manifest2;
+    ts::UStringList lines;
+    CPPUNIT_ASSERT(ts::UString::Load(lines, _dir1 + ts::PathSeparator + ts::PluginManifest::FILE_NAME));
+    CPPUNIT_ASSERT(ts::UString::Save(lines, _dir1 + ts::PathSeparator + ts::PluginManifest::FILE_NAME));
+    load(manifest2);
+    CPPUNIT_ASSERT(manifest2.isKnown(u"foo"));
+    CPPUNIT_ASSERT(manifest2.containsFile(PluginFile(_dir1, u"foo")));
+}
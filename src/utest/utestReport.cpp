@@ -32,6 +32,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsReportBuffer.h"
+#include "tsAsyncReport.h"
+#include "tsMonotonic.h"
 #include "tsReportFile.h"
 #include "tsSysUtils.h"
 #include "utestCppUnitTest.h"
@@ -55,6 +57,7 @@ public:
     void testPrintf();
     void testByName();
     void testByStream();
+    void testAsyncRepeated();
 
     CPPUNIT_TEST_SUITE(ReportTest);
     CPPUNIT_TEST(testSeverity);
@@ -62,6 +65,7 @@ public:
     CPPUNIT_TEST(testPrintf);
     CPPUNIT_TEST(testByName);
     CPPUNIT_TEST(testByStream);
+    CPPUNIT_TEST(testAsyncRepeated);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -325,3 +329,62 @@ void ReportTest::testByStream()
     ts::UString::Load(value, _fileName);
     CPPUNIT_ASSERT(value == ref);
 }
+
+// Test case: coalescing of repeated messages in asynchronous report
+namespace {
+    class CollectHandler: public ts::ReportHandler
+    {
+    public:
+        ts::UStringVector messages;
+        CollectHandler() : messages() {}
+        virtual void handleMessage(int, const ts::UString& msg) override
+        {
+            messages.push_back(msg);
+        }
+    };
+}
+
+void ReportTest::testAsyncRepeated()
+{
+    const size_t count = 10000;
+    CollectHandler handler;
+    ts::Monotonic start;
+    ts::Monotonic end;
+    {
+        // Synchronous mode: no message is dropped.
+        ts::AsyncReport log(ts::Severity::Info, false, 16, true);
+        log.setMessageHandler(&handler);
+        start.getSystemTime();
+        log.info(u"first");
+        for (size_t i = 0; i < count; ++i) {
+            log.info(u"repeated");
+        }
+        log.info(u"last");
+        end.getSystemTime();
+        log.terminate();
+    }
+    const ts::MilliSecond duration = (end - start) / ts::NanoSecPerMilliSec;
+
+    // The repetitions are reported once per time window: once if logging all messages
+    // was faster than the window, more if the system was very slow. All occurences must
+    // be accounted for.
+    CPPUNIT_ASSERT(handler.messages.size() >= 4);
+    CPPUNIT_ASSERT(handler.messages.front() == u"first");
+    CPPUNIT_ASSERT(handler.messages.back() == u"last");
+    CPPUNIT_ASSERT(handler.messages[1] == u"repeated");
+
+    size_t total = 1;
+    for (size_t i = 2; i + 1 < handler.messages.size(); ++i) {
+        size_t n = 0;
+        CPPUNIT_ASSERT(handler.messages[i].scan(u"last message repeated %d times", {&n}));
+        total += n;
+    }
+    utest::Out() << "ReportTest: " << count << " repeated messages displayed as " << (handler.messages.size() - 2) << " lines in " << duration << " ms" << std::endl;
+    CPPUNIT_ASSERT_EQUAL(count, total);
+    if (duration < ts::AsyncReport::REPEAT_INTERVAL) {
+        CPPUNIT_ASSERT_EQUAL(size_t(4), handler.messages.size());
+    }
+    else {
+        CPPUNIT_ASSERT(handler.messages.size() <= size_t(4 + duration / ts::AsyncReport::REPEAT_INTERVAL));
+    }
+}
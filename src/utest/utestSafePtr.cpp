@@ -33,7 +33,9 @@
 
 #include "tsSafePtr.h"
 #include "tsMutex.h"
+#include "tsTime.h"
 #include "utestCppUnitTest.h"
+#include "utestCppUnitThread.h"
 TSDUCK_SOURCE;
 
 
@@ -51,12 +53,18 @@ public:
     void testDowncast();
     void testUpcast();
     void testChangeMutex();
+    void testMove();
+    void testAtomic();
+    void testContention();
 
     CPPUNIT_TEST_SUITE (SafePtrTest);
     CPPUNIT_TEST (testSafePtr);
     CPPUNIT_TEST (testDowncast);
     CPPUNIT_TEST (testUpcast);
     CPPUNIT_TEST (testChangeMutex);
+    CPPUNIT_TEST (testMove);
+    CPPUNIT_TEST (testAtomic);
+    CPPUNIT_TEST (testContention);
     CPPUNIT_TEST_SUITE_END ();
 };
 
@@ -387,3 +395,145 @@ void SafePtrTest::testChangeMutex()
     pt.clear();
     CPPUNIT_ASSERT(TestData::InstanceCount() == 0);
 }
+
+// Test case: move constructor and assignment
+void SafePtrTest::testMove()
+{
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 0);
+    TestDataPtr p1(new TestData(999));
+    TestDataPtr p2(p1);
+    CPPUNIT_ASSERT(p1.count() == 2);
+
+    TestDataPtr p3(std::move(p1));
+    CPPUNIT_ASSERT(p1.isNull());
+    CPPUNIT_ASSERT(p1.pointer() == 0);
+    CPPUNIT_ASSERT(!p3.isNull());
+    CPPUNIT_ASSERT(p3.count() == 2);
+    CPPUNIT_ASSERT(p3->value() == 999);
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 1);
+
+    TestDataPtr p4;
+    p4 = std::move(p3);
+    CPPUNIT_ASSERT(p3.isNull());
+    CPPUNIT_ASSERT(p4.count() == 2);
+    CPPUNIT_ASSERT(p4 == p2);
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 1);
+
+    // Moved-from safe pointers can be reused.
+    p1 = p4;
+    CPPUNIT_ASSERT(p1.count() == 3);
+    p3.reset(new TestData(111));
+    CPPUNIT_ASSERT(p3->value() == 111);
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 2);
+
+    // Move assignment releases the previous object.
+    p3 = std::move(p4);
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 1);
+    CPPUNIT_ASSERT(p3.count() == 3);
+
+    p1.clear();
+    p2.clear();
+    p3.clear();
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 0);
+}
+
+// Test case: atomic reference counter
+void SafePtrTest::testAtomic()
+{
+    typedef ts::SafePtr<TestData, ts::AtomicRefCount> AtomicTestDataPtr;
+
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 0);
+    AtomicTestDataPtr p1(new SubTestData1(123));
+    {
+        AtomicTestDataPtr p2(p1);
+        AtomicTestDataPtr p3;
+        p3 = p2;
+        CPPUNIT_ASSERT(p1.count() == 3);
+        CPPUNIT_ASSERT(p3->value() == 123);
+    }
+    CPPUNIT_ASSERT(p1.count() == 1);
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 1);
+
+    // Failed downcast.
+    ts::SafePtr<SubTestData2, ts::AtomicRefCount> p2(p1.downcast<SubTestData2>());
+    CPPUNIT_ASSERT(p2.isNull());
+    CPPUNIT_ASSERT(!p1.isNull());
+
+    // Successful downcast.
+    ts::SafePtr<SubTestData1, ts::AtomicRefCount> p3(p1.downcast<SubTestData1>());
+    CPPUNIT_ASSERT(!p3.isNull());
+    CPPUNIT_ASSERT(p1.isNull());
+    CPPUNIT_ASSERT(p3->value() == 123);
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 1);
+
+    // Change to and from mutex-based safe pointers.
+    ts::SafePtr<SubTestData1, ts::Mutex> p4(p3.changeMutex<ts::Mutex>());
+    CPPUNIT_ASSERT(p3.isNull());
+    ts::SafePtr<SubTestData1, ts::AtomicRefCount> p5(p4.changeMutex<ts::AtomicRefCount>());
+    CPPUNIT_ASSERT(p4.isNull());
+    CPPUNIT_ASSERT(p5->value() == 123);
+
+    p5.reset(new SubTestData1(456));
+    CPPUNIT_ASSERT(p5->value() == 456);
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 1);
+    p5.clear();
+    CPPUNIT_ASSERT(TestData::InstanceCount() == 0);
+}
+
+// Thread for testContention(): copy and destroy a shared safe pointer.
+namespace {
+    template <class MUTEX>
+    class SafePtrTestThread: public utest::CppUnitThread
+    {
+    private:
+        const ts::SafePtr<int, MUTEX>& _ptr;
+        size_t _count;
+    public:
+        SafePtrTestThread(const ts::SafePtr<int, MUTEX>& ptr, size_t count) :
+            utest::CppUnitThread(),
+            _ptr(ptr),
+            _count(count)
+        {
+        }
+
+        virtual void test() override
+        {
+            for (size_t i = 0; i < _count; ++i) {
+                ts::SafePtr<int, MUTEX> p1(_ptr);
+                ts::SafePtr<int, MUTEX> p2(p1);
+                CPPUNIT_ASSERT(*p2 == 7);
+            }
+        }
+    };
+
+    // Run the contention test with one type of synchronization, return duration in ms.
+    template <class MUTEX>
+    ts::MilliSecond ContentionTest(size_t threads, size_t count)
+    {
+        ts::SafePtr<int, MUTEX> ptr(new int(7));
+        std::vector<SafePtrTestThread<MUTEX>*> workers;
+        const ts::Time start(ts::Time::CurrentUTC());
+        for (size_t i = 0; i < threads; ++i) {
+            workers.push_back(new SafePtrTestThread<MUTEX>(ptr, count));
+            CPPUNIT_ASSERT(workers.back()->start());
+        }
+        for (size_t i = 0; i < workers.size(); ++i) {
+            CPPUNIT_ASSERT(workers[i]->waitForTermination());
+            delete workers[i];
+        }
+        const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+        CPPUNIT_ASSERT(ptr.count() == 1);
+        return duration;
+    }
+}
+
+// Test case: several threads concurrently copying the same safe pointers
+void SafePtrTest::testContention()
+{
+    const size_t threads = 4;
+    const size_t count = 200000;
+    const ts::MilliSecond mutex_ms = ContentionTest<ts::Mutex>(threads, count);
+    const ts::MilliSecond atomic_ms = ContentionTest<ts::AtomicRefCount>(threads, count);
+    utest::Out() << "SafePtrTest: " << threads << " threads, " << (threads * count * 2) << " copies, mutex: "
+                 << mutex_ms << " ms, atomic: " << atomic_ms << " ms" << std::endl;
+}
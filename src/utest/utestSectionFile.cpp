@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsSectionFile.h"
+#include "tsMappedSectionFile.h"
 #include "tsTables.h"
 #include "tsSysUtils.h"
 #include "tsBinaryTable.h"
@@ -67,6 +68,7 @@ public:
     void testSCTE35();
     void testAllTables();
     void testBuildSections();
+    void testMappedFile();
 
     CPPUNIT_TEST_SUITE(SectionFileTest);
     CPPUNIT_TEST(testConfigurationFile);
@@ -77,6 +79,7 @@ public:
     CPPUNIT_TEST(testSCTE35);
     CPPUNIT_TEST(testAllTables);
     CPPUNIT_TEST(testBuildSections);
+    CPPUNIT_TEST(testMappedFile);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -459,3 +462,78 @@ void SectionFileTest::testBuildSections()
     ts::TDT xmlTDT(*xmlFile.tables()[2]);
     CPPUNIT_ASSERT(tdtTime == xmlTDT.utc_time);
 }
+
+void SectionFileTest::testMappedFile()
+{
+    // Build a PAT with 2 sections, an orphan section and a TDT.
+    ts::PAT pat(3, true, 0x5678);
+    for (uint16_t srv = 3; srv < ts::MAX_PSI_LONG_SECTION_PAYLOAD_SIZE / 4 + 16; ++srv) {
+        pat.pmts[srv] = ts::PID(srv + 2);
+    }
+    ts::BinaryTablePtr patBin(new(ts::BinaryTable));
+    pat.serialize(*patBin);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), patBin->sectionCount());
+
+    ts::BinaryTablePtr tdtBin(new(ts::BinaryTable));
+    ts::TDT(ts::Time(ts::Time::Fields(2018, 6, 1, 12, 0, 0))).serialize(*tdtBin);
+
+    ts::SectionFile file;
+    file.add(patBin);
+    file.add(patBin->sectionAt(1));
+    file.add(tdtBin);
+    CPPUNIT_ASSERT(file.saveBinary(_tempFileNameBin, report()));
+
+    // Map the file and check the raw views.
+    ts::MappedSectionFile mapped;
+    CPPUNIT_ASSERT(mapped.open(_tempFileNameBin, report()));
+    CPPUNIT_ASSERT(mapped.isOpen());
+    CPPUNIT_ASSERT(mapped.checkComplete(report()));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), mapped.sectionCount());
+
+    size_t offset = 0;
+    for (size_t i = 0; i < mapped.sectionCount(); ++i) {
+        const ts::Section& ref(*file.sections()[i]);
+        CPPUNIT_ASSERT_EQUAL(offset, mapped.sectionOffset(i));
+        CPPUNIT_ASSERT_EQUAL(ref.size(), mapped.sectionSize(i));
+        CPPUNIT_ASSERT(::memcmp(ref.content(), mapped.sectionData(i), ref.size()) == 0);
+        const ts::SectionPtr sec(mapped.section(i, ts::CRC32::CHECK));
+        CPPUNIT_ASSERT(!sec.isNull());
+        CPPUNIT_ASSERT(*sec == ref);
+        offset += ref.size();
+    }
+
+    // Rebuild the tables: the PAT, the orphan section is skipped, then the TDT.
+    size_t index = 0;
+    ts::BinaryTable table;
+    CPPUNIT_ASSERT(mapped.getTable(index, table, ts::CRC32::CHECK));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), index);
+    CPPUNIT_ASSERT(table == *patBin);
+    CPPUNIT_ASSERT(!mapped.getTable(index, table));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), index);
+    CPPUNIT_ASSERT(mapped.getTable(index, table));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), index);
+    CPPUNIT_ASSERT(table == *tdtBin);
+    CPPUNIT_ASSERT(!mapped.getTable(index, table));
+    mapped.close();
+    CPPUNIT_ASSERT(!mapped.isOpen());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), mapped.sectionCount());
+
+    // Tables of a loaded section file are built on demand.
+    ts::SectionFile binFile;
+    CPPUNIT_ASSERT(binFile.loadBinary(_tempFileNameBin, report(), ts::CRC32::CHECK));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), binFile.sections().size());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), binFile.tables().size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), binFile.orphanSections().size());
+    CPPUNIT_ASSERT(*binFile.tables()[0] == *patBin);
+    CPPUNIT_ASSERT(*binFile.tables()[1] == *tdtBin);
+
+    // Truncate the last section: the complete sections remain accessible.
+    ts::ByteBlock data;
+    CPPUNIT_ASSERT(data.loadFromFile(_tempFileNameBin));
+    data.resize(data.size() - 2);
+    CPPUNIT_ASSERT(data.saveToFile(_tempFileNameBin));
+    CPPUNIT_ASSERT(!mapped.open(_tempFileNameBin, report()));
+    CPPUNIT_ASSERT(mapped.isOpen());
+    CPPUNIT_ASSERT(!mapped.checkComplete(report()));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), mapped.sectionCount());
+}
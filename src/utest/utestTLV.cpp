@@ -0,0 +1,417 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for TLV messages and connections.
+//
+//----------------------------------------------------------------------------
+
+#include "tstlvConnection.h"
+#include "tstlvServer.h"
+#include "tstlvSerializer.h"
+#include "tstlvMessageFactory.h"
+#include "tsECMGSCS.h"
+#include "tsEMMGMUX.h"
+#include "tsTCPServer.h"
+#include "tsIPUtils.h"
+#include "tsSysUtils.h"
+#include "tsTime.h"
+#include "utestCppUnitTest.h"
+#include "utestCppUnitThread.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TLVTest: public CppUnit::TestFixture
+{
+public:
+    TLVTest();
+
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testSerializer();
+    void testECMGSCSConnection();
+    void testEMMGMUXConnection();
+    void testServer();
+    void testServerDestructor();
+
+    CPPUNIT_TEST_SUITE(TLVTest);
+    CPPUNIT_TEST(testSerializer);
+    CPPUNIT_TEST(testECMGSCSConnection);
+    CPPUNIT_TEST(testEMMGMUXConnection);
+    CPPUNIT_TEST(testServer);
+    CPPUNIT_TEST(testServerDestructor);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    int _previousSeverity;
+
+    // Send and receive messages over a loopback TLV connection, display the throughput.
+    void loopback(const ts::UString& name, const ts::tlv::Protocol* protocol, const ts::tlv::MessagePtr& msg, uint16_t port, size_t count);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TLVTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+TLVTest::TLVTest() :
+    _previousSeverity(0)
+{
+}
+
+// Test suite initialization method.
+void TLVTest::setUp()
+{
+    _previousSeverity = CERR.maxSeverity();
+    if (utest::DebugMode()) {
+        CERR.setMaxSeverity(ts::Severity::Debug);
+    }
+}
+
+// Test suite cleanup method.
+void TLVTest::tearDown()
+{
+    CERR.setMaxSeverity(_previousSeverity);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Build a typical CW_provision message.
+    ts::tlv::MessagePtr NewCWProvision()
+    {
+        static const uint8_t cw[ts::CW_BYTES] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+        ts::ecmgscs::CWProvision* msg = new ts::ecmgscs::CWProvision;
+        msg->channel_id = 0x0102;
+        msg->stream_id = 0x0304;
+        msg->CP_number = 0x0506;
+        msg->CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(0x0506, cw));
+        msg->CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(0x0507, cw));
+        msg->has_access_criteria = true;
+        msg->access_criteria = ts::ByteBlock(16, 0xA5);
+        return ts::tlv::MessagePtr(msg);
+    }
+
+    // Build a typical data_provision message with one EMM in one TS packet.
+    ts::tlv::MessagePtr NewDataProvision()
+    {
+        ts::emmgmux::DataProvision* msg = new ts::emmgmux::DataProvision;
+        msg->channel_id = 0x0102;
+        msg->stream_id = 0x0304;
+        msg->client_id = 0x05060708;
+        msg->data_id = 0x090A;
+        msg->datagram.push_back(ts::ByteBlockPtr(new ts::ByteBlock(188, 0x5A)));
+        return ts::tlv::MessagePtr(msg);
+    }
+}
+
+// Test case: serialization in a reused buffer.
+void TLVTest::testSerializer()
+{
+    const ts::tlv::MessagePtr msg(NewCWProvision());
+    ts::ByteBlockPtr bb(new ts::ByteBlock);
+
+    {
+        ts::tlv::Serializer zer(bb);
+        msg->serialize(zer);
+    }
+    const ts::ByteBlock ref(*bb);
+    const uint8_t* const data = bb->data();
+    CPPUNIT_ASSERT(ref.size() > 0);
+
+    // Serialize again in the same block, no reallocation expected.
+    bb->clear();
+    {
+        ts::tlv::Serializer zer(bb);
+        msg->serialize(zer);
+    }
+    CPPUNIT_ASSERT(bb->data() == data);
+    CPPUNIT_ASSERT(*bb == ref);
+
+    // Analyze the serialized message.
+    ts::tlv::MessageFactory mf(*bb, ts::ecmgscs::Protocol::Instance());
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::OK, mf.errorStatus());
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::TAG(ts::ecmgscs::Tags::CW_provision), mf.commandTag());
+    ts::tlv::MessagePtr msg2;
+    mf.factory(msg2);
+    CPPUNIT_ASSERT(!msg2.isNull());
+    ts::ecmgscs::CWProvision* cwp = dynamic_cast<ts::ecmgscs::CWProvision*>(msg2.pointer());
+    CPPUNIT_ASSERT(cwp != 0);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0102), cwp->channel_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0304), cwp->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0506), cwp->CP_number);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), cwp->CP_CW_combination.size());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0507), cwp->CP_CW_combination[1].CP);
+    CPPUNIT_ASSERT_EQUAL(size_t(ts::CW_BYTES), cwp->CP_CW_combination[1].CW.size());
+    CPPUNIT_ASSERT(cwp->has_access_criteria);
+    CPPUNIT_ASSERT(cwp->access_criteria == ts::ByteBlock(16, 0xA5));
+}
+
+// A thread class which sends the same TLV message many times.
+namespace {
+    class TLVClient: public utest::CppUnitThread
+    {
+    private:
+        const ts::tlv::Protocol* _protocol;
+        ts::tlv::MessagePtr _msg;
+        uint16_t _port;
+        size_t _count;
+    public:
+        TLVClient(const ts::tlv::Protocol* protocol, const ts::tlv::MessagePtr& msg, uint16_t port, size_t count) :
+            utest::CppUnitThread(),
+            _protocol(protocol),
+            _msg(msg),
+            _port(port),
+            _count(count)
+        {
+        }
+
+        virtual ~TLVClient()
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            ts::tlv::Connection<ts::NullMutex> session(_protocol);
+            CPPUNIT_ASSERT(session.open(CERR));
+            CPPUNIT_ASSERT(session.bind(ts::SocketAddress(ts::IPAddress::LocalHost, ts::SocketAddress::AnyPort), CERR));
+            CPPUNIT_ASSERT(session.connect(ts::SocketAddress(ts::IPAddress::LocalHost, _port), CERR));
+            for (size_t i = 0; i < _count; ++i) {
+                CPPUNIT_ASSERT(session.send(*_msg, CERR));
+            }
+            session.disconnect(CERR);
+            session.close(CERR);
+        }
+    };
+}
+
+void TLVTest::loopback(const ts::UString& name, const ts::tlv::Protocol* protocol, const ts::tlv::MessagePtr& msg, uint16_t port, size_t count)
+{
+    CPPUNIT_ASSERT(ts::IPInitialize());
+
+    ts::TCPServer server;
+    CPPUNIT_ASSERT(server.open(CERR));
+    CPPUNIT_ASSERT(server.reusePort(true, CERR));
+    CPPUNIT_ASSERT(server.bind(ts::SocketAddress(ts::IPAddress::LocalHost, port), CERR));
+    CPPUNIT_ASSERT(server.listen(5, CERR));
+
+    const ts::Time start(ts::Time::CurrentUTC());
+    TLVClient client(protocol, msg, port, count);
+    CPPUNIT_ASSERT(client.start());
+
+    ts::tlv::Connection<ts::NullMutex> session(protocol);
+    ts::SocketAddress client_address;
+    CPPUNIT_ASSERT(server.accept(session, client_address, CERR));
+
+    // Receive all messages, until the client disconnects.
+    size_t received = 0;
+    ts::tlv::MessagePtr rec;
+    while (session.receive(rec, 0, CERR)) {
+        CPPUNIT_ASSERT(!rec.isNull());
+        CPPUNIT_ASSERT_EQUAL(msg->tag(), rec->tag());
+        received++;
+    }
+    const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+
+    session.disconnect(CERR);
+    session.close(CERR);
+    CPPUNIT_ASSERT(server.close(CERR));
+    CPPUNIT_ASSERT_EQUAL(count, received);
+
+    utest::Out() << "TLVTest: " << name << ": " << received << " messages in " << duration << " ms, "
+                 << (duration <= 0 ? ts::UString(u"-") : ts::UString::Decimal((received * ts::MilliSecPerSec) / duration))
+                 << " messages/s" << std::endl;
+}
+
+// Test case: ECMG <=> SCS messages over a TCP connection.
+void TLVTest::testECMGSCSConnection()
+{
+    loopback(u"ECMG<=>SCS CW_provision", ts::ecmgscs::Protocol::Instance(), NewCWProvision(), 12346, 50000);
+}
+
+// Test case: EMMG <=> MUX messages over a TCP connection.
+void TLVTest::testEMMGMUXConnection()
+{
+    loopback(u"EMMG<=>MUX data_provision", ts::emmgmux::Protocol::Instance(), NewDataProvision(), 12347, 50000);
+}
+
+// Multi-client server: each channel_test is answered with a channel_status.
+namespace {
+    class TestServerHandler: public ts::tlv::ServerHandlerInterface
+    {
+    public:
+        size_t connected;
+        size_t disconnected;
+        size_t messages;
+
+        TestServerHandler() : connected(0), disconnected(0), messages(0) {}
+
+        virtual bool handleTLVConnect(ts::tlv::Server&, const ts::tlv::ServerConnectionPtr&, ts::Report&) override
+        {
+            connected++;
+            return true;
+        }
+
+        virtual bool handleTLVMessage(ts::tlv::Server&, const ts::tlv::ServerConnectionPtr& client, const ts::tlv::MessagePtr& msg, ts::Report& report) override
+        {
+            messages++;
+            const ts::ecmgscs::ChannelTest* test = dynamic_cast<const ts::ecmgscs::ChannelTest*>(msg.pointer());
+            CPPUNIT_ASSERT(test != 0);
+            ts::ecmgscs::ChannelStatus resp;
+            resp.channel_id = test->channel_id;
+            return client->send(resp, report);
+        }
+
+        virtual void handleTLVDisconnect(ts::tlv::Server&, const ts::tlv::ServerConnectionPtr&, ts::Report&) override
+        {
+            disconnected++;
+        }
+    };
+
+    class TestServerThread: public utest::CppUnitThread
+    {
+    private:
+        ts::tlv::Server& _server;
+    public:
+        explicit TestServerThread(ts::tlv::Server& server) : utest::CppUnitThread(), _server(server) {}
+        virtual ~TestServerThread() { waitForTermination(); }
+        virtual void test() override { CPPUNIT_ASSERT(_server.run(0, CERR)); }
+    };
+}
+
+void TLVTest::testServer()
+{
+    CPPUNIT_ASSERT(ts::IPInitialize());
+
+    const size_t client_count = 20;
+    const size_t msg_count = 50;
+    const ts::SocketAddress address(ts::IPAddress::LocalHost, 12348);
+
+    TestServerHandler handler;
+    ts::tlv::Server server(ts::ecmgscs::Protocol::Instance(), &handler);
+    CPPUNIT_ASSERT(server.open(address, CERR));
+    CPPUNIT_ASSERT(server.isOpen());
+
+    // Serve clients in a separate thread.
+    {
+        TestServerThread thread(server);
+        CPPUNIT_ASSERT(thread.start());
+
+        // Connect all clients at the same time.
+        std::vector<ts::SafePtr<ts::tlv::Connection<ts::NullMutex>>> clients(client_count);
+        for (size_t i = 0; i < client_count; ++i) {
+            clients[i] = new ts::tlv::Connection<ts::NullMutex>(ts::ecmgscs::Protocol::Instance());
+            CPPUNIT_ASSERT(clients[i]->open(CERR));
+            CPPUNIT_ASSERT(clients[i]->connect(address, CERR));
+        }
+
+        // Interleave the requests of all clients.
+        for (size_t n = 0; n < msg_count; ++n) {
+            for (size_t i = 0; i < client_count; ++i) {
+                ts::ecmgscs::ChannelTest test;
+                test.channel_id = uint16_t(i);
+                CPPUNIT_ASSERT(clients[i]->send(test, CERR));
+            }
+            for (size_t i = 0; i < client_count; ++i) {
+                ts::tlv::MessagePtr msg;
+                CPPUNIT_ASSERT(clients[i]->receive(msg, 0, CERR));
+                const ts::ecmgscs::ChannelStatus* status = dynamic_cast<const ts::ecmgscs::ChannelStatus*>(msg.pointer());
+                CPPUNIT_ASSERT(status != 0);
+                CPPUNIT_ASSERT_EQUAL(uint16_t(i), status->channel_id);
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(client_count, server.clientCount());
+
+        for (size_t i = 0; i < client_count; ++i) {
+            clients[i]->disconnect(CERR);
+            clients[i]->close(CERR);
+        }
+
+        // Wait for the server to see the disconnections.
+        for (int i = 0; i < 100 && server.clientCount() > 0; ++i) {
+            ts::SleepThread(10);
+        }
+        server.stop();
+    }
+
+    CPPUNIT_ASSERT(server.close(CERR));
+    CPPUNIT_ASSERT_EQUAL(client_count, handler.connected);
+    CPPUNIT_ASSERT_EQUAL(client_count, handler.disconnected);
+    CPPUNIT_ASSERT_EQUAL(client_count * msg_count, handler.messages);
+}
+
+// Destroying the server disconnects the clients without notifying the handler.
+void TLVTest::testServerDestructor()
+{
+    CPPUNIT_ASSERT(ts::IPInitialize());
+
+    const size_t client_count = 3;
+    const ts::SocketAddress address(ts::IPAddress::LocalHost, 12349);
+
+    TestServerHandler handler;
+    std::vector<ts::SafePtr<ts::tlv::Connection<ts::NullMutex>>> clients(client_count);
+    {
+        ts::tlv::Server server(ts::ecmgscs::Protocol::Instance(), &handler);
+        CPPUNIT_ASSERT(server.open(address, CERR));
+        {
+            TestServerThread thread(server);
+            CPPUNIT_ASSERT(thread.start());
+            for (size_t i = 0; i < client_count; ++i) {
+                clients[i] = new ts::tlv::Connection<ts::NullMutex>(ts::ecmgscs::Protocol::Instance());
+                CPPUNIT_ASSERT(clients[i]->open(CERR));
+                CPPUNIT_ASSERT(clients[i]->connect(address, CERR));
+            }
+            for (int i = 0; i < 100 && server.clientCount() < client_count; ++i) {
+                ts::SleepThread(10);
+            }
+            CPPUNIT_ASSERT_EQUAL(client_count, server.clientCount());
+            server.stop();
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(client_count, handler.connected);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), handler.disconnected);
+
+    // The clients see the disconnection.
+    for (size_t i = 0; i < client_count; ++i) {
+        ts::tlv::MessagePtr msg;
+        CPPUNIT_ASSERT(!clients[i]->receive(msg, 0, NULLREP));
+        clients[i]->close(NULLREP);
+    }
+}
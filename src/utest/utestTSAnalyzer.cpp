@@ -0,0 +1,305 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::TSAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzer.h"
+#include "tsOneShotPacketizer.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSAnalyzerTest: public CppUnit::TestFixture
+{
+public:
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testIncremental();
+    void testSnapshot();
+    void testEviction();
+
+    CPPUNIT_TEST_SUITE(TSAnalyzerTest);
+    CPPUNIT_TEST(testIncremental);
+    CPPUNIT_TEST(testSnapshot);
+    CPPUNIT_TEST(testEviction);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Feed an analyzer with packets on one PID.
+    static void FeedPackets(ts::TSAnalyzer& analyzer, ts::PID pid, size_t count, uint8_t scrambling = ts::SC_CLEAR);
+
+    // Feed an analyzer with a table.
+    static void FeedTable(ts::TSAnalyzer& analyzer, ts::PID pid, const ts::AbstractTable& table);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TSAnalyzerTest);
+
+namespace {
+    const uint16_t SERVICE_ID = 1;
+    const ts::PID PMT_PID = 0x0200;
+    const ts::PID VIDEO_PID = 0x0100;
+    const ts::PID OTHER_PID = 0x0300;
+
+    // Access to the statistics of the analyzer.
+    class TestAnalyzer: public ts::TSAnalyzer
+    {
+    public:
+        uint64_t packets() { recomputeStatistics(); return _ts_pkt_cnt; }
+        size_t pids() { recomputeStatistics(); return _pid_cnt; }
+        size_t scrambledPIDs() { recomputeStatistics(); return _scrambled_pid_cnt; }
+        size_t globalPIDs() { recomputeStatistics(); return _global_pid_cnt; }
+        uint64_t globalPackets() { recomputeStatistics(); return _global_pkt_cnt; }
+        size_t unreferencedPIDs() { recomputeStatistics(); return _unref_pid_cnt; }
+        uint64_t unreferencedPackets() { recomputeStatistics(); return _unref_pkt_cnt; }
+        uint16_t scrambledServices() { recomputeStatistics(); return _scrambled_services_cnt; }
+        size_t pidContexts() const { return _pids.size(); }
+        size_t serviceContexts() const { return _services.size(); }
+        bool hasPID(ts::PID pid) const { return _pids.find(pid) != _pids.end(); }
+
+        uint64_t pidPackets(ts::PID pid)
+        {
+            recomputeStatistics();
+            const PIDContextMap::const_iterator it(_pids.find(pid));
+            return it == _pids.end() ? 0 : it->second->ts_pkt_cnt;
+        }
+
+        uint64_t servicePackets(uint16_t id)
+        {
+            recomputeStatistics();
+            const ServiceContextMap::const_iterator it(_services.find(id));
+            return it == _services.end() ? 0 : it->second->ts_pkt_cnt;
+        }
+
+        size_t servicePIDs(uint16_t id)
+        {
+            recomputeStatistics();
+            const ServiceContextMap::const_iterator it(_services.find(id));
+            return it == _services.end() ? 0 : it->second->pid_cnt;
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSAnalyzerTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void TSAnalyzerTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build the test stream.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::FeedPackets(ts::TSAnalyzer& analyzer, ts::PID pid, size_t count, uint8_t scrambling)
+{
+    static uint8_t cc[ts::PID_MAX];
+    for (size_t i = 0; i < count; ++i) {
+        ts::TSPacket pkt(ts::NullPacket);
+        pkt.setPID(pid);
+        pkt.setCC(cc[pid]);
+        pkt.setScrambling(scrambling);
+        cc[pid] = (cc[pid] + 1) % ts::CC_MAX;
+        analyzer.feedPacket(pkt);
+    }
+}
+
+void TSAnalyzerTest::FeedTable(ts::TSAnalyzer& analyzer, ts::PID pid, const ts::AbstractTable& table)
+{
+    ts::OneShotPacketizer pzer(pid);
+    pzer.addTable(table);
+    ts::TSPacketVector packets;
+    pzer.getPackets(packets);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        analyzer.feedPacket(packets[i]);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::testIncremental()
+{
+    TestAnalyzer analyzer;
+
+    // Video PID before the signalization: unreferenced.
+    FeedPackets(analyzer, VIDEO_PID, 100);
+    FeedPackets(analyzer, ts::PID_NULL, 10);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(110), analyzer.packets());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), analyzer.pids());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), analyzer.unreferencedPIDs());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(100), analyzer.unreferencedPackets());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), analyzer.globalPIDs());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(10), analyzer.globalPackets());
+
+    // The PAT references the PMT PID, the PMT references the video PID.
+    ts::PAT pat(0, true, 1);
+    pat.pmts[SERVICE_ID] = PMT_PID;
+    FeedTable(analyzer, ts::PID_PAT, pat);
+    ts::PMT pmt(0, true, SERVICE_ID, VIDEO_PID);
+    pmt.streams[VIDEO_PID].stream_type = ts::ST_MPEG2_VIDEO;
+    FeedTable(analyzer, PMT_PID, pmt);
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(112), analyzer.packets());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), analyzer.pids());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), analyzer.unreferencedPIDs());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), analyzer.unreferencedPackets());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), analyzer.globalPIDs());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(11), analyzer.globalPackets());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), analyzer.servicePIDs(SERVICE_ID));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(101), analyzer.servicePackets(SERVICE_ID));
+
+    // The video PID becomes scrambled.
+    FeedPackets(analyzer, VIDEO_PID, 50, ts::SC_EVEN_KEY);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(162), analyzer.packets());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(151), analyzer.servicePackets(SERVICE_ID));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), analyzer.scrambledPIDs());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(1), analyzer.scrambledServices());
+
+    analyzer.reset();
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), analyzer.packets());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), analyzer.pids());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0), analyzer.scrambledServices());
+}
+
+void TSAnalyzerTest::testSnapshot()
+{
+    TestAnalyzer analyzer;
+    TestAnalyzer snapshot;
+
+    ts::PAT pat(0, true, 1);
+    pat.pmts[SERVICE_ID] = PMT_PID;
+    FeedTable(analyzer, ts::PID_PAT, pat);
+    ts::PMT pmt(0, true, SERVICE_ID, VIDEO_PID);
+    pmt.streams[VIDEO_PID].stream_type = ts::ST_MPEG2_VIDEO;
+    FeedTable(analyzer, PMT_PID, pmt);
+    FeedPackets(analyzer, VIDEO_PID, 100);
+
+    analyzer.getSnapshot(snapshot);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(102), snapshot.packets());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(101), snapshot.servicePackets(SERVICE_ID));
+
+    // Modifications in the analyzer do not affect the snapshot.
+    FeedPackets(analyzer, VIDEO_PID, 20, ts::SC_ODD_KEY);
+    FeedPackets(analyzer, 0x0300, 5);
+    FeedTable(analyzer, ts::PID_PAT, pat);
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(128), analyzer.packets());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(120), analyzer.pidPackets(VIDEO_PID));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(121), analyzer.servicePackets(SERVICE_ID));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(1), analyzer.scrambledServices());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), analyzer.unreferencedPIDs());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), analyzer.pids());
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(102), snapshot.packets());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(100), snapshot.pidPackets(VIDEO_PID));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), snapshot.pidPackets(ts::PID_PAT));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(101), snapshot.servicePackets(SERVICE_ID));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0), snapshot.scrambledServices());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), snapshot.unreferencedPIDs());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), snapshot.pids());
+
+    // Reset of the analyzer does not affect the snapshot either.
+    analyzer.reset();
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), analyzer.packets());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(100), snapshot.pidPackets(VIDEO_PID));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(101), snapshot.servicePackets(SERVICE_ID));
+}
+
+void TSAnalyzerTest::testEviction()
+{
+    TestAnalyzer analyzer;
+    analyzer.setIdleEviction(1000);
+
+    ts::PAT pat(0, true, 1);
+    pat.pmts[SERVICE_ID] = PMT_PID;
+    FeedTable(analyzer, ts::PID_PAT, pat);
+    ts::PMT pmt(0, true, SERVICE_ID, VIDEO_PID);
+    pmt.streams[VIDEO_PID].stream_type = ts::ST_MPEG2_VIDEO;
+    FeedTable(analyzer, PMT_PID, pmt);
+    FeedPackets(analyzer, VIDEO_PID, 100);
+    FeedPackets(analyzer, OTHER_PID, 10);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), analyzer.pids());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), analyzer.unreferencedPIDs());
+
+    // The unreferenced PID disappears. The PMT PID is idle but its service is active.
+    FeedPackets(analyzer, VIDEO_PID, 2000);
+    CPPUNIT_ASSERT(!analyzer.hasPID(OTHER_PID));
+    CPPUNIT_ASSERT(analyzer.hasPID(PMT_PID));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), analyzer.pids());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), analyzer.unreferencedPIDs());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), analyzer.unreferencedPackets());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2112), analyzer.packets());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2101), analyzer.servicePackets(SERVICE_ID));
+
+    // The service disappears. The PAT PID is never removed.
+    FeedPackets(analyzer, ts::PID_NULL, 2000);
+    CPPUNIT_ASSERT(!analyzer.hasPID(VIDEO_PID));
+    CPPUNIT_ASSERT(!analyzer.hasPID(PMT_PID));
+    CPPUNIT_ASSERT(analyzer.hasPID(ts::PID_PAT));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), analyzer.pids());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), analyzer.globalPIDs());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), analyzer.serviceContexts());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), analyzer.pidContexts());
+
+    // The service reappears with the same signalization, its PID's are referenced again.
+    FeedTable(analyzer, ts::PID_PAT, pat);
+    FeedTable(analyzer, PMT_PID, pmt);
+    FeedPackets(analyzer, VIDEO_PID, 10);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), analyzer.pids());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), analyzer.unreferencedPIDs());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), analyzer.servicePIDs(SERVICE_ID));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(11), analyzer.servicePackets(SERVICE_ID));
+
+    // Without bounded-memory mode, nothing is removed.
+    TestAnalyzer unbounded;
+    FeedPackets(unbounded, OTHER_PID, 10);
+    FeedPackets(unbounded, ts::PID_NULL, 5000);
+    CPPUNIT_ASSERT(unbounded.hasPID(OTHER_PID));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), unbounded.pids());
+}
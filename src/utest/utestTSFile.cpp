@@ -0,0 +1,244 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for classes ts::TSFileInput and ts::TSFileOutput
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSFileInput.h"
+#include "tsTSFileOutput.h"
+#include "tsTSSparseFormat.h"
+#include "tsByteBlock.h"
+#include "tsSysUtils.h"
+#include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSFileTest: public CppUnit::TestFixture
+{
+public:
+    TSFileTest();
+
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testSparse();
+    void testSparseRepeat();
+    void testSparseCorrupted();
+
+    CPPUNIT_TEST_SUITE(TSFileTest);
+    CPPUNIT_TEST(testSparse);
+    CPPUNIT_TEST(testSparseRepeat);
+    CPPUNIT_TEST(testSparseCorrupted);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    ts::UString _fileName;
+
+    // Build a stream with runs of distinct null packets and PCR's.
+    static void BuildStream(ts::TSPacketVector& packets);
+
+    // Write a stream in a sparse file, using several calls to write().
+    void writeSparse(const ts::TSPacketVector& packets, ts::MilliSecond timestamps);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TSFileTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+TSFileTest::TSFileTest() :
+    _fileName(ts::TempFile(u".tssp"))
+{
+}
+
+// Test suite initialization method.
+void TSFileTest::setUp()
+{
+    ts::DeleteFile(_fileName);
+}
+
+// Test suite cleanup method.
+void TSFileTest::tearDown()
+{
+    ts::DeleteFile(_fileName);
+}
+
+
+//----------------------------------------------------------------------------
+// Build a stream: 10 packets per ms, 3 of them are null packets.
+// The null packets are not all identical (some CC are different).
+//----------------------------------------------------------------------------
+
+void TSFileTest::BuildStream(ts::TSPacketVector& packets)
+{
+    packets.resize(10000);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        pkt = ts::NullPacket;
+        if (i % 10 < 7) {
+            pkt.setPID(0x0100);
+            pkt.setCC(uint8_t(i & 0x0F));
+            pkt.b[187] = uint8_t(i);
+            if (i % 10 == 0) {
+                pkt.b[3] = 0x30 | (pkt.b[3] & 0x0F);
+                pkt.b[4] = 7;
+                pkt.b[5] = 0x10;
+                pkt.setPCR(i * (ts::SYSTEM_CLOCK_FREQ / 10000));
+            }
+        }
+        else if (i > 5000 && i < 6000) {
+            pkt.setCC(uint8_t(i & 0x0F));
+        }
+    }
+    // A long run of null packets.
+    for (size_t i = 8000; i < 9000; ++i) {
+        packets[i] = ts::NullPacket;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Write a stream in a sparse file, using several calls to write().
+//----------------------------------------------------------------------------
+
+void TSFileTest::writeSparse(const ts::TSPacketVector& packets, ts::MilliSecond timestamps)
+{
+    ts::TSFileOutput out;
+    out.setSparse(true, timestamps);
+    CPPUNIT_ASSERT(out.isSparse());
+    CPPUNIT_ASSERT(!out.open(_fileName, true, false, NULLREP));
+    CPPUNIT_ASSERT(out.open(_fileName, false, false, CERR));
+    for (size_t i = 0; i < packets.size(); i += 777) {
+        CPPUNIT_ASSERT(out.write(&packets[i], std::min<size_t>(777, packets.size() - i), CERR));
+    }
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(packets.size()), out.getPacketCount());
+    CPPUNIT_ASSERT(out.close(CERR));
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TSFileTest::testSparse()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+    writeSparse(packets, 10);
+
+    ts::ByteBlock data;
+    CPPUNIT_ASSERT(data.loadFromFile(_fileName));
+    utest::Out() << "TSFileTest: sparse file size: " << data.size() << " bytes for " << (packets.size() * ts::PKT_SIZE) << " bytes of TS" << std::endl;
+    CPPUNIT_ASSERT(data.size() < 7000 * ts::PKT_SIZE);
+    CPPUNIT_ASSERT(::memcmp(data.data(), ts::SPARSE_TS_MAGIC, sizeof(ts::SPARSE_TS_MAGIC)) == 0);
+
+    ts::TSFileInput in;
+    CPPUNIT_ASSERT(in.open(_fileName, 1, 0, CERR));
+    ts::TSPacketVector buffer(1000);
+    size_t total = 0;
+    size_t count = 0;
+    while ((count = in.read(&buffer[0], buffer.size(), CERR)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT(buffer[i] == packets[total + i]);
+        }
+        total += count;
+    }
+    CPPUNIT_ASSERT_EQUAL(packets.size(), total);
+    CPPUNIT_ASSERT(in.close(CERR));
+
+    // Rewindable mode.
+    CPPUNIT_ASSERT(in.open(_fileName, 0, CERR));
+    CPPUNIT_ASSERT(in.seek(8500, CERR));
+    CPPUNIT_ASSERT_EQUAL(size_t(10), in.read(&buffer[0], 10, CERR));
+    CPPUNIT_ASSERT(buffer[0] == packets[8500]);
+    CPPUNIT_ASSERT(in.seek(33, CERR));
+    CPPUNIT_ASSERT_EQUAL(size_t(10), in.read(&buffer[0], 10, CERR));
+    CPPUNIT_ASSERT(buffer[9] == packets[42]);
+    CPPUNIT_ASSERT(in.close(CERR));
+
+    // Cannot use offsets in a sparse file.
+    CPPUNIT_ASSERT(!in.open(_fileName, 1, ts::PKT_SIZE, NULLREP));
+}
+
+void TSFileTest::testSparseRepeat()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+    writeSparse(packets, 0);
+
+    ts::TSFileInput in;
+    CPPUNIT_ASSERT(in.open(_fileName, 3, 0, CERR));
+    ts::TSPacketVector buffer(4096);
+    size_t total = 0;
+    size_t count = 0;
+    while ((count = in.read(&buffer[0], buffer.size(), CERR)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT(buffer[i] == packets[(total + i) % packets.size()]);
+        }
+        total += count;
+    }
+    CPPUNIT_ASSERT_EQUAL(3 * packets.size(), total);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(total), in.getPacketCount());
+    CPPUNIT_ASSERT(in.close(CERR));
+}
+
+void TSFileTest::testSparseCorrupted()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+    writeSparse(packets, 10);
+
+    // Remove the first packet after the header: time stamps become inconsistent.
+    ts::ByteBlock data;
+    CPPUNIT_ASSERT(data.loadFromFile(_fileName));
+    CPPUNIT_ASSERT_EQUAL(uint8_t(ts::SPARSE_TIMESTAMP), uint8_t(data[ts::SPARSE_TS_HEADER_SIZE]));
+    CPPUNIT_ASSERT_EQUAL(ts::SYNC_BYTE, data[ts::SPARSE_TS_HEADER_SIZE + ts::SPARSE_TIMESTAMP_SIZE]);
+    data.erase(ts::SPARSE_TS_HEADER_SIZE + ts::SPARSE_TIMESTAMP_SIZE, ts::PKT_SIZE);
+    CPPUNIT_ASSERT(data.saveToFile(_fileName));
+
+    ts::TSFileInput in;
+    CPPUNIT_ASSERT(in.open(_fileName, 1, 0, CERR));
+    ts::TSPacketVector buffer(1000);
+    size_t total = 0;
+    size_t count = 0;
+    while ((count = in.read(&buffer[0], buffer.size(), NULLREP)) > 0) {
+        total += count;
+    }
+    CPPUNIT_ASSERT(total < 100);
+    CPPUNIT_ASSERT(in.close(CERR));
+}
@@ -0,0 +1,290 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2018, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::TSFileIndex
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSFileIndex.h"
+#include "tsTSFileInput.h"
+#include "tsTSFileOutput.h"
+#include "tsOneShotPacketizer.h"
+#include "tsPAT.h"
+#include "tsTDT.h"
+#include "tsSysUtils.h"
+#include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSFileIndexTest: public CppUnit::TestFixture
+{
+public:
+    TSFileIndexTest();
+
+    virtual void setUp() override;
+    virtual void tearDown() override;
+
+    void testBuild();
+    void testSaveLoad();
+    void testSegment();
+
+    CPPUNIT_TEST_SUITE(TSFileIndexTest);
+    CPPUNIT_TEST(testBuild);
+    CPPUNIT_TEST(testSaveLoad);
+    CPPUNIT_TEST(testSegment);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    ts::UString _tsFileName;
+    ts::UString _indexFileName;
+
+    // Build a 20-second stream, 1000 packets per second.
+    static void BuildStream(ts::TSPacketVector& packets);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TSFileIndexTest);
+
+namespace {
+    const size_t PACKET_COUNT = 20000;
+    const ts::PID VIDEO_PID = 0x0100;
+    const uint64_t PCR_WRAP = ts::PTS_DTS_SCALE * ts::SYSTEM_CLOCK_SUBFACTOR;
+    const uint64_t FIRST_PCR = PCR_WRAP - 5 * uint64_t(ts::SYSTEM_CLOCK_FREQ);  // PCR wraps up after 5 seconds.
+    const ts::Time FIRST_UTC(2018, 6, 1, 12, 0, 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+TSFileIndexTest::TSFileIndexTest() :
+    _tsFileName(ts::TempFile(u".ts")),
+    _indexFileName(ts::TSFileIndex::IndexFileName(_tsFileName))
+{
+}
+
+// Test suite initialization method.
+void TSFileIndexTest::setUp()
+{
+    ts::DeleteFile(_tsFileName);
+    ts::DeleteFile(_indexFileName);
+}
+
+// Test suite cleanup method.
+void TSFileIndexTest::tearDown()
+{
+    ts::DeleteFile(_tsFileName);
+    ts::DeleteFile(_indexFileName);
+}
+
+
+//----------------------------------------------------------------------------
+// Build a 20-second stream, 1000 packets per second (PCR += 1 ms per packet).
+// Video PID: PCR every 10 packets, random access point every second.
+// TDT at the middle of each second. PAT version changes after 10 seconds.
+//----------------------------------------------------------------------------
+
+void TSFileIndexTest::BuildStream(ts::TSPacketVector& packets)
+{
+    packets.resize(PACKET_COUNT);
+
+    for (size_t i = 0; i < PACKET_COUNT; ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        ts::TSPacketVector psi;
+        if (i % 1000 == 1 || i % 1000 == 505) {
+            ts::OneShotPacketizer pzer(i % 1000 == 1 ? ts::PID_PAT : ts::PID_TDT);
+            if (i % 1000 == 1) {
+                ts::PAT pat(i < 10000 ? 0 : 1, true, 1);
+                pat.pmts[1] = 0x0200;
+                pzer.addTable(pat);
+            }
+            else {
+                pzer.addTable(ts::TDT(FIRST_UTC + ts::MilliSecond(i)));
+            }
+            pzer.getPackets(psi);
+            CPPUNIT_ASSERT_EQUAL(size_t(1), psi.size());
+            pkt = psi[0];
+            pkt.setCC(uint8_t((i / 1000) & 0x0F));
+        }
+        else {
+            pkt = ts::NullPacket;
+            pkt.setPID(VIDEO_PID);
+            pkt.setCC(uint8_t(i & 0x0F));
+            if (i % 10 == 0) {
+                // Adaptation field with PCR, random access every second.
+                pkt.b[3] = 0x30 | (pkt.b[3] & 0x0F);
+                pkt.b[4] = 7;
+                pkt.b[5] = i % 1000 == 0 ? 0x50 : 0x10;
+                pkt.setPCR((FIRST_PCR + i * (ts::SYSTEM_CLOCK_FREQ / 1000)) % PCR_WRAP);
+            }
+            if (i % 1000 == 0) {
+                pkt.setPUSI();
+                pkt.b[12] = 0x00;
+                pkt.b[13] = 0x00;
+                pkt.b[14] = 0x01;
+                pkt.b[15] = 0xE0;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TSFileIndexTest::testBuild()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    ts::TSFileIndex index;
+    for (size_t i = 0; i < packets.size(); ++i) {
+        index.feedPacket(packets[i]);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(PACKET_COUNT), index.packetCount());
+    CPPUNIT_ASSERT_EQUAL(VIDEO_PID, index.pcrPID());
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(PACKET_COUNT - 10), index.duration());
+
+    size_t pcr_count = 0;
+    size_t utc_count = 0;
+    size_t rap_count = 0;
+    size_t psi_count = 0;
+    for (ts::TSFileIndex::EntryVector::const_iterator it = index.entries().begin(); it != index.entries().end(); ++it) {
+        switch (it->type) {
+            case ts::TSFileIndex::PCR_ENTRY: pcr_count++; break;
+            case ts::TSFileIndex::UTC_ENTRY: utc_count++; break;
+            case ts::TSFileIndex::RAP_ENTRY: rap_count++; break;
+            case ts::TSFileIndex::PSI_ENTRY: psi_count++; break;
+            default: CPPUNIT_FAIL("invalid entry type"); break;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(40), pcr_count);
+    CPPUNIT_ASSERT_EQUAL(size_t(20), utc_count);
+    CPPUNIT_ASSERT_EQUAL(size_t(20), rap_count);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), psi_count);
+
+    // Start position: last random access point before the time.
+    ts::PacketCounter packet = 0;
+    CPPUNIT_ASSERT(index.findElapsed(7600, packet, true));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(7000), packet);
+    CPPUNIT_ASSERT(index.findElapsed(0, packet, true));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(0), packet);
+
+    // Stop position: first indexed PCR after the time.
+    CPPUNIT_ASSERT(index.findElapsed(7600, packet, false));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(8000), packet);
+    CPPUNIT_ASSERT(!index.findElapsed(25000, packet, false));
+
+    // PCR values, after wrap up.
+    const uint64_t pcr = (FIRST_PCR + 12200 * uint64_t(ts::SYSTEM_CLOCK_FREQ / 1000)) % PCR_WRAP;
+    CPPUNIT_ASSERT(index.findPCR(pcr, packet, true));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(12000), packet);
+    CPPUNIT_ASSERT(index.findPCR(pcr, packet, false));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(12500), packet);
+
+    // UTC time from the TDT (the TDT has a one-second precision).
+    CPPUNIT_ASSERT(index.findUTC(FIRST_UTC + 3300, packet, true));
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(3000), packet);
+    CPPUNIT_ASSERT(!index.findUTC(FIRST_UTC - 1000, packet, true));
+}
+
+void TSFileIndexTest::testSaveLoad()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    ts::TSFileIndex index1;
+    for (size_t i = 0; i < packets.size(); ++i) {
+        index1.feedPacket(packets[i]);
+    }
+    CPPUNIT_ASSERT(index1.save(_indexFileName, CERR));
+
+    ts::TSFileIndex index2;
+    CPPUNIT_ASSERT(index2.load(_indexFileName, CERR));
+    CPPUNIT_ASSERT_EQUAL(index1.packetCount(), index2.packetCount());
+    CPPUNIT_ASSERT_EQUAL(index1.pcrPID(), index2.pcrPID());
+    CPPUNIT_ASSERT_EQUAL(index1.duration(), index2.duration());
+    CPPUNIT_ASSERT_EQUAL(index1.entries().size(), index2.entries().size());
+
+    for (size_t i = 0; i < index1.entries().size(); ++i) {
+        const ts::TSFileIndex::Entry& e1(index1.entries()[i]);
+        const ts::TSFileIndex::Entry& e2(index2.entries()[i]);
+        CPPUNIT_ASSERT_EQUAL(e1.type, e2.type);
+        CPPUNIT_ASSERT_EQUAL(e1.pid, e2.pid);
+        CPPUNIT_ASSERT_EQUAL(e1.packet, e2.packet);
+        CPPUNIT_ASSERT_EQUAL(e1.elapsed, e2.elapsed);
+        CPPUNIT_ASSERT_EQUAL(e1.value, e2.value);
+    }
+
+    // Not an index file.
+    ts::TSFileOutput out;
+    CPPUNIT_ASSERT(out.open(_tsFileName, false, false, CERR));
+    CPPUNIT_ASSERT(out.write(&packets[0], 10, CERR));
+    CPPUNIT_ASSERT(out.close(CERR));
+    ts::TSFileIndex index3;
+    CPPUNIT_ASSERT(!index3.load(_tsFileName, NULLREP));
+}
+
+void TSFileIndexTest::testSegment()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    ts::TSFileOutput out;
+    CPPUNIT_ASSERT(out.open(_tsFileName, false, false, CERR));
+    CPPUNIT_ASSERT(out.write(&packets[0], packets.size(), CERR));
+    CPPUNIT_ASSERT(out.close(CERR));
+
+    // Read packets 3000 to 4999, twice.
+    ts::TSFileInput in;
+    CPPUNIT_ASSERT(in.open(_tsFileName, 2, 3000 * ts::PKT_SIZE, 5000 * ts::PKT_SIZE, CERR));
+
+    ts::TSPacketVector buffer(1500);
+    size_t total = 0;
+    size_t count = 0;
+    while ((count = in.read(&buffer[0], buffer.size(), CERR)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            CPPUNIT_ASSERT(buffer[i] == packets[3000 + (total + i) % 2000]);
+        }
+        total += count;
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(4000), total);
+    CPPUNIT_ASSERT(in.close(CERR));
+
+    // Invalid segment.
+    CPPUNIT_ASSERT(!in.open(_tsFileName, 1, 5000 * ts::PKT_SIZE, 3000 * ts::PKT_SIZE, NULLREP));
+}
@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSPacket.h"
+#include "tsByteBlock.h"
 #include "tsMemoryUtils.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
@@ -48,9 +49,11 @@ public:
     virtual void tearDown() override;
 
     void testPacket();
+    void testFindSync();
 
     CPPUNIT_TEST_SUITE(TSPacketTest);
     CPPUNIT_TEST(testPacket);
+    CPPUNIT_TEST(testFindSync);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -88,3 +91,63 @@ void TSPacketTest::testPacket()
 
     CPPUNIT_ASSERT_EQUAL(size_t(7 * ts::PKT_SIZE), sizeof(packets));
 }
+
+void TSPacketTest::testFindSync()
+{
+    // Build a buffer of random garbage, without any sync byte.
+    ts::ByteBlock buf(10000);
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = uint8_t(i * 7 + 3);
+        if (buf[i] == ts::SYNC_BYTE) {
+            buf[i] = 0;
+        }
+    }
+
+    size_t offset = 0;
+    size_t pkt_size = 0;
+    size_t header_size = 0;
+    CPPUNIT_ASSERT(!ts::FindTSSync(buf.data(), buf.size(), 0, offset, pkt_size, header_size));
+
+    // Isolated sync bytes before packets, 204-byte packets at offset 1000, up to the end.
+    buf[100] = buf[300] = buf[300 + ts::PKT_SIZE] = ts::SYNC_BYTE;
+    for (size_t i = 1000; i < buf.size(); i += ts::PKT_RS_SIZE) {
+        buf[i] = ts::SYNC_BYTE;
+    }
+    pkt_size = header_size = 0;
+    CPPUNIT_ASSERT(ts::FindTSSync(buf.data(), buf.size(), 2000, offset, pkt_size, header_size));
+    CPPUNIT_ASSERT_EQUAL(size_t(1000), offset);
+    CPPUNIT_ASSERT_EQUAL(ts::PKT_RS_SIZE, pkt_size);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), header_size);
+
+    // Same with a truncated last packet, up to the end of buffer.
+    pkt_size = header_size = 0;
+    CPPUNIT_ASSERT(ts::FindTSSync(buf.data(), buf.size(), 0, offset, pkt_size, header_size));
+    CPPUNIT_ASSERT_EQUAL(size_t(1000), offset);
+    CPPUNIT_ASSERT_EQUAL(ts::PKT_RS_SIZE, pkt_size);
+
+    // Searching only 188-byte packets: the first pair of sync bytes at 300 is enough for 2 packets.
+    pkt_size = ts::PKT_SIZE;
+    header_size = 0;
+    CPPUNIT_ASSERT(ts::FindTSSync(buf.data(), buf.size(), 2 * ts::PKT_SIZE + 10, offset, pkt_size, header_size));
+    CPPUNIT_ASSERT_EQUAL(size_t(300), offset);
+
+    // Up to the end of buffer, only the last 204-byte packet, followed by less than 188 bytes, matches.
+    CPPUNIT_ASSERT(ts::FindTSSync(buf.data(), buf.size(), 0, offset, pkt_size, header_size));
+    CPPUNIT_ASSERT_EQUAL(size_t(1000 + 43 * ts::PKT_RS_SIZE), offset);
+    CPPUNIT_ASSERT_EQUAL(ts::PKT_SIZE, pkt_size);
+
+    // Minimum size larger than buffer.
+    pkt_size = header_size = 0;
+    CPPUNIT_ASSERT(!ts::FindTSSync(buf.data(), buf.size(), buf.size() + 1, offset, pkt_size, header_size));
+
+    // M2TS packets with 4-byte header, starting at offset 2 (sync byte at 6).
+    ts::ByteBlock m2ts(20 * ts::PKT_M2TS_SIZE, 0);
+    for (size_t i = 6; i < m2ts.size(); i += ts::PKT_M2TS_SIZE) {
+        m2ts[i] = ts::SYNC_BYTE;
+    }
+    pkt_size = header_size = 0;
+    CPPUNIT_ASSERT(ts::FindTSSync(m2ts.data(), m2ts.size(), 10 * ts::PKT_M2TS_SIZE, offset, pkt_size, header_size));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), offset);
+    CPPUNIT_ASSERT_EQUAL(ts::PKT_M2TS_SIZE, pkt_size);
+    CPPUNIT_ASSERT_EQUAL(ts::M2TS_HEADER_SIZE, header_size);
+}
@@ -54,6 +54,11 @@ public:
     void testNIT();
     void testSDT();
     void testTOT();
+    void testPMTView();
+    void testSDTView();
+    void testNITView();
+    void testBATView();
+    void testEITView();
 
     CPPUNIT_TEST_SUITE(TableTest);
     CPPUNIT_TEST(testAssignPMT);
@@ -64,6 +69,11 @@ public:
     CPPUNIT_TEST(testNIT);
     CPPUNIT_TEST(testSDT);
     CPPUNIT_TEST(testTOT);
+    CPPUNIT_TEST(testPMTView);
+    CPPUNIT_TEST(testSDTView);
+    CPPUNIT_TEST(testNITView);
+    CPPUNIT_TEST(testBATView);
+    CPPUNIT_TEST(testEITView);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -296,3 +306,205 @@ void TableTest::testTOT()
     CPPUNIT_ASSERT_EQUAL(size_t(1), tot2.descs.count());
     CPPUNIT_ASSERT_EQUAL(ts::DID(ts::DID_CA), tot2.descs[0]->tag());
 }
+
+void TableTest::testPMTView()
+{
+    ts::PMT pmt(1, true, 27, 1001);
+    pmt.descs.add(ts::CADescriptor(0x1234, 2002));
+    pmt.streams[3003].stream_type = 45;
+    pmt.streams[3003].descs.add(ts::AVCVideoDescriptor());
+    pmt.streams[4004].stream_type = 149;
+    pmt.streams[4004].descs.add(ts::PrivateDataSpecifierDescriptor(0x12345678));
+    pmt.streams[4004].descs.add(ts::AC3Descriptor());
+    pmt.streams[4004].descs.add(ts::CADescriptor());
+
+    ts::BinaryTable bin;
+    pmt.serialize(bin);
+    CPPUNIT_ASSERT(bin.isValid());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), bin.sectionCount());
+
+    uint16_t service_id = 0;
+    ts::PID pcr_pid = ts::PID_NULL;
+    ts::DescriptorListView descs;
+    ts::PMT::StreamViewVector streams;
+    CPPUNIT_ASSERT(ts::PMT::GetView(*bin.sectionAt(0), service_id, pcr_pid, descs, streams));
+
+    CPPUNIT_ASSERT_EQUAL(uint16_t(27), service_id);
+    CPPUNIT_ASSERT_EQUAL(ts::PID(1001), pcr_pid);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), descs.count());
+    CPPUNIT_ASSERT_EQUAL(ts::DID(ts::DID_CA), descs.begin()->tag());
+    CPPUNIT_ASSERT(descs.begin()->payload() >= bin.sectionAt(0)->payload());
+
+    CPPUNIT_ASSERT_EQUAL(size_t(2), streams.size());
+    CPPUNIT_ASSERT_EQUAL(ts::PID(3003), streams[0].pid);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(45), streams[0].stream_type);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), streams[0].descs.count());
+    CPPUNIT_ASSERT_EQUAL(ts::DID(ts::DID_AVC_VIDEO), streams[0].descs.begin()->tag());
+
+    CPPUNIT_ASSERT_EQUAL(ts::PID(4004), streams[1].pid);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(149), streams[1].stream_type);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), streams[1].descs.count());
+    ts::DescriptorListView::const_iterator it(streams[1].descs.search(ts::DID_AC3));
+    CPPUNIT_ASSERT(it != streams[1].descs.end());
+    CPPUNIT_ASSERT_EQUAL(ts::PDS(0x12345678), it->privateDataSpecifier());
+    CPPUNIT_ASSERT(streams[1].descs.search(ts::DID_CA, ++it) != streams[1].descs.end());
+    CPPUNIT_ASSERT(streams[1].descs.search(ts::DID_AVC_VIDEO) == streams[1].descs.end());
+
+    // Owning list, built on demand.
+    ts::DescriptorList dlist(0);
+    streams[1].descs.toDescriptorList(dlist);
+    CPPUNIT_ASSERT(dlist == pmt.streams[4004].descs);
+    CPPUNIT_ASSERT_EQUAL(ts::PDS(0x12345678), dlist.privateDataSpecifier(2));
+}
+
+void TableTest::testSDTView()
+{
+    ts::SDT sdt(true, 1, true, 0x1234, 0x5678);
+    sdt.services[101].setName(u"Service One", 0x19);
+    sdt.services[101].setProvider(u"Provider");
+    sdt.services[101].EITpf_present = true;
+    sdt.services[102].running_status = 4;
+
+    ts::BinaryTable bin;
+    sdt.serialize(bin);
+    CPPUNIT_ASSERT(bin.isValid());
+
+    uint16_t ts_id = 0;
+    uint16_t onetw_id = 0;
+    ts::SDT::ServiceViewVector services;
+    CPPUNIT_ASSERT(ts::SDT::GetView(*bin.sectionAt(0), ts_id, onetw_id, services));
+
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x1234), ts_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x5678), onetw_id);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), services.size());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(101), services[0].service_id);
+    CPPUNIT_ASSERT(services[0].EITpf_present);
+    CPPUNIT_ASSERT(!services[0].EITs_present);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x19), services[0].serviceType());
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Service One", services[0].serviceName());
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Provider", services[0].providerName());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(102), services[1].service_id);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(4), services[1].running_status);
+    CPPUNIT_ASSERT(services[1].descs.empty());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0), services[1].serviceType());
+    CPPUNIT_ASSERT(services[1].serviceName().empty());
+}
+
+void TableTest::testNITView()
+{
+    ts::NIT nit(false, 3, true, 0x4321);
+    nit.descs.add(ts::NetworkNameDescriptor(u"Network"));
+    nit.transports[ts::TransportStreamId(1, 2)].descs.add(ts::CADescriptor());
+    nit.transports[ts::TransportStreamId(3, 4)];
+
+    ts::BinaryTable bin;
+    nit.serialize(bin);
+    CPPUNIT_ASSERT(bin.isValid());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), bin.sectionCount());
+
+    uint16_t network_id = 0;
+    ts::DescriptorListView descs;
+    ts::NIT::TransportViewVector transports;
+    CPPUNIT_ASSERT(ts::NIT::GetView(*bin.sectionAt(0), network_id, descs, transports));
+
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x4321), network_id);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), descs.count());
+    CPPUNIT_ASSERT_EQUAL(ts::DID(ts::DID_NETWORK_NAME), descs.begin()->tag());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), transports.size());
+    CPPUNIT_ASSERT(transports[0].ts_id == ts::TransportStreamId(1, 2));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), transports[0].descs.count());
+    CPPUNIT_ASSERT_EQUAL(ts::DID(ts::DID_CA), transports[0].descs.begin()->tag());
+    CPPUNIT_ASSERT(transports[1].ts_id == ts::TransportStreamId(3, 4));
+    CPPUNIT_ASSERT(transports[1].descs.empty());
+
+    // Owning list, built on demand.
+    ts::DescriptorList dlist(0);
+    transports[0].descs.toDescriptorList(dlist);
+    CPPUNIT_ASSERT(dlist == nit.transports[ts::TransportStreamId(1, 2)].descs);
+
+    // A NIT is not a BAT.
+    CPPUNIT_ASSERT(!ts::BAT::GetView(*bin.sectionAt(0), network_id, descs, transports));
+    CPPUNIT_ASSERT(transports.empty());
+}
+
+void TableTest::testBATView()
+{
+    ts::BAT bat(1, true, 0x0102);
+    bat.transports[ts::TransportStreamId(10, 20)].descs.add(ts::PrivateDataSpecifierDescriptor(0x12345678));
+    bat.transports[ts::TransportStreamId(10, 20)].descs.add(ts::CADescriptor());
+
+    ts::BinaryTable bin;
+    bat.serialize(bin);
+    CPPUNIT_ASSERT(bin.isValid());
+
+    uint16_t bouquet_id = 0;
+    ts::DescriptorListView descs;
+    ts::BAT::TransportViewVector transports;
+    CPPUNIT_ASSERT(ts::BAT::GetView(*bin.sectionAt(0), bouquet_id, descs, transports));
+
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0102), bouquet_id);
+    CPPUNIT_ASSERT(descs.empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), transports.size());
+    CPPUNIT_ASSERT(transports[0].ts_id == ts::TransportStreamId(10, 20));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), transports[0].descs.count());
+    ts::DescriptorListView::const_iterator it(transports[0].descs.search(ts::DID_CA));
+    CPPUNIT_ASSERT(it != transports[0].descs.end());
+    CPPUNIT_ASSERT_EQUAL(ts::PDS(0x12345678), it->privateDataSpecifier());
+
+    // A BAT is not a NIT.
+    CPPUNIT_ASSERT(!ts::NIT::GetView(*bin.sectionAt(0), bouquet_id, descs, transports));
+}
+
+void TableTest::testEITView()
+{
+    ts::EIT eit(true, false, 1, 2, true, 0x0A0B, 0x0C0D, 0x0E0F);
+    eit.segment_last = 8;
+    eit.last_table_id = ts::TID_EIT_S_ACT_MIN + 3;
+    eit.events[100].start_time = ts::Time(2018, 6, 15, 20, 30, 0);
+    eit.events[100].duration = 5400;
+    eit.events[100].running_status = 4;
+    eit.events[100].descs.add(ts::ShortEventDescriptor(u"eng", u"Event", u"Text"));
+    eit.events[101].start_time = ts::Time(2018, 6, 15, 22, 0, 0);
+    eit.events[101].duration = 59;
+    eit.events[101].CA_controlled = true;
+
+    ts::BinaryTable bin;
+    eit.serialize(bin);
+    CPPUNIT_ASSERT(bin.isValid());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), bin.sectionCount());
+
+    uint16_t service_id = 0;
+    uint16_t ts_id = 0;
+    uint16_t onetw_id = 0;
+    uint8_t segment_last = 0;
+    ts::TID last_table_id = 0;
+    ts::EIT::EventViewVector events;
+    CPPUNIT_ASSERT(ts::EIT::GetView(*bin.sectionAt(0), service_id, ts_id, onetw_id, segment_last, last_table_id, events));
+
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0A0B), service_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0C0D), ts_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0E0F), onetw_id);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(8), segment_last);
+    CPPUNIT_ASSERT_EQUAL(ts::TID(ts::TID_EIT_S_ACT_MIN + 3), last_table_id);
+
+    CPPUNIT_ASSERT_EQUAL(size_t(2), events.size());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(100), events[0].event_id);
+    CPPUNIT_ASSERT(events[0].start_time == ts::Time(2018, 6, 15, 20, 30, 0));
+    CPPUNIT_ASSERT_EQUAL(ts::Second(5400), events[0].duration);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(4), events[0].running_status);
+    CPPUNIT_ASSERT(!events[0].CA_controlled);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), events[0].descs.count());
+    CPPUNIT_ASSERT_EQUAL(ts::DID(ts::DID_SHORT_EVENT), events[0].descs.begin()->tag());
+
+    CPPUNIT_ASSERT_EQUAL(uint16_t(101), events[1].event_id);
+    CPPUNIT_ASSERT(events[1].start_time == ts::Time(2018, 6, 15, 22, 0, 0));
+    CPPUNIT_ASSERT_EQUAL(ts::Second(59), events[1].duration);
+    CPPUNIT_ASSERT(events[1].CA_controlled);
+    CPPUNIT_ASSERT(events[1].descs.empty());
+
+    // Not an EIT.
+    ts::BinaryTable pat;
+    ts::PAT().serialize(pat);
+    CPPUNIT_ASSERT(!ts::EIT::GetView(*pat.sectionAt(0), service_id, ts_id, onetw_id, segment_last, last_table_id, events));
+    CPPUNIT_ASSERT(events.empty());
+}
@@ -32,6 +32,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsTime.h"
+#include "tsPacketClock.h"
+#include "tsSysUtils.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -55,6 +57,7 @@ public:
     void testFieldsValid();
     void testDecode();
     void testEpoch();
+    void testPacketClock();
 
     CPPUNIT_TEST_SUITE(TimeTest);
     CPPUNIT_TEST(testTime);
@@ -66,6 +69,7 @@ public:
     CPPUNIT_TEST(testFieldsValid);
     CPPUNIT_TEST(testDecode);
     CPPUNIT_TEST(testEpoch);
+    CPPUNIT_TEST(testPacketClock);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -257,3 +261,31 @@ void TimeTest::testEpoch()
 {
     CPPUNIT_ASSERT_USTRINGS_EQUAL(u"1970/01/01 00:00:00.000", ts::Time::UnixEpoch.format());
 }
+
+void TimeTest::testPacketClock()
+{
+    // Coarse clock precision is a few milliseconds.
+    const ts::Time before(ts::Time::CurrentUTC());
+    const ts::Time coarse(ts::Time::CurrentCoarseUTC());
+    CPPUNIT_ASSERT(std::abs(coarse - before) < 100);
+
+    ts::PacketClock clock;
+    CPPUNIT_ASSERT(clock.isCoarse());
+    const ts::Time utc1(clock.utc());
+    CPPUNIT_ASSERT(std::abs(utc1 - before) < 100);
+
+    // The time does not change until the next update.
+    ts::SleepThread(50);
+    CPPUNIT_ASSERT(clock.utc() == utc1);
+    clock.update();
+    CPPUNIT_ASSERT(clock.utc() - utc1 >= 40);
+
+    // Same local time offset as the system.
+    const ts::Time local(clock.localTime());
+    CPPUNIT_ASSERT(local.localToUTC() == clock.utc());
+
+    clock.setCoarse(false);
+    CPPUNIT_ASSERT(!clock.isCoarse());
+    clock.update();
+    CPPUNIT_ASSERT(std::abs(clock.utc() - ts::Time::CurrentUTC()) < 100);
+}
@@ -51,6 +51,8 @@ public:
 
     void testIsSpace();
     void testUTF();
+    void testUTFBlocks();
+    void testUTF8ThreeBytes();
     void testDiacritical();
     void testSurrogate();
     void testWidth();
@@ -96,6 +98,8 @@ public:
     CPPUNIT_TEST_SUITE(UStringTest);
     CPPUNIT_TEST(testIsSpace);
     CPPUNIT_TEST(testUTF);
+    CPPUNIT_TEST(testUTFBlocks);
+    CPPUNIT_TEST(testUTF8ThreeBytes);
     CPPUNIT_TEST(testDiacritical);
     CPPUNIT_TEST(testSurrogate);
     CPPUNIT_TEST(testWidth);
@@ -300,6 +304,85 @@ void UStringTest::testUTF()
     CPPUNIT_ASSERT_USTRINGS_EQUAL(s1, s4);
 }
 
+void UStringTest::testUTFBlocks()
+{
+    // Runs of ASCII characters are converted by blocks. Check all alignments
+    // of a non-ASCII character (2, 3 or 4 bytes in UTF-8) inside ASCII runs.
+    // U+1D538 is encoded as the surrogate pair D835 DD38.
+    static const ts::UChar nonASCII[] = {0x00E9, 0x20AC, 0xD835, 0xDD38};
+    static const char* const nonASCII8[] = {"\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9D\x94\xB8"};
+
+    for (size_t kind = 0; kind < 3; ++kind) {
+        for (size_t len = 0; len < 48; ++len) {
+            for (size_t pos = 0; pos <= len; ++pos) {
+                ts::UString str16;
+                std::string str8;
+                for (size_t i = 0; i <= len; ++i) {
+                    if (i == pos) {
+                        str16.push_back(nonASCII[kind]);
+                        if (kind == 2) {
+                            str16.push_back(nonASCII[kind + 1]);
+                        }
+                        str8.append(nonASCII8[kind]);
+                    }
+                    else {
+                        const char c = char('!' + (i % 90));
+                        str16.push_back(ts::UChar(c));
+                        str8.push_back(c);
+                    }
+                }
+                CPPUNIT_ASSERT_STRINGS_EQUAL(str8, str16.toUTF8());
+                CPPUNIT_ASSERT_USTRINGS_EQUAL(str16, ts::UString::FromUTF8(str8));
+            }
+        }
+    }
+
+    // Long ASCII strings, output buffers shorter than the input.
+    const std::string ascii8("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+    const ts::UString ascii16(ts::UString::FromUTF8(ascii8));
+    CPPUNIT_ASSERT_EQUAL(ascii8.size(), ascii16.size());
+    CPPUNIT_ASSERT_STRINGS_EQUAL(ascii8, ascii16.toUTF8());
+
+    for (size_t outSize = 0; outSize <= ascii8.size(); ++outSize) {
+        ts::UChar buf16[64];
+        const char* in8 = ascii8.data();
+        ts::UChar* out16 = buf16;
+        ts::UString::ConvertUTF8ToUTF16(in8, ascii8.data() + ascii8.size(), out16, buf16 + outSize);
+        CPPUNIT_ASSERT_EQUAL(outSize, size_t(out16 - buf16));
+        CPPUNIT_ASSERT_EQUAL(outSize, size_t(in8 - ascii8.data()));
+        CPPUNIT_ASSERT(ascii16.substr(0, outSize) == ts::UString(buf16, outSize));
+
+        char buf8[64];
+        const ts::UChar* in16 = ascii16.data();
+        char* out8 = buf8;
+        ts::UString::ConvertUTF16ToUTF8(in16, ascii16.data() + ascii16.size(), out8, buf8 + outSize);
+        CPPUNIT_ASSERT_EQUAL(outSize, size_t(out8 - buf8));
+        CPPUNIT_ASSERT_EQUAL(outSize, size_t(in16 - ascii16.data()));
+        CPPUNIT_ASSERT_STRINGS_EQUAL(ascii8.substr(0, outSize), std::string(buf8, outSize));
+    }
+}
+
+void UStringTest::testUTF8ThreeBytes()
+{
+    // Strings ending with characters which are encoded on 3 bytes in UTF-8.
+    // Their UTF-8 size is more than twice the number of UTF-16 codes.
+    CPPUNIT_ASSERT_STRINGS_EQUAL("\xE2\x82\xAC", ts::UString(u"\u20AC").toUTF8());
+    CPPUNIT_ASSERT_STRINGS_EQUAL("a\xE2\x82\xAC", ts::UString(u"a\u20AC").toUTF8());
+    CPPUNIT_ASSERT_STRINGS_EQUAL("\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC", ts::UString(u"\u20AC\u20AC\u20AC").toUTF8());
+
+    ts::UString str16;
+    std::string str8;
+    for (size_t i = 0; i < 100; ++i) {
+        str16.push_back(ts::UChar(0x4E2D));
+        str8.append("\xE4\xB8\xAD");
+    }
+    std::string out8("previous content");
+    str16.toUTF8(out8);
+    CPPUNIT_ASSERT_EQUAL(size_t(300), out8.size());
+    CPPUNIT_ASSERT_STRINGS_EQUAL(str8, out8);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(str16, ts::UString::FromUTF8(out8));
+}
+
 void UStringTest::testDiacritical()
 {
     CPPUNIT_ASSERT(!ts::IsCombiningDiacritical(ts::UChar('a')));
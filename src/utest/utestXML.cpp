@@ -59,6 +59,7 @@ public:
     void testValidation();
     void testCreation();
     void testKeepOpen();
+    void testAttributes();
 
     CPPUNIT_TEST_SUITE(XMLTest);
     CPPUNIT_TEST(testDocument);
@@ -67,6 +68,7 @@ public:
     CPPUNIT_TEST(testValidation);
     CPPUNIT_TEST(testCreation);
     CPPUNIT_TEST(testKeepOpen);
+    CPPUNIT_TEST(testAttributes);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -371,3 +373,62 @@ void XMLTest::testKeepOpen()
         u"</node2>\n",
         out.toString());
 }
+
+void XMLTest::testAttributes()
+{
+    ts::xml::Document doc(report());
+    ts::xml::Element* root = doc.initialize(u"root");
+    CPPUNIT_ASSERT(root != 0);
+
+    // Attribute names are case-insensitive by default.
+    root->setAttribute(u"Foo", u"1");
+    root->setAttribute(u"bar", u"2");
+    root->setIntAttribute(u"Baz", 3);
+    CPPUNIT_ASSERT(root->hasAttribute(u"foo"));
+    CPPUNIT_ASSERT(root->hasAttribute(u"BAR"));
+    CPPUNIT_ASSERT(root->hasAttribute(u"baz"));
+    CPPUNIT_ASSERT(!root->hasAttribute(u"fo"));
+    CPPUNIT_ASSERT(!root->hasAttribute(u"fooo"));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"1", root->attribute(u"FOO").value());
+    CPPUNIT_ASSERT(!root->attribute(u"nope", true).isValid());
+
+    // Setting an existing attribute replaces it, with the new name spelling.
+    root->setAttribute(u"FOO", u"4");
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"4", root->attribute(u"foo").value());
+
+    ts::UStringList names;
+    root->getAttributesNames(names);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"FOO, bar, Baz", ts::UString::Join(names));
+    root->getAttributesNamesInModificationOrder(names);
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"bar, Baz, FOO", ts::UString::Join(names));
+
+    // Attributes are printed in modification order.
+    ts::TextFormatter out(report());
+    root->print(out.setString());
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"<root bar=\"2\" Baz=\"3\" FOO=\"4\"/>", out.toString());
+
+    // Case-sensitive attribute names.
+    ts::xml::Element* cs = new ts::xml::Element(root, u"cs", ts::CASE_SENSITIVE);
+    cs->setAttribute(u"a", u"1");
+    cs->setAttribute(u"A", u"2");
+    CPPUNIT_ASSERT(cs->hasAttribute(u"a"));
+    CPPUNIT_ASSERT(cs->hasAttribute(u"A"));
+    CPPUNIT_ASSERT(!cs->hasAttribute(u"b"));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"1", cs->attribute(u"a").value());
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"2", cs->attribute(u"A").value());
+    cs->getAttributesNames(names);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), names.size());
+
+    // Parsed attributes are printed in document order.
+    ts::xml::Document doc2(report());
+    CPPUNIT_ASSERT(doc2.parse(u"<root z='1' a=\"2\" M='3'/>"));
+    CPPUNIT_ASSERT(doc2.rootElement() != 0);
+    doc2.rootElement()->print(out.setString());
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(u"<root z=\"1\" a=\"2\" M=\"3\"/>", out.toString());
+
+    // Duplicate attributes, case-insensitive, are rejected.
+    ts::ReportBuffer<> rep;
+    ts::xml::Document doc3(rep);
+    CPPUNIT_ASSERT(!doc3.parse(u"<root a='1' b='2' A='3'/>"));
+    CPPUNIT_ASSERT(rep.getMessages().startWith(u"Error: line 1: duplicate attribute 'A' in tag <root>"));
+}